@@ -0,0 +1,113 @@
+/**
+ * @copyright
+ * ====================================================================
+ *    Licensed to the Apache Software Foundation (ASF) under one
+ *    or more contributor license agreements.  See the NOTICE file
+ *    distributed with this work for additional information
+ *    regarding copyright ownership.  The ASF licenses this file
+ *    to you under the Apache License, Version 2.0 (the
+ *    "License"); you may not use this file except in compliance
+ *    with the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing,
+ *    software distributed under the License is distributed on an
+ *    "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *    KIND, either express or implied.  See the License for the
+ *    specific language governing permissions and limitations
+ *    under the License.
+ * ====================================================================
+ * @endcopyright
+ *
+ * @file svn_batch_fsync.h
+ * @brief Efficiently fsync multiple targets
+ */
+
+#ifndef SVN_BATCH_FSYNC_H
+#define SVN_BATCH_FSYNC_H
+
+#include <apr_file_io.h>
+
+#include "svn_error.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * Infrastructure for efficiently calling fsync on files and directories.
+ *
+ * The idea is to have a container of open file handles (including
+ * directory handles on POSIX), at most one per file.  During the course
+ * of an FS operation that needs to be fsync'ed, all touched files and
+ * folders accumulate in the container.
+ *
+ * At the end of the FS operation, all file changes will be written the
+ * physical disk, once per file and folder.  Afterwards, all handles will
+ * be closed and the container is ready for reuse.
+ *
+ * To minimize the delay caused by the batch flush, run all fsync calls
+ * concurrently - if the OS supports multi-threading.
+ */
+
+/** Opaque container type.
+ */
+typedef struct svn_batch_fsync__t svn_batch_fsync__t;
+
+/** Initialize the concurrent fsync infrastructure.  Clean it up when
+ * @a owning_pool gets cleared.
+ *
+ * This function must be called before using any of the other functions in
+ * in this module.  Subsequent calls are no-ops, so each user, e.g. each FS
+ * backend, may call it upon initialization.
+ */
+svn_error_t *
+svn_batch_fsync__init(apr_pool_t *owning_pool);
+
+/** Set @a *result_p to a new batch fsync structure, allocated in
+ * @a result_pool.  If @a flush_to_disk is not set, the resulting struct
+ * will not actually use fsync.
+ */
+svn_error_t *
+svn_batch_fsync__create(svn_batch_fsync__t **result_p,
+                        svn_boolean_t flush_to_disk,
+                        apr_pool_t *result_pool);
+
+/** Open the file at @a filename for read and write access.  Return it in
+ * @a *file and schedule it for fsync in @a batch.  If @a batch already
+ * contains an open file for @a filename, return that instead creating a
+ * new instance.
+ *
+ * Use @a scratch_pool for temporaries.
+ */
+svn_error_t *
+svn_batch_fsync__open_file(apr_file_t **file,
+                           svn_batch_fsync__t *batch,
+                           const char *filename,
+                           apr_pool_t *scratch_pool);
+
+/** Inform the @a batch that a file or directory has been created at
+ * @a path.  "Created" means either newly created to renamed to @a path -
+ * even if another item with the same name existed before.  Depending on
+ * the OS, the correct path will scheduled for fsync.
+ *
+ * Use @a scratch_pool for temporaries.
+ */
+svn_error_t *
+svn_batch_fsync__new_path(svn_batch_fsync__t *batch,
+                          const char *path,
+                          apr_pool_t *scratch_pool);
+
+/** For all files and directories in @a batch, flush all changes to disk
+ * and close the file handles.  Use @a scratch_pool for temporaries.
+ */
+svn_error_t *
+svn_batch_fsync__run(svn_batch_fsync__t *batch,
+                     apr_pool_t *scratch_pool);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* SVN_BATCH_FSYNC_H */
@@ -115,6 +115,14 @@ typedef struct svn_memcache_t svn_memcache_t;
  */
 typedef struct svn_membuffer_t svn_membuffer_t;
 
+/**
+ * An opaque structure representing a persistent, size-bounded store in
+ * a local directory.  It may back any number of disk cache instances.
+ *
+ * @since New in 1.15.
+ */
+typedef struct svn_cache__disk_t svn_cache__disk_t;
+
 /**
  * Opaque type for an in-memory cache.
  */
@@ -270,6 +278,91 @@ svn_cache__make_memcache_from_config(svn_memcache_t **memcache_p,
                                      apr_pool_t *result_pool,
                                      apr_pool_t *scratch_pool);
 
+/**
+ * Open the disk cache store in directory @a path and return it in
+ * @a *disk_p, allocated in @a result_pool.  The directory will be created
+ * if it does not exist, yet.  Its contents will be limited to roughly
+ * @a max_size bytes, with the oldest items being removed first.
+ *
+ * Items are stored in individual files named after a hash of their full
+ * key.  They are written atomically and remain valid across process
+ * restarts.  Multiple processes may share the same @a path.
+ *
+ * @since New in 1.15.
+ */
+svn_error_t *
+svn_cache__disk_create(svn_cache__disk_t **disk_p,
+                       const char *path,
+                       apr_uint64_t max_size,
+                       apr_pool_t *result_pool);
+
+/**
+ * Return the process-global disk cache store for directory @a path in
+ * @a *disk_p.  The first call for any given @a path opens the store as
+ * svn_cache__disk_create() does, limiting it to @a max_size bytes.  Later
+ * calls for the same @a path return that same store and ignore
+ * @a max_size.  The store lives until the end of the process.
+ *
+ * Use @a scratch_pool for temporary allocations.
+ *
+ * @since New in 1.15.
+ */
+svn_error_t *
+svn_cache__get_global_disk_cache(svn_cache__disk_t **disk_p,
+                                 const char *path,
+                                 apr_uint64_t max_size,
+                                 apr_pool_t *scratch_pool);
+
+/**
+ * Creates a new cache in @a *cache_p, storing its items in @a disk.
+ * The elements in the cache will be indexed by keys of length @a klen,
+ * which may be APR_HASH_KEY_STRING if they are strings.  Values will be
+ * serialized using @a serialize_func and deserialized using
+ * @a deserialize_func.  Because the same @a disk may cache many different
+ * kinds of values, @a prefix should be specified to differentiate this
+ * cache from other caches.  As the items may outlive the current process,
+ * @a prefix must also identify the data source uniquely and persistently.
+ * @a *cache_p will be allocated in @a result_pool.
+ *
+ * If @a deserialize_func is NULL, then the data is returned as an
+ * svn_stringbuf_t; if @a serialize_func is NULL, then the data is
+ * assumed to be an svn_stringbuf_t.
+ *
+ * These caches are always thread safe.
+ *
+ * These caches do not support svn_cache__iter.
+ *
+ * @since New in 1.15.
+ */
+svn_error_t *
+svn_cache__create_disk_cache(svn_cache__t **cache_p,
+                             svn_cache__disk_t *disk,
+                             svn_cache__serialize_func_t serialize_func,
+                             svn_cache__deserialize_func_t deserialize_func,
+                             apr_ssize_t klen,
+                             const char *prefix,
+                             apr_pool_t *result_pool);
+
+/**
+ * Creates a new cache in @a *cache_p that stacks the usually slower but
+ * larger @a second_level cache behind @a first_level.  Both must use the
+ * same key type and value serialization.
+ *
+ * Items will be written to both caches.  Lookups that miss in
+ * @a first_level will be tried in @a second_level and, if found there,
+ * be copied to @a first_level.
+ *
+ * The cache is thread safe if both caches are.  It does not support
+ * svn_cache__iter.  @a *cache_p will be allocated in @a result_pool.
+ *
+ * @since New in 1.15.
+ */
+svn_error_t *
+svn_cache__create_tiered(svn_cache__t **cache_p,
+                         svn_cache__t *first_level,
+                         svn_cache__t *second_level,
+                         apr_pool_t *result_pool);
+
 /**
  * Creates a new membuffer cache object in @a *cache. It will contain
  * up to @a total_size bytes of data, using @a directory_size bytes
@@ -310,6 +403,33 @@ svn_cache__membuffer_cache_create(svn_membuffer_t **cache,
                                   svn_boolean_t allow_blocking_writes,
                                   apr_pool_t *result_pool);
 
+/**
+ * Same as svn_cache__membuffer_cache_create() but place the whole cache,
+ * i.e. its index, data buffers and segment locks, in anonymous shared
+ * memory.  All processes forked from the current one after this call will
+ * share the cache contents: items added by any of them become visible to
+ * all others.  Access is always serialized across processes and threads.
+ *
+ * Because key prefixes cannot be shared efficiently between processes,
+ * items in a shared cache always carry their full keys.
+ *
+ * The segment locks are robust process-shared mutexes, so a process that
+ * dies while holding one does not block the others.  The next process
+ * to take that lock discards the segment's contents.
+ *
+ * Return an error if the platform does not support anonymous shared
+ * memory or robust process-shared mutexes.
+ *
+ * @since New in 1.15.
+ */
+svn_error_t *
+svn_cache__membuffer_cache_create_shared(svn_membuffer_t **cache,
+                                         apr_size_t total_size,
+                                         apr_size_t directory_size,
+                                         apr_size_t segment_count,
+                                         svn_boolean_t allow_blocking_writes,
+                                         apr_pool_t *result_pool);
+
 /**
  * @defgroup Standard priority classes for #svn_cache__create_membuffer_cache.
  * @{
@@ -554,6 +674,25 @@ svn_cache__format_info(const svn_cache__info_t *info,
 struct svn_membuffer_t *
 svn_cache__get_global_membuffer_cache(void);
 
+/**
+ * Create the process-global (singleton) membuffer cache using the current
+ * cache config and place it in shared memory, i.e. all processes forked
+ * from the current one afterwards will use the same cache instance.  See
+ * svn_cache__membuffer_cache_create_shared().
+ *
+ * Pre-forking servers should call this during their initialization,
+ * after setting the cache config and before creating any child process.
+ * Repeated calls are no-ops.  Return an error if the global cache has
+ * already been created as a process-local cache or if the shared cache
+ * could not be created.  In the latter case, the global cache will be a
+ * process-local cache instead, i.e. each child process gets its own copy
+ * of it, unless that could not be created either.
+ *
+ * @since New in 1.15.
+ */
+svn_error_t *
+svn_cache__create_shared_global_membuffer_cache(void);
+
 /**
  * Return total access and size stats over all membuffer caches as they
  * share the underlying data buffer.  The result will be allocated in POOL.
@@ -108,6 +108,68 @@ svn_txdelta__read_raw_window_len(apr_size_t *window_len,
                                  svn_stream_t *stream,
                                  apr_pool_t *pool);
 
+/** Like svn_txdelta_to_svndiff3() but compress batches of windows
+ * concurrently, using up to @a jobs worker threads.  The windows are
+ * still written to @a output in their original order, i.e. the result is
+ * the same as with svn_txdelta_to_svndiff3().
+ *
+ * If @a jobs is 1 or less or @a svndiff_version is 0, this is equivalent
+ * to svn_txdelta_to_svndiff3().
+ */
+void
+svn_txdelta__to_svndiff_parallel(svn_txdelta_window_handler_t *handler,
+                                 void **handler_baton,
+                                 svn_stream_t *output,
+                                 int svndiff_version,
+                                 int compression_level,
+                                 int jobs,
+                                 apr_pool_t *pool);
+
+/** Like svn_txdelta2() but select the source data for each delta window
+ * by content rather than by offset.
+ *
+ * svn_txdelta2() compares the n-th window of @a target with the data at
+ * the same offset in @a source only.  After insertions into or deletions
+ * from large files, the delta will therefore contain most of the target
+ * as new data.  This function splits both @a source and @a target into
+ * content-defined chunks and uses matching chunks to find a suitable
+ * source view for each window.  The resulting windows are compatible with
+ * svn_txdelta_apply() and all other delta consumers.
+ *
+ * @a source will be read in full before the first window is produced and
+ * then again, partially, while producing the windows.  It must therefore
+ * support marks, see svn_stream_supports_mark().  If it does not, this
+ * function behaves like svn_txdelta2().
+ *
+ * Allocate the index and the buffers in @a pool.  The index requires
+ * about 1% of the size of @a source.
+ */
+void
+svn_txdelta__cdc(svn_txdelta_stream_t **stream,
+                 svn_stream_t *source,
+                 svn_stream_t *target,
+                 svn_boolean_t calculate_checksum,
+                 apr_pool_t *pool);
+
+/** Compose the chain of delta @a windows into a single window.
+ * @a windows is an array of <tt>const svn_txdelta_window_t *</tt> and must
+ * not be empty.  The target view of each window is the source view of
+ * its successor, i.e. the first window applies to the oldest data and
+ * the last one produces the newest target.
+ *
+ * This is equivalent to repeatedly calling svn_txdelta_compose_windows()
+ * but reuses the combiner's indexes across the whole chain and skips
+ * all windows preceding the last one that has no source copies.  The
+ * source view of the result is that of the first window not skipped.
+ *
+ * Allocate the result in @a result_pool and temporaries in
+ * @a scratch_pool.
+ */
+svn_txdelta_window_t *
+svn_txdelta__compose_window_chain(const apr_array_header_t *windows,
+                                  apr_pool_t *result_pool,
+                                  apr_pool_t *scratch_pool);
+
 /* Return a debug editor that wraps @a wrapped_editor.
  *
  * The debug editor simply prints an indication of what callbacks are being
@@ -364,6 +364,19 @@ typedef struct svn_fs_fs__ioctl_build_rep_cache_input_t
 /* See svn_fs_fs__build_rep_cache(). */
 SVN_FS_DECLARE_IOCTL_CODE(SVN_FS_FS__IOCTL_BUILD_REP_CACHE, SVN_FS_TYPE_FSFS, 1004);
 
+typedef struct svn_fs_fs__ioctl_warm_caches_input_t
+{
+  svn_revnum_t start_rev;
+  svn_revnum_t end_rev;
+  /* Array of const char * paths, may be NULL. */
+  const apr_array_header_t *paths;
+  svn_fs_progress_notify_func_t progress_func;
+  void *progress_baton;
+} svn_fs_fs__ioctl_warm_caches_input_t;
+
+/* See svn_fs_fs__warm_caches(). */
+SVN_FS_DECLARE_IOCTL_CODE(SVN_FS_FS__IOCTL_WARM_CACHES, SVN_FS_TYPE_FSFS, 1005);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
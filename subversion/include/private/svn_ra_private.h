@@ -83,6 +83,53 @@ svn_ra__assert_capable_server(svn_ra_session_t *ra_session,
                               const char *path_or_url,
                               apr_pool_t *pool);
 
+/** Like svn_ra_stat() but for all of the relpaths in @a paths, which is
+ * an array of <tt>const char *</tt>.  Set @a *dirents to an array of
+ * <tt>svn_dirent_t *</tt> of the same length, with each element
+ * describing the path at the same index, or @c NULL if that path does
+ * not exist in @a revision.
+ *
+ * RA layers that support it send all requests before waiting for the
+ * responses, so this is much faster than individual svn_ra_stat() calls
+ * over high-latency connections.
+ *
+ * Allocate @a *dirents in @a result_pool and use @a scratch_pool for
+ * temporary allocations.
+ *
+ * @since New in 1.15.
+ */
+svn_error_t *
+svn_ra__stat_many(svn_ra_session_t *session,
+                  apr_array_header_t **dirents,
+                  const apr_array_header_t *paths,
+                  svn_revnum_t revision,
+                  apr_pool_t *result_pool,
+                  apr_pool_t *scratch_pool);
+
+/** Like svn_ra_get_dir2() for all of the relpaths in @a paths, which is
+ * an array of <tt>const char *</tt>, but without returning any
+ * properties or the fetched revision.  Set @a *dirents to an array of
+ * <tt>apr_hash_t *</tt> of the same length, with each element mapping
+ * the entry names of the directory at the same index to
+ * <tt>svn_dirent_t *</tt> with the @a dirent_fields filled in.
+ *
+ * Like svn_ra__stat_many(), RA layers that support it send all requests
+ * before waiting for the responses.
+ *
+ * Allocate @a *dirents in @a result_pool and use @a scratch_pool for
+ * temporary allocations.
+ *
+ * @since New in 1.15.
+ */
+svn_error_t *
+svn_ra__get_dir_many(svn_ra_session_t *session,
+                     apr_array_header_t **dirents,
+                     const apr_array_header_t *paths,
+                     svn_revnum_t revision,
+                     apr_uint32_t dirent_fields,
+                     apr_pool_t *result_pool,
+                     apr_pool_t *scratch_pool);
+
 
 /*** Operational Locks ***/
 
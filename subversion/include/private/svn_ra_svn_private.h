@@ -966,6 +966,29 @@ svn_error_t *
 svn_ra_svn__write_cmd_finish_replay(svn_ra_svn_conn_t *conn,
                                     apr_pool_t *pool);
 
+/** Send a "begin-pipeline" command over connection @a conn.
+ * Use @a pool for allocations.
+ *
+ * Until the matching "end-pipeline", the server will not start an
+ * authentication exchange for any command.  Commands that would need
+ * one fail with #SVN_ERR_RA_NOT_AUTHORIZED instead, so the client may
+ * send several commands before reading any of their responses.
+ *
+ * @since New in 1.15.
+ */
+svn_error_t *
+svn_ra_svn__write_cmd_begin_pipeline(svn_ra_svn_conn_t *conn,
+                                     apr_pool_t *pool);
+
+/** Send an "end-pipeline" command over connection @a conn.
+ * Use @a pool for allocations.
+ *
+ * @since New in 1.15.
+ */
+svn_error_t *
+svn_ra_svn__write_cmd_end_pipeline(svn_ra_svn_conn_t *conn,
+                                   apr_pool_t *pool);
+
 /**
  * @}
  */
@@ -432,6 +432,12 @@ svn_error_t *
 svn_sqlite__finish_savepoint(svn_sqlite__db_t *db,
                              svn_error_t *err);
 
+/* Return the number of transactions, explicit or implicit, that have been
+ * committed in DB since it was opened.  Useful to tests that check how
+ * many commits, each of which syncs the journal, an operation takes. */
+apr_uint64_t
+svn_sqlite__get_commit_count(svn_sqlite__db_t *db);
+
 /* Evaluate the expression EXPR within a transaction.
  *
  * Begin a transaction in DB; evaluate the expression EXPR, which would
@@ -254,6 +254,19 @@ svn_string__similarity(const svn_string_t *stringa,
                        svn_membuf_t *buffer, apr_size_t *rlcs);
 
 
+/* Defined to 1 if the compiler targets a CPU that supports SSE2 (this
+ * is always the case for x86-64) and 0 otherwise.  Code using SSE2
+ * intrinsics must provide a portable fallback for the latter case.
+ */
+#ifndef SVN__SSE2_IS_OK
+# if defined(__SSE2__) || defined(_M_X64) \
+     || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define SVN__SSE2_IS_OK 1
+# else
+#  define SVN__SSE2_IS_OK 0
+# endif
+#endif
+
 /* Return the lowest position at which A and B differ. If no difference
  * can be found in the first MAX_LEN characters, MAX_LEN will be returned.
  */
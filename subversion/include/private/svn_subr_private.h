@@ -591,6 +591,31 @@ svn__decompress_lz4(const void *data, apr_size_t len,
                     svn_stringbuf_t *out,
                     apr_size_t limit);
 
+/* Highest compression level accepted by svn__compress_zstd(). */
+#define SVN__ZSTD_LEVEL_MAX 19
+
+/* Return TRUE if this build of Subversion supports zstd compression.
+ * Otherwise, the zstd functions below will return
+ * SVN_ERR_UNSUPPORTED_FEATURE.
+ */
+svn_boolean_t
+svn__zstd_available(void);
+
+/* Same as svn__compress_zlib(), but use zstd compression with the given
+ * COMPRESSION_LEVEL.  Levels outside 1 ... SVN__ZSTD_LEVEL_MAX will be
+ * clipped to that range.
+ */
+svn_error_t *
+svn__compress_zstd(const void *data, apr_size_t len,
+                   svn_stringbuf_t *out,
+                   int compression_level);
+
+/* Same as svn__decompress_zlib(), but use zstd compression. */
+svn_error_t *
+svn__decompress_zstd(const void *data, apr_size_t len,
+                     svn_stringbuf_t *out,
+                     apr_size_t limit);
+
 /** @} */
 
 /**
@@ -746,6 +771,15 @@ const char *svn_lz4__compiled_version(void);
  */
 int svn_lz4__runtime_version(void);
 
+/* Return the zstd version we compiled against or NULL, if we have been
+ * built without zstd support. */
+const char *svn_zstd__compiled_version(void);
+
+/* Return the zstd version we run against as a composed value:
+ * major * 100 * 100 + minor * 100 + release
+ */
+int svn_zstd__runtime_version(void);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
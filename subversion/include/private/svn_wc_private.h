@@ -1329,6 +1329,34 @@ svn_wc__parse_externals_description(apr_array_header_t **externals_p,
                                     svn_boolean_t canonicalize_url,
                                     apr_pool_t *pool);
 
+/**
+ * Like svn_wc_walk_status() but walk sub-directories concurrently, using
+ * up to @a jobs worker threads.  @a status_func is still called from the
+ * calling thread and in the same order as with svn_wc_walk_status().
+ *
+ * Unlike with svn_wc_walk_status(), @a status_func may only read from
+ * but not modify the working copy because the walk progresses concurrently.
+ *
+ * If @a jobs is 1 or less or the working copy database is opened with
+ * exclusive locking, this is equivalent to svn_wc_walk_status().
+ *
+ * @since New in 1.15.
+ */
+svn_error_t *
+svn_wc__walk_status_concurrently(svn_wc_context_t *wc_ctx,
+                                 const char *local_abspath,
+                                 svn_depth_t depth,
+                                 svn_boolean_t get_all,
+                                 svn_boolean_t no_ignore,
+                                 svn_boolean_t ignore_text_mods,
+                                 const apr_array_header_t *ignore_patterns,
+                                 int jobs,
+                                 svn_wc_status_func4_t status_func,
+                                 void *status_baton,
+                                 svn_cancel_func_t cancel_func,
+                                 void *cancel_baton,
+                                 apr_pool_t *scratch_pool);
+
 /**
  * Set @a *editor and @a *edit_baton to an editor that generates
  * #svn_wc_status3_t structures and sends them through @a status_func /
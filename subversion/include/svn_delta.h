@@ -526,7 +526,11 @@ svn_txdelta_apply(svn_stream_t *source,
  *
  * @since New in 1.7.  Since 1.10, @a svndiff_version can be 2 for the
  * svndiff2 format.  @a compression_level is currently ignored if
- * @a svndiff_version is set to 2.
+ * @a svndiff_version is set to 2.  Since 1.15, @a svndiff_version can be
+ * 3 for the zstd-based svndiff3 format, in which case @a compression_level
+ * is the zstd compression level (values above the zstd maximum will be
+ * clamped).  Producing svndiff3 fails if Subversion has been built without
+ * zstd support.
  */
 void
 svn_txdelta_to_svndiff3(svn_txdelta_window_handler_t *handler,
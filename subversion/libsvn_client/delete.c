@@ -302,7 +302,6 @@ delete_urls_multi_repos(const apr_array_header_t *uris,
       const char *uri = APR_ARRAY_IDX(uris, i, const char *);
       struct repos_deletables_t *repos_deletables = NULL;
       const char *repos_relpath;
-      svn_node_kind_t kind;
 
       for (hi = apr_hash_first(pool, deletables); hi; hi = apr_hash_next(hi))
         {
@@ -357,18 +356,43 @@ delete_urls_multi_repos(const apr_array_header_t *uris,
       if (!repos_relpath || !*repos_relpath)
         return svn_error_createf(SVN_ERR_RA_ILLEGAL_URL, NULL,
                                  _("URL '%s' not within a repository"), uri);
+    }
 
-      /* Now, test to see if the thing actually exists in HEAD. */
-      SVN_ERR(svn_ra_check_path(repos_deletables->ra_session, repos_relpath,
-                                SVN_INVALID_REVNUM, &kind, pool));
-      if (kind == svn_node_none)
-        return svn_error_createf(SVN_ERR_FS_NOT_FOUND, NULL,
-                                 _("URL '%s' does not exist"), uri);
+  /* Now, test to see if the things actually exist in HEAD.  Ask for all
+     targets within the same repository at once. */
+  iterpool = svn_pool_create(pool);
+  for (hi = apr_hash_first(pool, deletables); hi; hi = apr_hash_next(hi))
+    {
+      const char *repos_root = apr_hash_this_key(hi);
+      struct repos_deletables_t *repos_deletables = apr_hash_this_val(hi);
+      apr_array_header_t *target_uris = repos_deletables->target_uris;
+      apr_array_header_t *relpaths;
+      apr_array_header_t *dirents;
+
+      svn_pool_clear(iterpool);
+
+      relpaths = apr_array_make(iterpool, target_uris->nelts,
+                                sizeof(const char *));
+      for (i = 0; i < target_uris->nelts; i++)
+        APR_ARRAY_PUSH(relpaths, const char *)
+          = svn_uri_skip_ancestor(repos_root,
+                                  APR_ARRAY_IDX(target_uris, i, const char *),
+                                  iterpool);
+
+      SVN_ERR(svn_ra__stat_many(repos_deletables->ra_session, &dirents,
+                                relpaths, SVN_INVALID_REVNUM,
+                                iterpool, iterpool));
+
+      for (i = 0; i < dirents->nelts; i++)
+        if (APR_ARRAY_IDX(dirents, i, svn_dirent_t *) == NULL)
+          return svn_error_createf(SVN_ERR_FS_NOT_FOUND, NULL,
+                                   _("URL '%s' does not exist"),
+                                   APR_ARRAY_IDX(target_uris, i,
+                                                 const char *));
     }
 
   /* Now we iterate over the DELETABLES hash, issuing a commit for
      each repository with its associated collected targets. */
-  iterpool = svn_pool_create(pool);
   for (hi = apr_hash_first(pool, deletables); hi; hi = apr_hash_next(hi))
     {
       struct repos_deletables_t *repos_deletables = apr_hash_this_val(hi);
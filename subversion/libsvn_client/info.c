@@ -36,6 +36,7 @@
 
 #include "svn_private_config.h"
 #include "private/svn_fspath.h"
+#include "private/svn_ra_private.h"
 #include "private/svn_sorts_private.h"
 #include "private/svn_wc_private.h"
 
@@ -180,6 +181,11 @@ build_info_from_dirent(svn_client_info2_t **info,
    svn_depth_files, then invoke RECEIVER on file children of DIR but
    not on subdirectories; if svn_depth_infinity, recurse fully.
    DIR is a relpath, relative to the root of RA_SESSION.
+
+   DIRENTS are the entries of DIR, or NULL to fetch them here.  When
+   recursing fully, the entries of all subdirectories of DIR are fetched
+   with a single svn_ra__get_dir_many() call, so that RA layers that
+   pipeline requests need not wait for one response per directory.
 */
 static svn_error_t *
 push_dir_info(svn_ra_session_t *ra_session,
@@ -190,16 +196,50 @@ push_dir_info(svn_ra_session_t *ra_session,
               svn_depth_t depth,
               svn_client_ctx_t *ctx,
               apr_hash_t *locks,
+              apr_hash_t *dirents,
               apr_pool_t *pool)
 {
-  apr_hash_t *tmpdirents;
+  apr_hash_t *subdir_dirents = NULL;
   apr_hash_index_t *hi;
   apr_pool_t *subpool = svn_pool_create(pool);
 
-  SVN_ERR(svn_ra_get_dir2(ra_session, &tmpdirents, NULL, NULL,
-                          dir, pathrev->rev, DIRENT_FIELDS, pool));
+  if (dirents == NULL)
+    SVN_ERR(svn_ra_get_dir2(ra_session, &dirents, NULL, NULL,
+                            dir, pathrev->rev, DIRENT_FIELDS, pool));
+
+  if (depth == svn_depth_infinity)
+    {
+      apr_array_header_t *subdirs = apr_array_make(pool, 0,
+                                                   sizeof(const char *));
+      apr_array_header_t *names = apr_array_make(pool, 0,
+                                                 sizeof(const char *));
+      apr_array_header_t *listings;
+      int i;
+
+      for (hi = apr_hash_first(pool, dirents); hi; hi = apr_hash_next(hi))
+        {
+          const char *name = apr_hash_this_key(hi);
+          svn_dirent_t *the_ent = apr_hash_this_val(hi);
+
+          if (the_ent->kind != svn_node_dir)
+            continue;
+
+          APR_ARRAY_PUSH(names, const char *) = name;
+          APR_ARRAY_PUSH(subdirs, const char *)
+            = svn_relpath_join(dir, name, pool);
+        }
+
+      SVN_ERR(svn_ra__get_dir_many(ra_session, &listings, subdirs,
+                                   pathrev->rev, DIRENT_FIELDS,
+                                   pool, pool));
+
+      subdir_dirents = apr_hash_make(pool);
+      for (i = 0; i < names->nelts; i++)
+        svn_hash_sets(subdir_dirents, APR_ARRAY_IDX(names, i, const char *),
+                      APR_ARRAY_IDX(listings, i, apr_hash_t *));
+    }
 
-  for (hi = apr_hash_first(pool, tmpdirents); hi; hi = apr_hash_next(hi))
+  for (hi = apr_hash_first(pool, dirents); hi; hi = apr_hash_next(hi))
     {
       const char *path, *fs_path;
       svn_lock_t *lock;
@@ -232,7 +272,9 @@ push_dir_info(svn_ra_session_t *ra_session,
         {
           SVN_ERR(push_dir_info(ra_session, child_pathrev, path,
                                 receiver, receiver_baton,
-                                depth, ctx, locks, subpool));
+                                depth, ctx, locks,
+                                svn_hash_gets(subdir_dirents, name),
+                                subpool));
         }
     }
 
@@ -456,7 +498,7 @@ svn_client_info4(const char *abspath_or_url,
 
       SVN_ERR(push_dir_info(ra_session, pathrev, "",
                             receiver, receiver_baton,
-                            depth, ctx, locks, pool));
+                            depth, ctx, locks, NULL, pool));
     }
 
   return SVN_NO_ERROR;
@@ -41,6 +41,7 @@
 #include "svn_dirent_uri.h"
 #include "svn_delta.h"
 #include "svn_client.h"
+#include "svn_config.h"
 #include "svn_error.h"
 #include "svn_hash.h"
 
@@ -663,14 +664,28 @@ svn_client_status6(svn_revnum_t *result_rev,
     }
   else
     {
+      svn_config_t *cfg = ctx->config
+                        ? svn_hash_gets(ctx->config,
+                                        SVN_CONFIG_CATEGORY_CONFIG)
+                        : NULL;
+      apr_int64_t jobs;
+
+      SVN_ERR(svn_config_get_int64(cfg, &jobs,
+                                   SVN_CONFIG_SECTION_WORKING_COPY,
+                                   SVN_CONFIG_OPTION_STATUS_JOBS, 1));
+      if (jobs < 1 || jobs > APR_INT32_MAX)
+        jobs = 1;
+
       SVN_ERR(shelves_status(changelists, target_abspath,
                              tweak_status, &sb,
                              ctx, pool));
-      err = svn_wc_walk_status(ctx->wc_ctx, target_abspath,
-                               depth, get_all, no_ignore, FALSE, ignores,
-                               tweak_status, &sb,
-                               ctx->cancel_func, ctx->cancel_baton,
-                               pool);
+      err = svn_wc__walk_status_concurrently(ctx->wc_ctx, target_abspath,
+                                             depth, get_all, no_ignore,
+                                             FALSE, ignores, (int)jobs,
+                                             tweak_status, &sb,
+                                             ctx->cancel_func,
+                                             ctx->cancel_baton,
+                                             pool);
 
       if (err && err->apr_err == SVN_ERR_WC_MISSING)
         {
@@ -0,0 +1,513 @@
+/*
+ * cdc.c:  text deltas based on content-defined chunking
+ *
+ * ====================================================================
+ *    Licensed to the Apache Software Foundation (ASF) under one
+ *    or more contributor license agreements.  See the NOTICE file
+ *    distributed with this work for additional information
+ *    regarding copyright ownership.  The ASF licenses this file
+ *    to you under the Apache License, Version 2.0 (the
+ *    "License"); you may not use this file except in compliance
+ *    with the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing,
+ *    software distributed under the License is distributed on an
+ *    "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *    KIND, either express or implied.  See the License for the
+ *    specific language governing permissions and limitations
+ *    under the License.
+ * ====================================================================
+ */
+
+#include <apr_hash.h>
+#include <apr_strings.h>
+
+#include "svn_delta.h"
+#include "svn_pools.h"
+#include "private/svn_delta_private.h"
+#include "delta.h"
+
+#include "svn_private_config.h"
+
+/* svn_txdelta2() compares each target window only with the source data
+ * at the same offset.  Once data gets inserted into or removed from a
+ * large file, the source and target views drift apart and the delta
+ * degrades into plain new data.
+ *
+ * Here, we first split the whole source into chunks whose boundaries
+ * are determined by their content, using a gear rolling hash as in
+ * FastCDC.  Fingerprints of those chunks get stored in an index.  For
+ * each target window, we chunk its data the same way and look up the
+ * chunks in the index.  The source offset that most of the target data
+ * maps to becomes the source view of the window and the xdelta engine
+ * does the rest.
+ *
+ * The result is a sequence of ordinary delta windows.  Because
+ * svn_txdelta_apply() and all other consumers read the source as a
+ * stream, source views must never move backwards; we simply don't
+ * consider matches that would violate this.
+ */
+
+/* Chunks will not be shorter than this, except at the end of the data. */
+#define MIN_CHUNK_SIZE 0x800
+
+/* Chunks will not be longer than this. */
+#define MAX_CHUNK_SIZE 0x10000
+
+/* A chunk boundary is found where all of these bits in the gear hash are
+ * 0.  With 13 bits, the average chunk size is about 8 kB + MIN_CHUNK_SIZE.
+ * Use the upper bits because the lower bits of the gear hash only depend
+ * on the last few bytes. */
+#define BOUNDARY_MASK 0xfff80000
+
+/* Parameters of the FNV-1a hash that we use as fingerprints of chunks. */
+#define FNV1_PRIME_32 0x01000193
+#define FNV1_BASE_32 2166136261U
+
+/* Key in the chunk index. */
+typedef struct chunk_key_t
+{
+  /* FNV-1a checksum over the chunk contents. */
+  apr_uint32_t fingerprint;
+
+  /* Length of the chunk in bytes. */
+  apr_uint32_t length;
+} chunk_key_t;
+
+/* State of the chunking process. */
+typedef struct chunker_t
+{
+  /* Gear rolling hash over the data of the current chunk so far. */
+  apr_uint32_t gear;
+
+  /* FNV-1a checksum over the data of the current chunk so far. */
+  apr_uint32_t fingerprint;
+
+  /* Number of bytes in the current chunk so far. */
+  apr_size_t length;
+} chunker_t;
+
+/* Delta stream state. */
+typedef struct cdc_baton_t
+{
+  /* Input streams as passed to svn_txdelta__cdc. */
+  svn_stream_t *source;
+  svn_stream_t *target;
+
+  /* Start of SOURCE.  NULL until the index has been built. */
+  svn_stream_mark_t *source_start;
+
+  /* Current read position within SOURCE relative to SOURCE_START. */
+  svn_filesize_t source_pos;
+
+  /* Total length of SOURCE. */
+  svn_filesize_t source_size;
+
+  /* Maps chunk_key_t to the offset (svn_filesize_t *) of the first chunk
+   * in SOURCE with that key. */
+  apr_hash_t *index;
+
+  /* Random values to mix into the gear hash, one per byte value. */
+  apr_uint32_t gear_table[256];
+
+  /* Offset of the next target window. */
+  svn_filesize_t target_pos;
+
+  /* Source view offset of the previous window. */
+  svn_filesize_t sview_offset;
+
+  /* Source view offset minus target window offset for the latest window
+   * that had matching chunks.  Only valid if MATCHED is set. */
+  svn_filesize_t shift;
+  svn_boolean_t matched;
+
+  /* Buffer for up to SVN_DELTA_WINDOW_SIZE bytes of source data followed
+   * by up to SVN_DELTA_WINDOW_SIZE bytes of target data.  The target data
+   * always starts at SVN_DELTA_WINDOW_SIZE and the source view directly
+   * precedes it. */
+  char *buf;
+
+  /* Have we not yet returned the final NULL window? */
+  svn_boolean_t more;
+
+  /* MD5 of the target.  CONTEXT is NULL if not requested. */
+  svn_checksum_ctx_t *context;
+  svn_checksum_t *checksum;
+
+  /* For the index and other data that lives as long as the stream. */
+  apr_pool_t *pool;
+} cdc_baton_t;
+
+/* Initialize the gear hash TABLE with deterministic pseudo-random values.
+ * Determinism is not needed for correctness but makes deltas
+ * reproducible. */
+static void
+init_gear_table(apr_uint32_t table[256])
+{
+  apr_uint32_t x = 0x9e3779b9;
+  int i;
+
+  for (i = 0; i < 256; ++i)
+    {
+      /* xorshift32 */
+      x ^= x << 13;
+      x ^= x >> 17;
+      x ^= x << 5;
+      table[i] = x;
+    }
+}
+
+/* Reset CHUNKER to the start of a new chunk. */
+static void
+chunker_reset(chunker_t *chunker)
+{
+  chunker->gear = 0;
+  chunker->fingerprint = FNV1_BASE_32;
+  chunker->length = 0;
+}
+
+/* Feed up to LEN bytes from DATA into CHUNKER, using the gear hash
+ * TABLE.  Stop after the first chunk boundary.  Return the number of bytes
+ * consumed in *CONSUMED and return TRUE if a chunk boundary was found.
+ * In that case, the completed chunk is described by CHUNKER.
+ */
+static svn_boolean_t
+chunker_feed(chunker_t *chunker,
+             const apr_uint32_t table[256],
+             const char *data,
+             apr_size_t len,
+             apr_size_t *consumed)
+{
+  const unsigned char *p = (const unsigned char *)data;
+  apr_uint32_t gear = chunker->gear;
+  apr_uint32_t fingerprint = chunker->fingerprint;
+  apr_size_t length = chunker->length;
+  svn_boolean_t found = FALSE;
+  apr_size_t i;
+
+  for (i = 0; i < len; ++i)
+    {
+      gear = (gear << 1) + table[p[i]];
+      fingerprint = (fingerprint ^ p[i]) * FNV1_PRIME_32;
+      ++length;
+
+      if (   (length >= MIN_CHUNK_SIZE && (gear & BOUNDARY_MASK) == 0)
+          || length >= MAX_CHUNK_SIZE)
+        {
+          found = TRUE;
+          ++i;
+          break;
+        }
+    }
+
+  chunker->gear = gear;
+  chunker->fingerprint = fingerprint;
+  chunker->length = length;
+  *consumed = i;
+
+  return found;
+}
+
+/* Read the whole source stream of BATON, chunk it and fill the index.
+ * Afterwards, the source stream will be at its start again.
+ * Use SCRATCH_POOL for temporary allocations.
+ */
+static svn_error_t *
+build_index(cdc_baton_t *baton,
+            apr_pool_t *scratch_pool)
+{
+  chunker_t chunker;
+  svn_filesize_t chunk_start = 0;
+  svn_filesize_t pos = 0;
+  char *buf = apr_palloc(scratch_pool, SVN_DELTA_WINDOW_SIZE);
+  apr_size_t len;
+
+  SVN_ERR(svn_stream_mark(baton->source, &baton->source_start, baton->pool));
+  baton->index = apr_hash_make(baton->pool);
+  chunker_reset(&chunker);
+
+  do
+    {
+      apr_size_t offset = 0;
+
+      len = SVN_DELTA_WINDOW_SIZE;
+      SVN_ERR(svn_stream_read_full(baton->source, buf, &len));
+
+      while (offset < len)
+        {
+          apr_size_t consumed;
+          chunk_key_t key;
+
+          if (!chunker_feed(&chunker, baton->gear_table, buf + offset,
+                            len - offset, &consumed))
+            {
+              offset += consumed;
+              break;
+            }
+
+          offset += consumed;
+
+          key.fingerprint = chunker.fingerprint;
+          key.length = (apr_uint32_t)chunker.length;
+
+          /* Prefer the first occurrence.  Later ones are unlikely to be
+           * reachable without moving the source view backwards. */
+          if (!apr_hash_get(baton->index, &key, sizeof(key)))
+            {
+              chunk_key_t *stored_key = apr_pmemdup(baton->pool, &key,
+                                                    sizeof(key));
+              svn_filesize_t *stored_offset
+                = apr_palloc(baton->pool, sizeof(*stored_offset));
+
+              *stored_offset = chunk_start;
+              apr_hash_set(baton->index, stored_key, sizeof(*stored_key),
+                           stored_offset);
+            }
+
+          chunk_start += chunker.length;
+          chunker_reset(&chunker);
+        }
+
+      pos += len;
+    }
+  while (len == SVN_DELTA_WINDOW_SIZE);
+
+  baton->source_size = pos;
+  baton->source_pos = pos;
+
+  return SVN_NO_ERROR;
+}
+
+/* Return the source view offset for the LEN bytes of target DATA in
+ * BATON and update the match statistics in BATON.
+ * Use SCRATCH_POOL for temporary allocations.
+ */
+static svn_filesize_t
+select_source_view(cdc_baton_t *baton,
+                   const char *data,
+                   apr_size_t len,
+                   apr_pool_t *scratch_pool)
+{
+  /* Candidate view offsets and the number of target bytes supporting
+   * them. */
+  int max_candidates = SVN_DELTA_WINDOW_SIZE / MIN_CHUNK_SIZE + 1;
+  svn_filesize_t *offsets = apr_palloc(scratch_pool,
+                                       max_candidates * sizeof(*offsets));
+  apr_size_t *weights = apr_palloc(scratch_pool,
+                                   max_candidates * sizeof(*weights));
+  int candidates = 0;
+  int best = -1;
+  int i;
+
+  chunker_t chunker;
+  apr_size_t pos = 0;
+  svn_filesize_t result;
+
+  chunker_reset(&chunker);
+  while (pos < len)
+    {
+      apr_size_t consumed;
+      apr_size_t chunk_pos;
+      chunk_key_t key;
+      svn_filesize_t *source_offset;
+      svn_filesize_t view_offset;
+
+      /* The incomplete chunk at the end of the window has not been
+       * delimited by its content and is therefore unlikely to match. */
+      if (!chunker_feed(&chunker, baton->gear_table, data + pos, len - pos,
+                        &consumed))
+        break;
+
+      pos += consumed;
+      chunk_pos = pos - chunker.length;
+
+      key.fingerprint = chunker.fingerprint;
+      key.length = (apr_uint32_t)chunker.length;
+      chunker_reset(&chunker);
+
+      source_offset = apr_hash_get(baton->index, &key, sizeof(key));
+      if (source_offset == NULL)
+        continue;
+
+      /* Align the source view with the target window. */
+      view_offset = *source_offset - chunk_pos;
+      if (view_offset < 0)
+        view_offset = 0;
+
+      /* Never move backwards. */
+      if (view_offset < baton->sview_offset)
+        continue;
+
+      for (i = 0; i < candidates; ++i)
+        if (offsets[i] == view_offset)
+          break;
+
+      if (i == candidates)
+        {
+          offsets[i] = view_offset;
+          weights[i] = 0;
+          ++candidates;
+        }
+
+      weights[i] += key.length;
+    }
+
+  for (i = 0; i < candidates; ++i)
+    if (best < 0 || weights[i] > weights[best])
+      best = i;
+
+  /* Without any matches, assume that the data has been shifted by the
+   * same amount as for the previous windows.  If we haven't seen any
+   * matches yet, the target probably starts with new data.  Picking the
+   * same offset as svn_txdelta2() would then move the source view beyond
+   * where the following windows will match. */
+  if (best >= 0)
+    {
+      result = offsets[best];
+      baton->shift = result - baton->target_pos;
+      baton->matched = TRUE;
+    }
+  else if (baton->matched)
+    result = baton->target_pos + baton->shift;
+  else
+    result = baton->sview_offset;
+
+  if (result < baton->sview_offset)
+    result = baton->sview_offset;
+  if (result > baton->source_size)
+    result = baton->source_size;
+
+  return result;
+}
+
+/* Read LEN bytes from the source stream in BATON, starting at OFFSET,
+ * into DATA.
+ */
+static svn_error_t *
+read_source_view(cdc_baton_t *baton,
+                 char *data,
+                 svn_filesize_t offset,
+                 apr_size_t len)
+{
+  apr_size_t read_len = len;
+
+  /* Overlapping views require going back a bit. */
+  if (offset < baton->source_pos)
+    {
+      SVN_ERR(svn_stream_seek(baton->source, baton->source_start));
+      baton->source_pos = 0;
+    }
+
+  while (baton->source_pos < offset)
+    {
+      svn_filesize_t to_skip = offset - baton->source_pos;
+      apr_size_t chunk = to_skip > APR_INT32_MAX
+                       ? APR_INT32_MAX
+                       : (apr_size_t)to_skip;
+
+      SVN_ERR(svn_stream_skip(baton->source, chunk));
+      baton->source_pos += chunk;
+    }
+
+  SVN_ERR(svn_stream_read_full(baton->source, data, &read_len));
+  baton->source_pos += read_len;
+
+  if (read_len != len)
+    return svn_error_create(SVN_ERR_STREAM_UNEXPECTED_EOF, NULL,
+                            _("Delta source changed while being read"));
+
+  return SVN_NO_ERROR;
+}
+
+/* Implements svn_txdelta_next_window_fn_t. */
+static svn_error_t *
+cdc_next_window(svn_txdelta_window_t **window,
+                void *baton,
+                apr_pool_t *pool)
+{
+  cdc_baton_t *b = baton;
+  char *target = b->buf + SVN_DELTA_WINDOW_SIZE;
+  apr_size_t target_len = SVN_DELTA_WINDOW_SIZE;
+  svn_filesize_t source_offset;
+  apr_size_t source_len;
+
+  SVN_ERR(svn_stream_read_full(b->target, target, &target_len));
+  if (target_len == 0)
+    {
+      /* No target data?  We're done; return the final window. */
+      if (b->context != NULL)
+        SVN_ERR(svn_checksum_final(&b->checksum, b->context, b->pool));
+
+      *window = NULL;
+      b->more = FALSE;
+      return SVN_NO_ERROR;
+    }
+  else if (b->context != NULL)
+    SVN_ERR(svn_checksum_update(b->context, target, target_len));
+
+  if (b->source_start == NULL)
+    SVN_ERR(build_index(b, pool));
+
+  source_offset = select_source_view(b, target, target_len, pool);
+  source_len = b->source_size - source_offset > SVN_DELTA_WINDOW_SIZE
+             ? SVN_DELTA_WINDOW_SIZE
+             : (apr_size_t)(b->source_size - source_offset);
+
+  SVN_ERR(read_source_view(b, target - source_len, source_offset,
+                           source_len));
+
+  *window = svn_txdelta__compute_window(target - source_len, source_len,
+                                        target_len, source_offset, pool);
+
+  b->sview_offset = source_offset;
+  b->target_pos += target_len;
+
+  return SVN_NO_ERROR;
+}
+
+/* Implements svn_txdelta_md5_digest_fn_t. */
+static const unsigned char *
+cdc_md5_digest(void *baton)
+{
+  cdc_baton_t *b = baton;
+
+  /* If there are more windows for this stream, the digest has not yet
+     been calculated.  */
+  if (b->more || b->context == NULL)
+    return NULL;
+
+  return b->checksum->digest;
+}
+
+void
+svn_txdelta__cdc(svn_txdelta_stream_t **stream,
+                 svn_stream_t *source,
+                 svn_stream_t *target,
+                 svn_boolean_t calculate_checksum,
+                 apr_pool_t *pool)
+{
+  cdc_baton_t *b;
+
+  /* We need to read SOURCE twice. */
+  if (!svn_stream_supports_mark(source))
+    {
+      svn_txdelta2(stream, source, target, calculate_checksum, pool);
+      return;
+    }
+
+  b = apr_pcalloc(pool, sizeof(*b));
+  b->source = source;
+  b->target = target;
+  b->more = TRUE;
+  b->buf = apr_palloc(pool, 2 * SVN_DELTA_WINDOW_SIZE);
+  b->context = calculate_checksum
+             ? svn_checksum_ctx_create(svn_checksum_md5, pool)
+             : NULL;
+  b->pool = pool;
+  init_gear_table(b->gear_table);
+
+  *stream = svn_txdelta_stream_create(b, cdc_next_window, cdc_md5_digest,
+                                      pool);
+}
@@ -23,108 +23,23 @@
 
 
 #include <assert.h>
+#include <string.h>
 
-#include <apr_general.h>        /* For APR_INLINE */
+#include <apr_tables.h>
 
 #include "svn_delta.h"
 #include "svn_pools.h"
 #include "delta.h"
 
-/* Define a MIN macro if this platform doesn't already have one. */
+#include "private/svn_delta_private.h"
+
+/* Define MIN and MAX macros if this platform doesn't already have them. */
 #ifndef MIN
 #define MIN(a, b) ((a) < (b) ? (a) : (b))
 #endif
-
-
-/* ==================================================================== */
-/* Support for efficient small-block allocation from pools. */
-
-/* The following structs will be allocated and freed often: */
-
-/* A node in the range index tree. */
-typedef struct range_index_node_t range_index_node_t;
-struct range_index_node_t
-{
-  /* 'offset' and 'limit' define the range in the source window. */
-  apr_size_t offset;
-  apr_size_t limit;
-
-  /* 'target_offset' is where that range is represented in the target. */
-  apr_size_t target_offset;
-
-  /* 'left' and 'right' link the node into a splay tree. */
-  range_index_node_t *left, *right;
-
-  /* 'prev' and 'next' link it into an ordered, doubly-linked list. */
-  range_index_node_t *prev, *next;
-};
-
-/* A node in a list of ranges for source and target op copies. */
-enum range_kind
-  {
-    range_from_source,
-    range_from_target
-  };
-
-typedef struct range_list_node_t range_list_node_t;
-struct range_list_node_t
-{
-  /* Where does the range come from?
-     'offset' and 'limit' always refer to the "virtual" source data
-     for the second delta window. For a target range, the actual
-     offset to use for generating the target op is 'target_offset';
-     that field isn't used by source ranges. */
-  enum range_kind kind;
-
-  /* 'offset' and 'limit' define the range. */
-  apr_size_t offset;
-  apr_size_t limit;
-
-  /* 'target_offset' is the start of the range in the target. */
-  apr_size_t target_offset;
-
-  /* 'prev' and 'next' link the node into an ordered, doubly-linked list. */
-  range_list_node_t *prev, *next;
-};
-
-
-/* This is what will be allocated: */
-typedef union alloc_block_t alloc_block_t;
-union alloc_block_t
-{
-  range_index_node_t index_node;
-  range_list_node_t list_node;
-
-  /* Links free blocks into a freelist. */
-  alloc_block_t *next_free;
-};
-
-
-/* Allocate a block. */
-static APR_INLINE void *
-alloc_block(apr_pool_t *pool, alloc_block_t **free_list)
-{
-  alloc_block_t *block;
-  if (*free_list == NULL)
-    block = apr_palloc(pool, sizeof(*block));
-  else
-    {
-      block = *free_list;
-      *free_list = block->next_free;
-    }
-  return block;
-}
-
-/* Return the block back to the free list. */
-static APR_INLINE void
-free_block(void *ptr, alloc_block_t **free_list)
-{
-  /* Wrapper functions take care of type safety. */
-  alloc_block_t *const block = ptr;
-  block->next_free = *free_list;
-  *free_list = block;
-}
-
+#ifndef MAX
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+#endif
 
 
 /* ==================================================================== */
@@ -134,20 +49,29 @@ typedef struct offset_index_t
 {
   int length;
   apr_size_t *offs;
+
+  /* Number of elements allocated in OFFS. */
+  int capacity;
 } offset_index_t;
 
-/* Create an index mapping target stream offsets to delta ops in
-   WINDOW. Allocate from POOL. */
+/* Fill NDX with an index mapping target stream offsets to delta ops in
+   WINDOW.  Reuse the buffer in NDX if it is large enough; otherwise
+   allocate a new one from POOL. */
 
-static offset_index_t *
-create_offset_index(const svn_txdelta_window_t *window, apr_pool_t *pool)
+static void
+fill_offset_index(offset_index_t *ndx,
+                  const svn_txdelta_window_t *window,
+                  apr_pool_t *pool)
 {
-  offset_index_t *ndx = apr_palloc(pool, sizeof(*ndx));
   apr_size_t offset = 0;
   int i;
 
   ndx->length = window->num_ops;
-  ndx->offs = apr_palloc(pool, (ndx->length + 1) * sizeof(*ndx->offs));
+  if (ndx->capacity < ndx->length + 1)
+    {
+      ndx->capacity = MAX(ndx->length + 1, 2 * ndx->capacity);
+      ndx->offs = apr_palloc(pool, ndx->capacity * sizeof(*ndx->offs));
+    }
 
   for (i = 0; i < ndx->length; ++i)
     {
@@ -155,8 +79,6 @@ create_offset_index(const svn_txdelta_window_t *window, apr_pool_t *pool)
       offset += window->ops[i].length;
     }
   ndx->offs[ndx->length] = offset;
-
-  return ndx;
 }
 
 /* Find the index of the delta op thet defines that data at OFFSET in
@@ -212,166 +134,120 @@ search_offset_index(const offset_index_t *ndx,
 /* ==================================================================== */
 /* Mapping ranges in the source stream to ranges in the composed delta. */
 
-/* The range index tree. */
+/* A range [OFFSET, LIMIT) in the source of the second window that has
+   already been written to the composed target at TARGET_OFFSET. */
+typedef struct range_index_entry_t
+{
+  apr_size_t offset;
+  apr_size_t limit;
+  apr_size_t target_offset;
+} range_index_entry_t;
+
+/* The range index.  RANGES is a flat array of range_index_entry_t,
+   sorted by OFFSET.  Superseded ranges get removed upon insertion, so
+   the LIMITs are sorted as well in all but corner cases.  CURSOR is the
+   position found by the last seek_range_index() call. */
 typedef struct range_index_t
 {
-  range_index_node_t *tree;
-  alloc_block_t *free_list;
-  apr_pool_t *pool;
+  apr_array_header_t *ranges;
+  int cursor;
 } range_index_t;
 
-/* Create a range index tree. Allocate from POOL. */
-static range_index_t *
-create_range_index(apr_pool_t *pool)
-{
-  range_index_t *ndx = apr_palloc(pool, sizeof(*ndx));
-  ndx->tree = NULL;
-  ndx->pool = pool;
-  ndx->free_list = NULL;
-  return ndx;
-}
+/* Shorthand for the I-th entry in NDX. */
+#define RANGE(ndx, i) APR_ARRAY_IDX((ndx)->ranges, i, range_index_entry_t)
 
-/* Allocate a node for the range index tree. */
-static range_index_node_t *
-alloc_range_index_node(range_index_t *ndx,
-                       apr_size_t offset,
-                       apr_size_t limit,
-                       apr_size_t target_offset)
+/* Initialize the range index NDX.  Allocate from POOL. */
+static void
+init_range_index(range_index_t *ndx, apr_pool_t *pool)
 {
-  range_index_node_t *const node = alloc_block(ndx->pool, &ndx->free_list);
-  node->offset = offset;
-  node->limit = limit;
-  node->target_offset = target_offset;
-  node->left = node->right = NULL;
-  node->prev = node->next = NULL;
-  return node;
+  ndx->ranges = apr_array_make(pool, 16, sizeof(range_index_entry_t));
+  ndx->cursor = 0;
 }
 
-/* Free a node from the range index tree. */
+/* Remove all ranges from NDX. */
 static void
-free_range_index_node(range_index_t *ndx, range_index_node_t *node)
+clear_range_index(range_index_t *ndx)
 {
-  if (node->next)
-    node->next->prev = node->prev;
-  if (node->prev)
-    node->prev->next = node->next;
-  free_block(node, &ndx->free_list);
+  apr_array_clear(ndx->ranges);
+  ndx->cursor = 0;
 }
 
 
-/* Splay the index tree, using OFFSET as the key. */
+/* Set the cursor of NDX to the range with the largest offset that is
+   not larger than OFFSET.  If there is no such range, set it to the
+   first one. */
 
 static void
-splay_range_index(apr_size_t offset, range_index_t *ndx)
+seek_range_index(apr_size_t offset, range_index_t *ndx)
 {
-  range_index_node_t *tree = ndx->tree;
-  range_index_node_t scratch_node;
-  range_index_node_t *left, *right;
-
-  if (tree == NULL)
-    return;
+  int lo, hi;
 
-  scratch_node.left = scratch_node.right = NULL;
-  left = right = &scratch_node;
-
-  for (;;)
+  /* Most source copies in a window address increasing offsets, so the
+     last position or the one right after it are good guesses. */
+  if (ndx->cursor < ndx->ranges->nelts
+      && RANGE(ndx, ndx->cursor).offset <= offset)
     {
-      if (offset < tree->offset)
-        {
-          if (tree->left != NULL
-              && offset < tree->left->offset)
-            {
-              /* Right rotation */
-              range_index_node_t *const node = tree->left;
-              tree->left = node->right;
-              node->right = tree;
-              tree = node;
-            }
-          if (tree->left == NULL)
-            break;
+      if (ndx->cursor + 1 == ndx->ranges->nelts
+          || RANGE(ndx, ndx->cursor + 1).offset > offset)
+        return;
 
-          /* Remember the right subtree */
-          right->left = tree;
-          right = tree;
-          tree = tree->left;
-        }
-      else if (offset > tree->offset)
+      if (ndx->cursor + 2 == ndx->ranges->nelts
+          || RANGE(ndx, ndx->cursor + 2).offset > offset)
         {
-          if (tree->right != NULL
-              && offset > tree->right->offset)
-            {
-              /* Left rotation */
-              range_index_node_t *const node = tree->right;
-              tree->right = node->left;
-              node->left = tree;
-              tree = node;
-            }
-          if (tree->right == NULL)
-            break;
-
-          /* Remember the left subtree */
-          left->right = tree;
-          left = tree;
-          tree = tree->right;
+          ++ndx->cursor;
+          return;
         }
-      else
-        break;
+
+      lo = ndx->cursor + 2;
+    }
+  else
+    {
+      lo = 0;
     }
 
-  /* Link in the left and right subtrees */
-  left->right = tree->left;
-  right->left = tree->right;
-  tree->left  = scratch_node.right;
-  tree->right = scratch_node.left;
-
-  /* The basic top-down splay is finished, but we may still need to
-     turn the tree around. What we want is to put the node with the
-     largest offset where node->offset <= offset at the top of the
-     tree, so that we can insert the new data (or search for existing
-     ranges) to the right of the root. This makes cleaning up the
-     tree after an insert much simpler, and -- incidentally -- makes
-     the whole range index magic work. */
-  if (offset < tree->offset && tree->left != NULL)
+  /* Binary search for the first range starting beyond OFFSET. */
+  hi = ndx->ranges->nelts;
+  while (lo < hi)
     {
-      if (tree->left->right == NULL)
-        {
-          /* A single right rotation is enough. */
-          range_index_node_t *const node = tree->left;
-          tree->left = node->right; /* Which is always NULL. */
-          node->right = tree;
-          tree = node;
-        }
+      const int mid = lo + (hi - lo) / 2;
+      if (RANGE(ndx, mid).offset <= offset)
+        lo = mid + 1;
       else
-        {
-          /* Slide down to the rightmost node in the left subtree. */
-          range_index_node_t **nodep = &tree->left;
-          while ((*nodep)->right != NULL)
-            nodep = &(*nodep)->right;
-
-          /* Now move this node to root in one giant promotion. */
-          right = tree;
-          left = tree->left;
-          tree = *nodep;
-          *nodep = tree->left;
-          right->left = tree->right; /* Which is always NULL, too. */
-          tree->left = left;
-          tree->right = right;
-        }
+        hi = mid;
     }
 
-  /* Sanity check ... */
-  assert((offset >= tree->offset)
-         || ((tree->left == NULL)
-             && (tree->prev == NULL)));
-  ndx->tree = tree;
+  ndx->cursor = lo > 0 ? lo - 1 : 0;
 }
 
 
-/* Remove all ranges from NDX that fall into the root's range.  To
-   keep the range index as small as possible, we must also remove
-   nodes that don't fall into the new range, but have become redundant
-   because the new range overlaps the beginning of the next range.
-   Like this:
+/* Insert the range [OFFSET, LIMIT) at position POS into NDX. */
+
+static void
+insert_range_entry(range_index_t *ndx,
+                   int pos,
+                   apr_size_t offset,
+                   apr_size_t limit,
+                   apr_size_t target_offset)
+{
+  range_index_entry_t *entry;
+
+  /* Make room at the end and shift the tail. */
+  apr_array_push(ndx->ranges);
+  entry = &RANGE(ndx, pos);
+  memmove(entry + 1, entry,
+          (ndx->ranges->nelts - 1 - pos) * sizeof(*entry));
+
+  entry->offset = offset;
+  entry->limit = limit;
+  entry->target_offset = target_offset;
+}
+
+
+/* Remove all ranges from NDX that follow the range at POS and fall into
+   [OFFSET, LIMIT) of that range.  To keep the range index as small as
+   possible, we must also remove ranges that don't fall into the new
+   range, but have become redundant because the new range overlaps the
+   beginning of the next range.  Like this:
 
        new-range: |-----------------|
          range-1:         |-----------------|
@@ -381,47 +257,39 @@ splay_range_index(apr_size_t offset, range_index_t *ndx)
    necessary. Now the union of new-range and range-2 completely covers
    range-1, which has become redundant now.
 
+   Since the offsets are sorted, the redundant ranges always form a
+   contiguous sequence right after POS.
+
    FIXME: But, of course, there's a catch. range-1 must still remain
-   in the tree if we want to optimize the number of target copy ops in
+   in the index if we want to optimize the number of target copy ops in
    the case were a copy falls within range-1, but starts before
    range-2 and ends after new-range. */
 
 static void
-delete_subtree(range_index_t *ndx, range_index_node_t *node)
+clean_range_index(range_index_t *ndx, int pos, apr_size_t limit)
 {
-  if (node != NULL)
+  const int first = pos + 1;
+  int end = first;
+
+  while (end < ndx->ranges->nelts)
     {
-      delete_subtree(ndx, node->left);
-      delete_subtree(ndx, node->right);
-      free_range_index_node(ndx, node);
+      const range_index_entry_t *const entry = &RANGE(ndx, end);
+      const apr_size_t next_offset = (end + 1 < ndx->ranges->nelts
+                                      ? RANGE(ndx, end + 1).offset
+                                      : limit + 1);
+
+      if (entry->limit <= limit
+          || (entry->offset < limit && next_offset < limit))
+        ++end;
+      else
+        break;
     }
-}
 
-static void
-clean_tree(range_index_t *ndx, apr_size_t limit)
-{
-  apr_size_t top_offset = limit + 1;
-  range_index_node_t **nodep = &ndx->tree->right;
-  while (*nodep != NULL)
+  if (end > first)
     {
-      range_index_node_t *const node = *nodep;
-      apr_size_t const offset =
-        (node->right != NULL && node->right->offset < top_offset
-         ? node->right->offset
-         : top_offset);
-
-      if (node->limit <= limit
-          || (node->offset < limit && offset < limit))
-        {
-          *nodep = node->right;
-          node->right = NULL;
-          delete_subtree(ndx, node);
-        }
-      else
-        {
-          top_offset = node->offset;
-          nodep = &node->left;
-        }
+      memmove(&RANGE(ndx, first), &RANGE(ndx, end),
+              (ndx->ranges->nelts - end) * sizeof(range_index_entry_t));
+      ndx->ranges->nelts -= end - first;
     }
 }
 
@@ -429,165 +297,151 @@ clean_tree(range_index_t *ndx, apr_size_t limit)
 /* Add a range [OFFSET, LIMIT) into NDX. If NDX already contains a
    range that encloses [OFFSET, LIMIT), do nothing. Otherwise, remove
    all ranges from NDX that are superseded by the new range.
-   NOTE: The range index must be splayed to OFFSET! */
+   NOTE: The range index must have been seeked to OFFSET! */
 
 static void
 insert_range(apr_size_t offset, apr_size_t limit, apr_size_t target_offset,
              range_index_t *ndx)
 {
-  range_index_node_t *node = NULL;
+  range_index_entry_t *current;
+  int pos = ndx->cursor;
 
-  if (ndx->tree == NULL)
+  if (ndx->ranges->nelts == 0)
     {
-      node = alloc_range_index_node(ndx, offset, limit, target_offset);
-      ndx->tree = node;
+      insert_range_entry(ndx, 0, offset, limit, target_offset);
+      return;
     }
-  else
+
+  current = &RANGE(ndx, pos);
+  if (offset == current->offset
+      && limit > current->limit)
+    {
+      current->limit = limit;
+      current->target_offset = target_offset;
+    }
+  else if (offset > current->offset
+           && limit > current->limit)
     {
-      if (offset == ndx->tree->offset
-          && limit > ndx->tree->limit)
+      /* Ignore the new range if the current one and its successor
+         already cover it. */
+      if (pos + 1 < ndx->ranges->nelts
+          && current->limit >= current[1].offset
+          && limit <= current[1].limit)
+        return;
+
+      /* Again, we have to check if the new range and the one to the
+         left of the current range override the current one. */
+      if (pos > 0 && current[-1].limit > offset)
         {
-          ndx->tree->limit = limit;
-          ndx->tree->target_offset = target_offset;
-          clean_tree(ndx, limit);
+          /* Replace the data in the current range. */
+          current->offset = offset;
+          current->limit = limit;
+          current->target_offset = target_offset;
         }
-      else if (offset > ndx->tree->offset
-               && limit > ndx->tree->limit)
-        {
-          /* We have to make the same sort of checks as clean_tree()
-             does for superseded ranges. Have to merge these someday. */
-
-          const svn_boolean_t insert_range_p =
-            (!ndx->tree->next
-             || ndx->tree->limit < ndx->tree->next->offset
-             || limit > ndx->tree->next->limit);
-
-          if (insert_range_p)
-            {
-              /* Again, we have to check if the new node and the one
-                 to the left of the root override root's range. */
-              if (ndx->tree->prev && ndx->tree->prev->limit > offset)
-                {
-                  /* Replace the data in the splayed node. */
-                  ndx->tree->offset = offset;
-                  ndx->tree->limit = limit;
-                  ndx->tree->target_offset = target_offset;
-                }
-              else
-                {
-                  /* Insert the range to the right of the splayed node. */
-                  node = alloc_range_index_node(ndx, offset, limit,
-                                                target_offset);
-                  if ((node->next = ndx->tree->next) != NULL)
-                    node->next->prev = node;
-                  ndx->tree->next = node;
-                  node->prev = ndx->tree;
-
-                  node->right = ndx->tree->right;
-                  ndx->tree->right = NULL;
-                  node->left = ndx->tree;
-                  ndx->tree = node;
-                }
-              clean_tree(ndx, limit);
-            }
-          else
-            /* Ignore the range */;
-        }
-      else if (offset < ndx->tree->offset)
+      else
         {
-          assert(ndx->tree->left == NULL);
-
-          /* Insert the range left of the splayed node */
-          node = alloc_range_index_node(ndx, offset, limit, target_offset);
-          node->left = node->prev = NULL;
-          node->right = node->next = ndx->tree;
-          ndx->tree = node->next->prev = node;
-          clean_tree(ndx, limit);
+          /* Insert the range to the right of the current one. */
+          insert_range_entry(ndx, ++pos, offset, limit, target_offset);
         }
-      else
-        /* Ignore the range */;
     }
+  else if (offset < current->offset)
+    {
+      /* Only the first range may start behind OFFSET. */
+      assert(pos == 0);
+
+      insert_range_entry(ndx, pos, offset, limit, target_offset);
+    }
+  else
+    {
+      /* Ignore the range */
+      return;
+    }
+
+  ndx->cursor = pos;
+  clean_range_index(ndx, pos, limit);
 }
 
 
-
+
 /* ==================================================================== */
 /* Juggling with lists of ranges. */
 
-/* Allocate a node and add it to the range list. LIST is the head of
-   the range list, TAIL is the last node in the list. NDX holds the
-   freelist; OFFSET, LIMIT and KIND are node data. */
-static range_list_node_t *
-alloc_range_list(range_list_node_t **list,
-                 range_list_node_t **tail,
-                 range_index_t *ndx,
-                 enum range_kind kind,
-                 apr_size_t offset,
-                 apr_size_t limit,
-                 apr_size_t target_offset)
+/* An entry in a list of ranges for source and target op copies. */
+enum range_kind
+  {
+    range_from_source,
+    range_from_target
+  };
+
+typedef struct range_list_entry_t
 {
-  range_list_node_t *const node = alloc_block(ndx->pool, &ndx->free_list);
-  node->kind = kind;
-  node->offset = offset;
-  node->limit = limit;
-  node->target_offset = target_offset;
-  if (*list == NULL)
-    {
-      node->prev = node->next = NULL;
-      *list = *tail = node;
-    }
-  else
-    {
-      node->prev = *tail;
-      node->next = NULL;
-      (*tail)->next = node;
-      *tail = node;
-    }
-  return *list;
-}
+  /* Where does the range come from?
+     'offset' and 'limit' always refer to the "virtual" source data
+     for the second delta window. For a target range, the actual
+     offset to use for generating the target op is 'target_offset';
+     that field isn't used by source ranges. */
+  enum range_kind kind;
+
+  /* 'offset' and 'limit' define the range. */
+  apr_size_t offset;
+  apr_size_t limit;
+
+  /* 'target_offset' is the start of the range in the target. */
+  apr_size_t target_offset;
+} range_list_entry_t;
 
-/* Free a range list. LIST is the head of the list, NDX holds the freelist. */
+/* Append a range to the range list LIST, an array of range_list_entry_t.
+   OFFSET, LIMIT, KIND and TARGET_OFFSET are the entry's data. */
 static void
-free_range_list(range_list_node_t *list, range_index_t *ndx)
+append_range(apr_array_header_t *list,
+             enum range_kind kind,
+             apr_size_t offset,
+             apr_size_t limit,
+             apr_size_t target_offset)
 {
-  while (list)
-    {
-      range_list_node_t *const node = list;
-      list = node->next;
-      free_block(node, &ndx->free_list);
-    }
+  range_list_entry_t *const entry = apr_array_push(list);
+  entry->kind = kind;
+  entry->offset = offset;
+  entry->limit = limit;
+  entry->target_offset = target_offset;
 }
 
 
-/* Based on the data in NDX, build a list of ranges that cover
-   [OFFSET, LIMIT) in the "virtual" source data.
-   NOTE: The range index must be splayed to OFFSET! */
+/* Based on the data in NDX, fill the array LIST with range_list_entry_t
+   that cover [OFFSET, LIMIT) in the "virtual" source data.
+   NOTE: The range index must have been seeked to OFFSET! */
 
-static range_list_node_t *
-build_range_list(apr_size_t offset, apr_size_t limit, range_index_t *ndx)
+static void
+build_range_list(apr_array_header_t *list,
+                 apr_size_t offset,
+                 apr_size_t limit,
+                 const range_index_t *ndx)
 {
-  range_list_node_t *range_list = NULL;
-  range_list_node_t *last_range = NULL;
-  range_index_node_t *node = ndx->tree;
+  int i = ndx->cursor;
 
+  apr_array_clear(list);
   while (offset < limit)
     {
-      if (node == NULL)
-        return alloc_range_list(&range_list, &last_range, ndx,
-                                range_from_source,
-                                offset, limit, 0);
+      const range_index_entry_t *node;
+
+      if (i >= ndx->ranges->nelts)
+        {
+          append_range(list, range_from_source, offset, limit, 0);
+          return;
+        }
 
+      node = &RANGE(ndx, i);
       if (offset < node->offset)
         {
           if (limit <= node->offset)
-            return alloc_range_list(&range_list, &last_range, ndx,
-                                    range_from_source,
-                                    offset, limit, 0);
+            {
+              append_range(list, range_from_source, offset, limit, 0);
+              return;
+            }
           else
             {
-              alloc_range_list(&range_list, &last_range, ndx,
-                               range_from_source,
-                               offset, node->offset, 0);
+              append_range(list, range_from_source,
+                           offset, node->offset, 0);
               offset = node->offset;
             }
         }
@@ -600,23 +454,24 @@ build_range_list(apr_size_t offset, apr_size_t limit, range_index_t *ndx)
              uses vdelta). */
 
           if (offset >= node->limit)
-            node = node->next;
+            ++i;
           else
             {
               const apr_size_t target_offset =
                 offset - node->offset + node->target_offset;
 
               if (limit <= node->limit)
-                return alloc_range_list(&range_list, &last_range, ndx,
-                                        range_from_target,
-                                        offset, limit, target_offset);
+                {
+                  append_range(list, range_from_target,
+                               offset, limit, target_offset);
+                  return;
+                }
               else
                 {
-                  alloc_range_list(&range_list, &last_range, ndx,
-                                   range_from_target,
-                                   offset, node->limit, target_offset);
+                  append_range(list, range_from_target,
+                               offset, node->limit, target_offset);
                   offset = node->limit;
-                  node = node->next;
+                  ++i;
                 }
             }
         }
@@ -759,20 +614,52 @@ copy_source_ops(apr_size_t offset, apr_size_t limit,
 /* ==================================================================== */
 /* Bringing it all together. */
 
+/* The combiner's working data.  It can be reused for any number of
+   compositions, which saves us rebuilding the indexes from scratch. */
+typedef struct compose_baton_t
+{
+  /* Maps target offsets in the first window to its ops. */
+  offset_index_t offset_index;
 
-svn_txdelta_window_t *
-svn_txdelta_compose_windows(const svn_txdelta_window_t *window_A,
-                            const svn_txdelta_window_t *window_B,
-                            apr_pool_t *pool)
+  /* Ranges of the first window's target already written to the
+     composite. */
+  range_index_t range_index;
+
+  /* Scratch array of range_list_entry_t. */
+  apr_array_header_t *range_list;
+
+  /* Pool for the above. */
+  apr_pool_t *pool;
+} compose_baton_t;
+
+/* Initialize CB.  Allocate from POOL. */
+static void
+init_compose_baton(compose_baton_t *cb, apr_pool_t *pool)
+{
+  cb->offset_index.length = 0;
+  cb->offset_index.offs = NULL;
+  cb->offset_index.capacity = 0;
+  init_range_index(&cb->range_index, pool);
+  cb->range_list = apr_array_make(pool, 16, sizeof(range_list_entry_t));
+  cb->pool = pool;
+}
+
+/* Implement svn_txdelta_compose_windows() using the working data in CB. */
+static svn_txdelta_window_t *
+compose_windows(compose_baton_t *cb,
+                const svn_txdelta_window_t *window_A,
+                const svn_txdelta_window_t *window_B,
+                apr_pool_t *pool)
 {
   svn_txdelta__ops_baton_t build_baton = { 0 };
   svn_txdelta_window_t *composite;
-  apr_pool_t *subpool = svn_pool_create(pool);
-  offset_index_t *offset_index = create_offset_index(window_A, subpool);
-  range_index_t *range_index = create_range_index(subpool);
+  range_index_t *range_index = &cb->range_index;
   apr_size_t target_offset = 0;
   int i;
 
+  fill_offset_index(&cb->offset_index, window_A, cb->pool);
+  clear_range_index(range_index);
+
   /* Read the description of the delta composition algorithm in
      notes/fs-improvements.txt before going any further.
      You have been warned. */
@@ -799,14 +686,17 @@ svn_txdelta_compose_windows(const svn_txdelta_window_t *window_A,
              same as window_A's _target_ stream! */
           const apr_size_t offset = op->offset;
           const apr_size_t limit = op->offset + op->length;
-          range_list_node_t *range_list, *range;
           apr_size_t tgt_off = target_offset;
+          int k;
 
-          splay_range_index(offset, range_index);
-          range_list = build_range_list(offset, limit, range_index);
+          seek_range_index(offset, range_index);
+          build_range_list(cb->range_list, offset, limit, range_index);
 
-          for (range = range_list; range; range = range->next)
+          for (k = 0; k < cb->range_list->nelts; ++k)
             {
+              const range_list_entry_t *const range
+                = &APR_ARRAY_IDX(cb->range_list, k, range_list_entry_t);
+
               if (range->kind == range_from_target)
                 svn_txdelta__insert_op(&build_baton, svn_txdelta_target,
                                        range->target_offset,
@@ -814,14 +704,13 @@ svn_txdelta_compose_windows(const svn_txdelta_window_t *window_A,
                                        NULL, pool);
               else
                 copy_source_ops(range->offset, range->limit, tgt_off, 0,
-                                &build_baton, window_A, offset_index,
+                                &build_baton, window_A, &cb->offset_index,
                                 pool);
 
               tgt_off += range->limit - range->offset;
             }
           assert(tgt_off == target_offset + op->length);
 
-          free_range_list(range_list, range_index);
           insert_range(offset, limit, target_offset, range_index);
         }
 
@@ -829,11 +718,95 @@ svn_txdelta_compose_windows(const svn_txdelta_window_t *window_A,
       target_offset += op->length;
     }
 
-  svn_pool_destroy(subpool);
-
   composite = svn_txdelta__make_window(&build_baton, pool);
   composite->sview_offset = window_A->sview_offset;
   composite->sview_len = window_A->sview_len;
   composite->tview_len = window_B->tview_len;
   return composite;
 }
+
+
+svn_txdelta_window_t *
+svn_txdelta_compose_windows(const svn_txdelta_window_t *window_A,
+                            const svn_txdelta_window_t *window_B,
+                            apr_pool_t *pool)
+{
+  compose_baton_t cb;
+  svn_txdelta_window_t *composite;
+  apr_pool_t *subpool = svn_pool_create(pool);
+
+  init_compose_baton(&cb, subpool);
+  composite = compose_windows(&cb, window_A, window_B, pool);
+  svn_pool_destroy(subpool);
+
+  return composite;
+}
+
+svn_txdelta_window_t *
+svn_txdelta__compose_window_chain(const apr_array_header_t *windows,
+                                  apr_pool_t *result_pool,
+                                  apr_pool_t *scratch_pool)
+{
+  compose_baton_t cb;
+  const svn_txdelta_window_t *first_window;
+  svn_txdelta_window_t *composite;
+  apr_pool_t *pools[2];
+  int first, i;
+
+  SVN_ERR_ASSERT_NO_RETURN(windows->nelts > 0);
+
+  /* Windows that precede a window without source copies don't
+     contribute anything to the result. */
+  for (first = windows->nelts - 1; first > 0; --first)
+    if (APR_ARRAY_IDX(windows, first, const svn_txdelta_window_t *)->src_ops
+        == 0)
+      break;
+
+  /* The result applies to the source view of the first window that we
+     actually compose. */
+  first_window = APR_ARRAY_IDX(windows, first, const svn_txdelta_window_t *);
+
+  if (first == windows->nelts - 1)
+    {
+      composite = svn_txdelta_window_dup(
+                    APR_ARRAY_IDX(windows, first,
+                                  const svn_txdelta_window_t *),
+                    result_pool);
+    }
+  else
+    {
+      /* Intermediate composites live in alternating pools, so we can
+         always release the one before the current. */
+      init_compose_baton(&cb, scratch_pool);
+      pools[0] = svn_pool_create(scratch_pool);
+      pools[1] = svn_pool_create(scratch_pool);
+
+      composite = (svn_txdelta_window_t *)
+        APR_ARRAY_IDX(windows, first, const svn_txdelta_window_t *);
+      for (i = first + 1; i < windows->nelts; ++i)
+        {
+          const svn_txdelta_window_t *window
+            = APR_ARRAY_IDX(windows, i, const svn_txdelta_window_t *);
+          apr_pool_t *pool;
+
+          if (i == windows->nelts - 1)
+            {
+              pool = result_pool;
+            }
+          else
+            {
+              pool = pools[i % 2];
+              svn_pool_clear(pool);
+            }
+
+          composite = compose_windows(&cb, composite, window, pool);
+        }
+
+      svn_pool_destroy(pools[0]);
+      svn_pool_destroy(pools[1]);
+    }
+
+  composite->sview_offset = first_window->sview_offset;
+  composite->sview_len = first_window->sview_len;
+  return composite;
+}
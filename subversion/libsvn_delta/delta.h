@@ -81,6 +81,17 @@ svn_txdelta__make_window(const svn_txdelta__ops_baton_t *build_baton,
                          apr_pool_t *pool);
 
 
+/* Compute and return a delta window using the xdelta algorithm on
+   DATA, which contains SOURCE_LEN bytes of source data and TARGET_LEN
+   bytes of target data.  SOURCE_OFFSET gives the offset of the source
+   data, and is simply copied into the window's sview_offset field. */
+svn_txdelta_window_t *
+svn_txdelta__compute_window(const char *data,
+                            apr_size_t source_len,
+                            apr_size_t target_len,
+                            svn_filesize_t source_offset,
+                            apr_pool_t *pool);
+
 /* Create xdelta window data. Allocate temporary data from POOL. */
 void svn_txdelta__xdelta(svn_txdelta__ops_baton_t *build_baton,
                          const char *start,
@@ -88,6 +99,19 @@ void svn_txdelta__xdelta(svn_txdelta__ops_baton_t *build_baton,
                          apr_size_t target_len,
                          apr_pool_t *pool);
 
+/* Return the size of the blocks that svn_txdelta__xdelta() computes its
+   checksums for. */
+apr_size_t
+svn_txdelta__match_blocksize(void);
+
+/* Return the checksum that svn_txdelta__xdelta() uses for the block of
+   svn_txdelta__match_blocksize() bytes starting at DATA.  If SCALAR is
+   set, use the portable implementation even where a vectorized one is
+   available.  This is meant for testing the latter against the former. */
+apr_uint32_t
+svn_txdelta__adler32_block(const char *data,
+                           svn_boolean_t scalar);
+
 
 #ifdef __cplusplus
 }
@@ -35,17 +35,21 @@
 #include "private/svn_subr_private.h"
 #include "private/svn_string_private.h"
 #include "private/svn_dep_compat.h"
+#include "private/svn_task.h"
 
 static const char SVNDIFF_V0[] = { 'S', 'V', 'N', 0 };
 static const char SVNDIFF_V1[] = { 'S', 'V', 'N', 1 };
 static const char SVNDIFF_V2[] = { 'S', 'V', 'N', 2 };
+static const char SVNDIFF_V3[] = { 'S', 'V', 'N', 3 };
 
 #define SVNDIFF_HEADER_SIZE (sizeof(SVNDIFF_V0))
 
 static const char *
 get_svndiff_header(int version)
 {
-  if (version == 2)
+  if (version == 3)
+    return SVNDIFF_V3;
+  else if (version == 2)
     return SVNDIFF_V2;
   else if (version == 1)
     return SVNDIFF_V1;
@@ -198,7 +202,15 @@ encode_window(svn_stringbuf_t **instructions_p,
   append_encoded_int(header, window->sview_offset);
   append_encoded_int(header, window->sview_len);
   append_encoded_int(header, window->tview_len);
-  if (version == 2)
+  if (version == 3)
+    {
+      svn_stringbuf_t *compressed_instructions;
+      compressed_instructions = svn_stringbuf_create_empty(pool);
+      SVN_ERR(svn__compress_zstd(instructions->data, instructions->len,
+                                 compressed_instructions, compression_level));
+      instructions = compressed_instructions;
+    }
+  else if (version == 2)
     {
       svn_stringbuf_t *compressed_instructions;
       compressed_instructions = svn_stringbuf_create_empty(pool);
@@ -217,7 +229,15 @@ encode_window(svn_stringbuf_t **instructions_p,
   append_encoded_int(header, instructions->len);
 
   /* Encode the data. */
-  if (version == 2)
+  if (version == 3)
+    {
+      svn_stringbuf_t *compressed = svn_stringbuf_create_empty(pool);
+
+      SVN_ERR(svn__compress_zstd(window->new_data->data, window->new_data->len,
+                                 compressed, compression_level));
+      newdata = svn_stringbuf__morph_into_string(compressed);
+    }
+  else if (version == 2)
     {
       svn_stringbuf_t *compressed = svn_stringbuf_create_empty(pool);
 
@@ -245,13 +265,55 @@ encode_window(svn_stringbuf_t **instructions_p,
   return SVN_NO_ERROR;
 }
 
+/* Write the svndiff header to the output of EB unless that has already
+   been done. */
+static svn_error_t *
+write_header(struct encoder_baton *eb)
+{
+  apr_size_t len = SVNDIFF_HEADER_SIZE;
+
+  if (eb->header_done)
+    return SVN_NO_ERROR;
+
+  SVN_ERR(svn_stream_write(eb->output, get_svndiff_header(eb->version),
+                           &len));
+  eb->header_done = TRUE;
+
+  return SVN_NO_ERROR;
+}
+
+/* Write the window HEADER, INSTRUCTIONS and NEWDATA, as returned by
+   encode_window(), to the output of EB. */
+static svn_error_t *
+write_encoded_window(struct encoder_baton *eb,
+                     const svn_stringbuf_t *header,
+                     const svn_stringbuf_t *instructions,
+                     const svn_string_t *newdata)
+{
+  apr_size_t len;
+
+  len = header->len;
+  SVN_ERR(svn_stream_write(eb->output, header->data, &len));
+  if (instructions->len > 0)
+    {
+      len = instructions->len;
+      SVN_ERR(svn_stream_write(eb->output, instructions->data, &len));
+    }
+  if (newdata->len > 0)
+    {
+      len = newdata->len;
+      SVN_ERR(svn_stream_write(eb->output, newdata->data, &len));
+    }
+
+  return SVN_NO_ERROR;
+}
+
 /* Note: When changing things here, check the related comment in
    the svn_txdelta_to_svndiff_stream() function.  */
 static svn_error_t *
 window_handler(svn_txdelta_window_t *window, void *baton)
 {
   struct encoder_baton *eb = baton;
-  apr_size_t len;
   svn_stringbuf_t *instructions;
   svn_stringbuf_t *header;
   const svn_string_t *newdata;
@@ -261,13 +323,7 @@ window_handler(svn_txdelta_window_t *window, void *baton)
     return svn_error_trace(send_simple_insertion_window(window, eb));
 
   /* Make sure we write the header.  */
-  if (!eb->header_done)
-    {
-      len = SVNDIFF_HEADER_SIZE;
-      SVN_ERR(svn_stream_write(eb->output, get_svndiff_header(eb->version),
-                               &len));
-      eb->header_done = TRUE;
-    }
+  SVN_ERR(write_header(eb));
 
   if (window == NULL)
     {
@@ -286,20 +342,8 @@ window_handler(svn_txdelta_window_t *window, void *baton)
                         eb->scratch_pool));
 
   /* Write out the window.  */
-  len = header->len;
-  SVN_ERR(svn_stream_write(eb->output, header->data, &len));
-  if (instructions->len > 0)
-    {
-      len = instructions->len;
-      SVN_ERR(svn_stream_write(eb->output, instructions->data, &len));
-    }
-  if (newdata->len > 0)
-    {
-      len = newdata->len;
-      SVN_ERR(svn_stream_write(eb->output, newdata->data, &len));
-    }
-
-  return SVN_NO_ERROR;
+  return svn_error_trace(write_encoded_window(eb, header, instructions,
+                                              newdata));
 }
 
 void
@@ -345,6 +389,213 @@ svn_txdelta_to_svndiff(svn_stream_t *output,
 }
 
 
+
+/* ----- Concurrent text delta to svndiff ----- */
+
+/* For large files, compression often dominates the time spent in
+   svn_txdelta_to_svndiff3().  svn_txdelta__to_svndiff_parallel() therefore
+   collects a batch of windows, compresses them concurrently using the
+   svn_task__t framework and writes them in their original order.  The
+   output is the same as with svn_txdelta_to_svndiff3(). */
+
+/* Number of windows to collect per worker thread before compressing them.
+   Larger values keep the workers busier at the expense of memory: each
+   buffered window may take up to 2 * SVN_DELTA_WINDOW_SIZE bytes. */
+#define WINDOWS_PER_JOB 4
+
+/* Window handler baton used by svn_txdelta__to_svndiff_parallel(). */
+struct parallel_encoder_baton
+{
+  /* Output stream, svndiff version and compression settings. */
+  struct encoder_baton *eb;
+
+  /* Maximum number of worker threads. */
+  int jobs;
+
+  /* Windows received but not encoded yet, as svn_txdelta_window_t *.
+     The windows are allocated in BATCH_POOL. */
+  apr_array_header_t *windows;
+  apr_pool_t *batch_pool;
+};
+
+/* Process baton for encode_window_process(). */
+typedef struct encode_task_baton_t
+{
+  /* Encoding parameters.  Treat as read-only. */
+  const struct encoder_baton *eb;
+
+  /* The window to encode. */
+  svn_txdelta_window_t *window;
+} encode_task_baton_t;
+
+/* Result of encode_window_process(). */
+typedef struct encoded_window_t
+{
+  svn_stringbuf_t *header;
+  svn_stringbuf_t *instructions;
+  const svn_string_t *newdata;
+} encoded_window_t;
+
+/* Implements svn_task__process_func_t.
+   Encode the window given by the encode_task_baton_t in PROCESS_BATON and
+   return it as an encoded_window_t in *RESULT. */
+static svn_error_t *
+encode_window_process(void **result,
+                      svn_task__t *task,
+                      void *thread_context,
+                      void *process_baton,
+                      svn_cancel_func_t cancel_func,
+                      void *cancel_baton,
+                      apr_pool_t *result_pool,
+                      apr_pool_t *scratch_pool)
+{
+  encode_task_baton_t *baton = process_baton;
+  encoded_window_t *encoded = apr_palloc(result_pool, sizeof(*encoded));
+
+  SVN_ERR(encode_window(&encoded->instructions, &encoded->header,
+                        &encoded->newdata, baton->window,
+                        baton->eb->version, baton->eb->compression_level,
+                        result_pool));
+  *result = encoded;
+
+  return SVN_NO_ERROR;
+}
+
+/* Implements svn_task__output_func_t.
+   Write the encoded_window_t in RESULT to the output of the
+   encoder_baton in OUTPUT_BATON. */
+static svn_error_t *
+encode_window_output(svn_task__t *task,
+                     void *result,
+                     void *output_baton,
+                     svn_cancel_func_t cancel_func,
+                     void *cancel_baton,
+                     apr_pool_t *result_pool,
+                     apr_pool_t *scratch_pool)
+{
+  encoded_window_t *encoded = result;
+
+  return svn_error_trace(write_encoded_window(output_baton,
+                                              encoded->header,
+                                              encoded->instructions,
+                                              encoded->newdata));
+}
+
+/* Implements svn_task__process_func_t.
+   Add one encoding sub-task to TASK for each window buffered in the
+   parallel_encoder_baton in PROCESS_BATON.  There is no output. */
+static svn_error_t *
+encode_batch_process(void **result,
+                     svn_task__t *task,
+                     void *thread_context,
+                     void *process_baton,
+                     svn_cancel_func_t cancel_func,
+                     void *cancel_baton,
+                     apr_pool_t *result_pool,
+                     apr_pool_t *scratch_pool)
+{
+  struct parallel_encoder_baton *peb = process_baton;
+  int i;
+
+  for (i = 0; i < peb->windows->nelts; ++i)
+    {
+      apr_pool_t *sub_task_pool = svn_task__create_process_pool(task);
+      encode_task_baton_t *sub_task_baton
+        = apr_palloc(sub_task_pool, sizeof(*sub_task_baton));
+
+      sub_task_baton->eb = peb->eb;
+      sub_task_baton->window = APR_ARRAY_IDX(peb->windows, i,
+                                             svn_txdelta_window_t *);
+
+      SVN_ERR(svn_task__add(task, sub_task_pool, NULL,
+                            encode_window_process, sub_task_baton,
+                            encode_window_output, peb->eb));
+    }
+
+  *result = NULL;
+
+  return SVN_NO_ERROR;
+}
+
+/* Encode and write all windows buffered in PEB. */
+static svn_error_t *
+flush_windows(struct parallel_encoder_baton *peb)
+{
+  if (peb->windows->nelts == 0)
+    return SVN_NO_ERROR;
+
+  SVN_ERR(write_header(peb->eb));
+  SVN_ERR(svn_task__run(peb->jobs,
+                        encode_batch_process, peb,
+                        NULL, NULL,
+                        NULL, NULL,
+                        NULL, NULL,
+                        peb->batch_pool, peb->batch_pool));
+
+  apr_array_clear(peb->windows);
+  svn_pool_clear(peb->batch_pool);
+
+  return SVN_NO_ERROR;
+}
+
+/* Implements svn_txdelta_window_handler_t for
+   svn_txdelta__to_svndiff_parallel(). */
+static svn_error_t *
+parallel_window_handler(svn_txdelta_window_t *window, void *baton)
+{
+  struct parallel_encoder_baton *peb = baton;
+
+  if (window)
+    {
+      APR_ARRAY_PUSH(peb->windows, svn_txdelta_window_t *)
+        = svn_txdelta_window_dup(window, peb->batch_pool);
+
+      if (peb->windows->nelts < peb->jobs * WINDOWS_PER_JOB)
+        return SVN_NO_ERROR;
+    }
+
+  SVN_ERR(flush_windows(peb));
+
+  if (window == NULL)
+    {
+      svn_pool_destroy(peb->batch_pool);
+      return svn_error_trace(window_handler(NULL, peb->eb));
+    }
+
+  return SVN_NO_ERROR;
+}
+
+void
+svn_txdelta__to_svndiff_parallel(svn_txdelta_window_handler_t *handler,
+                                 void **handler_baton,
+                                 svn_stream_t *output,
+                                 int svndiff_version,
+                                 int compression_level,
+                                 int jobs,
+                                 apr_pool_t *pool)
+{
+  struct parallel_encoder_baton *peb;
+
+  svn_txdelta_to_svndiff3(handler, handler_baton, output, svndiff_version,
+                          compression_level, pool);
+
+  /* svndiff0 does not compress anything, so there is nothing worth
+     spreading across threads. */
+  if (jobs <= 1 || svndiff_version == 0)
+    return;
+
+  peb = apr_palloc(pool, sizeof(*peb));
+  peb->eb = *handler_baton;
+  peb->jobs = jobs;
+  peb->windows = apr_array_make(pool, jobs * WINDOWS_PER_JOB,
+                                sizeof(svn_txdelta_window_t *));
+  peb->batch_pool = svn_pool_create(pool);
+
+  *handler = parallel_window_handler;
+  *handler_baton = peb;
+}
+
+
 /* ----- svndiff to text delta ----- */
 
 /* An svndiff parser object.  */
@@ -565,7 +816,23 @@ decode_window(svn_txdelta_window_t *window, svn_filesize_t sview_offset,
 
   insend = data + inslen;
 
-  if (version == 2)
+  if (version == 3)
+    {
+      svn_stringbuf_t *instout = svn_stringbuf_create_empty(pool);
+      svn_stringbuf_t *ndout = svn_stringbuf_create_empty(pool);
+
+      SVN_ERR(svn__decompress_zstd(insend, newlen, ndout,
+                                   SVN_DELTA_WINDOW_SIZE));
+      SVN_ERR(svn__decompress_zstd(data, insend - data, instout,
+                                   MAX_INSTRUCTION_SECTION_LEN));
+
+      newlen = ndout->len;
+      data = (unsigned char *)instout->data;
+      insend = (unsigned char *)instout->data + instout->len;
+
+      new_data = svn_stringbuf__morph_into_string(ndout);
+    }
+  else if (version == 2)
     {
       svn_stringbuf_t *instout = svn_stringbuf_create_empty(pool);
       svn_stringbuf_t *ndout = svn_stringbuf_create_empty(pool);
@@ -653,6 +920,8 @@ write_handler(void *baton,
         db->version = 1;
       else if (memcmp(buffer, SVNDIFF_V2 + db->header_bytes, nheader) == 0)
         db->version = 2;
+      else if (memcmp(buffer, SVNDIFF_V3 + db->header_bytes, nheader) == 0)
+        db->version = 3;
       else
         return svn_error_create(SVN_ERR_SVNDIFF_INVALID_HEADER, NULL,
                                 _("Svndiff has invalid header"));
@@ -31,6 +31,10 @@
 #include "svn_delta.h"
 #include "private/svn_string_private.h"
 #include "delta.h"
+
+#if SVN__SSE2_IS_OK
+#include <emmintrin.h>
+#endif
 
 /* This is pseudo-adler32. It is adler32 without the prime modulus.
    The idea is borrowed from monotone, and is a translation of the C++
@@ -77,10 +81,10 @@ adler32_replace(apr_uint32_t adler32, const char c_out, const char c_in)
 }
 
 /* Calculate an pseudo-adler32 checksum for MATCH_BLOCKSIZE bytes starting
-   at DATA.  Return the checksum value.  */
-
+   at DATA.  Return the checksum value.  This is the portable reference
+   implementation of init_adler32(). */
 static APR_INLINE apr_uint32_t
-init_adler32(const char *data)
+init_adler32_scalar(const char *data)
 {
   const unsigned char *input = (const unsigned char *)data;
   const unsigned char *last = input + MATCH_BLOCKSIZE;
@@ -103,6 +107,61 @@ init_adler32(const char *data)
   return s2 * 0x10000 + s1;
 }
 
+#if SVN__SSE2_IS_OK && (MATCH_BLOCKSIZE % 16 == 0)
+
+/* SSE2 variant of init_adler32_scalar().  Since the sum of sums is simply the sum
+   of all bytes weighted with their distance from the end of the block, we
+   can calculate both sums 16 bytes at a time without any dependencies
+   between the iterations. */
+static APR_INLINE apr_uint32_t
+init_adler32(const char *data)
+{
+  const __m128i zero = _mm_setzero_si128();
+  __m128i s1 = zero;
+  __m128i s2 = zero;
+  int i;
+
+  for (i = 0; i < MATCH_BLOCKSIZE; i += 16)
+    {
+      __m128i chunk = _mm_loadu_si128((const __m128i *)(data + i));
+
+      /* Weights for the lower and upper 8 bytes of CHUNK, respectively.
+         Note that _mm_set_epi16 expects the highest element first. */
+      const __m128i weights_lo
+        = _mm_set_epi16(MATCH_BLOCKSIZE - i - 7, MATCH_BLOCKSIZE - i - 6,
+                        MATCH_BLOCKSIZE - i - 5, MATCH_BLOCKSIZE - i - 4,
+                        MATCH_BLOCKSIZE - i - 3, MATCH_BLOCKSIZE - i - 2,
+                        MATCH_BLOCKSIZE - i - 1, MATCH_BLOCKSIZE - i);
+      const __m128i weights_hi
+        = _mm_sub_epi16(weights_lo, _mm_set1_epi16(8));
+
+      /* Sum of bytes.  PSADBW yields two 64 bit partial sums. */
+      s1 = _mm_add_epi64(s1, _mm_sad_epu8(chunk, zero));
+
+      /* Weighted sum of bytes, using 16 bit lanes and 32 bit sums. */
+      s2 = _mm_add_epi32(s2,
+                         _mm_madd_epi16(_mm_unpacklo_epi8(chunk, zero),
+                                        weights_lo));
+      s2 = _mm_add_epi32(s2,
+                         _mm_madd_epi16(_mm_unpackhi_epi8(chunk, zero),
+                                        weights_hi));
+    }
+
+  /* Horizontal sums. */
+  s1 = _mm_add_epi64(s1, _mm_unpackhi_epi64(s1, s1));
+  s2 = _mm_add_epi32(s2, _mm_shuffle_epi32(s2, _MM_SHUFFLE(1, 0, 3, 2)));
+  s2 = _mm_add_epi32(s2, _mm_shuffle_epi32(s2, _MM_SHUFFLE(2, 3, 0, 1)));
+
+  return (apr_uint32_t)_mm_cvtsi128_si32(s2) * 0x10000
+       + (apr_uint32_t)_mm_cvtsi128_si32(s1);
+}
+
+#else
+
+#define init_adler32 init_adler32_scalar
+
+#endif
+
 /* Information for a block of the delta source.  The length of the
    block is the smaller of MATCH_BLOCKSIZE and the difference between
    the size of the source data and the position of this block. */
@@ -165,6 +224,14 @@ static apr_uint32_t hash_flags(apr_uint32_t sum)
   return (sum >> 16) & ((FLAGS_COUNT / 8) - 1);
 }
 
+/* Return TRUE if BLOCKS may contain a block with the checksum ADLERSUM.
+   FALSE means that there is definitely no such block. */
+static APR_INLINE svn_boolean_t
+may_match(const struct blocks *blocks, apr_uint32_t adlersum)
+{
+  return (blocks->flags[hash_flags(adlersum)] & (1 << (adlersum & 7))) != 0;
+}
+
 /* Insert a block with the checksum ADLERSUM at position POS in the source
    data into the table BLOCKS.  Ignore true duplicates, i.e. blocks with
    actually the same content. */
@@ -296,11 +363,16 @@ find_match(const struct blocks *blocks,
 
   /* See if we can extend backwards (max MATCH_BLOCKSIZE-1 steps because A's
      content has been sampled only every MATCH_BLOCKSIZE positions).  */
-  while (apos > 0 && bpos > pending_insert_start && a[apos-1] == b[bpos-1])
+  max_delta = apos < bpos - pending_insert_start
+            ? apos
+            : bpos - pending_insert_start;
+  if (max_delta > 0)
     {
-      --apos;
-      --bpos;
-      ++delta;
+      apr_size_t back = svn_cstring__reverse_match_length(a + apos, b + bpos,
+                                                          max_delta);
+      apos -= back;
+      bpos -= back;
+      delta += back;
     }
 
   *aposp = apos;
@@ -413,9 +485,35 @@ compute_delta(svn_txdelta__ops_baton_t *build_baton,
       apr_size_t apos;
 
       /* Quickly skip positions whose respective ROLLING checksums
-         definitely do not match any SLOT in BLOCKS. */
-      while (!(blocks.flags[hash_flags(rolling)] & (1 << (rolling & 7)))
-             && lo < upper)
+         definitely do not match any SLOT in BLOCKS.  Check the upper
+         bound only every 4 positions; that is the hottest loop here. */
+      while (lo + 4 <= upper)
+        {
+          if (may_match(&blocks, rolling))
+            break;
+          rolling = adler32_replace(rolling, b[lo], b[lo+MATCH_BLOCKSIZE]);
+          if (may_match(&blocks, rolling))
+            {
+              lo += 1;
+              break;
+            }
+          rolling = adler32_replace(rolling, b[lo+1], b[lo+1+MATCH_BLOCKSIZE]);
+          if (may_match(&blocks, rolling))
+            {
+              lo += 2;
+              break;
+            }
+          rolling = adler32_replace(rolling, b[lo+2], b[lo+2+MATCH_BLOCKSIZE]);
+          if (may_match(&blocks, rolling))
+            {
+              lo += 3;
+              break;
+            }
+          rolling = adler32_replace(rolling, b[lo+3], b[lo+3+MATCH_BLOCKSIZE]);
+          lo += 4;
+        }
+
+      while (!may_match(&blocks, rolling) && lo < upper)
         {
           rolling = adler32_replace(rolling, b[lo], b[lo+MATCH_BLOCKSIZE]);
           lo++;
@@ -494,3 +592,16 @@ svn_txdelta__xdelta(svn_txdelta__ops_baton_t *build_baton,
                 data + source_len, target_len,
                 pool);
 }
+
+apr_size_t
+svn_txdelta__match_blocksize(void)
+{
+  return MATCH_BLOCKSIZE;
+}
+
+apr_uint32_t
+svn_txdelta__adler32_block(const char *data,
+                           svn_boolean_t scalar)
+{
+  return scalar ? init_adler32_scalar(data) : init_adler32(data);
+}
@@ -1681,7 +1681,7 @@ get_combined_window(svn_stringbuf_t **result,
 {
   apr_pool_t *pool, *new_pool, *window_pool;
   int i;
-  apr_array_header_t *windows;
+  apr_array_header_t *windows, *run;
   svn_stringbuf_t *source, *buf = rb->base_window;
   rep_state_t *rs;
   apr_pool_t *iterpool;
@@ -1711,16 +1711,39 @@ get_combined_window(svn_stringbuf_t **result,
         }
     }
 
-  /* Combine in the windows from the other delta reps. */
+  /* Combine in the windows from the other delta reps.  Only levels whose
+     fulltext gets cached need to be expanded.  Compose all windows up to
+     the next such level into a single one, so that we only apply one
+     window per run instead of expanding every intermediate text. */
   pool = svn_pool_create(rb->pool);
+  run = apr_array_make(window_pool, i, sizeof(svn_txdelta_window_t *));
   for (--i; i >= 0; --i)
     {
       svn_txdelta_window_t *window;
+      svn_boolean_t cache_window;
+
+      rs = APR_ARRAY_IDX(rb->rs_list, i, rep_state_t *);
+      APR_ARRAY_PUSH(run, svn_txdelta_window_t *)
+        = APR_ARRAY_IDX(windows, i, svn_txdelta_window_t *);
+
+      /* Cache windows only if the whole rep content could be read as a
+         single chunk.  Only then will no other chunk need a deeper RS
+         list than the cached chunk. */
+      cache_window = (rb->chunk_index == 0) && (rs->current == rs->size)
+                  && SVN_IS_VALID_REVNUM(rs->revision)
+                  && rs->combined_cache;
+
+      /* Defer intermediate levels that we would not cache anyway. */
+      if (i > 0 && !cache_window)
+        {
+          rs->chunk_index++;
+          continue;
+        }
 
       svn_pool_clear(iterpool);
 
-      rs = APR_ARRAY_IDX(rb->rs_list, i, rep_state_t *);
-      window = APR_ARRAY_IDX(windows, i, svn_txdelta_window_t *);
+      /* The first window of the run determines the source view. */
+      window = APR_ARRAY_IDX(run, 0, svn_txdelta_window_t *);
 
       /* Maybe, we've got a PLAIN start representation.  If we do, read
          as much data from it as the needed for the txdelta window's source
@@ -1742,6 +1765,9 @@ get_combined_window(svn_stringbuf_t **result,
             SVN_ERR(skip_plain_window(rb->src_state, window->sview_len));
         }
 
+      if (run->nelts > 1)
+        window = svn_txdelta__compose_window_chain(run, iterpool, iterpool);
+
       /* Combine this window with the current one. */
       new_pool = svn_pool_create(rb->pool);
       buf = svn_stringbuf_create_ensure(window->tview_len, new_pool);
@@ -1754,14 +1780,11 @@ get_combined_window(svn_stringbuf_t **result,
                                 _("svndiff window length is "
                                   "corrupt"));
 
-      /* Cache windows only if the whole rep content could be read as a
-         single chunk.  Only then will no other chunk need a deeper RS
-         list than the cached chunk. */
-      if (   (rb->chunk_index == 0) && (rs->current == rs->size)
-          && SVN_IS_VALID_REVNUM(rs->revision))
+      if (cache_window)
         SVN_ERR(set_cached_combined_window(buf, rs, new_pool));
 
       rs->chunk_index++;
+      apr_array_clear(run);
 
       /* Cycle pools so that we only need to hold three windows at a time. */
       svn_pool_destroy(pool);
@@ -284,6 +284,10 @@ init_callbacks(svn_cache__t *cache,
  * is 0, then use the default priority class.  HAS_NAMESPACE indicates
  * whether we prefixed this cache instance with a namespace.
  *
+ * If DISK is not NULL, back the membuffer or inprocess cache by a
+ * persistent disk cache in DISK.  Since namespaced caches are considered
+ * short-lived, they never get a disk cache.
+ *
  * Unless NO_HANDLER is true, register an error handler that reports errors
  * as warnings to the FS warning callback.
  *
@@ -293,6 +297,7 @@ static svn_error_t *
 create_cache(svn_cache__t **cache_p,
              svn_memcache_t *memcache,
              svn_membuffer_t *membuffer,
+             svn_cache__disk_t *disk,
              apr_int64_t pages,
              apr_int64_t items_per_page,
              svn_cache__serialize_func_t serializer,
@@ -341,6 +346,29 @@ create_cache(svn_cache__t **cache_p,
       *cache_p = NULL;
     }
 
+  /* Stack the disk cache behind the in-memory one.  Disk I/O errors
+   * should not be fatal, just like memcached errors. */
+  if (disk && *cache_p && !memcache && !has_namespace)
+    {
+      /* Persistent items must not be mistaken for those of a different
+       * repository at the same path and with the same UUID, e.g. after
+       * a hotcopy has been moved into place.  The instance ID tells them
+       * apart. */
+      fs_fs_data_t *ffd = fs->fsap_data;
+      const char *disk_prefix = apr_pstrcat(scratch_pool, prefix, ":",
+                                            ffd->instance_id, SVN_VA_NULL);
+      svn_cache__t *disk_cache;
+
+      SVN_ERR(svn_cache__create_disk_cache(&disk_cache, disk, serializer,
+                                           deserializer, klen, disk_prefix,
+                                           result_pool));
+      SVN_ERR(svn_cache__create_tiered(cache_p, *cache_p, disk_cache,
+                                       result_pool));
+      error_handler = no_handler
+                    ? NULL
+                    : warn_and_continue_on_cache_errors;
+    }
+
   SVN_ERR(init_callbacks(*cache_p, fs, error_handler, result_pool));
 
   return SVN_NO_ERROR;
@@ -408,6 +436,7 @@ svn_fs_fs__initialize_caches(svn_fs_t *fs,
   SVN_ERR(create_cache(&(ffd->rev_root_id_cache),
                        NULL,
                        membuffer,
+                       NULL,
                        1, 50,
                        svn_fs_fs__serialize_id,
                        svn_fs_fs__deserialize_id,
@@ -424,6 +453,7 @@ svn_fs_fs__initialize_caches(svn_fs_t *fs,
   SVN_ERR(create_cache(&(ffd->rev_node_cache),
                        NULL,
                        membuffer,
+                       NULL,
                        1, 8,
                        svn_fs_fs__dag_serialize,
                        svn_fs_fs__dag_deserialize,
@@ -442,6 +472,7 @@ svn_fs_fs__initialize_caches(svn_fs_t *fs,
   SVN_ERR(create_cache(&(ffd->dir_cache),
                        NULL,
                        membuffer,
+                       ffd->disk_cache,
                        1, 8,
                        svn_fs_fs__serialize_dir_entries,
                        svn_fs_fs__deserialize_dir_entries,
@@ -458,6 +489,7 @@ svn_fs_fs__initialize_caches(svn_fs_t *fs,
   SVN_ERR(create_cache(&(ffd->packed_offset_cache),
                        NULL,
                        membuffer,
+                       NULL,
                        8, 1,
                        svn_fs_fs__serialize_manifest,
                        svn_fs_fs__deserialize_manifest,
@@ -474,6 +506,7 @@ svn_fs_fs__initialize_caches(svn_fs_t *fs,
   SVN_ERR(create_cache(&(ffd->node_revision_cache),
                        NULL,
                        membuffer,
+                       NULL,
                        2, 16, /* ~500 byte / entry; 32 entries total */
                        svn_fs_fs__serialize_node_revision,
                        svn_fs_fs__deserialize_node_revision,
@@ -489,6 +522,7 @@ svn_fs_fs__initialize_caches(svn_fs_t *fs,
   SVN_ERR(create_cache(&(ffd->rep_header_cache),
                        NULL,
                        membuffer,
+                       NULL,
                        1, 200, /* ~40 bytes / entry; 200 entries total */
                        svn_fs_fs__serialize_rep_header,
                        svn_fs_fs__deserialize_rep_header,
@@ -504,6 +538,7 @@ svn_fs_fs__initialize_caches(svn_fs_t *fs,
   SVN_ERR(create_cache(&(ffd->changes_cache),
                        NULL,
                        membuffer,
+                       NULL,
                        1, 8, /* 1k / entry; 8 entries total, rarely used */
                        svn_fs_fs__serialize_changes,
                        svn_fs_fs__deserialize_changes,
@@ -519,6 +554,7 @@ svn_fs_fs__initialize_caches(svn_fs_t *fs,
   SVN_ERR(create_cache(&(ffd->revprop_cache),
                        NULL,
                        membuffer,
+                       NULL,
                        8, 20, /* ~400 bytes / entry, capa for ~2 packs */
                        svn_fs_fs__serialize_revprops,
                        svn_fs_fs__deserialize_revprops,
@@ -536,6 +572,7 @@ svn_fs_fs__initialize_caches(svn_fs_t *fs,
       SVN_ERR(create_cache(&(ffd->fulltext_cache),
                            ffd->memcache,
                            membuffer,
+                           ffd->disk_cache,
                            0, 0, /* Do not use the inprocess cache */
                            /* Values are svn_stringbuf_t */
                            NULL, NULL,
@@ -550,6 +587,7 @@ svn_fs_fs__initialize_caches(svn_fs_t *fs,
       SVN_ERR(create_cache(&(ffd->mergeinfo_cache),
                            NULL,
                            membuffer,
+                           NULL,
                            0, 0, /* Do not use the inprocess cache */
                            svn_fs_fs__serialize_mergeinfo,
                            svn_fs_fs__deserialize_mergeinfo,
@@ -565,6 +603,7 @@ svn_fs_fs__initialize_caches(svn_fs_t *fs,
       SVN_ERR(create_cache(&(ffd->mergeinfo_existence_cache),
                            NULL,
                            membuffer,
+                           NULL,
                            0, 0, /* Do not use the inprocess cache */
                            /* Values are svn_stringbuf_t */
                            NULL, NULL,
@@ -590,6 +629,7 @@ svn_fs_fs__initialize_caches(svn_fs_t *fs,
       SVN_ERR(create_cache(&(ffd->properties_cache),
                            NULL,
                            membuffer,
+                           NULL,
                            0, 0, /* Do not use the inprocess cache */
                            svn_fs_fs__serialize_properties,
                            svn_fs_fs__deserialize_properties,
@@ -613,6 +653,7 @@ svn_fs_fs__initialize_caches(svn_fs_t *fs,
       SVN_ERR(create_cache(&(ffd->raw_window_cache),
                            NULL,
                            membuffer,
+                           NULL,
                            0, 0, /* Do not use the inprocess cache */
                            svn_fs_fs__serialize_raw_window,
                            svn_fs_fs__deserialize_raw_window,
@@ -628,6 +669,7 @@ svn_fs_fs__initialize_caches(svn_fs_t *fs,
       SVN_ERR(create_cache(&(ffd->txdelta_window_cache),
                            NULL,
                            membuffer,
+                           NULL,
                            0, 0, /* Do not use the inprocess cache */
                            svn_fs_fs__serialize_txdelta_window,
                            svn_fs_fs__deserialize_txdelta_window,
@@ -643,6 +685,7 @@ svn_fs_fs__initialize_caches(svn_fs_t *fs,
       SVN_ERR(create_cache(&(ffd->combined_window_cache),
                            NULL,
                            membuffer,
+                           ffd->disk_cache,
                            0, 0, /* Do not use the inprocess cache */
                            /* Values are svn_stringbuf_t */
                            NULL, NULL,
@@ -664,6 +707,7 @@ svn_fs_fs__initialize_caches(svn_fs_t *fs,
   SVN_ERR(create_cache(&(ffd->l2p_header_cache),
                        NULL,
                        membuffer,
+                       NULL,
                        8, 16, /* entry size varies but we must cover a
                                  reasonable number of rev / pack files
                                  to allow for delta chains to be walked
@@ -681,6 +725,7 @@ svn_fs_fs__initialize_caches(svn_fs_t *fs,
   SVN_ERR(create_cache(&(ffd->l2p_page_cache),
                        NULL,
                        membuffer,
+                       NULL,
                        8, 16, /* entry size varies but we must cover a
                                  reasonable number of rev / pack files
                                  to allow for delta chains to be walked
@@ -698,6 +743,7 @@ svn_fs_fs__initialize_caches(svn_fs_t *fs,
   SVN_ERR(create_cache(&(ffd->p2l_header_cache),
                        NULL,
                        membuffer,
+                       NULL,
                        4, 1, /* Large entries. Rarely used. */
                        svn_fs_fs__serialize_p2l_header,
                        svn_fs_fs__deserialize_p2l_header,
@@ -712,6 +758,7 @@ svn_fs_fs__initialize_caches(svn_fs_t *fs,
   SVN_ERR(create_cache(&(ffd->p2l_page_cache),
                        NULL,
                        membuffer,
+                       NULL,
                        4, 1, /* Variably sized entries. Rarely used. */
                        svn_fs_fs__serialize_p2l_page,
                        svn_fs_fs__deserialize_p2l_page,
@@ -871,6 +918,7 @@ svn_fs_fs__initialize_txn_caches(svn_fs_t *fs,
   SVN_ERR(create_cache(&ffd->txn_dir_cache,
                        NULL,
                        svn_cache__get_global_membuffer_cache(),
+                       NULL,
                        1024, 8,
                        svn_fs_fs__serialize_txndir_entries,
                        svn_fs_fs__deserialize_dir_entries,
@@ -46,6 +46,7 @@
 #include "util.h"
 #include "verify.h"
 #include "svn_private_config.h"
+#include "private/svn_batch_fsync.h"
 #include "private/svn_fs_util.h"
 #include "private/svn_fs_fs_private.h"
 
@@ -124,6 +125,11 @@ fs_serialized_init(svn_fs_t *fs, apr_pool_t *common_pool, apr_pool_t *pool)
          transaction list and free transaction pointer. */
       SVN_ERR(svn_mutex__init(&ffsd->txn_list_lock, TRUE, common_pool));
 
+      /* Group commits queue up under yet another mutex. */
+      SVN_ERR(svn_mutex__init(&ffsd->group_commit_lock, TRUE, common_pool));
+      SVN_ERR(svn_thread_cond__create(&ffsd->group_commit_done,
+                                      common_pool));
+
       key = apr_pstrdup(common_pool, key);
       status = apr_pool_userdata_set(ffsd, key, NULL, common_pool);
       if (status)
@@ -148,7 +154,6 @@ svn_fs_fs__initialize_shared_data(svn_fs_t *fs,
 }
 
 
-
 static svn_error_t *
 fs_refresh_revprops(svn_fs_t *fs,
                     apr_pool_t *scratch_pool)
@@ -325,6 +330,23 @@ fs_ioctl(svn_fs_t *fs, svn_fs_ioctl_code_t ctlcode,
                                              cancel_baton,
                                              scratch_pool));
 
+          *output_p = NULL;
+          return SVN_NO_ERROR;
+        }
+      else if (ctlcode.code == SVN_FS_FS__IOCTL_WARM_CACHES.code)
+        {
+          svn_fs_fs__ioctl_warm_caches_input_t *input = input_void;
+
+          SVN_ERR(svn_fs_fs__warm_caches(fs,
+                                         input->start_rev,
+                                         input->end_rev,
+                                         input->paths,
+                                         input->progress_func,
+                                         input->progress_baton,
+                                         cancel_func,
+                                         cancel_baton,
+                                         scratch_pool));
+
           *output_p = NULL;
           return SVN_NO_ERROR;
         }
@@ -387,6 +409,36 @@ uninitialize_fs_struct(svn_fs_t *fs)
   fs->fsap_data = NULL;
 }
 
+svn_error_t *
+svn_fs_fs__open_clone(svn_fs_t **clone_p,
+                      svn_fs_t *fs,
+                      apr_pool_t *result_pool,
+                      apr_pool_t *scratch_pool)
+{
+  fs_fs_data_t *ffd = fs->fsap_data;
+  fs_fs_data_t *clone_ffd;
+  svn_fs_t *clone = apr_pcalloc(result_pool, sizeof(*clone));
+
+  clone->pool = result_pool;
+  clone->warning = fs->warning;
+  clone->warning_baton = fs->warning_baton;
+  clone->config = fs->config;
+
+  SVN_ERR(initialize_fs_struct(clone));
+  SVN_ERR(svn_fs_fs__open(clone, fs->path, scratch_pool));
+  SVN_ERR(svn_fs_fs__initialize_caches(clone, scratch_pool));
+
+  /* Same repository, same process.  Hence, the shared data is the same
+     that fs_serialized_init() would have found for CLONE. */
+  clone_ffd = clone->fsap_data;
+  clone_ffd->shared = ffd->shared;
+  clone_ffd->svn_fs_open_ = ffd->svn_fs_open_;
+
+  *clone_p = clone;
+
+  return SVN_NO_ERROR;
+}
+
 /* This implements the fs_library_vtable_t.create() API.  Create a new
    fsfs-backed Subversion filesystem at path PATH and link it into
    *FS.  Perform temporary allocations in POOL, and fs-global allocations
@@ -545,6 +597,7 @@ fs_verify(svn_fs_t *fs, const char *path,
 static svn_error_t *
 fs_pack(svn_fs_t *fs,
         const char *path,
+        int jobs,
         svn_fs_pack_notify_t notify_func,
         void *notify_baton,
         svn_cancel_func_t cancel_func,
@@ -554,7 +607,7 @@ fs_pack(svn_fs_t *fs,
         apr_pool_t *common_pool)
 {
   SVN_ERR(fs_open(fs, path, common_pool_lock, pool, common_pool));
-  return svn_fs_fs__pack(fs, 0, notify_func, notify_baton,
+  return svn_fs_fs__pack(fs, 0, jobs, notify_func, notify_baton,
                          cancel_func, cancel_baton, pool);
 }
 
@@ -566,8 +619,9 @@ fs_pack(svn_fs_t *fs,
    DST_FS at DEST_PATH. If INCREMENTAL is TRUE, make an effort not to
    re-copy data which already exists in DST_FS.
    The CLEAN_LOGS argument is ignored and included for Subversion
-   1.0.x compatibility.  Indicate progress via the optional NOTIFY_FUNC
-   callback using NOTIFY_BATON.  Perform all temporary allocations in POOL. */
+   1.0.x compatibility.  Use up to JOBS threads to copy the data.
+   Indicate progress via the optional NOTIFY_FUNC callback using
+   NOTIFY_BATON.  Perform all temporary allocations in POOL. */
 static svn_error_t *
 fs_hotcopy(svn_fs_t *src_fs,
            svn_fs_t *dst_fs,
@@ -575,6 +629,7 @@ fs_hotcopy(svn_fs_t *src_fs,
            const char *dst_path,
            svn_boolean_t clean_logs,
            svn_boolean_t incremental,
+           int jobs,
            svn_fs_hotcopy_notify_t notify_func,
            void *notify_baton,
            svn_cancel_func_t cancel_func,
@@ -593,7 +648,7 @@ fs_hotcopy(svn_fs_t *src_fs,
      can't be opened.
    */
   return svn_fs_fs__hotcopy(src_fs, dst_fs, src_path, dst_path,
-                            incremental, notify_func, notify_baton,
+                            incremental, jobs, notify_func, notify_baton,
                             cancel_func, cancel_baton, common_pool_lock,
                             pool, common_pool);
 }
@@ -705,6 +760,8 @@ svn_fs_fs__init(const svn_version_t *loader_version,
                              loader_version->major);
   SVN_ERR(svn_ver_check_list2(fs_version(), checklist, svn_ver_equal));
 
+  SVN_ERR(svn_batch_fsync__init(common_pool));
+
   *vtable = &library_vtable;
   return SVN_NO_ERROR;
 }
@@ -36,6 +36,7 @@
 #include "private/svn_fs_private.h"
 #include "private/svn_sqlite.h"
 #include "private/svn_mutex.h"
+#include "private/svn_thread_cond.h"
 
 #include "rev_file.h"
 
@@ -100,6 +101,8 @@ extern "C" {
 /* Names of sections and options in fsfs.conf. */
 #define CONFIG_SECTION_CACHES            "caches"
 #define CONFIG_OPTION_FAIL_STOP          "fail-stop"
+#define CONFIG_OPTION_DISK_CACHE_PATH    "disk-cache-path"
+#define CONFIG_OPTION_DISK_CACHE_SIZE    "disk-cache-size"
 #define CONFIG_SECTION_REP_SHARING       "rep-sharing"
 #define CONFIG_OPTION_ENABLE_REP_SHARING "enable-rep-sharing"
 #define CONFIG_SECTION_DELTIFICATION     "deltification"
@@ -108,6 +111,7 @@ extern "C" {
 #define CONFIG_OPTION_MAX_DELTIFICATION_WALK     "max-deltification-walk"
 #define CONFIG_OPTION_MAX_LINEAR_DELTIFICATION   "max-linear-deltification"
 #define CONFIG_OPTION_COMPRESSION_LEVEL  "compression-level"
+#define CONFIG_OPTION_COMPRESSION_THREADS "compression-threads"
 #define CONFIG_SECTION_PACKED_REVPROPS   "packed-revprops"
 #define CONFIG_OPTION_REVPROP_PACK_SIZE  "revprop-pack-size"
 #define CONFIG_OPTION_COMPRESS_PACKED_REVPROPS  "compress-packed-revprops"
@@ -115,6 +119,8 @@ extern "C" {
 #define CONFIG_OPTION_BLOCK_SIZE         "block-size"
 #define CONFIG_OPTION_L2P_PAGE_SIZE      "l2p-page-size"
 #define CONFIG_OPTION_P2L_PAGE_SIZE      "p2l-page-size"
+#define CONFIG_SECTION_COMMITS           "commits"
+#define CONFIG_OPTION_GROUP_COMMITS      "group-commits"
 #define CONFIG_SECTION_DEBUG             "debug"
 #define CONFIG_OPTION_PACK_AFTER_COMMIT  "pack-after-commit"
 #define CONFIG_OPTION_VERIFY_BEFORE_COMMIT "verify-before-commit"
@@ -127,7 +133,7 @@ extern "C" {
    Note: If you bump this, please update the switch statement in
          svn_fs_fs__create() as well.
  */
-#define SVN_FS_FS__FORMAT_NUMBER   8
+#define SVN_FS_FS__FORMAT_NUMBER   9
 
 /* The minimum format number that supports svndiff version 1.  */
 #define SVN_FS_FS__MIN_SVNDIFF1_FORMAT 2
@@ -188,6 +194,9 @@ extern "C" {
 /* The minimum format number that supports svndiff version 2. */
 #define SVN_FS_FS__MIN_SVNDIFF2_FORMAT 8
 
+/* The minimum format number that supports svndiff version 3. */
+#define SVN_FS_FS__MIN_SVNDIFF3_FORMAT 9
+
 /* The minimum format number that supports the special notation ("-")
    for optional values that are not present in the representation strings,
    such as SHA1 or the uniquifier.  For example:
@@ -275,6 +284,26 @@ typedef struct fs_fs_shared_data_t
      txn-current file. */
   svn_mutex__t *txn_current_lock;
 
+  /* Commits waiting to be processed as part of the next group commit,
+     most recent first, or NULL if there are none.  Access to this list,
+     the objects in it and GROUP_COMMIT_LEADER is synchronised under
+     GROUP_COMMIT_LOCK.  That lock is never held while acquiring any of
+     the above. */
+  struct fs_fs_group_commit_t *group_commits;
+
+  /* Number of commits in GROUP_COMMITS.  Synchronised likewise. */
+  int group_commits_queued;
+
+  /* Whether some thread is currently committing a group of transactions
+     on behalf of all threads waiting in GROUP_COMMITS. */
+  svn_boolean_t group_commit_leader;
+
+  /* A lock for intra-process synchronization of group commits. */
+  svn_mutex__t *group_commit_lock;
+
+  /* Signalled whenever a group commit has been completed. */
+  svn_thread_cond__t *group_commit_done;
+
   /* The common pool, under which this object is allocated, subpools
      of which are used to allocate the transaction objects. */
   apr_pool_t *common_pool;
@@ -315,7 +344,8 @@ typedef enum compression_type_t
 {
   compression_type_none,
   compression_type_zlib,
-  compression_type_lz4
+  compression_type_lz4,
+  compression_type_zstd
 } compression_type_t;
 
 /* Private (non-shared) FSFS-specific data for each svn_fs_t object.
@@ -356,6 +386,9 @@ typedef struct fs_fs_data_t
   /* Access to the configured memcached instances.  May be NULL. */
   svn_memcache_t *memcache;
 
+  /* The configured persistent local disk cache.  May be NULL. */
+  svn_cache__disk_t *disk_cache;
+
   /* If TRUE, don't ignore any cache-related errors.  If FALSE, errors from
      e.g. memcached may be ignored as caching is an optional feature. */
   svn_boolean_t fail_stop;
@@ -496,15 +529,24 @@ typedef struct fs_fs_data_t
   /* Compression type to use with txdelta storage format in new revs. */
   compression_type_t delta_compression_type;
 
-  /* Compression level (currently, only used with compression_type_zlib). */
+  /* Compression level (only used with compression_type_zlib and
+   * compression_type_zstd). */
   int delta_compression_level;
 
+  /* Maximum number of threads compressing txdelta windows of a single
+   * representation in parallel. */
+  int delta_compression_threads;
+
   /* Pack after every commit. */
   svn_boolean_t pack_after_commit;
 
   /* Verify each new revision before commit. */
   svn_boolean_t verify_before_commit;
 
+  /* Let concurrent commits within this process share their write lock,
+     the flushing to disk and the update of 'current'. */
+  svn_boolean_t group_commits;
+
   /* Per-instance filesystem ID, which provides an additional level of
      uniqueness for filesystems that share the same UUID, but should
      still be distinguishable (e.g. backups produced by svn_fs_hotcopy()
@@ -693,7 +693,8 @@ parse_compression_option(compression_type_t *compression_type_p,
   int level;
   svn_boolean_t is_valid = TRUE;
 
-  /* compression = none | lz4 | zlib | zlib-1 ... zlib-9 */
+  /* compression = none | lz4 | zlib | zlib-1 ... zlib-9
+   *               | zstd | zstd-1 ... zstd-19 */
   if (strcmp(value, "none") == 0)
     {
       type = compression_type_none;
@@ -723,6 +724,25 @@ parse_compression_option(compression_type_t *compression_type_p,
       else
         is_valid = FALSE;
     }
+  else if (strncmp(value, "zstd", 4) == 0)
+    {
+      const char *p = value + 4;
+
+      type = compression_type_zstd;
+      if (*p == 0)
+        {
+          level = SVN_DELTA_COMPRESSION_LEVEL_DEFAULT;
+        }
+      else if (*p == '-')
+        {
+          p++;
+          SVN_ERR(svn_cstring_atoi(&level, p));
+          if (level < 1 || level > SVN__ZSTD_LEVEL_MAX)
+            is_valid = FALSE;
+        }
+      else
+        is_valid = FALSE;
+    }
   else
     {
       is_valid = FALSE;
@@ -891,6 +911,18 @@ read_config(fs_fs_data_t *ffd,
                                       _("Compression type 'lz4' requires "
                                         "filesystem format 8 or higher"));
             }
+          if (ffd->delta_compression_type == compression_type_zstd)
+            {
+              if (ffd->format < SVN_FS_FS__MIN_SVNDIFF3_FORMAT)
+                return svn_error_create(SVN_ERR_BAD_CONFIG_VALUE, NULL,
+                                        _("Compression type 'zstd' requires "
+                                          "filesystem format 9 or higher"));
+              if (!svn__zstd_available())
+                return svn_error_create(SVN_ERR_BAD_CONFIG_VALUE, NULL,
+                                        _("Compression type 'zstd' is not "
+                                          "supported by this build of "
+                                          "Subversion"));
+            }
         }
       else if (compression_level_val)
         {
@@ -926,6 +958,22 @@ read_config(fs_fs_data_t *ffd,
       ffd->delta_compression_level = SVN_DELTA_COMPRESSION_LEVEL_NONE;
     }
 
+  if (ffd->format >= SVN_FS_FS__MIN_DELTIFICATION_FORMAT)
+    {
+      apr_int64_t compression_threads;
+
+      SVN_ERR(svn_config_get_int64(config, &compression_threads,
+                                   CONFIG_SECTION_DELTIFICATION,
+                                   CONFIG_OPTION_COMPRESSION_THREADS,
+                                   1));
+      ffd->delta_compression_threads
+        = (int)MIN(MAX(compression_threads, 1), 64);
+    }
+  else
+    {
+      ffd->delta_compression_threads = 1;
+    }
+
 #ifdef SVN_DEBUG
   SVN_ERR(svn_config_get_bool(config, &ffd->verify_before_commit,
                               CONFIG_SECTION_DEBUG,
@@ -938,10 +986,52 @@ read_config(fs_fs_data_t *ffd,
                               FALSE));
 #endif
 
+  /* Group commits require threads to group and the same id space in all
+     revisions.  Older formats hand out node and copy ids globally. */
+#if APR_HAS_THREADS
+  if (ffd->format >= SVN_FS_FS__MIN_NO_GLOBAL_IDS_FORMAT)
+    SVN_ERR(svn_config_get_bool(config, &ffd->group_commits,
+                                CONFIG_SECTION_COMMITS,
+                                CONFIG_OPTION_GROUP_COMMITS,
+                                FALSE));
+  else
+    ffd->group_commits = FALSE;
+#else
+  ffd->group_commits = FALSE;
+#endif
+
   /* memcached configuration */
   SVN_ERR(svn_cache__make_memcache_from_config(&ffd->memcache, config,
                                                result_pool, scratch_pool));
 
+  /* local disk cache configuration */
+  {
+    const char *disk_cache_path;
+    apr_int64_t disk_cache_size;
+
+    svn_config_get(config, &disk_cache_path, CONFIG_SECTION_CACHES,
+                   CONFIG_OPTION_DISK_CACHE_PATH, NULL);
+    SVN_ERR(svn_config_get_int64(config, &disk_cache_size,
+                                 CONFIG_SECTION_CACHES,
+                                 CONFIG_OPTION_DISK_CACHE_SIZE,
+                                 1024));
+
+    ffd->disk_cache = NULL;
+    if (disk_cache_path && *disk_cache_path && disk_cache_size > 0)
+      {
+        disk_cache_path = svn_dirent_join(fs_path,
+                                          svn_dirent_internal_style(
+                                              disk_cache_path,
+                                              scratch_pool),
+                                          scratch_pool);
+        SVN_ERR(svn_cache__get_global_disk_cache(&ffd->disk_cache,
+                                                 disk_cache_path,
+                                                 (apr_uint64_t)disk_cache_size
+                                                   * 0x100000,
+                                                 scratch_pool));
+      }
+  }
+
   SVN_ERR(svn_config_get_bool(config, &ffd->fail_stop,
                               CONFIG_SECTION_CACHES, CONFIG_OPTION_FAIL_STOP,
                               FALSE));
@@ -978,6 +1068,14 @@ write_config(svn_fs_t *fs,
 "### configured (and ignoring it with file:// access).  To make"             NL
 "### Subversion never ignore cache errors, uncomment this line."             NL
 "# " CONFIG_OPTION_FAIL_STOP " = true"                                       NL
+"### Fulltexts, combined deltas and directory listings can also be kept in"  NL
+"### a local disk cache that survives server restarts.  It is disabled by"   NL
+"### default.  To enable it, specify the cache directory.  Relative paths"   NL
+"### are relative to the 'db' directory of the repository.  The directory"   NL
+"### may be shared between repositories and server processes."               NL
+"# " CONFIG_OPTION_DISK_CACHE_PATH " = /var/cache/svn"                       NL
+"### The disk cache size is given in MB and defaults to 1024."               NL
+"# " CONFIG_OPTION_DISK_CACHE_SIZE " = 1024"                                 NL
 ""                                                                           NL
 "[" CONFIG_SECTION_REP_SHARING "]"                                           NL
 "### To conserve space, the filesystem can optionally avoid storing"         NL
@@ -1059,19 +1157,26 @@ write_config(svn_fs_t *fs,
 "### After deltification, we compress the data to minimize on-disk size."    NL
 "### This setting controls the compression algorithm, which will be used in" NL
 "### future revisions.  It can be used to either disable compression or to"  NL
-"### select between available algorithms (zlib, lz4).  zlib is a general-"   NL
-"### purpose compression algorithm.  lz4 is a fast compression algorithm"    NL
-"### which should be preferred for repositories with large and, possibly,"   NL
-"### incompressible files.  Note that the compression ratio of lz4 is"       NL
-"### usually lower than the one provided by zlib, but using it can"          NL
-"### significantly speed up commits as well as reading the data."            NL
+"### select between available algorithms (zlib, lz4, zstd).  zlib is a"      NL
+"### general-purpose compression algorithm.  lz4 is a fast compression"      NL
+"### algorithm which should be preferred for repositories with large and,"   NL
+"### possibly, incompressible files.  Note that the compression ratio of lz4"NL
+"### is usually lower than the one provided by zlib, but using it can"       NL
+"### significantly speed up commits as well as reading the data.  zstd"      NL
+"### offers compression ratios better than zlib at speeds close to lz4;"     NL
+"### higher zstd levels trade commit speed for smaller repositories while"   NL
+"### reading remains fast."                                                  NL
 "### lz4 compression algorithm is supported, starting from format 8"         NL
-"### repositories, available in Subversion 1.10 and higher."                 NL
+"### repositories, available in Subversion 1.10 and higher.  zstd requires"  NL
+"### format 9 repositories, available in Subversion 1.15 and higher, and a"  NL
+"### Subversion build with zstd support."                                    NL
 "### The syntax of this option is:"                                          NL
 "###   " CONFIG_OPTION_COMPRESSION " = none | lz4 | zlib | zlib-1 ... zlib-9" NL
+"###               | zstd | zstd-1 ... zstd-19"                              NL
 "### Versions prior to Subversion 1.10 will ignore this option."             NL
 "### The default value is 'lz4' if supported by the repository format and"   NL
-"### 'zlib' otherwise.  'zlib' is currently equivalent to 'zlib-5'."         NL
+"### 'zlib' otherwise.  'zlib' is currently equivalent to 'zlib-5' and"      NL
+"### 'zstd' to 'zstd-5'."                                                    NL
 "# " CONFIG_OPTION_COMPRESSION " = lz4"                                      NL
 "###"                                                                        NL
 "### DEPRECATED: The new '" CONFIG_OPTION_COMPRESSION "' option deprecates previously used" NL
@@ -1080,6 +1185,15 @@ write_config(svn_fs_t *fs,
 "### still be used (and it will result in zlib compression with the"         NL
 "### corresponding compression level)."                                      NL
 "###   " CONFIG_OPTION_COMPRESSION_LEVEL " = 0 ... 9 (default is 5)"         NL
+"###"                                                                        NL
+"### Compressing large files may take most of the time of a commit.  This"   NL
+"### setting lets up to the given number of threads compress the delta"      NL
+"### windows of a single file in parallel.  The data written to the"         NL
+"### repository remains the same.  Values larger than 1 have no effect"      NL
+"### if compression is disabled or APR has been built without thread"        NL
+"### support.  Versions prior to Subversion 1.15 will ignore this option."   NL
+"### The default is 1, i.e. no parallel compression."                        NL
+"# " CONFIG_OPTION_COMPRESSION_THREADS " = 1"                                NL
 ""                                                                           NL
 "[" CONFIG_SECTION_PACKED_REVPROPS "]"                                       NL
 "### This parameter controls the size (in kBytes) of packed revprop files."  NL
@@ -1149,6 +1263,19 @@ write_config(svn_fs_t *fs,
 "### p2l-page-size is given in kBytes and with a default of 1024 kBytes."    NL
 "# " CONFIG_OPTION_P2L_PAGE_SIZE " = 1024"                                   NL
 ""                                                                           NL
+"[" CONFIG_SECTION_COMMITS "]"                                               NL
+"### When several commits to this repository are being processed by the"     NL
+"### same server process at the same time,  group commits let the first of"  NL
+"### them write all the waiting ones as consecutive revisions while holding" NL
+"### the write lock.  The whole group then needs only a single round of"     NL
+"### flushing data to disk and a single update of the 'current' file."       NL
+"### Every commit still gets its own revision and reports its own errors."   NL
+"### This is useful for threaded servers with high commit rates and slow"    NL
+"### disk flushes.  It has no effect in format 1 and 2 repositories or"      NL
+"### when APR has been built without thread support."                        NL
+"### Group commits are disabled by default."                                 NL
+"# " CONFIG_OPTION_GROUP_COMMITS " = false"                                  NL
+""                                                                           NL
 "[" CONFIG_SECTION_DEBUG "]"                                                 NL
 "###"                                                                        NL
 "### Whether to verify each new revision immediately before finalizing"      NL
@@ -1952,6 +2079,13 @@ svn_fs_fs__create(svn_fs_t *fs,
           case 9: format = 7;
                   break;
 
+          case 10:
+          case 11:
+          case 12:
+          case 13:
+          case 14: format = 8;
+                   break;
+
           default:format = SVN_FS_FS__FORMAT_NUMBER;
         }
 
@@ -2323,8 +2457,11 @@ svn_fs_fs__info_format(int *fs_format,
     case 8:
       (*supports_version)->minor = 10;
       break;
+    case 9:
+      (*supports_version)->minor = 15;
+      break;
 #ifdef SVN_DEBUG
-# if SVN_FS_FS__FORMAT_NUMBER != 8
+# if SVN_FS_FS__FORMAT_NUMBER != 9
 #  error "Need to add a 'case' statement here"
 # endif
 #endif
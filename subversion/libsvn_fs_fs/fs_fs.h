@@ -48,6 +48,16 @@ svn_error_t *svn_fs_fs__initialize_shared_data(svn_fs_t *fs,
                                                apr_pool_t *pool,
                                                apr_pool_t *common_pool);
 
+/* Open another, independent filesystem object for the repository of the
+   already open FS and return it in *CLONE_P.  The clone shares the process-
+   wide data with FS but uses its own caches and file handles, which makes
+   it suitable for use in a different thread than FS.  Allocate *CLONE_P in
+   RESULT_POOL and use SCRATCH_POOL for temporary allocations. */
+svn_error_t *svn_fs_fs__open_clone(svn_fs_t **clone_p,
+                                   svn_fs_t *fs,
+                                   apr_pool_t *result_pool,
+                                   apr_pool_t *scratch_pool);
+
 /* Upgrade the fsfs filesystem FS.  Indicate progress via the optional
  * NOTIFY_FUNC callback using NOTIFY_BATON.  The optional CANCEL_FUNC
  * will periodically be called with CANCEL_BATON to allow for preemption.
@@ -319,6 +329,33 @@ svn_fs_fs__get_stats(svn_fs_fs__stats_t **stats,
                      apr_pool_t *result_pool,
                      apr_pool_t *scratch_pool);
 
+/* Read the changed paths lists and all nodes created in revisions
+ * START_REV through END_REV inclusive of FS, as well as the PATHS
+ * (const char *, may be NULL) in the youngest revision of FS, through
+ * the regular cached data access functions.  This populates the caches
+ * of FS such that subsequent requests for that data will be fast.
+ * If START_REV is SVN_INVALID_REVNUM, start at revision 0; if END_REV is
+ * SVN_INVALID_REVNUM, end at the head revision.  If START_REV > END_REV,
+ * no revisions will be read.  Revisions are read in ascending order, so
+ * that the youngest ones are the last to get evicted.  Paths that don't
+ * exist in the youngest revision will be ignored.
+ *
+ * Indicate progress via the optional PROGRESS_FUNC callback using
+ * PROGRESS_BATON. The optional CANCEL_FUNC will periodically be called with
+ * CANCEL_BATON to allow cancellation. Use SCRATCH_POOL for temporary
+ * allocations.
+ */
+svn_error_t *
+svn_fs_fs__warm_caches(svn_fs_t *fs,
+                       svn_revnum_t start_rev,
+                       svn_revnum_t end_rev,
+                       const apr_array_header_t *paths,
+                       svn_fs_progress_notify_func_t progress_func,
+                       void *progress_baton,
+                       svn_cancel_func_t cancel_func,
+                       void *cancel_baton,
+                       apr_pool_t *scratch_pool);
+
 /* Read the P2L index for the rev / pack file containing REVISION in FS.
  * For each index entry, invoke CALLBACK_FUNC with CALLBACK_BATON.
  * If not NULL, call CANCEL_FUNC with CANCEL_BATON from time to time.
@@ -30,6 +30,8 @@
 #include "revprops.h"
 #include "rep-cache.h"
 
+#include "private/svn_task.h"
+
 #include "../libsvn_fs/fs-loader.h"
 
 #include "svn_private_config.h"
@@ -278,8 +280,8 @@ hotcopy_copy_shard_file(svn_boolean_t *skipped_p,
 
 
 /* Copy a packed shard containing revision REV, and which contains
- * MAX_FILES_PER_DIR revisions, from SRC_FS to DST_FS.
- * Update *DST_MIN_UNPACKED_REV in case the shard is new in DST_FS.
+ * MAX_FILES_PER_DIR revisions, from SRC_FS to DST_FS.  REVPROPS_PACKED
+ * tells whether SRC_FS may contain packed revprops for that shard.
  * Do not re-copy data which already exists in DST_FS.
  * Set *SKIPPED_P to FALSE only if at least one part of the shard
  * was copied, do not change the value in *SKIPPED_P otherwise.
@@ -287,11 +289,11 @@ hotcopy_copy_shard_file(svn_boolean_t *skipped_p,
  * Use SCRATCH_POOL for temporary allocations. */
 static svn_error_t *
 hotcopy_copy_packed_shard(svn_boolean_t *skipped_p,
-                          svn_revnum_t *dst_min_unpacked_rev,
                           svn_fs_t *src_fs,
                           svn_fs_t *dst_fs,
                           svn_revnum_t rev,
                           int max_files_per_dir,
+                          svn_boolean_t revprops_packed,
                           apr_pool_t *scratch_pool)
 {
   const char *src_subdir;
@@ -300,7 +302,6 @@ hotcopy_copy_packed_shard(svn_boolean_t *skipped_p,
   const char *src_subdir_packed_shard;
   svn_revnum_t revprop_rev;
   apr_pool_t *iterpool;
-  fs_fs_data_t *src_ffd = src_fs->fsap_data;
 
   /* Copy the packed shard. */
   src_subdir = svn_dirent_join(src_fs->path, PATH_REVS_DIR, scratch_pool);
@@ -319,8 +320,7 @@ hotcopy_copy_packed_shard(svn_boolean_t *skipped_p,
   src_subdir = svn_dirent_join(src_fs->path, PATH_REVPROPS_DIR, scratch_pool);
   dst_subdir = svn_dirent_join(dst_fs->path, PATH_REVPROPS_DIR, scratch_pool);
 
-  if (   src_ffd->format < SVN_FS_FS__MIN_PACKED_REVPROP_FORMAT
-      || src_ffd->min_unpacked_rev < rev + max_files_per_dir)
+  if (!revprops_packed)
     {
       /* copy unpacked revprops rev by rev */
       iterpool = svn_pool_create(scratch_pool);
@@ -357,15 +357,6 @@ hotcopy_copy_packed_shard(svn_boolean_t *skipped_p,
                                               scratch_pool));
     }
 
-  /* If necessary, update the min-unpacked rev file in the hotcopy. */
-  if (*dst_min_unpacked_rev < rev + max_files_per_dir)
-    {
-      *dst_min_unpacked_rev = rev + max_files_per_dir;
-      SVN_ERR(svn_fs_fs__write_min_unpacked_rev(dst_fs,
-                                                *dst_min_unpacked_rev,
-                                                scratch_pool));
-    }
-
   return SVN_NO_ERROR;
 }
 
@@ -532,13 +523,407 @@ remove_folder(const char *path,
   return svn_error_trace(err);
 }
 
+/* Parameters and state shared by the functions copying the revision and
+ * revprop files in hotcopy_revisions(). */
+typedef struct hotcopy_revs_baton_t
+{
+  /* Copy from SRC_FS to DST_FS. */
+  svn_fs_t *src_fs;
+  svn_fs_t *dst_fs;
+
+  /* Sharding layout of both repositories. */
+  int max_files_per_dir;
+
+  /* Youngest revision in DST_FS before the hotcopy started. */
+  svn_revnum_t dst_youngest;
+
+  /* Current value of the min-unpacked-rev file in DST_FS. */
+  svn_revnum_t dst_min_unpacked_rev;
+
+  /* As passed to hotcopy_revisions(). */
+  svn_boolean_t incremental;
+  const char *src_revs_dir;
+  const char *dst_revs_dir;
+  const char *src_revprops_dir;
+  const char *dst_revprops_dir;
+  svn_fs_hotcopy_notify_t notify_func;
+  void* notify_baton;
+  svn_cancel_func_t cancel_func;
+  void* cancel_baton;
+} hotcopy_revs_baton_t;
+
+/* Return TRUE if the revprops of the packed shard in SRC_FS that starts
+ * at revision REV are packed as well. */
+static svn_boolean_t
+revprops_packed(svn_fs_t *src_fs,
+                svn_revnum_t rev)
+{
+  fs_fs_data_t *src_ffd = src_fs->fsap_data;
+
+  return src_ffd->format >= SVN_FS_FS__MIN_PACKED_REVPROP_FORMAT
+      && src_ffd->min_unpacked_rev >= rev + src_ffd->max_files_per_dir;
+}
+
+/* Update the bookkeeping in the destination described by HRB after the
+ * packed shard containing revision REV has been copied.  SKIPPED tells
+ * whether no data had to be copied for the shard.
+ * Use SCRATCH_POOL for temporary allocations. */
+static svn_error_t *
+hotcopy_finish_packed_shard(hotcopy_revs_baton_t *hrb,
+                            svn_revnum_t rev,
+                            svn_boolean_t skipped,
+                            apr_pool_t *scratch_pool)
+{
+  svn_fs_t *dst_fs = hrb->dst_fs;
+  fs_fs_data_t *dst_ffd = dst_fs->fsap_data;
+  int max_files_per_dir = hrb->max_files_per_dir;
+  svn_revnum_t pack_end_rev = rev + max_files_per_dir - 1;
+
+  /* If necessary, update the min-unpacked rev file in the hotcopy. */
+  if (hrb->dst_min_unpacked_rev < rev + max_files_per_dir)
+    {
+      hrb->dst_min_unpacked_rev = rev + max_files_per_dir;
+      SVN_ERR(svn_fs_fs__write_min_unpacked_rev(dst_fs,
+                                                hrb->dst_min_unpacked_rev,
+                                                scratch_pool));
+    }
+
+  /* Whenever this pack did not previously exist in the destination,
+   * update 'current' to the most recent packed rev (so readers can see
+   * new revisions which arrived in this pack). */
+  if (pack_end_rev > hrb->dst_youngest)
+    {
+      SVN_ERR(svn_fs_fs__write_current(dst_fs, pack_end_rev, 0, 0,
+                                       scratch_pool));
+    }
+
+  /* When notifying about packed shards, make things simpler by either
+   * reporting a full revision range, i.e [pack start, pack end] or
+   * reporting nothing. There is one case when this approach might not
+   * be exact (incremental hotcopy with a pack replacing last unpacked
+   * revisions), but generally this is good enough. */
+  if (hrb->notify_func && !skipped)
+    hrb->notify_func(hrb->notify_baton, rev, pack_end_rev, scratch_pool);
+
+  /* Remove revision files which are now packed. */
+  if (hrb->incremental)
+    {
+      SVN_ERR(hotcopy_remove_rev_files(dst_fs, rev,
+                                       rev + max_files_per_dir,
+                                       max_files_per_dir, scratch_pool));
+      if (dst_ffd->format >= SVN_FS_FS__MIN_PACKED_REVPROP_FORMAT)
+        SVN_ERR(hotcopy_remove_revprop_files(dst_fs, rev,
+                                             rev + max_files_per_dir,
+                                             max_files_per_dir,
+                                             scratch_pool));
+    }
+
+  /* Now that all revisions have moved into the pack, the original
+   * rev dir can be removed. */
+  SVN_ERR(remove_folder(svn_fs_fs__path_rev_shard(dst_fs, rev, scratch_pool),
+                        hrb->cancel_func, hrb->cancel_baton, scratch_pool));
+  if (rev > 0 && dst_ffd->format >= SVN_FS_FS__MIN_PACKED_REVPROP_FORMAT)
+    SVN_ERR(remove_folder(svn_fs_fs__path_revprops_shard(dst_fs, rev,
+                                                         scratch_pool),
+                          hrb->cancel_func, hrb->cancel_baton,
+                          scratch_pool));
+
+  return SVN_NO_ERROR;
+}
+
+/* Copy the rev and revprop files of the non-packed revision REV as
+ * described by HRB.  Set *SKIPPED_P to FALSE only if any of them was
+ * copied, do not change the value in *SKIPPED_P otherwise.
+ * Use SCRATCH_POOL for temporary allocations. */
+static svn_error_t *
+hotcopy_copy_revision(svn_boolean_t *skipped_p,
+                      const hotcopy_revs_baton_t *hrb,
+                      svn_revnum_t rev,
+                      apr_pool_t *scratch_pool)
+{
+  /* Copying non-packed revisions is racy in case the source repository is
+   * being packed concurrently with this hotcopy operation. The race can
+   * happen with FS formats prior to SVN_FS_FS__MIN_PACK_LOCK_FORMAT that
+   * support packed revisions. With the pack lock, however, the race is
+   * impossible, because hotcopy and pack operations block each other.
+   *
+   * We assume that all revisions coming after 'min-unpacked-rev' really
+   * are unpacked and that's not necessarily true with concurrent packing.
+   * Don't try to be smart in this edge case, because handling it properly
+   * might require copying *everything* from the start. Just abort the
+   * hotcopy with an ENOENT (revision file moved to a pack, so it is no
+   * longer where we expect it to be). */
+
+  /* Copy the rev file. */
+  SVN_ERR(hotcopy_copy_shard_file(skipped_p,
+                                  hrb->src_revs_dir, hrb->dst_revs_dir, rev,
+                                  hrb->max_files_per_dir,
+                                  scratch_pool));
+  /* Copy the revprop file. */
+  SVN_ERR(hotcopy_copy_shard_file(skipped_p,
+                                  hrb->src_revprops_dir,
+                                  hrb->dst_revprops_dir,
+                                  rev, hrb->max_files_per_dir,
+                                  scratch_pool));
+
+  return SVN_NO_ERROR;
+}
+
+/* Update the bookkeeping in the destination described by HRB after the
+ * non-packed revision REV has been copied.  SKIPPED tells whether no data
+ * had to be copied for it.  Use SCRATCH_POOL for temporary allocations. */
+static svn_error_t *
+hotcopy_finish_revision(hotcopy_revs_baton_t *hrb,
+                        svn_revnum_t rev,
+                        svn_boolean_t skipped,
+                        apr_pool_t *scratch_pool)
+{
+  /* Whenever this revision did not previously exist in the destination,
+   * checkpoint the progress via 'current' (do that once per full shard
+   * in order not to slow things down). */
+  if (rev > hrb->dst_youngest)
+    {
+      if (hrb->max_files_per_dir && (rev % hrb->max_files_per_dir == 0))
+        {
+          SVN_ERR(svn_fs_fs__write_current(hrb->dst_fs, rev, 0, 0,
+                                           scratch_pool));
+        }
+    }
+
+  if (hrb->notify_func && !skipped)
+    hrb->notify_func(hrb->notify_baton, rev, rev, scratch_pool);
+
+  return SVN_NO_ERROR;
+}
+
+/* Concurrent hotcopy:
+ *
+ * Copying files of different shards is independent, so we use the
+ * svn_task__t framework with one task per packed shard and per shard
+ * of non-packed revisions.  The workers only copy files.  Everything
+ * that makes the copied data visible in the destination, i.e. updating
+ * 'min-unpacked-rev' and 'current' as well as removing obsolete files,
+ * happens in the output functions.  These get called from the main
+ * thread and strictly in revision order.  Hence, 'current' will never
+ * point to a revision that has not been copied completely, just as with
+ * the serial hotcopy.
+ */
+
+/* Non-packed revisions in repositories without sharding get copied in
+ * batches of this many revisions. */
+#define HOTCOPY_BATCH_SIZE 1000
+
+/* Process baton for the tasks copying a packed shard or a range of
+ * non-packed revisions. */
+typedef struct hotcopy_task_baton_t
+{
+  /* Describes the whole operation.  Workers must only read the members
+     that are not being updated while copying. */
+  hotcopy_revs_baton_t *hrb;
+
+  /* Copy revisions FIRST to LAST, inclusive. */
+  svn_revnum_t first;
+  svn_revnum_t last;
+
+  /* Whether FIRST is the start of a packed shard.  In that case, LAST
+     is the end of that shard. */
+  svn_boolean_t packed;
+} hotcopy_task_baton_t;
+
+/* Result of a task copying files for the revision range given in its
+ * process baton. */
+typedef struct hotcopy_task_result_t
+{
+  /* The process baton. */
+  const hotcopy_task_baton_t *baton;
+
+  /* Whether nothing had to be copied.  For packed shards, this has a
+     single element.  Otherwise, one element per revision. */
+  svn_boolean_t *skipped;
+} hotcopy_task_result_t;
+
+/* Implements svn_task__output_func_t.
+ * Update the destination for the files copied as described by the
+ * hotcopy_task_result_t in RESULT.  OUTPUT_BATON is the
+ * hotcopy_revs_baton_t of the hotcopy.
+ */
+static svn_error_t *
+hotcopy_output(svn_task__t *task,
+               void *result,
+               void *output_baton,
+               svn_cancel_func_t cancel_func,
+               void *cancel_baton,
+               apr_pool_t *result_pool,
+               apr_pool_t *scratch_pool)
+{
+  hotcopy_revs_baton_t *hrb = output_baton;
+  hotcopy_task_result_t *task_result = result;
+  const hotcopy_task_baton_t *baton = task_result->baton;
+  svn_revnum_t rev;
+  apr_pool_t *iterpool;
+
+  if (cancel_func)
+    SVN_ERR(cancel_func(cancel_baton));
+
+  if (baton->packed)
+    return svn_error_trace(hotcopy_finish_packed_shard(hrb, baton->first,
+                                                       task_result->skipped[0],
+                                                       scratch_pool));
+
+  iterpool = svn_pool_create(scratch_pool);
+  for (rev = baton->first; rev <= baton->last; ++rev)
+    {
+      svn_pool_clear(iterpool);
+      SVN_ERR(hotcopy_finish_revision(hrb, rev,
+                                      task_result->skipped[rev - baton->first],
+                                      iterpool));
+    }
+  svn_pool_destroy(iterpool);
+
+  return SVN_NO_ERROR;
+}
+
+/* Implements svn_task__process_func_t.
+ * Copy the files for the revision range given by the hotcopy_task_baton_t
+ * in PROCESS_BATON and return a hotcopy_task_result_t in *RESULT.
+ */
+static svn_error_t *
+hotcopy_process(void **result,
+                svn_task__t *task,
+                void *thread_context,
+                void *process_baton,
+                svn_cancel_func_t cancel_func,
+                void *cancel_baton,
+                apr_pool_t *result_pool,
+                apr_pool_t *scratch_pool)
+{
+  const hotcopy_task_baton_t *baton = process_baton;
+  const hotcopy_revs_baton_t *hrb = baton->hrb;
+  hotcopy_task_result_t *task_result
+    = apr_pcalloc(result_pool, sizeof(*task_result));
+  svn_revnum_t count = baton->packed ? 1 : baton->last - baton->first + 1;
+  svn_revnum_t i;
+
+  task_result->baton = baton;
+  task_result->skipped = apr_palloc(result_pool,
+                                    count * sizeof(*task_result->skipped));
+  for (i = 0; i < count; ++i)
+    task_result->skipped[i] = TRUE;
+
+  if (baton->packed)
+    {
+      SVN_ERR(hotcopy_copy_packed_shard(task_result->skipped,
+                                        hrb->src_fs, hrb->dst_fs,
+                                        baton->first, hrb->max_files_per_dir,
+                                        revprops_packed(hrb->src_fs,
+                                                        baton->first),
+                                        scratch_pool));
+    }
+  else
+    {
+      apr_pool_t *iterpool = svn_pool_create(scratch_pool);
+      for (i = 0; i < count; ++i)
+        {
+          svn_pool_clear(iterpool);
+
+          if (cancel_func)
+            SVN_ERR(cancel_func(cancel_baton));
+
+          SVN_ERR(hotcopy_copy_revision(&task_result->skipped[i], hrb,
+                                        baton->first + i, iterpool));
+        }
+      svn_pool_destroy(iterpool);
+    }
+
+  *result = task_result;
+
+  return SVN_NO_ERROR;
+}
+
+/* Add a sub-task to TASK that copies the revisions FIRST to LAST as
+ * described by HRB.  PACKED tells whether these form a packed shard. */
+static svn_error_t *
+add_hotcopy_task(svn_task__t *task,
+                 hotcopy_revs_baton_t *hrb,
+                 svn_revnum_t first,
+                 svn_revnum_t last,
+                 svn_boolean_t packed)
+{
+  apr_pool_t *sub_task_pool = svn_task__create_process_pool(task);
+  hotcopy_task_baton_t *sub_task_baton
+    = apr_pcalloc(sub_task_pool, sizeof(*sub_task_baton));
+
+  sub_task_baton->hrb = hrb;
+  sub_task_baton->first = first;
+  sub_task_baton->last = last;
+  sub_task_baton->packed = packed;
+
+  return svn_error_trace(svn_task__add(task, sub_task_pool, NULL,
+                                       hotcopy_process, sub_task_baton,
+                                       hotcopy_output, hrb));
+}
+
+/* Process baton for the root task of a concurrent hotcopy. */
+typedef struct hotcopy_revisions_task_baton_t
+{
+  /* Describes the whole operation. */
+  hotcopy_revs_baton_t *hrb;
+
+  /* Revisions before this one are packed in the source. */
+  svn_revnum_t src_min_unpacked_rev;
+
+  /* Youngest revision to copy. */
+  svn_revnum_t src_youngest;
+} hotcopy_revisions_task_baton_t;
+
+/* Implements svn_task__process_func_t.
+ * Add sub-tasks to TASK for all packed shards and non-packed revisions
+ * described by the hotcopy_revisions_task_baton_t in PROCESS_BATON.
+ * There is no output.
+ */
+static svn_error_t *
+hotcopy_revisions_process(void **result,
+                          svn_task__t *task,
+                          void *thread_context,
+                          void *process_baton,
+                          svn_cancel_func_t cancel_func,
+                          void *cancel_baton,
+                          apr_pool_t *result_pool,
+                          apr_pool_t *scratch_pool)
+{
+  hotcopy_revisions_task_baton_t *baton = process_baton;
+  hotcopy_revs_baton_t *hrb = baton->hrb;
+  svn_revnum_t batch_size = hrb->max_files_per_dir
+                          ? hrb->max_files_per_dir
+                          : HOTCOPY_BATCH_SIZE;
+  svn_revnum_t rev;
+
+  /* First, the packed shards. */
+  for (rev = 0; rev < baton->src_min_unpacked_rev;
+       rev += hrb->max_files_per_dir)
+    SVN_ERR(add_hotcopy_task(task, hrb, rev,
+                             rev + hrb->max_files_per_dir - 1, TRUE));
+
+  /* Now, the non-packed revisions.  Each task covers at most one shard. */
+  for (; rev <= baton->src_youngest; rev = (rev / batch_size + 1) * batch_size)
+    SVN_ERR(add_hotcopy_task(task, hrb, rev,
+                             MIN((rev / batch_size + 1) * batch_size - 1,
+                                 baton->src_youngest),
+                             FALSE));
+
+  *result = NULL;
+
+  return SVN_NO_ERROR;
+}
+
 /* Copy the revision and revprop files (possibly sharded / packed) from
  * SRC_FS to DST_FS.  Do not re-copy data which already exists in DST_FS.
  * When copying packed or unpacked shards, checkpoint the result in DST_FS
  * for every shard by updating the 'current' file if necessary.  Assume
  * the >= SVN_FS_FS__MIN_NO_GLOBAL_IDS_FORMAT filesystem format without
- * global next-ID counters.  Indicate progress via the optional NOTIFY_FUNC
- * callback using NOTIFY_BATON.  Use POOL for temporary allocations.
+ * global next-ID counters.  Use up to JOBS threads to copy the files.
+ * Indicate progress via the optional NOTIFY_FUNC callback using
+ * NOTIFY_BATON.  Use POOL for temporary allocations.
  */
 static svn_error_t *
 hotcopy_revisions(svn_fs_t *src_fs,
@@ -546,6 +931,7 @@ hotcopy_revisions(svn_fs_t *src_fs,
                   svn_revnum_t src_youngest,
                   svn_revnum_t dst_youngest,
                   svn_boolean_t incremental,
+                  int jobs,
                   const char *src_revs_dir,
                   const char *dst_revs_dir,
                   const char *src_revprops_dir,
@@ -557,8 +943,8 @@ hotcopy_revisions(svn_fs_t *src_fs,
                   apr_pool_t *pool)
 {
   fs_fs_data_t *src_ffd = src_fs->fsap_data;
-  fs_fs_data_t *dst_ffd = dst_fs->fsap_data;
   int max_files_per_dir = src_ffd->max_files_per_dir;
+  hotcopy_revs_baton_t hrb;
   svn_revnum_t src_min_unpacked_rev;
   svn_revnum_t dst_min_unpacked_rev;
   svn_revnum_t rev;
@@ -596,16 +982,47 @@ hotcopy_revisions(svn_fs_t *src_fs,
   if (cancel_func)
     SVN_ERR(cancel_func(cancel_baton));
 
+  hrb.src_fs = src_fs;
+  hrb.dst_fs = dst_fs;
+  hrb.max_files_per_dir = max_files_per_dir;
+  hrb.dst_youngest = dst_youngest;
+  hrb.dst_min_unpacked_rev = dst_min_unpacked_rev;
+  hrb.incremental = incremental;
+  hrb.src_revs_dir = src_revs_dir;
+  hrb.dst_revs_dir = dst_revs_dir;
+  hrb.src_revprops_dir = src_revprops_dir;
+  hrb.dst_revprops_dir = dst_revprops_dir;
+  hrb.notify_func = notify_func;
+  hrb.notify_baton = notify_baton;
+  hrb.cancel_func = cancel_func;
+  hrb.cancel_baton = cancel_baton;
+
   /*
    * Copy the necessary rev files.
    */
 
+  if (jobs > 1)
+    {
+      hotcopy_revisions_task_baton_t root_baton;
+
+      root_baton.hrb = &hrb;
+      root_baton.src_min_unpacked_rev = src_min_unpacked_rev;
+      root_baton.src_youngest = src_youngest;
+
+      SVN_ERR(svn_task__run(jobs, hotcopy_revisions_process, &root_baton,
+                            NULL, NULL, NULL, NULL,
+                            cancel_func, cancel_baton, pool, pool));
+
+      SVN_ERR_ASSERT(src_min_unpacked_rev == hrb.dst_min_unpacked_rev);
+
+      return SVN_NO_ERROR;
+    }
+
   iterpool = svn_pool_create(pool);
   /* First, copy packed shards. */
   for (rev = 0; rev < src_min_unpacked_rev; rev += max_files_per_dir)
     {
       svn_boolean_t skipped = TRUE;
-      svn_revnum_t pack_end_rev;
 
       svn_pool_clear(iterpool);
 
@@ -613,58 +1030,18 @@ hotcopy_revisions(svn_fs_t *src_fs,
         SVN_ERR(cancel_func(cancel_baton));
 
       /* Copy the packed shard. */
-      SVN_ERR(hotcopy_copy_packed_shard(&skipped, &dst_min_unpacked_rev,
-                                        src_fs, dst_fs,
+      SVN_ERR(hotcopy_copy_packed_shard(&skipped, src_fs, dst_fs,
                                         rev, max_files_per_dir,
+                                        revprops_packed(src_fs, rev),
                                         iterpool));
-
-      pack_end_rev = rev + max_files_per_dir - 1;
-
-      /* Whenever this pack did not previously exist in the destination,
-       * update 'current' to the most recent packed rev (so readers can see
-       * new revisions which arrived in this pack). */
-      if (pack_end_rev > dst_youngest)
-        {
-          SVN_ERR(svn_fs_fs__write_current(dst_fs, pack_end_rev, 0, 0,
-                                           iterpool));
-        }
-
-      /* When notifying about packed shards, make things simpler by either
-       * reporting a full revision range, i.e [pack start, pack end] or
-       * reporting nothing. There is one case when this approach might not
-       * be exact (incremental hotcopy with a pack replacing last unpacked
-       * revisions), but generally this is good enough. */
-      if (notify_func && !skipped)
-        notify_func(notify_baton, rev, pack_end_rev, iterpool);
-
-      /* Remove revision files which are now packed. */
-      if (incremental)
-        {
-          SVN_ERR(hotcopy_remove_rev_files(dst_fs, rev,
-                                           rev + max_files_per_dir,
-                                           max_files_per_dir, iterpool));
-          if (dst_ffd->format >= SVN_FS_FS__MIN_PACKED_REVPROP_FORMAT)
-            SVN_ERR(hotcopy_remove_revprop_files(dst_fs, rev,
-                                                 rev + max_files_per_dir,
-                                                 max_files_per_dir,
-                                                 iterpool));
-        }
-
-      /* Now that all revisions have moved into the pack, the original
-       * rev dir can be removed. */
-      SVN_ERR(remove_folder(svn_fs_fs__path_rev_shard(dst_fs, rev, iterpool),
-                            cancel_func, cancel_baton, iterpool));
-      if (rev > 0 && dst_ffd->format >= SVN_FS_FS__MIN_PACKED_REVPROP_FORMAT)
-        SVN_ERR(remove_folder(svn_fs_fs__path_revprops_shard(dst_fs, rev,
-                                                             iterpool),
-                              cancel_func, cancel_baton, iterpool));
+      SVN_ERR(hotcopy_finish_packed_shard(&hrb, rev, skipped, iterpool));
     }
 
   if (cancel_func)
     SVN_ERR(cancel_func(cancel_baton));
 
   SVN_ERR_ASSERT(rev == src_min_unpacked_rev);
-  SVN_ERR_ASSERT(src_min_unpacked_rev == dst_min_unpacked_rev);
+  SVN_ERR_ASSERT(src_min_unpacked_rev == hrb.dst_min_unpacked_rev);
 
   /* Now, copy pairs of non-packed revisions and revprop files.
    * If necessary, update 'current' after copying all files from a shard. */
@@ -677,44 +1054,8 @@ hotcopy_revisions(svn_fs_t *src_fs,
       if (cancel_func)
         SVN_ERR(cancel_func(cancel_baton));
 
-      /* Copying non-packed revisions is racy in case the source repository is
-       * being packed concurrently with this hotcopy operation. The race can
-       * happen with FS formats prior to SVN_FS_FS__MIN_PACK_LOCK_FORMAT that
-       * support packed revisions. With the pack lock, however, the race is
-       * impossible, because hotcopy and pack operations block each other.
-       *
-       * We assume that all revisions coming after 'min-unpacked-rev' really
-       * are unpacked and that's not necessarily true with concurrent packing.
-       * Don't try to be smart in this edge case, because handling it properly
-       * might require copying *everything* from the start. Just abort the
-       * hotcopy with an ENOENT (revision file moved to a pack, so it is no
-       * longer where we expect it to be). */
-
-      /* Copy the rev file. */
-      SVN_ERR(hotcopy_copy_shard_file(&skipped,
-                                      src_revs_dir, dst_revs_dir, rev,
-                                      max_files_per_dir,
-                                      iterpool));
-      /* Copy the revprop file. */
-      SVN_ERR(hotcopy_copy_shard_file(&skipped,
-                                      src_revprops_dir, dst_revprops_dir,
-                                      rev, max_files_per_dir,
-                                      iterpool));
-
-      /* Whenever this revision did not previously exist in the destination,
-       * checkpoint the progress via 'current' (do that once per full shard
-       * in order not to slow things down). */
-      if (rev > dst_youngest)
-        {
-          if (max_files_per_dir && (rev % max_files_per_dir == 0))
-            {
-              SVN_ERR(svn_fs_fs__write_current(dst_fs, rev, 0, 0,
-                                               iterpool));
-            }
-        }
-
-      if (notify_func && !skipped)
-        notify_func(notify_baton, rev, rev, iterpool);
+      SVN_ERR(hotcopy_copy_revision(&skipped, &hrb, rev, iterpool));
+      SVN_ERR(hotcopy_finish_revision(&hrb, rev, skipped, iterpool));
     }
   svn_pool_destroy(iterpool);
 
@@ -780,6 +1121,7 @@ struct hotcopy_body_baton {
   svn_fs_t *src_fs;
   svn_fs_t *dst_fs;
   svn_boolean_t incremental;
+  int jobs;
   svn_fs_hotcopy_notify_t notify_func;
   void *notify_baton;
   svn_cancel_func_t cancel_func;
@@ -928,7 +1270,8 @@ hotcopy_body(void *baton, apr_pool_t *pool)
   if (src_ffd->format >= SVN_FS_FS__MIN_NO_GLOBAL_IDS_FORMAT)
     {
       SVN_ERR(hotcopy_revisions(src_fs, dst_fs, src_youngest, dst_youngest,
-                                incremental, src_revs_dir, dst_revs_dir,
+                                incremental, hbb->jobs,
+                                src_revs_dir, dst_revs_dir,
                                 src_revprops_dir, dst_revprops_dir,
                                 notify_func, notify_baton,
                                 cancel_func, cancel_baton, pool));
@@ -1007,6 +1350,7 @@ svn_fs_fs__hotcopy(svn_fs_t *src_fs,
                    const char *src_path,
                    const char *dst_path,
                    svn_boolean_t incremental,
+                   int jobs,
                    svn_fs_hotcopy_notify_t notify_func,
                    void *notify_baton,
                    svn_cancel_func_t cancel_func,
@@ -1082,6 +1426,7 @@ svn_fs_fs__hotcopy(svn_fs_t *src_fs,
   hbb.src_fs = src_fs;
   hbb.dst_fs = dst_fs;
   hbb.incremental = incremental;
+  hbb.jobs = jobs;
   hbb.notify_func = notify_func;
   hbb.notify_baton = notify_baton;
   hbb.cancel_func = cancel_func;
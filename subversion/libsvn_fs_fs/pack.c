@@ -30,6 +30,7 @@
 #include "private/svn_subr_private.h"
 #include "private/svn_string_private.h"
 #include "private/svn_io_private.h"
+#include "private/svn_task.h"
 
 #include "fs_fs.h"
 #include "pack.h"
@@ -1865,6 +1866,7 @@ struct pack_baton
   svn_cancel_func_t cancel_func;
   void *cancel_baton;
   size_t max_mem;
+  int jobs;
 
   /* Additional entries valid when entering pack_shard(). */
   const char *revs_dir;
@@ -1957,6 +1959,60 @@ synced_pack_shard(void *baton,
   return SVN_NO_ERROR;
 }
 
+/* Return the path of the folder containing the non-packed revisions of
+ * SHARD in REVS_DIR.  Allocate the result in POOL.
+ */
+static const char *
+rev_shard_path(const char *revs_dir,
+               apr_int64_t shard,
+               apr_pool_t *pool)
+{
+  return svn_dirent_join(revs_dir,
+                         apr_psprintf(pool, "%" APR_INT64_T_FMT, shard),
+                         pool);
+}
+
+/* Return the path of the folder that will contain the packed revisions of
+ * SHARD in REVS_DIR.  Allocate the result in POOL.
+ */
+static const char *
+rev_pack_file_dir(const char *revs_dir,
+                  apr_int64_t shard,
+                  apr_pool_t *pool)
+{
+  return svn_dirent_join(revs_dir,
+                         apr_psprintf(pool,
+                                      "%" APR_INT64_T_FMT PATH_EXT_PACKED_SHARD,
+                                      shard),
+                         pool);
+}
+
+/* Switch the repository over to the already packed revisions of the shard
+ * described by BATON and notify the caller that this shard is done.
+ */
+static svn_error_t *
+switch_to_packed_shard(struct pack_baton *baton,
+                       apr_pool_t *pool)
+{
+  fs_fs_data_t *ffd = baton->fs->fsap_data;
+
+  /* For newer repo formats, we only acquired the pack lock so far.
+     Before modifying the repo state by switching over to the packed
+     data, we need to acquire the global (write) lock. */
+  if (ffd->format >= SVN_FS_FS__MIN_PACK_LOCK_FORMAT)
+    SVN_ERR(svn_fs_fs__with_write_lock(baton->fs, synced_pack_shard, baton,
+                                       pool));
+  else
+    SVN_ERR(synced_pack_shard(baton, pool));
+
+  /* Notify caller we're done packing this shard. */
+  if (baton->notify_func)
+    SVN_ERR(baton->notify_func(baton->notify_baton, baton->shard,
+                               svn_fs_pack_notify_end, pool));
+
+  return SVN_NO_ERROR;
+}
+
 /* Pack the shard described by BATON.
  *
  * If for some reason we detect a partial packing already performed,
@@ -1967,44 +2023,176 @@ pack_shard(struct pack_baton *baton,
            apr_pool_t *pool)
 {
   fs_fs_data_t *ffd = baton->fs->fsap_data;
-  const char *rev_pack_file_dir;
 
   /* Notify caller we're starting to pack this shard. */
   if (baton->notify_func)
     SVN_ERR(baton->notify_func(baton->notify_baton, baton->shard,
                                svn_fs_pack_notify_start, pool));
 
-  /* Some useful paths. */
-  rev_pack_file_dir = svn_dirent_join(baton->revs_dir,
-                  apr_psprintf(pool,
-                               "%" APR_INT64_T_FMT PATH_EXT_PACKED_SHARD,
-                               baton->shard),
-                  pool);
-  baton->rev_shard_path = svn_dirent_join(baton->revs_dir,
-                                          apr_psprintf(pool,
-                                                       "%" APR_INT64_T_FMT,
-                                                       baton->shard),
-                                          pool);
-
   /* pack the revision content */
-  SVN_ERR(pack_rev_shard(baton->fs, rev_pack_file_dir, baton->rev_shard_path,
+  baton->rev_shard_path = rev_shard_path(baton->revs_dir, baton->shard, pool);
+  SVN_ERR(pack_rev_shard(baton->fs,
+                         rev_pack_file_dir(baton->revs_dir, baton->shard,
+                                           pool),
+                         baton->rev_shard_path,
                          baton->shard, ffd->max_files_per_dir,
                          baton->max_mem, ffd->flush_to_disk,
                          baton->cancel_func, baton->cancel_baton, pool));
 
-  /* For newer repo formats, we only acquired the pack lock so far.
-     Before modifying the repo state by switching over to the packed
-     data, we need to acquire the global (write) lock. */
-  if (ffd->format >= SVN_FS_FS__MIN_PACK_LOCK_FORMAT)
-    SVN_ERR(svn_fs_fs__with_write_lock(baton->fs, synced_pack_shard, baton,
-                                       pool));
-  else
-    SVN_ERR(synced_pack_shard(baton, pool));
+  return svn_error_trace(switch_to_packed_shard(baton, pool));
+}
 
-  /* Notify caller we're starting to pack this shard. */
-  if (baton->notify_func)
-    SVN_ERR(baton->notify_func(baton->notify_baton, baton->shard,
-                               svn_fs_pack_notify_end, pool));
+/* Parallel packing:
+ *
+ * Writing the pack files for a shard only reads the shard's revision files
+ * and creates a new "*.pack" folder that nobody else will look at until
+ * min-unpacked-rev gets bumped.  So, this part can be done for many shards
+ * at once.  We use the svn_task__t framework with one sub-task per shard.
+ * The process functions run in worker threads with their own FS instance
+ * and write the pack files.  The output functions get called in shard order
+ * from the main thread and switch the repository over to the packed data.
+ *
+ * Should we fail or get interrupted, there may be pack folders for shards
+ * beyond min-unpacked-rev.  The next pack run will simply remove and re-
+ * create them, just as it would after a crash during sequential packing.
+ */
+
+/* Process baton for a shard packing sub-task. */
+typedef struct pack_shard_task_baton_t
+{
+  /* Describes the whole pack operation.  Only the members that are valid
+     when entering pack_body() and REVS_DIR may be used by the workers. */
+  struct pack_baton *pb;
+
+  /* Shard to pack. */
+  apr_int64_t shard;
+} pack_shard_task_baton_t;
+
+/* Process baton for the root task of a parallel pack. */
+typedef struct pack_shards_task_baton_t
+{
+  /* Describes the whole pack operation. */
+  struct pack_baton *pb;
+
+  /* Pack all shards from FIRST_SHARD up to but not including END_SHARD. */
+  apr_int64_t first_shard;
+  apr_int64_t end_shard;
+} pack_shards_task_baton_t;
+
+/* Implements svn_task__thread_context_constructor_t.
+ * Open a separate instance of the svn_fs_t given as CONTEXT_BATON and
+ * return it in *THREAD_CONTEXT.
+ */
+static svn_error_t *
+open_worker_fs(void **thread_context,
+               void *context_baton,
+               apr_pool_t *result_pool,
+               apr_pool_t *scratch_pool)
+{
+  svn_fs_t *fs;
+  SVN_ERR(svn_fs_fs__open_clone(&fs, context_baton, result_pool,
+                                scratch_pool));
+  *thread_context = fs;
+
+  return SVN_NO_ERROR;
+}
+
+/* Implements svn_task__output_func_t.
+ * Switch to the packed shard given as pack_shard_task_baton_t in RESULT.
+ * OUTPUT_BATON is the struct pack_baton of the pack operation.
+ */
+static svn_error_t *
+pack_shard_output(svn_task__t *task,
+                  void *result,
+                  void *output_baton,
+                  svn_cancel_func_t cancel_func,
+                  void *cancel_baton,
+                  apr_pool_t *result_pool,
+                  apr_pool_t *scratch_pool)
+{
+  struct pack_baton *pb = output_baton;
+  pack_shard_task_baton_t *shard_baton = result;
+
+  if (cancel_func)
+    SVN_ERR(cancel_func(cancel_baton));
+
+  pb->shard = shard_baton->shard;
+  pb->rev_shard_path = rev_shard_path(pb->revs_dir, pb->shard, scratch_pool);
+
+  /* From the caller's perspective, the shard gets packed right now. */
+  if (pb->notify_func)
+    SVN_ERR(pb->notify_func(pb->notify_baton, pb->shard,
+                            svn_fs_pack_notify_start, scratch_pool));
+
+  return svn_error_trace(switch_to_packed_shard(pb, scratch_pool));
+}
+
+/* Implements svn_task__process_func_t.
+ * Write the pack files for the shard given by the pack_shard_task_baton_t
+ * in PROCESS_BATON, reading the revision files through the svn_fs_t in
+ * THREAD_CONTEXT.  The result is a copy of PROCESS_BATON.
+ */
+static svn_error_t *
+pack_shard_process(void **result,
+                   svn_task__t *task,
+                   void *thread_context,
+                   void *process_baton,
+                   svn_cancel_func_t cancel_func,
+                   void *cancel_baton,
+                   apr_pool_t *result_pool,
+                   apr_pool_t *scratch_pool)
+{
+  pack_shard_task_baton_t *baton = process_baton;
+  svn_fs_t *fs = thread_context;
+  fs_fs_data_t *ffd = fs->fsap_data;
+  const char *revs_dir = baton->pb->revs_dir;
+
+  SVN_ERR(pack_rev_shard(fs,
+                         rev_pack_file_dir(revs_dir, baton->shard,
+                                           scratch_pool),
+                         rev_shard_path(revs_dir, baton->shard,
+                                        scratch_pool),
+                         baton->shard, ffd->max_files_per_dir,
+                         baton->pb->max_mem, ffd->flush_to_disk,
+                         cancel_func, cancel_baton, scratch_pool));
+
+  *result = apr_pmemdup(result_pool, baton, sizeof(*baton));
+
+  return SVN_NO_ERROR;
+}
+
+/* Implements svn_task__process_func_t.
+ * Add a pack_shard_process() sub-task to TASK for every shard described by
+ * the pack_shards_task_baton_t in PROCESS_BATON.  There is no output.
+ */
+static svn_error_t *
+pack_shards_process(void **result,
+                    svn_task__t *task,
+                    void *thread_context,
+                    void *process_baton,
+                    svn_cancel_func_t cancel_func,
+                    void *cancel_baton,
+                    apr_pool_t *result_pool,
+                    apr_pool_t *scratch_pool)
+{
+  pack_shards_task_baton_t *baton = process_baton;
+  apr_int64_t shard;
+
+  for (shard = baton->first_shard; shard < baton->end_shard; ++shard)
+    {
+      apr_pool_t *sub_task_pool = svn_task__create_process_pool(task);
+      pack_shard_task_baton_t *sub_task_baton
+        = apr_pcalloc(sub_task_pool, sizeof(*sub_task_baton));
+
+      sub_task_baton->pb = baton->pb;
+      sub_task_baton->shard = shard;
+
+      SVN_ERR(svn_task__add(task, sub_task_pool, NULL,
+                            pack_shard_process, sub_task_baton,
+                            pack_shard_output, baton->pb));
+    }
+
+  *result = NULL;
 
   return SVN_NO_ERROR;
 }
@@ -2080,6 +2268,25 @@ pack_body(void *baton,
     pb->revsprops_dir = svn_dirent_join(pb->fs->path, PATH_REVPROPS_DIR,
                                         pool);
 
+  /* Pack multiple shards concurrently? */
+  if (pb->jobs > 1)
+    {
+      pack_shards_task_baton_t shards_baton;
+      shards_baton.pb = pb;
+      shards_baton.first_shard = ffd->min_unpacked_rev
+                               / ffd->max_files_per_dir;
+      shards_baton.end_shard = completed_shards;
+
+      SVN_ERR(svn_task__run(pb->jobs,
+                            pack_shards_process, &shards_baton,
+                            NULL, NULL,
+                            open_worker_fs, pb->fs,
+                            pb->cancel_func, pb->cancel_baton,
+                            pool, pool));
+
+      return SVN_NO_ERROR;
+    }
+
   iterpool = svn_pool_create(pool);
   for (pb->shard = ffd->min_unpacked_rev / ffd->max_files_per_dir;
        pb->shard < completed_shards;
@@ -2100,6 +2307,7 @@ pack_body(void *baton,
 svn_error_t *
 svn_fs_fs__pack(svn_fs_t *fs,
                 apr_size_t max_mem,
+                int jobs,
                 svn_fs_pack_notify_t notify_func,
                 void *notify_baton,
                 svn_cancel_func_t cancel_func,
@@ -2146,6 +2354,7 @@ svn_fs_fs__pack(svn_fs_t *fs,
   pb.cancel_func = cancel_func;
   pb.cancel_baton = cancel_baton;
   pb.max_mem = max_mem ? max_mem : DEFAULT_MAX_MEM;
+  pb.jobs = jobs;
 
   if (ffd->format >= SVN_FS_FS__MIN_PACK_LOCK_FORMAT)
     {
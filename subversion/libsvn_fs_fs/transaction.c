@@ -43,6 +43,8 @@
 #include "lock.h"
 #include "rep-cache.h"
 
+#include "private/svn_batch_fsync.h"
+#include "private/svn_delta_private.h"
 #include "private/svn_fs_util.h"
 #include "private/svn_fspath.h"
 #include "private/svn_sorts_private.h"
@@ -2169,7 +2171,12 @@ txdelta_to_svndiff(svn_txdelta_window_handler_t *handler,
   fs_fs_data_t *ffd = fs->fsap_data;
   int svndiff_version;
 
-  if (ffd->delta_compression_type == compression_type_lz4)
+  if (ffd->delta_compression_type == compression_type_zstd)
+    {
+      SVN_ERR_ASSERT_NO_RETURN(ffd->format >= SVN_FS_FS__MIN_SVNDIFF3_FORMAT);
+      svndiff_version = 3;
+    }
+  else if (ffd->delta_compression_type == compression_type_lz4)
     {
       SVN_ERR_ASSERT_NO_RETURN(ffd->format >= SVN_FS_FS__MIN_SVNDIFF2_FORMAT);
       svndiff_version = 2;
@@ -2184,8 +2191,10 @@ txdelta_to_svndiff(svn_txdelta_window_handler_t *handler,
       svndiff_version = 0;
     }
 
-  svn_txdelta_to_svndiff3(handler, handler_baton, output, svndiff_version,
-                          ffd->delta_compression_level, pool);
+  svn_txdelta__to_svndiff_parallel(handler, handler_baton, output,
+                                   svndiff_version,
+                                   ffd->delta_compression_level,
+                                   ffd->delta_compression_threads, pool);
 }
 
 /* Get a rep_write_baton and store it in *WB_P for the representation
@@ -3493,13 +3502,15 @@ verify_before_commit(svn_fs_t *fs,
 
 /* Update the 'current' file to hold the correct next node and copy_ids
    from transaction TXN_ID in filesystem FS.  The current revision is
-   set to REV.  Perform temporary allocations in POOL. */
+   set to REV.  Flush all changes scheduled in BATCH to disk before the
+   new 'current' becomes visible.  Perform temporary allocations in POOL. */
 static svn_error_t *
 write_final_current(svn_fs_t *fs,
                     const svn_fs_fs__id_part_t *txn_id,
                     svn_revnum_t rev,
                     apr_uint64_t start_node_id,
                     apr_uint64_t start_copy_id,
+                    svn_batch_fsync__t *batch,
                     apr_pool_t *pool)
 {
   apr_uint64_t txn_node_id;
@@ -3507,7 +3518,7 @@ write_final_current(svn_fs_t *fs,
   fs_fs_data_t *ffd = fs->fsap_data;
 
   if (ffd->format >= SVN_FS_FS__MIN_NO_GLOBAL_IDS_FORMAT)
-    return svn_fs_fs__write_current(fs, rev, 0, 0, pool);
+    return svn_fs_fs__bump_current(fs, rev, 0, 0, batch, pool);
 
   /* To find the next available ids, we add the id that used to be in
      the 'current' file, to the next ids from the transaction file. */
@@ -3516,8 +3527,8 @@ write_final_current(svn_fs_t *fs,
   start_node_id += txn_node_id;
   start_copy_id += txn_copy_id;
 
-  return svn_fs_fs__write_current(fs, rev, start_node_id, start_copy_id,
-                                  pool);
+  return svn_fs_fs__bump_current(fs, rev, start_node_id, start_copy_id,
+                                 batch, pool);
 }
 
 /* Verify that the user registered with FS has all the locks necessary to
@@ -3593,13 +3604,14 @@ verify_locks(svn_fs_t *fs,
 }
 
 /* Writes final revision properties to file PATH applying permissions
-   from file PERMS_REFERENCE. This involves setting svn:date and
-   removing any temporary properties associated with the commit flags. */
+   from file PERMS_REFERENCE and schedule the necessary fsync calls in
+   BATCH. This involves setting svn:date and removing any temporary
+   properties associated with the commit flags. */
 static svn_error_t *
 write_final_revprop(const char *path,
                     const char *perms_reference,
                     svn_fs_txn_t *txn,
-                    svn_boolean_t flush_to_disk,
+                    svn_batch_fsync__t *batch,
                     apr_pool_t *pool)
 {
   apr_hash_t *txnprops;
@@ -3629,19 +3641,19 @@ write_final_revprop(const char *path,
       svn_hash_sets(txnprops, SVN_PROP_REVISION_DATE, &date);
     }
 
-  /* Create new revprops file. Tell OS to truncate existing file,
-     since  file may already exists from failed transaction. */
-  SVN_ERR(svn_io_file_open(&revprop_file, path,
-                           APR_WRITE | APR_CREATE | APR_TRUNCATE
-                           | APR_BUFFERED, APR_OS_DEFAULT, pool));
+  /* Create new revprops file. Truncate existing file, since file may
+     already exists from failed transaction.  BATCH owns the file handle. */
+  SVN_ERR(svn_batch_fsync__open_file(&revprop_file, batch, path,
+                                     pool));
+  SVN_ERR(svn_io_file_trunc(revprop_file, 0, pool));
 
   stream = svn_stream_from_aprfile2(revprop_file, TRUE, pool);
   SVN_ERR(svn_hash_write2(txnprops, stream, SVN_HASH_TERMINATOR, pool));
   SVN_ERR(svn_stream_close(stream));
 
-  if (flush_to_disk)
-    SVN_ERR(svn_io_file_flush_to_disk(revprop_file, pool));
-  SVN_ERR(svn_io_file_close(revprop_file, pool));
+  /* Make the contents visible to other readers, e.g. the verification
+     code.  Flushing to disk is left to BATCH. */
+  SVN_ERR(svn_io_file_flush(revprop_file, pool));
 
   SVN_ERR(svn_io_copy_perms(perms_reference, path, pool));
 
@@ -3734,50 +3746,34 @@ struct commit_baton {
   apr_pool_t *reps_pool;
 };
 
-/* The work-horse for svn_fs_fs__commit, called with the FS write lock.
-   This implements the svn_fs_fs__with_write_lock() 'body' callback
-   type.  BATON is a 'struct commit_baton *'. */
+/* Write the transaction in CB as the revision following OLD_REV, which
+   must be the youngest revision in CB->FS, and move all its files into
+   place.  Schedule all the necessary fsyncs in BATCH but don't update
+   'current'.  START_NODE_ID and START_COPY_ID are the respective values
+   read from 'current'.  Add the keys of all directories that have been
+   cached for the new revision to DIRECTORY_IDS.
+
+   The FS write lock is assumed to be held by the caller.  Use POOL for
+   temporary allocations. */
 static svn_error_t *
-commit_body(void *baton, apr_pool_t *pool)
+write_final_revision(struct commit_baton *cb,
+                     svn_revnum_t old_rev,
+                     apr_uint64_t start_node_id,
+                     apr_uint64_t start_copy_id,
+                     svn_batch_fsync__t *batch,
+                     apr_array_header_t *directory_ids,
+                     apr_pool_t *pool)
 {
-  struct commit_baton *cb = baton;
   fs_fs_data_t *ffd = cb->fs->fsap_data;
   const char *old_rev_filename, *rev_filename, *proto_filename;
   const char *revprop_filename;
   const svn_fs_id_t *root_id, *new_root_id;
-  apr_uint64_t start_node_id;
-  apr_uint64_t start_copy_id;
-  svn_revnum_t old_rev, new_rev;
-  apr_file_t *proto_file;
+  svn_revnum_t new_rev;
+  apr_file_t *proto_file, *final_rev_file;
   void *proto_file_lockcookie;
   apr_off_t initial_offset, changed_path_offset;
   const svn_fs_fs__id_part_t *txn_id = svn_fs_fs__txn_get_id(cb->txn);
   apr_hash_t *changed_paths;
-  apr_array_header_t *directory_ids = apr_array_make(pool, 4,
-                                                     sizeof(pair_cache_key_t));
-
-  /* Re-Read the current repository format.  All our repo upgrade and
-     config evaluation strategies are such that existing information in
-     FS and FFD remains valid.
-
-     Although we don't recommend upgrading hot repositories, people may
-     still do it and we must make sure to either handle them gracefully
-     or to error out.
-
-     Committing pre-format 3 txns will fail after upgrade to format 3+
-     because the proto-rev cannot be found; no further action needed.
-     Upgrades from pre-f7 to f7+ means a potential change in addressing
-     mode for the final rev.  We must be sure to detect that cause because
-     the failure would only manifest once the new revision got committed.
-   */
-  SVN_ERR(svn_fs_fs__read_format_file(cb->fs, pool));
-
-  /* Read the current youngest revision and, possibly, the next available
-     node id and copy id (for old format filesystems).  Update the cached
-     value for the youngest revision, because we have just checked it. */
-  SVN_ERR(svn_fs_fs__read_current(&old_rev, &start_node_id, &start_copy_id,
-                                  cb->fs, pool));
-  ffd->youngest_rev_cache = old_rev;
 
   /* Check to make sure this transaction is based off the most recent
      revision. */
@@ -3837,8 +3833,10 @@ commit_body(void *baton, apr_pool_t *pool)
                                      NULL, pool));
     }
 
-  if (ffd->flush_to_disk)
-    SVN_ERR(svn_io_file_flush_to_disk(proto_file, pool));
+  /* Flushing to disk will be done later through BATCH, together with
+     all the other files and directories that we are about to touch.
+     That way, we pay for one round of concurrent fsyncs instead of
+     a sequence of individual ones. */
   SVN_ERR(svn_io_file_close(proto_file, pool));
 
   /* We don't unlock the prototype revision file immediately to avoid a
@@ -3863,6 +3861,7 @@ commit_body(void *baton, apr_pool_t *pool)
                                                     PATH_REVS_DIR,
                                                     pool),
                                     new_dir, pool));
+          SVN_ERR(svn_batch_fsync__new_path(batch, new_dir, pool));
         }
 
       /* Create the revprops shard. */
@@ -3879,6 +3878,7 @@ commit_body(void *baton, apr_pool_t *pool)
                                                     PATH_REVPROPS_DIR,
                                                     pool),
                                     new_dir, pool));
+          SVN_ERR(svn_batch_fsync__new_path(batch, new_dir, pool));
         }
     }
 
@@ -3891,8 +3891,15 @@ commit_body(void *baton, apr_pool_t *pool)
   rev_filename = svn_fs_fs__path_rev(cb->fs, new_rev, pool);
   proto_filename = svn_fs_fs__path_txn_proto_rev(cb->fs, txn_id, pool);
   SVN_ERR(svn_fs_fs__move_into_place(proto_filename, rev_filename,
-                                     old_rev_filename, ffd->flush_to_disk,
-                                     pool));
+                                     proto_filename, FALSE, pool));
+
+  /* Schedule the rev file contents as well as its new directory entry
+     for fsync.  The handle must be opened before revoking write access
+     through the permission update. */
+  SVN_ERR(svn_batch_fsync__open_file(&final_rev_file, batch,
+                                     rev_filename, pool));
+  SVN_ERR(svn_batch_fsync__new_path(batch, rev_filename, pool));
+  SVN_ERR(svn_io_copy_perms(old_rev_filename, rev_filename, pool));
 
   /* Now that we've moved the prototype revision file out of the way,
      we can unlock it (since further attempts to write to the file
@@ -3904,7 +3911,7 @@ commit_body(void *baton, apr_pool_t *pool)
   SVN_ERR_ASSERT(! svn_fs_fs__is_packed_revprop(cb->fs, new_rev));
   revprop_filename = svn_fs_fs__path_revprops(cb->fs, new_rev, pool);
   SVN_ERR(write_final_revprop(revprop_filename, old_rev_filename,
-                              cb->txn, ffd->flush_to_disk, pool));
+                              cb->txn, batch, pool));
 
   /* Run paranoia checks. */
   if (ffd->verify_before_commit)
@@ -3912,9 +3919,20 @@ commit_body(void *baton, apr_pool_t *pool)
       SVN_ERR(verify_before_commit(cb->fs, new_rev, pool));
     }
 
-  /* Update the 'current' file. */
-  SVN_ERR(write_final_current(cb->fs, txn_id, new_rev, start_node_id,
-                              start_copy_id, pool));
+  return SVN_NO_ERROR;
+}
+
+/* Tell the caches of CB->FS about the new revision NEW_REV, which has
+   been committed from CB->TXN, and remove the transaction.  DIRECTORY_IDS
+   are the keys of all directories cached for NEW_REV while writing it.
+   Also, set *CB->NEW_REV_P.  Use POOL for temporary allocations. */
+static svn_error_t *
+finalize_commit(struct commit_baton *cb,
+                svn_revnum_t new_rev,
+                apr_array_header_t *directory_ids,
+                apr_pool_t *pool)
+{
+  fs_fs_data_t *ffd = cb->fs->fsap_data;
 
   /* At this point the new revision is committed and globally visible
      so let the caller know it succeeded by giving it the new revision
@@ -3935,6 +3953,320 @@ commit_body(void *baton, apr_pool_t *pool)
   return SVN_NO_ERROR;
 }
 
+/* The work-horse for svn_fs_fs__commit, called with the FS write lock.
+   This implements the svn_fs_fs__with_write_lock() 'body' callback
+   type.  BATON is a 'struct commit_baton *'. */
+static svn_error_t *
+commit_body(void *baton, apr_pool_t *pool)
+{
+  struct commit_baton *cb = baton;
+  fs_fs_data_t *ffd = cb->fs->fsap_data;
+  apr_uint64_t start_node_id;
+  apr_uint64_t start_copy_id;
+  svn_revnum_t old_rev, new_rev;
+  const svn_fs_fs__id_part_t *txn_id = svn_fs_fs__txn_get_id(cb->txn);
+  apr_array_header_t *directory_ids = apr_array_make(pool, 4,
+                                                     sizeof(pair_cache_key_t));
+  svn_batch_fsync__t *batch;
+
+  /* Re-Read the current repository format.  All our repo upgrade and
+     config evaluation strategies are such that existing information in
+     FS and FFD remains valid.
+
+     Although we don't recommend upgrading hot repositories, people may
+     still do it and we must make sure to either handle them gracefully
+     or to error out.
+
+     Committing pre-format 3 txns will fail after upgrade to format 3+
+     because the proto-rev cannot be found; no further action needed.
+     Upgrades from pre-f7 to f7+ means a potential change in addressing
+     mode for the final rev.  We must be sure to detect that cause because
+     the failure would only manifest once the new revision got committed.
+   */
+  SVN_ERR(svn_fs_fs__read_format_file(cb->fs, pool));
+
+  /* Read the current youngest revision and, possibly, the next available
+     node id and copy id (for old format filesystems).  Update the cached
+     value for the youngest revision, because we have just checked it. */
+  SVN_ERR(svn_fs_fs__read_current(&old_rev, &start_node_id, &start_copy_id,
+                                  cb->fs, pool));
+  ffd->youngest_rev_cache = old_rev;
+
+  SVN_ERR(svn_batch_fsync__create(&batch, ffd->flush_to_disk, pool));
+  SVN_ERR(write_final_revision(cb, old_rev, start_node_id, start_copy_id,
+                               batch, directory_ids, pool));
+
+  /* Update the 'current' file.  This flushes all of the above to disk
+     before the new revision becomes visible. */
+  new_rev = old_rev + 1;
+  SVN_ERR(write_final_current(cb->fs, txn_id, new_rev, start_node_id,
+                              start_copy_id, batch, pool));
+
+  return svn_error_trace(finalize_commit(cb, new_rev, directory_ids, pool));
+}
+
+/* A commit waiting in the group commit queue of a repository.  Unless
+   noted otherwise, the members get only accessed by the thread that is
+   currently committing the group.  The thread that created the object is
+   blocked until DONE has been set. */
+typedef struct fs_fs_group_commit_t
+{
+  /* The commit to perform.  CB->FS is only used by this commit. */
+  struct commit_baton *cb;
+
+  /* Brings CB->TXN up to date with the youngest revision. */
+  svn_fs_fs__rebase_func_t rebase_func;
+  void *rebase_baton;
+
+  /* Pool owned by the committing thread; used for anything that has to
+     survive until the commit has been completed. */
+  apr_pool_t *pool;
+
+  /* Keys of the directories cached for the new revision. */
+  apr_array_header_t *directory_ids;
+
+  /* The new revision once it has been written, SVN_INVALID_REVNUM
+     otherwise. */
+  svn_revnum_t new_rev;
+
+  /* Result of this commit, to be returned by svn_fs_fs__commit. */
+  svn_error_t *err;
+
+  /* Set once the commit has been completed, successfully or not.
+     Synchronised under the GROUP_COMMIT_LOCK. */
+  svn_boolean_t done;
+
+  /* Next commit in the queue.  Synchronised under the GROUP_COMMIT_LOCK
+     while in the shared queue. */
+  struct fs_fs_group_commit_t *next;
+} fs_fs_group_commit_t;
+
+/* Write the commit in ENTRY as revision *YOUNGEST + 1 but don't update
+   'current'.  If that succeeds, increment *YOUNGEST.  Schedule all the
+   necessary fsyncs in BATCH.
+
+   The FS write lock is assumed to be held by the caller.  Use POOL for
+   temporary allocations. */
+static svn_error_t *
+write_group_member(fs_fs_group_commit_t *entry,
+                   svn_revnum_t *youngest,
+                   svn_batch_fsync__t *batch,
+                   apr_pool_t *pool)
+{
+  struct commit_baton *cb = entry->cb;
+  fs_fs_data_t *ffd = cb->fs->fsap_data;
+
+  /* See commit_body for why the format needs to be re-read.  The write
+     lock has been taken through a different svn_fs_t, so update the
+     bits of repository state that our FS would otherwise have updated
+     when taking the lock.  Revisions written earlier in this group count
+     as existing already, even though they aren't in 'current' yet. */
+  SVN_ERR(svn_fs_fs__read_format_file(cb->fs, pool));
+  if (ffd->format >= SVN_FS_FS__MIN_PACKED_FORMAT)
+    SVN_ERR(svn_fs_fs__update_min_unpacked_rev(cb->fs, pool));
+  ffd->youngest_rev_cache = *youngest;
+
+  /* TXN has most likely been based on a revision written earlier in the
+     same group.  Merge the latest changes in. */
+  if (cb->txn->base_rev != *youngest)
+    SVN_ERR(entry->rebase_func(cb->txn, *youngest, entry->rebase_baton,
+                               pool));
+
+  SVN_ERR(write_final_revision(cb, *youngest, 0, 0, batch,
+                               entry->directory_ids, pool));
+  entry->new_rev = ++*youngest;
+
+  return SVN_NO_ERROR;
+}
+
+/* Let the FS of the commit in ENTRY forget about any revisions younger
+   than OLD_REV, which write_group_member() made it assume to exist. */
+static void
+reset_youngest_rev(fs_fs_group_commit_t *entry,
+                   svn_revnum_t old_rev)
+{
+  fs_fs_data_t *ffd = entry->cb->fs->fsap_data;
+  ffd->youngest_rev_cache = old_rev;
+}
+
+/* Mark all commits in QUEUE as not having been written and let their
+   FSes forget about any revisions younger than OLD_REV. */
+static void
+forget_new_revisions(fs_fs_group_commit_t *queue,
+                     svn_revnum_t old_rev)
+{
+  for (; queue; queue = queue->next)
+    {
+      queue->new_rev = SVN_INVALID_REVNUM;
+      reset_youngest_rev(queue, old_rev);
+    }
+}
+
+/* Baton used for group_commit_body below. */
+struct group_commit_baton {
+  svn_fs_t *fs;
+  fs_fs_group_commit_t *queue;
+};
+
+/* Commit all transactions in BATON->QUEUE in that order, one revision
+   each, and then make them visible with a single update of 'current'.
+   The outcome of each commit is stored in its queue entry.  Return an
+   error only if no revision could be published at all.
+
+   This implements the svn_fs_fs__with_write_lock() 'body' callback
+   type.  BATON is a 'struct group_commit_baton *'. */
+static svn_error_t *
+group_commit_body(void *baton, apr_pool_t *pool)
+{
+  struct group_commit_baton *gcb = baton;
+  fs_fs_data_t *ffd = gcb->fs->fsap_data;
+  apr_pool_t *iterpool = svn_pool_create(pool);
+  svn_batch_fsync__t *batch;
+  fs_fs_group_commit_t *entry;
+  svn_revnum_t old_rev, youngest;
+  apr_uint64_t start_node_id;
+  apr_uint64_t start_copy_id;
+  svn_error_t *err;
+
+  SVN_ERR(svn_fs_fs__read_format_file(gcb->fs, pool));
+  SVN_ERR(svn_fs_fs__read_current(&old_rev, &start_node_id, &start_copy_id,
+                                  gcb->fs, pool));
+  SVN_ERR(svn_batch_fsync__create(&batch, ffd->flush_to_disk, pool));
+
+  youngest = old_rev;
+  for (entry = gcb->queue; entry; entry = entry->next)
+    {
+      svn_pool_clear(iterpool);
+
+      entry->err = write_group_member(entry, &youngest, batch, iterpool);
+      if (entry->err)
+        {
+          /* Revisions of this group may still fail to get published. */
+          reset_youngest_rev(entry, old_rev);
+
+          /* The next commit will overwrite whatever files this one left
+             behind.  Don't let BATCH hand out stale handles for them. */
+          err = svn_batch_fsync__run(batch, iterpool);
+          if (err)
+            {
+              forget_new_revisions(gcb->queue, old_rev);
+              return svn_error_trace(err);
+            }
+        }
+    }
+
+  svn_pool_destroy(iterpool);
+
+  /* Nothing to publish? */
+  if (youngest == old_rev)
+    return SVN_NO_ERROR;
+
+  /* Update the 'current' file.  This flushes all revisions of the group
+     to disk before any of them becomes visible. */
+  err = svn_fs_fs__bump_current(gcb->fs, youngest, 0, 0, batch, pool);
+  if (err)
+    {
+      forget_new_revisions(gcb->queue, old_rev);
+      return svn_error_trace(err);
+    }
+
+  ffd->youngest_rev_cache = youngest;
+  for (entry = gcb->queue; entry; entry = entry->next)
+    if (SVN_IS_VALID_REVNUM(entry->new_rev))
+      {
+        fs_fs_data_t *entry_ffd = entry->cb->fs->fsap_data;
+
+        entry->err = finalize_commit(entry->cb, entry->new_rev,
+                                     entry->directory_ids, entry->pool);
+        entry_ffd->youngest_rev_cache = youngest;
+      }
+
+  return SVN_NO_ERROR;
+}
+
+/* Add ENTRY to the group commit queue of FS.  If we are the first to
+   arrive, commit everything that is queued and wake up all other waiting
+   threads.  Otherwise, wait for the thread that commits ENTRY on our
+   behalf.  Use POOL for temporary allocations. */
+static svn_error_t *
+group_commit(svn_fs_t *fs,
+             fs_fs_group_commit_t *entry,
+             apr_pool_t *pool)
+{
+  fs_fs_data_t *ffd = fs->fsap_data;
+  fs_fs_shared_data_t *ffsd = ffd->shared;
+  struct group_commit_baton gcb;
+  fs_fs_group_commit_t *next;
+  svn_error_t *err;
+
+  gcb.fs = fs;
+  gcb.queue = NULL;
+
+  /* Enqueue and wait until either ENTRY has been committed or nobody is
+     committing at the moment.  In the latter case, grab the whole queue
+     and become the one committing it. */
+  SVN_ERR(svn_mutex__lock(ffsd->group_commit_lock));
+  entry->next = ffsd->group_commits;
+  ffsd->group_commits = entry;
+  ffsd->group_commits_queued++;
+
+  err = SVN_NO_ERROR;
+  while (!err && !entry->done && ffsd->group_commit_leader)
+    err = svn_thread_cond__wait(ffsd->group_commit_done,
+                                ffsd->group_commit_lock);
+
+  if (err && !entry->done)
+    {
+      /* ENTRY will become invalid as soon as we return. */
+      fs_fs_group_commit_t **link = &ffsd->group_commits;
+      while (*link != entry)
+        link = &(*link)->next;
+
+      *link = entry->next;
+      ffsd->group_commits_queued--;
+    }
+  else if (!entry->done)
+    {
+      ffsd->group_commit_leader = TRUE;
+
+      /* The queue is most-recent-first; commit in order of arrival. */
+      while (ffsd->group_commits)
+        {
+          next = ffsd->group_commits->next;
+          ffsd->group_commits->next = gcb.queue;
+          gcb.queue = ffsd->group_commits;
+          ffsd->group_commits = next;
+        }
+
+      ffsd->group_commits_queued = 0;
+    }
+
+  SVN_ERR(svn_mutex__unlock(ffsd->group_commit_lock, err));
+
+  /* Somebody else did the work for us? */
+  if (!gcb.queue)
+    return SVN_NO_ERROR;
+
+  err = svn_fs_fs__with_write_lock(fs, group_commit_body, &gcb, pool);
+
+  /* Report the results and hand over to the next group. */
+  SVN_ERR(svn_mutex__lock(ffsd->group_commit_lock));
+  for (; gcb.queue; gcb.queue = next)
+    {
+      next = gcb.queue->next;
+      if (err && !gcb.queue->err && !SVN_IS_VALID_REVNUM(gcb.queue->new_rev))
+        gcb.queue->err = svn_error_dup(err);
+
+      gcb.queue->done = TRUE;
+    }
+
+  svn_error_clear(err);
+  ffsd->group_commit_leader = FALSE;
+  err = svn_thread_cond__broadcast(ffsd->group_commit_done);
+
+  return svn_error_trace(svn_mutex__unlock(ffsd->group_commit_lock, err));
+}
+
 /* Add the representations in REPS_TO_CACHE (an array of representation_t *)
  * to the rep-cache database of FS. */
 static svn_error_t *
@@ -3958,6 +4290,8 @@ svn_error_t *
 svn_fs_fs__commit(svn_revnum_t *new_rev_p,
                   svn_fs_t *fs,
                   svn_fs_txn_t *txn,
+                  svn_fs_fs__rebase_func_t rebase_func,
+                  void *rebase_baton,
                   apr_pool_t *pool)
 {
   struct commit_baton cb;
@@ -3980,7 +4314,24 @@ svn_fs_fs__commit(svn_revnum_t *new_rev_p,
       cb.reps_pool = NULL;
     }
 
-  SVN_ERR(svn_fs_fs__with_write_lock(fs, commit_body, &cb, pool));
+  if (ffd->group_commits && rebase_func)
+    {
+      fs_fs_group_commit_t entry = { 0 };
+
+      entry.cb = &cb;
+      entry.rebase_func = rebase_func;
+      entry.rebase_baton = rebase_baton;
+      entry.pool = pool;
+      entry.directory_ids = apr_array_make(pool, 4, sizeof(pair_cache_key_t));
+      entry.new_rev = SVN_INVALID_REVNUM;
+
+      SVN_ERR(group_commit(fs, &entry, pool));
+      SVN_ERR(entry.err);
+    }
+  else
+    {
+      SVN_ERR(svn_fs_fs__with_write_lock(fs, commit_body, &cb, pool));
+    }
 
   /* At this point, *NEW_REV_P has been set, so errors below won't affect
      the success of the commit.  (See svn_fs_commit_txn().)  */
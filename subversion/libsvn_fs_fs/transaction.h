@@ -210,14 +210,33 @@ svn_fs_fs__add_index_data(svn_fs_t *fs,
                           svn_revnum_t revision,
                           apr_pool_t *pool);
 
+/* Callback used by svn_fs_fs__commit to merge all changes up to and
+   including revision NEW_BASE_REV into TXN.  Upon success, TXN->BASE_REV
+   must be NEW_BASE_REV.  BATON is the baton given to svn_fs_fs__commit.
+   Use SCRATCH_POOL for temporary allocations. */
+typedef svn_error_t *
+(*svn_fs_fs__rebase_func_t)(svn_fs_txn_t *txn,
+                            svn_revnum_t new_base_rev,
+                            void *baton,
+                            apr_pool_t *scratch_pool);
+
 /* Commit the transaction TXN in filesystem FS and return its new
    revision number in *REV.  If the transaction is out of date, return
    the error SVN_ERR_FS_TXN_OUT_OF_DATE. Use POOL for temporary
-   allocations. */
+   allocations.
+
+   If group commits have been enabled for FS and REBASE_FUNC is not NULL,
+   TXN may be committed together with other transactions waiting for the
+   write lock.  REBASE_FUNC will then be called with REBASE_BATON, possibly
+   from another thread, to bring TXN up to date with the revisions
+   committed before it in the same group.  Errors returned by it will be
+   returned by this function.  */
 svn_error_t *
 svn_fs_fs__commit(svn_revnum_t *new_rev_p,
                   svn_fs_t *fs,
                   svn_fs_txn_t *txn,
+                  svn_fs_fs__rebase_func_t rebase_func,
+                  void *rebase_baton,
                   apr_pool_t *pool);
 
 /* Set *NAMES_P to an array of names which are all the active
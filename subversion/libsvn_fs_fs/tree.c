@@ -2221,6 +2221,28 @@ merge_changes(dag_node_t *ancestor_node,
   return SVN_NO_ERROR;
 }
 
+/* Merge all changes up to and including revision NEW_BASE_REV into TXN.
+   This implements svn_fs_fs__rebase_func_t; BATON is the svn_stringbuf_t
+   that receives the conflicting path, if any. */
+static svn_error_t *
+rebase_txn(svn_fs_txn_t *txn,
+           svn_revnum_t new_base_rev,
+           void *baton,
+           apr_pool_t *scratch_pool)
+{
+  svn_stringbuf_t *conflict = baton;
+  svn_fs_root_t *new_base_root;
+  dag_node_t *new_base_root_node;
+
+  SVN_ERR(svn_fs_fs__revision_root(&new_base_root, txn->fs, new_base_rev,
+                                   scratch_pool));
+  SVN_ERR(get_root(&new_base_root_node, new_base_root, scratch_pool));
+  SVN_ERR(merge_changes(NULL, new_base_root_node, txn, conflict,
+                        scratch_pool));
+  txn->base_rev = new_base_rev;
+
+  return SVN_NO_ERROR;
+}
 
 svn_error_t *
 svn_fs_fs__commit_txn(const char **conflict_p,
@@ -2322,9 +2344,18 @@ svn_fs_fs__commit_txn(const char **conflict_p,
         }
       txn->base_rev = youngish_rev;
 
-      /* Try to commit. */
-      err = svn_fs_fs__commit(new_rev, fs, txn, iterpool);
-      if (err && (err->apr_err == SVN_ERR_FS_TXN_OUT_OF_DATE))
+      /* Try to commit.  If this becomes part of a group commit, the
+         changes committed before us within that group will be merged
+         into TXN as well. */
+      err = svn_fs_fs__commit(new_rev, fs, txn, rebase_txn, conflict,
+                              iterpool);
+      if (err && (err->apr_err == SVN_ERR_FS_CONFLICT))
+        {
+          if (conflict_p)
+            *conflict_p = conflict->data;
+          goto cleanup;
+        }
+      else if (err && (err->apr_err == SVN_ERR_FS_TXN_OUT_OF_DATE))
         {
           /* Did someone else finish committing a new revision while we
              were in mid-merge or mid-commit?  If so, we'll need to
@@ -2359,7 +2390,7 @@ svn_fs_fs__commit_txn(const char **conflict_p,
 
   if (ffd->pack_after_commit)
     {
-      SVN_ERR(svn_fs_fs__pack(fs, 0, NULL, NULL, NULL, NULL, pool));
+      SVN_ERR(svn_fs_fs__pack(fs, 0, 1, NULL, NULL, NULL, NULL, pool));
     }
 
   return SVN_NO_ERROR;
@@ -492,6 +492,29 @@ svn_fs_fs__read_current(svn_revnum_t *rev,
   return SVN_NO_ERROR;
 }
 
+/* Return the contents of the 'current' file in FS for REV, NEXT_NODE_ID
+   and NEXT_COPY_ID.  Allocate the result in RESULT_POOL. */
+static const char *
+unparse_current(svn_fs_t *fs,
+                svn_revnum_t rev,
+                apr_uint64_t next_node_id,
+                apr_uint64_t next_copy_id,
+                apr_pool_t *result_pool)
+{
+  fs_fs_data_t *ffd = fs->fsap_data;
+  char node_id_str[SVN_INT64_BUFFER_SIZE];
+  char copy_id_str[SVN_INT64_BUFFER_SIZE];
+
+  if (ffd->format >= SVN_FS_FS__MIN_NO_GLOBAL_IDS_FORMAT)
+    return apr_psprintf(result_pool, "%ld\n", rev);
+
+  svn__ui64tobase36(node_id_str, next_node_id);
+  svn__ui64tobase36(copy_id_str, next_copy_id);
+
+  return apr_psprintf(result_pool, "%ld %s %s\n", rev, node_id_str,
+                      copy_id_str);
+}
+
 svn_error_t *
 svn_fs_fs__write_current(svn_fs_t *fs,
                          svn_revnum_t rev,
@@ -499,24 +522,12 @@ svn_fs_fs__write_current(svn_fs_t *fs,
                          apr_uint64_t next_copy_id,
                          apr_pool_t *pool)
 {
-  char *buf;
+  const char *buf;
   const char *name;
   fs_fs_data_t *ffd = fs->fsap_data;
 
   /* Now we can just write out this line. */
-  if (ffd->format >= SVN_FS_FS__MIN_NO_GLOBAL_IDS_FORMAT)
-    {
-      buf = apr_psprintf(pool, "%ld\n", rev);
-    }
-  else
-    {
-      char node_id_str[SVN_INT64_BUFFER_SIZE];
-      char copy_id_str[SVN_INT64_BUFFER_SIZE];
-      svn__ui64tobase36(node_id_str, next_node_id);
-      svn__ui64tobase36(copy_id_str, next_copy_id);
-
-      buf = apr_psprintf(pool, "%ld %s %s\n", rev, node_id_str, copy_id_str);
-    }
+  buf = unparse_current(fs, rev, next_node_id, next_copy_id, pool);
 
   name = svn_fs_fs__path_current(fs, pool);
   SVN_ERR(svn_io_write_atomic2(name, buf, strlen(buf),
@@ -526,6 +537,55 @@ svn_fs_fs__write_current(svn_fs_t *fs,
   return SVN_NO_ERROR;
 }
 
+svn_error_t *
+svn_fs_fs__bump_current(svn_fs_t *fs,
+                        svn_revnum_t rev,
+                        apr_uint64_t next_node_id,
+                        apr_uint64_t next_copy_id,
+                        svn_batch_fsync__t *batch,
+                        apr_pool_t *scratch_pool)
+{
+  const char *buf;
+  const char *name = svn_fs_fs__path_current(fs, scratch_pool);
+  const char *tmp_name;
+  apr_file_t *file;
+  svn_error_t *err;
+
+  buf = unparse_current(fs, rev, next_node_id, next_copy_id, scratch_pool);
+
+  /* Write the new contents to a temporary file next to 'current' and let
+     it be flushed together with everything else in BATCH. */
+  SVN_ERR(svn_io_open_unique_file3(NULL, &tmp_name,
+                                   svn_dirent_dirname(name, scratch_pool),
+                                   svn_io_file_del_none, scratch_pool,
+                                   scratch_pool));
+  err = svn_batch_fsync__open_file(&file, batch, tmp_name, scratch_pool);
+  if (!err)
+    err = svn_io_file_write_full(file, buf, strlen(buf), NULL,
+                                 scratch_pool);
+  if (!err)
+    err = svn_io_copy_perms(name, tmp_name, scratch_pool);
+  if (!err)
+    err = svn_batch_fsync__run(batch, scratch_pool);
+
+  /* Make the new contents visible. */
+  if (!err)
+    err = svn_io_file_rename2(tmp_name, name, FALSE, scratch_pool);
+
+  /* Don't leave the temporary file behind if we could not replace
+     'current' with it. */
+  if (err)
+    return svn_error_compose_create(err,
+                                    svn_io_remove_file2(tmp_name, TRUE,
+                                                        scratch_pool));
+
+  /* Make the new 'current' persistent. */
+  SVN_ERR(svn_batch_fsync__new_path(batch, name, scratch_pool));
+  SVN_ERR(svn_batch_fsync__run(batch, scratch_pool));
+
+  return SVN_NO_ERROR;
+}
+
 svn_error_t *
 svn_fs_fs__try_stringbuf_from_file(svn_stringbuf_t **content,
                                    svn_boolean_t *missing,
@@ -25,6 +25,7 @@
 
 #include "svn_fs.h"
 #include "id.h"
+#include "private/svn_batch_fsync.h"
 
 /* Functions for dealing with recoverable errors on mutable files
  *
@@ -347,6 +348,20 @@ svn_fs_fs__write_current(svn_fs_t *fs,
                          apr_uint64_t next_copy_id,
                          apr_pool_t *pool);
 
+/* Like svn_fs_fs__write_current but with the new 'current' contents
+   being written through BATCH.  All changes previously scheduled in BATCH
+   will be flushed to disk before the new 'current' file replaces the old
+   one; the replacement will be flushed to disk as well.  Hence, when this
+   function returns, BATCH has been run and is empty.
+   Perform temporary allocations in SCRATCH_POOL. */
+svn_error_t *
+svn_fs_fs__bump_current(svn_fs_t *fs,
+                        svn_revnum_t rev,
+                        apr_uint64_t next_node_id,
+                        apr_uint64_t next_copy_id,
+                        svn_batch_fsync__t *batch,
+                        apr_pool_t *scratch_pool);
+
 /* Read the file at PATH and return its content in *CONTENT. *CONTENT will
  * not be modified unless the whole file was read successfully.
  *
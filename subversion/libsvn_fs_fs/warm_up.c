@@ -0,0 +1,272 @@
+/* warm_up.c -- implements the svn_fs_fs__warm_caches private API.
+ *
+ * ====================================================================
+ *    Licensed to the Apache Software Foundation (ASF) under one
+ *    or more contributor license agreements.  See the NOTICE file
+ *    distributed with this work for additional information
+ *    regarding copyright ownership.  The ASF licenses this file
+ *    to you under the Apache License, Version 2.0 (the
+ *    "License"); you may not use this file except in compliance
+ *    with the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing,
+ *    software distributed under the License is distributed on an
+ *    "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *    KIND, either express or implied.  See the License for the
+ *    specific language governing permissions and limitations
+ *    under the License.
+ * ====================================================================
+ */
+
+#include "svn_dirent_uri.h"
+#include "svn_io.h"
+#include "svn_pools.h"
+#include "svn_string.h"
+
+#include "fs_fs.h"
+#include "cached_data.h"
+#include "id.h"
+
+#include "svn_private_config.h"
+
+/* All data access in this file goes through the regular cached_data.c
+ * functions.  Those will populate the noderev, directory, property,
+ * fulltext and window caches as a side-effect - which is all we want.
+ * If block-read is enabled for FS, they will also pull in and cache
+ * the items that surround the ones we explicitly ask for. */
+
+/* Read the node revision NODEREV in FS and all its contents such that
+ * they end up in the respective caches.  Directory listings are read
+ * but not recursed into.
+ * Use CANCEL_FUNC and CANCEL_BATON for cancellation while reading large
+ * file contents.  Use SCRATCH_POOL for temporary allocations.
+ */
+static svn_error_t *
+warm_node_contents(svn_fs_t *fs,
+                   node_revision_t *noderev,
+                   svn_cancel_func_t cancel_func,
+                   void *cancel_baton,
+                   apr_pool_t *scratch_pool)
+{
+  apr_hash_t *proplist;
+
+  if (noderev->kind == svn_node_dir)
+    {
+      apr_array_header_t *entries;
+      SVN_ERR(svn_fs_fs__rep_contents_dir(&entries, fs, noderev,
+                                          scratch_pool, scratch_pool));
+    }
+  else if (noderev->data_rep)
+    {
+      svn_stream_t *contents;
+
+      /* Reconstructing the fulltext will also cache the delta windows
+       * along the way. */
+      SVN_ERR(svn_fs_fs__get_contents(&contents, fs, noderev->data_rep,
+                                      TRUE, scratch_pool));
+      SVN_ERR(svn_stream_copy3(contents, svn_stream_empty(scratch_pool),
+                               cancel_func, cancel_baton, scratch_pool));
+    }
+
+  SVN_ERR(svn_fs_fs__get_proplist(&proplist, fs, noderev, scratch_pool));
+
+  return SVN_NO_ERROR;
+}
+
+/* Warm the caches in FS for the node ID and, if it is a directory, all
+ * nodes below it - as long as they have been created in revision REV.
+ * Use SCRATCH_POOL for temporary allocations.
+ */
+static svn_error_t *
+warm_revision_tree(svn_fs_t *fs,
+                   const svn_fs_id_t *id,
+                   svn_revnum_t rev,
+                   svn_cancel_func_t cancel_func,
+                   void *cancel_baton,
+                   apr_pool_t *scratch_pool)
+{
+  node_revision_t *noderev;
+
+  /* Older nodes will be covered by older revisions, if at all. */
+  if (svn_fs_fs__id_rev(id) != rev)
+    return SVN_NO_ERROR;
+
+  if (cancel_func)
+    SVN_ERR(cancel_func(cancel_baton));
+
+  SVN_ERR(svn_fs_fs__get_node_revision(&noderev, fs, id, scratch_pool,
+                                       scratch_pool));
+  SVN_ERR(warm_node_contents(fs, noderev, cancel_func, cancel_baton,
+                             scratch_pool));
+
+  if (noderev->kind == svn_node_dir)
+    {
+      apr_array_header_t *entries;
+      apr_pool_t *iterpool = svn_pool_create(scratch_pool);
+      int i;
+
+      /* This will be a cache hit now. */
+      SVN_ERR(svn_fs_fs__rep_contents_dir(&entries, fs, noderev,
+                                          scratch_pool, scratch_pool));
+      for (i = 0; i < entries->nelts; i++)
+        {
+          const svn_fs_dirent_t *dirent
+            = APR_ARRAY_IDX(entries, i, svn_fs_dirent_t *);
+
+          svn_pool_clear(iterpool);
+          SVN_ERR(warm_revision_tree(fs, dirent->id, rev, cancel_func,
+                                     cancel_baton, iterpool));
+        }
+
+      svn_pool_destroy(iterpool);
+    }
+
+  return SVN_NO_ERROR;
+}
+
+/* Warm the caches in FS for revision REV: its changed paths list as well
+ * as all nodes that were created in it.
+ * Use SCRATCH_POOL for temporary allocations.
+ */
+static svn_error_t *
+warm_revision(svn_fs_t *fs,
+              svn_revnum_t rev,
+              svn_cancel_func_t cancel_func,
+              void *cancel_baton,
+              apr_pool_t *scratch_pool)
+{
+  apr_pool_t *iterpool = svn_pool_create(scratch_pool);
+  svn_fs_fs__changes_context_t *context;
+  svn_fs_id_t *root_id;
+
+  SVN_ERR(svn_fs_fs__create_changes_context(&context, fs, rev,
+                                            scratch_pool));
+  while (!context->eol)
+    {
+      apr_array_header_t *changes;
+
+      svn_pool_clear(iterpool);
+      SVN_ERR(svn_fs_fs__get_changes(&changes, context, iterpool, iterpool));
+    }
+
+  svn_pool_clear(iterpool);
+  SVN_ERR(svn_fs_fs__rev_get_root(&root_id, fs, rev, scratch_pool,
+                                  iterpool));
+  SVN_ERR(warm_revision_tree(fs, root_id, rev, cancel_func, cancel_baton,
+                             iterpool));
+
+  svn_pool_destroy(iterpool);
+
+  return SVN_NO_ERROR;
+}
+
+/* Warm the caches in FS for PATH in revision REV, i.e. the path to it
+ * from the root directory plus the node itself.  Silently ignore paths
+ * that don't exist in REV.
+ * Use SCRATCH_POOL for temporary allocations.
+ */
+static svn_error_t *
+warm_path(svn_fs_t *fs,
+          svn_revnum_t rev,
+          const char *path,
+          svn_cancel_func_t cancel_func,
+          void *cancel_baton,
+          apr_pool_t *scratch_pool)
+{
+  svn_fs_id_t *id;
+  node_revision_t *noderev;
+  apr_array_header_t *components;
+  int i;
+
+  path = svn_relpath_canonicalize(path[0] == '/' ? path + 1 : path,
+                                  scratch_pool);
+  components = svn_cstring_split(path, "/", FALSE, scratch_pool);
+
+  SVN_ERR(svn_fs_fs__rev_get_root(&id, fs, rev, scratch_pool,
+                                  scratch_pool));
+  SVN_ERR(svn_fs_fs__get_node_revision(&noderev, fs, id, scratch_pool,
+                                       scratch_pool));
+
+  for (i = 0; i < components->nelts; i++)
+    {
+      const char *name = APR_ARRAY_IDX(components, i, const char *);
+      svn_fs_dirent_t *dirent;
+
+      if (noderev->kind != svn_node_dir)
+        return SVN_NO_ERROR;
+
+      SVN_ERR(svn_fs_fs__rep_contents_dir_entry(&dirent, fs, noderev, name,
+                                                scratch_pool,
+                                                scratch_pool));
+      if (dirent == NULL)
+        return SVN_NO_ERROR;
+
+      SVN_ERR(svn_fs_fs__get_node_revision(&noderev, fs, dirent->id,
+                                           scratch_pool, scratch_pool));
+    }
+
+  return svn_error_trace(warm_node_contents(fs, noderev, cancel_func,
+                                            cancel_baton, scratch_pool));
+}
+
+svn_error_t *
+svn_fs_fs__warm_caches(svn_fs_t *fs,
+                       svn_revnum_t start_rev,
+                       svn_revnum_t end_rev,
+                       const apr_array_header_t *paths,
+                       svn_fs_progress_notify_func_t progress_func,
+                       void *progress_baton,
+                       svn_cancel_func_t cancel_func,
+                       void *cancel_baton,
+                       apr_pool_t *scratch_pool)
+{
+  apr_pool_t *iterpool = svn_pool_create(scratch_pool);
+  svn_revnum_t youngest;
+  svn_revnum_t rev;
+  int i;
+
+  SVN_ERR(svn_fs_fs__youngest_rev(&youngest, fs, scratch_pool));
+
+  if (start_rev == SVN_INVALID_REVNUM)
+    start_rev = 0;
+  if (end_rev == SVN_INVALID_REVNUM)
+    end_rev = youngest;
+
+  if (end_rev > youngest)
+    return svn_error_createf(SVN_ERR_FS_NO_SUCH_REVISION, NULL,
+                             _("No such revision %ld"), end_rev);
+
+  /* Oldest revisions first.  The newest ones are most likely to be
+   * requested, so they should be the last ones to enter the caches and
+   * thus be the last ones to get evicted if the caches are too small for
+   * all.  Also, reading forward matches the on-disk order. */
+  for (rev = start_rev; rev <= end_rev; rev++)
+    {
+      svn_pool_clear(iterpool);
+
+      if (progress_func)
+        progress_func(rev, progress_baton, iterpool);
+
+      SVN_ERR(warm_revision(fs, rev, cancel_func, cancel_baton, iterpool));
+    }
+
+  /* Paths of interest are being looked up in HEAD. */
+  for (i = 0; paths && i < paths->nelts; i++)
+    {
+      const char *path = APR_ARRAY_IDX(paths, i, const char *);
+
+      svn_pool_clear(iterpool);
+
+      if (cancel_func)
+        SVN_ERR(cancel_func(cancel_baton));
+
+      SVN_ERR(warm_path(fs, youngest, path, cancel_func, cancel_baton,
+                        iterpool));
+    }
+
+  svn_pool_destroy(iterpool);
+
+  return SVN_NO_ERROR;
+}
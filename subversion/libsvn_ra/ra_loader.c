@@ -944,6 +944,76 @@ svn_error_t *svn_ra_stat(svn_ra_session_t *session,
   return SVN_NO_ERROR;
 }
 
+svn_error_t *
+svn_ra__stat_many(svn_ra_session_t *session,
+                  apr_array_header_t **dirents,
+                  const apr_array_header_t *paths,
+                  svn_revnum_t revision,
+                  apr_pool_t *result_pool,
+                  apr_pool_t *scratch_pool)
+{
+  int i;
+
+  for (i = 0; i < paths->nelts; i++)
+    SVN_ERR_ASSERT(svn_relpath_is_canonical(APR_ARRAY_IDX(paths, i,
+                                                          const char *)));
+
+  if (session->vtable->stat_many)
+    return svn_error_trace(session->vtable->stat_many(session, dirents,
+                                                      paths, revision,
+                                                      result_pool,
+                                                      scratch_pool));
+
+  *dirents = apr_array_make(result_pool, paths->nelts,
+                            sizeof(svn_dirent_t *));
+  for (i = 0; i < paths->nelts; i++)
+    {
+      svn_dirent_t *dirent;
+
+      SVN_ERR(svn_ra_stat(session, APR_ARRAY_IDX(paths, i, const char *),
+                          revision, &dirent, result_pool));
+      APR_ARRAY_PUSH(*dirents, svn_dirent_t *) = dirent;
+    }
+
+  return SVN_NO_ERROR;
+}
+
+svn_error_t *
+svn_ra__get_dir_many(svn_ra_session_t *session,
+                     apr_array_header_t **dirents,
+                     const apr_array_header_t *paths,
+                     svn_revnum_t revision,
+                     apr_uint32_t dirent_fields,
+                     apr_pool_t *result_pool,
+                     apr_pool_t *scratch_pool)
+{
+  int i;
+
+  for (i = 0; i < paths->nelts; i++)
+    SVN_ERR_ASSERT(svn_relpath_is_canonical(APR_ARRAY_IDX(paths, i,
+                                                          const char *)));
+
+  if (session->vtable->get_dir_many)
+    return svn_error_trace(session->vtable->get_dir_many(session, dirents,
+                                                         paths, revision,
+                                                         dirent_fields,
+                                                         result_pool,
+                                                         scratch_pool));
+
+  *dirents = apr_array_make(result_pool, paths->nelts, sizeof(apr_hash_t *));
+  for (i = 0; i < paths->nelts; i++)
+    {
+      apr_hash_t *entries;
+
+      SVN_ERR(svn_ra_get_dir2(session, &entries, NULL, NULL,
+                              APR_ARRAY_IDX(paths, i, const char *),
+                              revision, dirent_fields, result_pool));
+      APR_ARRAY_PUSH(*dirents, apr_hash_t *) = entries;
+    }
+
+  return SVN_NO_ERROR;
+}
+
 svn_error_t *svn_ra_get_uuid2(svn_ra_session_t *session,
                               const char **uuid,
                               apr_pool_t *pool)
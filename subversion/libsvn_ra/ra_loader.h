@@ -380,6 +380,25 @@ typedef struct svn_ra__vtable_t {
     void *replay_baton,
     apr_pool_t *scratch_pool);
 
+  /* See svn_ra__stat_many().  May be NULL, in which case the loader
+     falls back to calling stat() for each path. */
+  svn_error_t *(*stat_many)(svn_ra_session_t *session,
+                            apr_array_header_t **dirents,
+                            const apr_array_header_t *paths,
+                            svn_revnum_t revision,
+                            apr_pool_t *result_pool,
+                            apr_pool_t *scratch_pool);
+
+  /* See svn_ra__get_dir_many().  May be NULL, in which case the loader
+     falls back to calling get_dir() for each path. */
+  svn_error_t *(*get_dir_many)(svn_ra_session_t *session,
+                               apr_array_header_t **dirents,
+                               const apr_array_header_t *paths,
+                               svn_revnum_t revision,
+                               apr_uint32_t dirent_fields,
+                               apr_pool_t *result_pool,
+                               apr_pool_t *scratch_pool);
+
 } svn_ra__vtable_t;
 
 /* The RA session object. */
@@ -150,6 +150,15 @@ load_http_auth_types(apr_pool_t *pool, svn_config_t *config,
    runtime configuration variable. */
 #define DEFAULT_HTTP_TIMEOUT 600
 
+/* Whether we offer http/2 to the server if the "http-use-http2" runtime
+   configuration variable is not set.  Serf's http/2 support is still
+   young, so this is opt-in except for test builds. */
+#ifdef SVN__SERF_TEST_HTTP2
+#define DEFAULT_HTTP2_ENABLED TRUE
+#else
+#define DEFAULT_HTTP2_ENABLED FALSE
+#endif
+
 static svn_error_t *
 load_config(svn_ra_serf__session_t *session,
             apr_hash_t *config_hash,
@@ -251,6 +260,12 @@ load_config(svn_ra_serf__session_t *session,
                                   SVN_CONFIG_OPTION_HTTP_CHUNKED_REQUESTS,
                                   "auto", svn_tristate_unknown));
 
+  /* Should we negotiate http/2 for https connections. */
+  SVN_ERR(svn_config_get_bool(config, &session->http2_enabled,
+                              SVN_CONFIG_SECTION_GLOBAL,
+                              SVN_CONFIG_OPTION_HTTP_USE_HTTP2,
+                              DEFAULT_HTTP2_ENABLED));
+
 #if SERF_VERSION_AT_LEAST(1, 4, 0) && !defined(SVN_SERF_NO_LOGGING)
   SVN_ERR(svn_config_get_int64(config, &log_components,
                                SVN_CONFIG_SECTION_GLOBAL,
@@ -318,6 +333,12 @@ load_config(svn_ra_serf__session_t *session,
                                       SVN_CONFIG_OPTION_HTTP_CHUNKED_REQUESTS,
                                       "auto", chunked_requests));
 
+      /* Should we negotiate http/2, overriding global values. */
+      SVN_ERR(svn_config_get_bool(config, &session->http2_enabled,
+                                  server_group,
+                                  SVN_CONFIG_OPTION_HTTP_USE_HTTP2,
+                                  session->http2_enabled));
+
 #if SERF_VERSION_AT_LEAST(1, 4, 0) && !defined(SVN_SERF_NO_LOGGING)
       SVN_ERR(svn_config_get_int64(config, &log_components,
                                    server_group,
@@ -647,6 +668,7 @@ ra_serf_dup_session(svn_ra_session_t *new_session,
   /* using_compression */
   /* http10 */
   /* http20 */
+  /* http2_enabled */
   /* using_chunked_requests */
   /* detect_chunking */
 
@@ -762,6 +784,7 @@ ra_serf_dup_session(svn_ra_session_t *new_session,
   /* supports_rev_rsrc_replay */
   /* supports_svndiff1 */
   /* supports_svndiff2 */
+  /* supports_svndiff3 */
   /* supports_put_result_checksum */
   /* conn_latency */
 
@@ -1070,7 +1093,9 @@ static const svn_ra__vtable_t serf_vtable = {
   svn_ra_serf__list,
   svn_ra_serf__register_editor_shim_callbacks,
   NULL /* commit_ev2 */,
-  NULL /* replay_range_ev2 */
+  NULL /* replay_range_ev2 */,
+  NULL /* stat_many */,
+  NULL /* get_dir_many */
 };
 
 svn_error_t *
@@ -555,6 +555,11 @@ create_file_baton(file_baton_t **new_file,
 static svn_error_t *
 open_connection_if_needed(svn_ra_serf__session_t *sess, int num_active_reqs)
 {
+  /* With http/2 all requests are multiplexed over the main connection,
+     see get_best_connection(). */
+  if (sess->http20 && sess->max_connections > 2)
+    return SVN_NO_ERROR;
+
   /* For each REQS_PER_CONN outstanding requests open a new connection, with
    * a minimum of 1 extra connection. */
   if (sess->num_conns == 1 ||
@@ -608,6 +613,13 @@ get_best_connection(report_context_t *ctx)
   if (ctx->report_received && (ctx->sess->max_connections > 2))
     first_conn = 0;
 
+  /* An http/2 connection interleaves the responses of all requests sent
+     over it, so the fetches don't have to wait for the REPORT response.
+     The max_connections limit from above still applies, because it asks
+     for the fetches to be kept apart from the REPORT. */
+  if (ctx->sess->http20 && (ctx->sess->max_connections > 2))
+    return ctx->sess->conns[0];
+
   /* If there's only one available auxiliary connection to use, don't bother
      doing all the cur_conn math -- just return that one connection.  */
   if (ctx->sess->num_conns - first_conn == 1)
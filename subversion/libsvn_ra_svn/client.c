@@ -747,7 +747,7 @@ static svn_error_t *open_session(svn_ra_svn__session_baton_t **sess_p,
    * capability list, and the URL, and subsequently there is an auth
    * request. */
   /* Client-side capabilities list: */
-  SVN_ERR(svn_ra_svn__write_tuple(conn, pool, "n(wwwwwww)cc(?c)",
+  SVN_ERR(svn_ra_svn__write_tuple(conn, pool, "n(wwwwwww?w)cc(?c)",
                                   (apr_uint64_t) 2,
                                   SVN_RA_SVN_CAP_EDIT_PIPELINE,
                                   SVN_RA_SVN_CAP_SVNDIFF1,
@@ -756,6 +756,9 @@ static svn_error_t *open_session(svn_ra_svn__session_baton_t **sess_p,
                                   SVN_RA_SVN_CAP_DEPTH,
                                   SVN_RA_SVN_CAP_MERGEINFO,
                                   SVN_RA_SVN_CAP_LOG_REVPROPS,
+                                  svn__zstd_available()
+                                    ? SVN_RA_SVN_CAP_SVNDIFF3_ACCEPTED
+                                    : NULL,
                                   url,
                                   SVN_RA_SVN__DEFAULT_USERAGENT,
                                   client_string));
@@ -1542,44 +1545,16 @@ send_dirent_fields(svn_ra_svn_conn_t *conn,
   return SVN_NO_ERROR;
 }
 
-static svn_error_t *ra_svn_get_dir(svn_ra_session_t *session,
-                                   apr_hash_t **dirents,
-                                   svn_revnum_t *fetched_rev,
-                                   apr_hash_t **props,
-                                   const char *path,
-                                   svn_revnum_t rev,
-                                   apr_uint32_t dirent_fields,
-                                   apr_pool_t *pool)
+/* Set *DIRENTS to a hash mapping entry names to svn_dirent_t * for the
+   directory list DIRLIST of a get-dir response.  Allocate the result in
+   POOL. */
+static svn_error_t *
+parse_dirlist(apr_hash_t **dirents,
+              svn_ra_svn__list_t *dirlist,
+              apr_pool_t *pool)
 {
-  svn_ra_svn__session_baton_t *sess_baton = session->priv;
-  svn_ra_svn_conn_t *conn = sess_baton->conn;
-  svn_ra_svn__list_t *proplist, *dirlist;
   int i;
 
-  path = reparent_path(session, path, pool);
-  SVN_ERR(svn_ra_svn__write_tuple(conn, pool, "w(c(?r)bb(!", "get-dir", path,
-                                  rev, (props != NULL), (dirents != NULL)));
-  SVN_ERR(send_dirent_fields(conn, dirent_fields, pool));
-
-  /* Always send the, nominally optional, want-iprops as "false" to
-     workaround a bug in svnserve 1.8.0-1.8.8 that causes the server
-     to see "true" if it is omitted. */
-  SVN_ERR(svn_ra_svn__write_tuple(conn, pool, "!)b)", FALSE));
-
-  SVN_ERR(handle_auth_request(sess_baton, pool));
-  SVN_ERR(svn_ra_svn__read_cmd_response(conn, pool, "rll", &rev, &proplist,
-                                        &dirlist));
-
-  if (fetched_rev)
-    *fetched_rev = rev;
-  if (props)
-    SVN_ERR(svn_ra_svn__parse_proplist(proplist, pool, props));
-
-  /* We're done if dirents aren't wanted. */
-  if (!dirents)
-    return SVN_NO_ERROR;
-
-  /* Interpret the directory list. */
   *dirents = svn_hash__make(pool);
   for (i = 0; i < dirlist->nelts; i++)
     {
@@ -1628,6 +1603,63 @@ static svn_error_t *ra_svn_get_dir(svn_ra_session_t *session,
   return SVN_NO_ERROR;
 }
 
+/* Write a get-dir command for PATH in REV to CONN.  Ask for the directory
+   properties if WANT_PROPS is set and for the DIRENT_FIELDS of the
+   directory entries if WANT_CONTENTS is set.  Use POOL for temporary
+   allocations. */
+static svn_error_t *
+write_cmd_get_dir(svn_ra_svn_conn_t *conn,
+                  const char *path,
+                  svn_revnum_t rev,
+                  svn_boolean_t want_props,
+                  svn_boolean_t want_contents,
+                  apr_uint32_t dirent_fields,
+                  apr_pool_t *pool)
+{
+  SVN_ERR(svn_ra_svn__write_tuple(conn, pool, "w(c(?r)bb(!", "get-dir", path,
+                                  rev, want_props, want_contents));
+  SVN_ERR(send_dirent_fields(conn, dirent_fields, pool));
+
+  /* Always send the, nominally optional, want-iprops as "false" to
+     workaround a bug in svnserve 1.8.0-1.8.8 that causes the server
+     to see "true" if it is omitted. */
+  return svn_error_trace(svn_ra_svn__write_tuple(conn, pool, "!)b)",
+                                                 FALSE));
+}
+
+static svn_error_t *ra_svn_get_dir(svn_ra_session_t *session,
+                                   apr_hash_t **dirents,
+                                   svn_revnum_t *fetched_rev,
+                                   apr_hash_t **props,
+                                   const char *path,
+                                   svn_revnum_t rev,
+                                   apr_uint32_t dirent_fields,
+                                   apr_pool_t *pool)
+{
+  svn_ra_svn__session_baton_t *sess_baton = session->priv;
+  svn_ra_svn_conn_t *conn = sess_baton->conn;
+  svn_ra_svn__list_t *proplist, *dirlist;
+
+  path = reparent_path(session, path, pool);
+  SVN_ERR(write_cmd_get_dir(conn, path, rev, (props != NULL),
+                            (dirents != NULL), dirent_fields, pool));
+
+  SVN_ERR(handle_auth_request(sess_baton, pool));
+  SVN_ERR(svn_ra_svn__read_cmd_response(conn, pool, "rll", &rev, &proplist,
+                                        &dirlist));
+
+  if (fetched_rev)
+    *fetched_rev = rev;
+  if (props)
+    SVN_ERR(svn_ra_svn__parse_proplist(proplist, pool, props));
+
+  /* We're done if dirents aren't wanted. */
+  if (!dirents)
+    return SVN_NO_ERROR;
+
+  return svn_error_trace(parse_dirlist(dirents, dirlist, pool));
+}
+
 /* Converts a apr_uint64_t with values TRUE, FALSE or
    SVN_RA_SVN_UNSPECIFIED_NUMBER as provided by svn_ra_svn__parse_tuple
    to a svn_tristate_t */
@@ -2136,21 +2168,13 @@ static svn_error_t *handle_unsupported_cmd(svn_error_t *err,
 }
 
 
-static svn_error_t *ra_svn_stat(svn_ra_session_t *session,
-                                const char *path, svn_revnum_t rev,
-                                svn_dirent_t **dirent, apr_pool_t *pool)
+/* Set *DIRENT to the dirent described by the response LIST of a "stat"
+   command, or to NULL if LIST is NULL.  Allocate it in POOL. */
+static svn_error_t *
+parse_stat_response(svn_dirent_t **dirent,
+                    svn_ra_svn__list_t *list,
+                    apr_pool_t *pool)
 {
-  svn_ra_svn__session_baton_t *sess_baton = session->priv;
-  svn_ra_svn_conn_t *conn = sess_baton->conn;
-  svn_ra_svn__list_t *list = NULL;
-  svn_dirent_t *the_dirent;
-
-  path = reparent_path(session, path, pool);
-  SVN_ERR(svn_ra_svn__write_cmd_stat(conn, pool, path, rev));
-  SVN_ERR(handle_unsupported_cmd(handle_auth_request(sess_baton, pool),
-                                 N_("'stat' not implemented")));
-  SVN_ERR(svn_ra_svn__read_cmd_response(conn, pool, "(?l)", &list));
-
   if (! list)
     {
       *dirent = NULL;
@@ -2161,6 +2185,7 @@ static svn_error_t *ra_svn_stat(svn_ra_session_t *session,
       svn_boolean_t has_props;
       svn_revnum_t crev;
       apr_uint64_t size;
+      svn_dirent_t *the_dirent;
 
       SVN_ERR(svn_ra_svn__parse_tuple(list, "wnbr(?c)(?c)",
                                       &kind, &size, &has_props,
@@ -2180,6 +2205,340 @@ static svn_error_t *ra_svn_stat(svn_ra_session_t *session,
   return SVN_NO_ERROR;
 }
 
+static svn_error_t *ra_svn_stat(svn_ra_session_t *session,
+                                const char *path, svn_revnum_t rev,
+                                svn_dirent_t **dirent, apr_pool_t *pool)
+{
+  svn_ra_svn__session_baton_t *sess_baton = session->priv;
+  svn_ra_svn_conn_t *conn = sess_baton->conn;
+  svn_ra_svn__list_t *list = NULL;
+
+  path = reparent_path(session, path, pool);
+  SVN_ERR(svn_ra_svn__write_cmd_stat(conn, pool, path, rev));
+  SVN_ERR(handle_unsupported_cmd(handle_auth_request(sess_baton, pool),
+                                 N_("'stat' not implemented")));
+  SVN_ERR(svn_ra_svn__read_cmd_response(conn, pool, "(?l)", &list));
+
+  return svn_error_trace(parse_stat_response(dirent, list, pool));
+}
+
+/* Maximum number of commands that we send within a single pipeline
+   before reading their responses.  The server cannot read more commands
+   while its unread responses fill up the connection buffers, so this
+   keeps both sides from blocking on each other. */
+#define PIPELINE_DEPTH 64
+
+/* Return TRUE if ERR indicates that the connection itself failed, such
+   that no further responses can be read from it. */
+static svn_boolean_t
+is_connection_error(const svn_error_t *err)
+{
+  return err->apr_err == SVN_ERR_RA_SVN_CONNECTION_CLOSED
+      || err->apr_err == SVN_ERR_RA_SVN_IO_ERROR
+      || err->apr_err == SVN_ERR_RA_SVN_MALFORMED_DATA
+      || err->apr_err == SVN_ERR_CANCELLED;
+}
+
+/* Callbacks for run_pipelined().  Each works on the element at index I
+   of the PATHS given to it.  BATON is the baton given to run_pipelined(). */
+
+/* Write the command for PATH, which has already been made relative to
+   the session URL, to CONN. */
+typedef svn_error_t *(*pipeline_write_func_t)(svn_ra_svn_conn_t *conn,
+                                              const char *path,
+                                              void *baton,
+                                              apr_pool_t *scratch_pool);
+
+/* Read the response for element I from CONN and store the result. */
+typedef svn_error_t *(*pipeline_read_func_t)(svn_ra_svn_conn_t *conn,
+                                             int i,
+                                             void *baton,
+                                             apr_pool_t *result_pool,
+                                             apr_pool_t *scratch_pool);
+
+/* Perform the request for element I outside any pipeline, i.e. the way
+   it is done without pipelining, and store the result. */
+typedef svn_error_t *(*pipeline_single_func_t)(svn_ra_session_t *session,
+                                               int i,
+                                               void *baton,
+                                               apr_pool_t *result_pool);
+
+/* Perform one request per element of PATHS, an array of relpaths
+   relative to SESSION, sending them in pipelines of up to PIPELINE_DEPTH
+   commands.  Use WRITE_FUNC and READ_FUNC to write the commands and read
+   their responses.  Requests rejected within a pipeline because they
+   would need authentication are repeated through SINGLE_FUNC afterwards,
+   as are all requests if the server does not support pipelining.
+
+   Allocate the results in RESULT_POOL and use SCRATCH_POOL for temporary
+   allocations. */
+static svn_error_t *
+run_pipelined(svn_ra_session_t *session,
+              const apr_array_header_t *paths,
+              pipeline_write_func_t write_func,
+              pipeline_read_func_t read_func,
+              pipeline_single_func_t single_func,
+              void *baton,
+              apr_pool_t *result_pool,
+              apr_pool_t *scratch_pool)
+{
+  svn_ra_svn__session_baton_t *sess_baton = session->priv;
+  svn_ra_svn_conn_t *conn = sess_baton->conn;
+  apr_pool_t *iterpool;
+  apr_array_header_t *retries;
+  svn_error_t *first_err = SVN_NO_ERROR;
+  int start, i;
+
+  /* Older servers need one round trip per path. */
+  if (!svn_ra_svn_has_capability(conn, SVN_RA_SVN_CAP_PIPELINING))
+    {
+      for (i = 0; i < paths->nelts; i++)
+        SVN_ERR(single_func(session, i, baton, result_pool));
+
+      return SVN_NO_ERROR;
+    }
+
+  iterpool = svn_pool_create(scratch_pool);
+  retries = apr_array_make(scratch_pool, 0, sizeof(int));
+
+  for (start = 0; start < paths->nelts; start += PIPELINE_DEPTH)
+    {
+      int end = start + PIPELINE_DEPTH;
+
+      if (end > paths->nelts)
+        end = paths->nelts;
+
+      svn_pool_clear(iterpool);
+
+      /* Send the whole batch, then collect the responses in order. */
+      SVN_ERR(svn_ra_svn__write_cmd_begin_pipeline(conn, iterpool));
+      for (i = start; i < end; i++)
+        {
+          const char *path = APR_ARRAY_IDX(paths, i, const char *);
+
+          SVN_ERR(write_func(conn, reparent_path(session, path, iterpool),
+                             baton, iterpool));
+        }
+      SVN_ERR(svn_ra_svn__write_cmd_end_pipeline(conn, iterpool));
+
+      SVN_ERR(handle_auth_request(sess_baton, iterpool));
+      SVN_ERR(svn_ra_svn__read_cmd_response(conn, iterpool, ""));
+
+      for (i = start; i < end; i++)
+        {
+          svn_error_t *err;
+
+          err = handle_auth_request(sess_baton, iterpool);
+          if (!err)
+            err = read_func(conn, i, baton, result_pool, iterpool);
+
+          if (err && is_connection_error(err))
+            {
+              svn_error_clear(first_err);
+              return svn_error_trace(err);
+            }
+
+          /* The server did not ask for authentication within the
+             pipeline.  Retry those paths once we are done with it. */
+          if (err && svn_error_find_cause(err, SVN_ERR_RA_NOT_AUTHORIZED))
+            {
+              svn_error_clear(err);
+              APR_ARRAY_PUSH(retries, int) = i;
+            }
+          else if (err)
+            {
+              /* Keep reading so that the connection stays in sync. */
+              if (first_err)
+                svn_error_clear(err);
+              else
+                first_err = err;
+            }
+        }
+
+      SVN_ERR(handle_auth_request(sess_baton, iterpool));
+      SVN_ERR(svn_ra_svn__read_cmd_response(conn, iterpool, ""));
+
+      if (first_err)
+        break;
+    }
+
+  svn_pool_destroy(iterpool);
+  SVN_ERR(first_err);
+
+  /* These may require an authentication exchange. */
+  for (i = 0; i < retries->nelts; i++)
+    SVN_ERR(single_func(session, APR_ARRAY_IDX(retries, i, int), baton,
+                        result_pool));
+
+  return SVN_NO_ERROR;
+}
+
+/* Baton for the run_pipelined() callbacks of ra_svn_stat_many() and
+   ra_svn_get_dir_many(). */
+typedef struct many_baton_t
+{
+  const apr_array_header_t *paths;
+  svn_revnum_t revision;
+
+  /* Only used by ra_svn_get_dir_many(). */
+  apr_uint32_t dirent_fields;
+
+  /* The results, one element per path. */
+  apr_array_header_t *results;
+} many_baton_t;
+
+/* Implements pipeline_write_func_t for ra_svn_stat_many(). */
+static svn_error_t *
+write_stat(svn_ra_svn_conn_t *conn,
+           const char *path,
+           void *baton,
+           apr_pool_t *scratch_pool)
+{
+  many_baton_t *b = baton;
+
+  return svn_error_trace(svn_ra_svn__write_cmd_stat(conn, scratch_pool,
+                                                    path, b->revision));
+}
+
+/* Implements pipeline_read_func_t for ra_svn_stat_many(). */
+static svn_error_t *
+read_stat(svn_ra_svn_conn_t *conn,
+          int i,
+          void *baton,
+          apr_pool_t *result_pool,
+          apr_pool_t *scratch_pool)
+{
+  many_baton_t *b = baton;
+  svn_ra_svn__list_t *list = NULL;
+
+  SVN_ERR(svn_ra_svn__read_cmd_response(conn, scratch_pool, "(?l)", &list));
+
+  return svn_error_trace(parse_stat_response(&APR_ARRAY_IDX(b->results, i,
+                                                            svn_dirent_t *),
+                                             list, result_pool));
+}
+
+/* Implements pipeline_single_func_t for ra_svn_stat_many(). */
+static svn_error_t *
+single_stat(svn_ra_session_t *session,
+            int i,
+            void *baton,
+            apr_pool_t *result_pool)
+{
+  many_baton_t *b = baton;
+
+  return svn_error_trace(svn_ra_stat(session,
+                                     APR_ARRAY_IDX(b->paths, i,
+                                                   const char *),
+                                     b->revision,
+                                     &APR_ARRAY_IDX(b->results, i,
+                                                    svn_dirent_t *),
+                                     result_pool));
+}
+
+static svn_error_t *
+ra_svn_stat_many(svn_ra_session_t *session,
+                 apr_array_header_t **dirents,
+                 const apr_array_header_t *paths,
+                 svn_revnum_t revision,
+                 apr_pool_t *result_pool,
+                 apr_pool_t *scratch_pool)
+{
+  many_baton_t b = { 0 };
+
+  b.paths = paths;
+  b.revision = revision;
+  b.results = apr_array_make(result_pool, paths->nelts,
+                             sizeof(svn_dirent_t *));
+  while (b.results->nelts < paths->nelts)
+    APR_ARRAY_PUSH(b.results, svn_dirent_t *) = NULL;
+
+  SVN_ERR(run_pipelined(session, paths, write_stat, read_stat, single_stat,
+                        &b, result_pool, scratch_pool));
+
+  *dirents = b.results;
+  return SVN_NO_ERROR;
+}
+
+/* Implements pipeline_write_func_t for ra_svn_get_dir_many(). */
+static svn_error_t *
+write_get_dir(svn_ra_svn_conn_t *conn,
+              const char *path,
+              void *baton,
+              apr_pool_t *scratch_pool)
+{
+  many_baton_t *b = baton;
+
+  return svn_error_trace(write_cmd_get_dir(conn, path, b->revision,
+                                           FALSE, TRUE, b->dirent_fields,
+                                           scratch_pool));
+}
+
+/* Implements pipeline_read_func_t for ra_svn_get_dir_many(). */
+static svn_error_t *
+read_get_dir(svn_ra_svn_conn_t *conn,
+             int i,
+             void *baton,
+             apr_pool_t *result_pool,
+             apr_pool_t *scratch_pool)
+{
+  many_baton_t *b = baton;
+  svn_ra_svn__list_t *proplist, *dirlist;
+  svn_revnum_t rev;
+
+  SVN_ERR(svn_ra_svn__read_cmd_response(conn, scratch_pool, "rll", &rev,
+                                        &proplist, &dirlist));
+
+  return svn_error_trace(parse_dirlist(&APR_ARRAY_IDX(b->results, i,
+                                                      apr_hash_t *),
+                                       dirlist, result_pool));
+}
+
+/* Implements pipeline_single_func_t for ra_svn_get_dir_many(). */
+static svn_error_t *
+single_get_dir(svn_ra_session_t *session,
+               int i,
+               void *baton,
+               apr_pool_t *result_pool)
+{
+  many_baton_t *b = baton;
+
+  return svn_error_trace(svn_ra_get_dir2(session,
+                                         &APR_ARRAY_IDX(b->results, i,
+                                                        apr_hash_t *),
+                                         NULL, NULL,
+                                         APR_ARRAY_IDX(b->paths, i,
+                                                       const char *),
+                                         b->revision, b->dirent_fields,
+                                         result_pool));
+}
+
+static svn_error_t *
+ra_svn_get_dir_many(svn_ra_session_t *session,
+                    apr_array_header_t **dirents,
+                    const apr_array_header_t *paths,
+                    svn_revnum_t revision,
+                    apr_uint32_t dirent_fields,
+                    apr_pool_t *result_pool,
+                    apr_pool_t *scratch_pool)
+{
+  many_baton_t b = { 0 };
+
+  b.paths = paths;
+  b.revision = revision;
+  b.dirent_fields = dirent_fields;
+  b.results = apr_array_make(result_pool, paths->nelts,
+                             sizeof(apr_hash_t *));
+  while (b.results->nelts < paths->nelts)
+    APR_ARRAY_PUSH(b.results, apr_hash_t *) = NULL;
+
+  SVN_ERR(run_pipelined(session, paths, write_get_dir, read_get_dir,
+                        single_get_dir, &b, result_pool, scratch_pool));
+
+  *dirents = b.results;
+  return SVN_NO_ERROR;
+}
+
 
 static svn_error_t *ra_svn_get_locations(svn_ra_session_t *session,
                                          apr_hash_t **locations,
@@ -3300,7 +3659,9 @@ static const svn_ra__vtable_t ra_svn_vtable = {
   ra_svn_list,
   ra_svn_register_editor_shim_callbacks,
   NULL /* commit_ev2 */,
-  NULL /* replay_range_ev2 */
+  NULL /* replay_range_ev2 */,
+  ra_svn_stat_many,
+  ra_svn_get_dir_many
 };
 
 svn_error_t *
@@ -27,6 +27,7 @@
 #include <stdlib.h>
 
 #define APR_WANT_STRFUNC
+#define APR_WANT_IOVEC
 #include <apr_want.h>
 #include <apr_general.h>
 #include <apr_lib.h>
@@ -273,13 +274,17 @@ svn_ra_svn__svndiff_version(svn_ra_svn_conn_t *conn)
   if (svn_ra_svn_compression_level(conn) <= 0)
     return 0;
 
-  /* Prefer SVNDIFF2 over SVNDIFF1. */
+  /* Prefer SVNDIFF3 over SVNDIFF2 over SVNDIFF1.  We can only produce
+   * SVNDIFF3 if we have been built with zstd support. */
+  if (svn__zstd_available()
+      && svn_ra_svn_has_capability(conn, SVN_RA_SVN_CAP_SVNDIFF3_ACCEPTED))
+    return 3;
   if (svn_ra_svn_has_capability(conn, SVN_RA_SVN_CAP_SVNDIFF2_ACCEPTED))
     return 2;
   if (svn_ra_svn_has_capability(conn, SVN_RA_SVN_CAP_SVNDIFF1))
     return 1;
 
-  /* The connection does not support SVNDIFF1/2; default to "version 0". */
+  /* The connection does not support SVNDIFF1/2/3; default to "version 0". */
   return 0;
 }
 
@@ -363,14 +368,21 @@ check_io_limits(svn_ra_svn_conn_t *conn)
   return SVN_NO_ERROR;
 }
 
-/* Write data to socket or output file as appropriate. */
-static svn_error_t *writebuf_output(svn_ra_svn_conn_t *conn, apr_pool_t *pool,
-                                    const char *data, apr_size_t len)
+/* Write the NVEC buffers in VEC to socket or output file as appropriate.
+   The contents of VEC will be modified. */
+static svn_error_t *writebuf_outputv(svn_ra_svn_conn_t *conn,
+                                     apr_pool_t *pool,
+                                     struct iovec *vec,
+                                     int nvec)
 {
-  const char *end = data + len;
-  apr_size_t count;
+  apr_size_t len = 0;
+  apr_size_t count = 0;
   apr_pool_t *subpool = NULL;
   svn_ra_svn__session_baton_t *session = conn->session;
+  int i;
+
+  for (i = 0; i < nvec; i++)
+    len += vec[i].iov_len;
 
   /* Limit the size of the response, if a limit has been configured.
    * This is to limit the server load in case users e.g. accidentally ran
@@ -378,14 +390,26 @@ static svn_error_t *writebuf_output(svn_ra_svn_conn_t *conn, apr_pool_t *pool,
   conn->current_out += len;
   SVN_ERR(check_io_limits(conn));
 
-  while (data < end)
+  while (TRUE)
     {
-      count = end - data;
+      /* Skip over everything that has been written so far. */
+      while (nvec > 0 && count >= vec->iov_len)
+        {
+          count -= vec->iov_len;
+          vec++;
+          nvec--;
+        }
+
+      if (nvec == 0)
+        break;
+
+      vec->iov_base = (char *)vec->iov_base + count;
+      vec->iov_len -= count;
 
       if (session && session->callbacks && session->callbacks->cancel_func)
         SVN_ERR((session->callbacks->cancel_func)(session->callbacks_baton));
 
-      SVN_ERR(svn_ra_svn__stream_write(conn->stream, data, &count));
+      SVN_ERR(svn_ra_svn__stream_writev(conn->stream, vec, nvec, &count));
       if (count == 0)
         {
           if (!subpool)
@@ -394,7 +418,6 @@ static svn_error_t *writebuf_output(svn_ra_svn_conn_t *conn, apr_pool_t *pool,
             svn_pool_clear(subpool);
           SVN_ERR(conn->block_handler(conn, subpool, conn->block_baton));
         }
-      data += count;
 
       if (session)
         {
@@ -416,6 +439,18 @@ static svn_error_t *writebuf_output(svn_ra_svn_conn_t *conn, apr_pool_t *pool,
   return SVN_NO_ERROR;
 }
 
+/* Write data to socket or output file as appropriate. */
+static svn_error_t *writebuf_output(svn_ra_svn_conn_t *conn, apr_pool_t *pool,
+                                    const char *data, apr_size_t len)
+{
+  struct iovec vec;
+
+  vec.iov_base = (void *)data;
+  vec.iov_len = len;
+
+  return writebuf_outputv(conn, pool, &vec, 1);
+}
+
 /* Write data from the write buffer out to the socket. */
 static svn_error_t *writebuf_flush(svn_ra_svn_conn_t *conn, apr_pool_t *pool)
 {
@@ -430,13 +465,21 @@ static svn_error_t *writebuf_flush(svn_ra_svn_conn_t *conn, apr_pool_t *pool)
 static svn_error_t *writebuf_write(svn_ra_svn_conn_t *conn, apr_pool_t *pool,
                                    const char *data, apr_size_t len)
 {
-  /* data >= 8k is sent immediately */
-  if (len >= sizeof(conn->write_buf) / 2)
+  /* data >= 4k is not copied but sent immediately, together with the
+     buffered data in a single gather write.  This is what happens to
+     file contents, e.g. during checkouts. */
+  if (len >= SVN_RA_SVN__PAGE_SIZE)
     {
-      if (conn->write_pos > 0)
-        SVN_ERR(writebuf_flush(conn, pool));
+      struct iovec vec[2];
+
+      vec[0].iov_base = conn->write_buf;
+      vec[0].iov_len = conn->write_pos;
+      vec[1].iov_base = (void *)data;
+      vec[1].iov_len = len;
 
-      return writebuf_output(conn, pool, data, len);
+      /* Clear conn->write_pos first in case the block handler does a read. */
+      conn->write_pos = 0;
+      return writebuf_outputv(conn, pool, vec, 2);
     }
 
   /* ensure room for the data to add */
@@ -2744,6 +2787,20 @@ svn_ra_svn__write_cmd_finish_replay(svn_ra_svn_conn_t *conn,
   return writebuf_write_literal(conn, pool, "( finish-replay ( ) ) ");
 }
 
+svn_error_t *
+svn_ra_svn__write_cmd_begin_pipeline(svn_ra_svn_conn_t *conn,
+                                     apr_pool_t *pool)
+{
+  return writebuf_write_literal(conn, pool, "( begin-pipeline ( ) ) ");
+}
+
+svn_error_t *
+svn_ra_svn__write_cmd_end_pipeline(svn_ra_svn_conn_t *conn,
+                                   apr_pool_t *pool)
+{
+  return writebuf_write_literal(conn, pool, "( end-pipeline ( ) ) ");
+}
+
 svn_error_t *svn_ra_svn__write_cmd_response(svn_ra_svn_conn_t *conn,
                                             apr_pool_t *pool,
                                             const char *fmt, ...)
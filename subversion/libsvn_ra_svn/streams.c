@@ -42,6 +42,11 @@ struct svn_ra_svn__stream_st {
   svn_stream_t *out_stream;
   void *timeout_baton;
   ra_svn_timeout_fn_t timeout_fn;
+
+  /* The socket or file that OUT_STREAM writes to, if known.  Used for
+     gather writes.  At most one of them is set. */
+  apr_socket_t *out_sock;
+  apr_file_t *out_file;
 };
 
 typedef struct sock_baton_t {
@@ -88,11 +93,16 @@ svn_ra_svn__stream_from_streams(svn_stream_t *in_stream,
      The callback is used to make the write non-blocking on
      some error scenarios. ### This (legacy) usage
      breaks the stream promise */
+  svn_ra_svn__stream_t *s;
+
   file = svn_stream__aprfile(out_stream);
 
-  return svn_ra_svn__stream_create(in_stream, out_stream,
-                                   file, file_timeout_cb,
-                                   pool);
+  s = svn_ra_svn__stream_create(in_stream, out_stream,
+                                file, file_timeout_cb,
+                                pool);
+  s->out_file = file;
+
+  return s;
 }
 
 /* Functions to implement a socket backed svn_ra_svn__stream_t. */
@@ -167,6 +177,7 @@ svn_ra_svn__stream_from_sock(apr_socket_t *sock,
 {
   sock_baton_t *b = apr_palloc(result_pool, sizeof(*b));
   svn_stream_t *sock_stream;
+  svn_ra_svn__stream_t *s;
 
   b->sock = sock;
   b->pool = svn_pool_create(result_pool);
@@ -177,8 +188,11 @@ svn_ra_svn__stream_from_sock(apr_socket_t *sock,
   svn_stream_set_write(sock_stream, sock_write_cb);
   svn_stream_set_data_available(sock_stream, sock_pending_cb);
 
-  return svn_ra_svn__stream_create(sock_stream, sock_stream,
-                                   b, sock_timeout_cb, result_pool);
+  s = svn_ra_svn__stream_create(sock_stream, sock_stream,
+                                b, sock_timeout_cb, result_pool);
+  s->out_sock = sock;
+
+  return s;
 }
 
 svn_ra_svn__stream_t *
@@ -193,6 +207,8 @@ svn_ra_svn__stream_create(svn_stream_t *in_stream,
   s->out_stream = out_stream;
   s->timeout_baton = timeout_baton;
   s->timeout_fn = timeout_cb;
+  s->out_sock = NULL;
+  s->out_file = NULL;
   return s;
 }
 
@@ -203,6 +219,48 @@ svn_ra_svn__stream_write(svn_ra_svn__stream_t *stream,
   return svn_error_trace(svn_stream_write(stream->out_stream, data, len));
 }
 
+svn_error_t *
+svn_ra_svn__stream_writev(svn_ra_svn__stream_t *stream,
+                          const struct iovec *vec,
+                          int nvec,
+                          apr_size_t *len)
+{
+  apr_status_t status;
+  int i;
+
+  if (stream->out_sock)
+    {
+      status = apr_socket_sendv(stream->out_sock, vec, nvec, len);
+      if (status)
+        return svn_error_wrap_apr(status, _("Can't write to connection"));
+
+      return SVN_NO_ERROR;
+    }
+
+  if (stream->out_file)
+    {
+      status = apr_file_writev(stream->out_file, vec, nvec, len);
+      if (status)
+        return svn_error_wrap_apr(status, _("Can't write to connection"));
+
+      return SVN_NO_ERROR;
+    }
+
+  /* Other streams, e.g. SASL-encrypted ones, take one buffer at a time. */
+  *len = 0;
+  for (i = 0; i < nvec; i++)
+    {
+      apr_size_t count = vec[i].iov_len;
+
+      SVN_ERR(svn_stream_write(stream->out_stream, vec[i].iov_base, &count));
+      *len += count;
+      if (count < vec[i].iov_len)
+        break;
+    }
+
+  return SVN_NO_ERROR;
+}
+
 svn_error_t *
 svn_ra_svn__stream_read(svn_ra_svn__stream_t *stream, char *data,
                         apr_size_t *len)
@@ -45,6 +45,7 @@
 #include "private/svn_utf_private.h"
 #include "private/svn_cache.h"
 #include "private/svn_fspath.h"
+#include "private/svn_task.h"
 
 #define ARE_VALID_COPY_ARGS(p,r) ((p) && SVN_IS_VALID_REVNUM(r))
 
@@ -2459,10 +2460,355 @@ report_error(svn_revnum_t revision,
     }
 }
 
+/* Report the outcome VERIFY_ERR of verifying revision REV.  Cancellation
+ * is returned immediately.  Other errors are passed to VERIFY_CALLBACK with
+ * VERIFY_BATON, if given.  Otherwise, tell NOTIFY_FUNC with NOTIFY_BATON
+ * that we are done with REV, using the pre-allocated NOTIFY structure.
+ * Use SCRATCH_POOL for temporary allocations.
+ */
+static svn_error_t *
+finish_revision(svn_revnum_t rev,
+                svn_error_t *verify_err,
+                svn_repos_notify_func_t notify_func,
+                void *notify_baton,
+                svn_repos_notify_t *notify,
+                svn_repos_verify_callback_t verify_callback,
+                void *verify_baton,
+                apr_pool_t *scratch_pool)
+{
+  if (verify_err && verify_err->apr_err == SVN_ERR_CANCELLED)
+    {
+      return svn_error_trace(verify_err);
+    }
+  else if (verify_err)
+    {
+      SVN_ERR(report_error(rev, verify_err, verify_callback, verify_baton,
+                           scratch_pool));
+    }
+  else if (notify_func)
+    {
+      /* Tell the caller that we're done with this revision. */
+      notify->revision = rev;
+      notify_func(notify_baton, notify, scratch_pool);
+    }
+
+  return SVN_NO_ERROR;
+}
+
+/* Concurrent verification:
+ *
+ * Once the backend-specific checks in svn_fs_verify() have been run,
+ * revisions can be verified independently from each other.  We use the
+ * svn_task__t framework with one task per revision.  These are grouped
+ * under batch tasks of VERIFY_BATCH_SIZE revisions each to limit the
+ * size of the task tree.
+ *
+ * The worker threads use their own svn_fs_t instances and do not report
+ * anything directly.  Instead, they record notifications and the error
+ * for their revision.  The output function passes those on from the main
+ * thread and in revision order.
+ */
+#define VERIFY_BATCH_SIZE 1024
+
+/* Data shared by all verification tasks. */
+typedef struct verify_task_context_t
+{
+  /* As passed to svn_repos_verify_fs4(). */
+  svn_revnum_t start_rev;
+  svn_boolean_t check_normalization;
+  svn_repos_notify_func_t notify_func;
+  void *notify_baton;
+  svn_repos_verify_callback_t verify_callback;
+  void *verify_baton;
+
+  /* Pre-allocated notification to use with NOTIFY_FUNC. */
+  svn_repos_notify_t *notify;
+
+  /* Repository to open in each worker thread. */
+  const char *fs_path;
+  apr_hash_t *fs_config;
+} verify_task_context_t;
+
+/* Process baton for the root and batch tasks as well as for the tasks
+ * verifying individual revisions. */
+typedef struct verify_task_baton_t
+{
+  /* Context data.  Workers must not use the notification and callback
+     members. */
+  const verify_task_context_t *context;
+
+  /* Verify revisions FIRST to LAST, inclusive. */
+  svn_revnum_t first;
+  svn_revnum_t last;
+} verify_task_baton_t;
+
+/* Recorded outcome of verifying a single revision. */
+typedef struct verify_task_result_t
+{
+  /* The revision that was verified. */
+  svn_revnum_t revision;
+
+  /* Verification error or SVN_NO_ERROR. */
+  svn_error_t *err;
+
+  /* Notifications sent during the verification, as svn_repos_notify_t *.
+   * NULL, if the caller does not want notifications. */
+  apr_array_header_t *notifications;
+} verify_task_result_t;
+
+/* Implements svn_repos_notify_func_t.
+ * Append a copy of NOTIFY to the notifications recorded in the
+ * verify_task_result_t given as BATON.
+ */
+static void
+record_notification(void *baton,
+                    const svn_repos_notify_t *notify,
+                    apr_pool_t *scratch_pool)
+{
+  verify_task_result_t *result = baton;
+  apr_pool_t *pool = result->notifications->pool;
+  svn_repos_notify_t *copy = apr_pmemdup(pool, notify, sizeof(*notify));
+
+  copy->warning_str = apr_pstrdup(pool, notify->warning_str);
+  copy->path = apr_pstrdup(pool, notify->path);
+
+  APR_ARRAY_PUSH(result->notifications, svn_repos_notify_t *) = copy;
+}
+
+/* Pool cleanup function making sure we don't leak the error in the
+ * verify_task_result_t given as BATON if we never get to output it. */
+static apr_status_t
+clear_task_result(void *baton)
+{
+  verify_task_result_t *result = baton;
+  svn_error_clear(result->err);
+  result->err = SVN_NO_ERROR;
+
+  return APR_SUCCESS;
+}
+
+/* Implements svn_fs_warning_callback_t.
+ * There is nobody to report FS warnings to from within worker threads.
+ * Anything relevant to the verification result will be reported as an
+ * error anyway. */
+static void
+ignore_fs_warnings(void *baton,
+                   svn_error_t *err)
+{
+}
+
+/* Implements svn_task__thread_context_constructor_t.
+ * Open a svn_fs_t for the repository described by the
+ * verify_task_context_t in CONTEXT_BATON and return it in
+ * *THREAD_CONTEXT.
+ */
+static svn_error_t *
+open_verify_fs(void **thread_context,
+               void *context_baton,
+               apr_pool_t *result_pool,
+               apr_pool_t *scratch_pool)
+{
+  const verify_task_context_t *context = context_baton;
+  apr_hash_t *fs_config = context->fs_config
+                        ? apr_hash_copy(result_pool, context->fs_config)
+                        : NULL;
+  svn_fs_t *fs;
+
+  SVN_ERR(svn_fs_open2(&fs, context->fs_path, fs_config, result_pool,
+                       scratch_pool));
+  svn_fs_set_warning_func(fs, ignore_fs_warnings, NULL);
+  *thread_context = fs;
+
+  return SVN_NO_ERROR;
+}
+
+/* Implements svn_task__output_func_t.
+ * Pass the recorded verify_task_result_t in RESULT on to the caller as
+ * described by the verify_task_context_t in OUTPUT_BATON.
+ */
+static svn_error_t *
+verify_revision_output(svn_task__t *task,
+                       void *result,
+                       void *output_baton,
+                       svn_cancel_func_t cancel_func,
+                       void *cancel_baton,
+                       apr_pool_t *result_pool,
+                       apr_pool_t *scratch_pool)
+{
+  const verify_task_context_t *context = output_baton;
+  verify_task_result_t *task_result = result;
+  svn_error_t *err = task_result->err;
+  int i;
+
+  /* From now on, we own the error. */
+  task_result->err = SVN_NO_ERROR;
+
+  if (cancel_func)
+    {
+      svn_error_t *cancel_err = cancel_func(cancel_baton);
+      if (cancel_err)
+        {
+          svn_error_clear(err);
+          return svn_error_trace(cancel_err);
+        }
+    }
+
+  if (task_result->notifications)
+    for (i = 0; i < task_result->notifications->nelts; ++i)
+      context->notify_func(context->notify_baton,
+                           APR_ARRAY_IDX(task_result->notifications, i,
+                                         svn_repos_notify_t *),
+                           scratch_pool);
+
+  return svn_error_trace(finish_revision(task_result->revision, err,
+                                         context->notify_func,
+                                         context->notify_baton,
+                                         context->notify,
+                                         context->verify_callback,
+                                         context->verify_baton,
+                                         scratch_pool));
+}
+
+/* Implements svn_task__process_func_t.
+ * Verify the single revision given by the verify_task_baton_t in
+ * PROCESS_BATON using the svn_fs_t in THREAD_CONTEXT.  Record the outcome
+ * in a verify_task_result_t returned in *RESULT.
+ */
+static svn_error_t *
+verify_revision_process(void **result,
+                        svn_task__t *task,
+                        void *thread_context,
+                        void *process_baton,
+                        svn_cancel_func_t cancel_func,
+                        void *cancel_baton,
+                        apr_pool_t *result_pool,
+                        apr_pool_t *scratch_pool)
+{
+  const verify_task_baton_t *baton = process_baton;
+  const verify_task_context_t *context = baton->context;
+  verify_task_result_t *task_result
+    = apr_pcalloc(result_pool, sizeof(*task_result));
+
+  task_result->revision = baton->first;
+  if (context->notify_func)
+    task_result->notifications
+      = apr_array_make(result_pool, 0, sizeof(svn_repos_notify_t *));
+
+  apr_pool_cleanup_register(result_pool, task_result, clear_task_result,
+                            apr_pool_cleanup_null);
+
+  task_result->err = verify_one_revision(thread_context, baton->first,
+                                         context->notify_func
+                                           ? record_notification
+                                           : NULL,
+                                         task_result,
+                                         context->start_rev,
+                                         context->check_normalization,
+                                         cancel_func, cancel_baton,
+                                         scratch_pool);
+  *result = task_result;
+
+  return SVN_NO_ERROR;
+}
+
+/* Implements svn_task__process_func_t.
+ * Add sub-tasks to TASK that cover the revision range given by the
+ * verify_task_baton_t in PROCESS_BATON.  If that range is larger than
+ * VERIFY_BATCH_SIZE, add one such batch task per VERIFY_BATCH_SIZE
+ * revisions.  Otherwise, add one verify_revision_process() task per
+ * revision.  There is no output.
+ */
+static svn_error_t *
+verify_range_process(void **result,
+                     svn_task__t *task,
+                     void *thread_context,
+                     void *process_baton,
+                     svn_cancel_func_t cancel_func,
+                     void *cancel_baton,
+                     apr_pool_t *result_pool,
+                     apr_pool_t *scratch_pool)
+{
+  const verify_task_baton_t *baton = process_baton;
+  svn_revnum_t step = baton->last - baton->first >= VERIFY_BATCH_SIZE
+                    ? VERIFY_BATCH_SIZE
+                    : 1;
+  svn_revnum_t rev;
+
+  for (rev = baton->first; rev <= baton->last; rev += step)
+    {
+      apr_pool_t *sub_task_pool = svn_task__create_process_pool(task);
+      verify_task_baton_t *sub_task_baton
+        = apr_pcalloc(sub_task_pool, sizeof(*sub_task_baton));
+
+      sub_task_baton->context = baton->context;
+      sub_task_baton->first = rev;
+      sub_task_baton->last = MIN(rev + step - 1, baton->last);
+
+      if (step > 1)
+        SVN_ERR(svn_task__add_similar(task, sub_task_pool, NULL,
+                                      sub_task_baton));
+      else
+        SVN_ERR(svn_task__add(task, sub_task_pool, NULL,
+                              verify_revision_process, sub_task_baton,
+                              verify_revision_output,
+                              (void *)baton->context));
+    }
+
+  *result = NULL;
+
+  return SVN_NO_ERROR;
+}
+
+/* Verify revisions START_REV to END_REV in FS using up to JOBS worker
+ * threads.  The other parameters are the same as for
+ * svn_repos_verify_fs4().  NOTIFY is the pre-allocated notification to
+ * send after each successfully verified revision.
+ */
+static svn_error_t *
+verify_revisions_concurrently(svn_fs_t *fs,
+                              svn_revnum_t start_rev,
+                              svn_revnum_t end_rev,
+                              int jobs,
+                              svn_boolean_t check_normalization,
+                              svn_repos_notify_func_t notify_func,
+                              void *notify_baton,
+                              svn_repos_notify_t *notify,
+                              svn_repos_verify_callback_t verify_callback,
+                              void *verify_baton,
+                              svn_cancel_func_t cancel_func,
+                              void *cancel_baton,
+                              apr_pool_t *scratch_pool)
+{
+  verify_task_context_t context;
+  verify_task_baton_t root_baton;
+
+  context.start_rev = start_rev;
+  context.check_normalization = check_normalization;
+  context.notify_func = notify_func;
+  context.notify_baton = notify_baton;
+  context.notify = notify;
+  context.verify_callback = verify_callback;
+  context.verify_baton = verify_baton;
+  context.fs_path = svn_fs_path(fs, scratch_pool);
+  context.fs_config = svn_fs_config(fs, scratch_pool);
+
+  root_baton.context = &context;
+  root_baton.first = start_rev;
+  root_baton.last = end_rev;
+
+  return svn_error_trace(svn_task__run(jobs,
+                                       verify_range_process, &root_baton,
+                                       NULL, NULL,
+                                       open_verify_fs, &context,
+                                       cancel_func, cancel_baton,
+                                       scratch_pool, scratch_pool));
+}
+
 svn_error_t *
-svn_repos_verify_fs3(svn_repos_t *repos,
+svn_repos_verify_fs4(svn_repos_t *repos,
                      svn_revnum_t start_rev,
                      svn_revnum_t end_rev,
+                     int jobs,
                      svn_boolean_t check_normalization,
                      svn_boolean_t metadata_only,
                      svn_repos_notify_func_t notify_func,
@@ -2477,7 +2823,7 @@ svn_repos_verify_fs3(svn_repos_t *repos,
   svn_revnum_t youngest;
   svn_revnum_t rev;
   apr_pool_t *iterpool = svn_pool_create(pool);
-  svn_repos_notify_t *notify;
+  svn_repos_notify_t *notify = NULL;
   svn_fs_progress_notify_func_t verify_notify = NULL;
   struct verify_fs_notify_func_baton_t *verify_notify_baton = NULL;
   svn_error_t *err;
@@ -2537,7 +2883,14 @@ svn_repos_verify_fs3(svn_repos_t *repos,
                            verify_baton, iterpool));
     }
 
-  if (!metadata_only)
+  if (!metadata_only && jobs > 1)
+    SVN_ERR(verify_revisions_concurrently(fs, start_rev, end_rev, jobs,
+                                          check_normalization,
+                                          notify_func, notify_baton, notify,
+                                          verify_callback, verify_baton,
+                                          cancel_func, cancel_baton,
+                                          iterpool));
+  else if (!metadata_only)
     for (rev = start_rev; rev <= end_rev; rev++)
       {
         svn_pool_clear(iterpool);
@@ -2548,21 +2901,8 @@ svn_repos_verify_fs3(svn_repos_t *repos,
                                   cancel_func, cancel_baton,
                                   iterpool);
 
-        if (err && err->apr_err == SVN_ERR_CANCELLED)
-          {
-            return svn_error_trace(err);
-          }
-        else if (err)
-          {
-            SVN_ERR(report_error(rev, err, verify_callback, verify_baton,
-                                 iterpool));
-          }
-        else if (notify_func)
-          {
-            /* Tell the caller that we're done with this revision. */
-            notify->revision = rev;
-            notify_func(notify_baton, notify, iterpool);
-          }
+        SVN_ERR(finish_revision(rev, err, notify_func, notify_baton, notify,
+                                verify_callback, verify_baton, iterpool));
       }
 
   /* We're done. */
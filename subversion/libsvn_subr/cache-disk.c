@@ -0,0 +1,745 @@
+/*
+ * cache-disk.c: persistent local disk caching for Subversion
+ *
+ * ====================================================================
+ *    Licensed to the Apache Software Foundation (ASF) under one
+ *    or more contributor license agreements.  See the NOTICE file
+ *    distributed with this work for additional information
+ *    regarding copyright ownership.  The ASF licenses this file
+ *    to you under the Apache License, Version 2.0 (the
+ *    "License"); you may not use this file except in compliance
+ *    with the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing,
+ *    software distributed under the License is distributed on an
+ *    "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *    KIND, either express or implied.  See the License for the
+ *    specific language governing permissions and limitations
+ *    under the License.
+ * ====================================================================
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "svn_checksum.h"
+#include "svn_dirent_uri.h"
+#include "svn_hash.h"
+#include "svn_io.h"
+#include "svn_pools.h"
+
+#include "svn_private_config.h"
+#include "private/svn_atomic.h"
+#include "private/svn_cache.h"
+#include "private/svn_mutex.h"
+#include "private/svn_subr_private.h"
+
+#include "cache.h"
+
+/* A note on the design:
+
+   Every item gets stored in a file of its own.  The file name is the MD5
+   of the item's full key, i.e. the cache prefix plus the actual key.  To
+   keep the directories reasonably small, the items are distributed over
+   BUCKET_COUNT sub-directories, selected by the first byte of the MD5.
+
+   Files are written to a temporary file first and then moved into place.
+   Hence, readers never see partially written items, even if they run in
+   a different process.  Each file contains a header, the full key and the
+   serialized item.  A hash collision or a corrupted file simply results in
+   a cache miss.
+
+   Each bucket gets an equal share of the total size limit.  We track the
+   bucket sizes in memory, initialized by scanning the bucket directory
+   upon first write.  Whenever a bucket exceeds its limit, we scan it again
+   - catching up with changes made by other processes - and remove the
+   oldest items.  So, the limit is a soft one and eviction is FIFO.
+
+   Nothing in svn_cache__disk_t or disk_cache_t changes after creation,
+   except for the bucket sizes.  Those are protected by a mutex.
+
+   Within a process, all users of the same directory should share a single
+   svn_cache__disk_t, so the bucket sizes get tracked only once.  The
+   process-global registry of stores below takes care of that.
+ */
+
+/* Number of sub-directories to distribute the items over. */
+#define BUCKET_COUNT 256
+
+/* Identifies our item file format. */
+#define ITEM_MAGIC "SVNDC001"
+
+/* Upon eviction, shrink the bucket to this fraction of its limit. */
+#define EVICTION_TARGET(limit) ((limit) / 4 * 3)
+
+/* Suffix used by svn_io_open_unique_file3 for temporary files. */
+#define TEMP_SUFFIX ".tmp"
+
+/* Header of every item file.  It will be followed by the full key, padded
+ * to a multiple of 8 bytes, and the serialized item data.  Because of the
+ * padding, the data will be suitably aligned for in-place deserialization.
+ *
+ * Values are in host byte order.  That is fine for a local cache.
+ */
+typedef struct item_header_t
+{
+  /* ITEM_MAGIC without the terminating NUL. */
+  char magic[8];
+
+  /* Length of the full key in bytes, excluding the padding. */
+  apr_uint32_t key_len;
+
+  /* FNV-1a checksum over the item data. */
+  apr_uint32_t checksum;
+
+  /* Length of the item data in bytes. */
+  apr_uint64_t data_len;
+} item_header_t;
+
+/* Round VALUE up to the next multiple of 8. */
+#define ALIGN_8(value) (((value) + 7) & ~(apr_size_t)7)
+
+/* The persistent store shared by all disk cache instances using it. */
+struct svn_cache__disk_t
+{
+  /* Root directory of the store. */
+  const char *path;
+
+  /* Size limit for each bucket in bytes. */
+  apr_uint64_t bucket_limit;
+
+  /* Estimated number of bytes used per bucket.  Only valid if the
+   * respective entry in SCANNED is set. */
+  apr_uint64_t usage[BUCKET_COUNT];
+
+  /* Whether we scanned the respective bucket directory already. */
+  svn_boolean_t scanned[BUCKET_COUNT];
+
+  /* Serializes access to USAGE and SCANNED. */
+  svn_mutex__t *mutex;
+};
+
+/* The (internal) cache object. */
+typedef struct disk_cache_t
+{
+  /* The store that we use. */
+  svn_cache__disk_t *disk;
+
+  /* A prefix used to differentiate our data from any other data in
+   * the DISK. */
+  const char *prefix;
+
+  /* The size of the key: either a fixed number of bytes or
+   * APR_HASH_KEY_STRING. */
+  apr_ssize_t klen;
+
+  /* Used to marshal values in and out of the cache. */
+  svn_cache__serialize_func_t serialize_func;
+  svn_cache__deserialize_func_t deserialize_func;
+} disk_cache_t;
+
+/* Set *FULL_KEY to the combination of CACHE's prefix and KEY.  Set
+ * *BUCKET_DIR to the directory and *PATH to the file that an item with
+ * that key would be stored in.  Set *BUCKET to the index of that bucket.
+ * Allocate the results in POOL.
+ */
+static svn_error_t *
+locate_item(svn_stringbuf_t **full_key,
+            const char **bucket_dir,
+            const char **path,
+            int *bucket,
+            disk_cache_t *cache,
+            const void *key,
+            apr_pool_t *pool)
+{
+  apr_size_t key_len = cache->klen == APR_HASH_KEY_STRING
+                     ? strlen(key)
+                     : (apr_size_t)cache->klen;
+  svn_checksum_t *checksum;
+  const char *name;
+
+  *full_key = svn_stringbuf_create(cache->prefix, pool);
+  svn_stringbuf_appendbyte(*full_key, '\0');
+  svn_stringbuf_appendbytes(*full_key, key, key_len);
+
+  SVN_ERR(svn_checksum(&checksum, svn_checksum_md5, (*full_key)->data,
+                       (*full_key)->len, pool));
+  name = svn_checksum_to_cstring_display(checksum, pool);
+
+  *bucket = checksum->digest[0];
+  *bucket_dir = svn_dirent_join(cache->disk->path,
+                                apr_pstrndup(pool, name, 2), pool);
+  *path = svn_dirent_join(*bucket_dir, name, pool);
+
+  return SVN_NO_ERROR;
+}
+
+/* Return TRUE, if NAME looks like an item file in a bucket directory.
+ */
+static svn_boolean_t
+is_item_file(const char *name)
+{
+  apr_size_t len = strlen(name);
+  return len < strlen(TEMP_SUFFIX)
+      || strcmp(name + len - strlen(TEMP_SUFFIX), TEMP_SUFFIX) != 0;
+}
+
+/* Describes a file found in a bucket directory. */
+typedef struct bucket_file_t
+{
+  const char *name;
+  svn_io_dirent2_t *dirent;
+} bucket_file_t;
+
+/* Sort bucket_file_t * by ascending modification time.
+ * Implements the qsort comparison function signature. */
+static int
+compare_mtime(const void *lhs, const void *rhs)
+{
+  const bucket_file_t *a = *(const bucket_file_t * const *)lhs;
+  const bucket_file_t *b = *(const bucket_file_t * const *)rhs;
+
+  if (a->dirent->mtime < b->dirent->mtime)
+    return -1;
+
+  return a->dirent->mtime > b->dirent->mtime ? 1 : 0;
+}
+
+/* Scan the directory of BUCKET in DISK and update its usage info.  If the
+ * bucket exceeds its limit, remove the oldest items.  The caller must
+ * hold DISK's mutex.  Use SCRATCH_POOL for temporary allocations.
+ */
+static svn_error_t *
+scan_bucket(svn_cache__disk_t *disk,
+            int bucket,
+            apr_pool_t *scratch_pool)
+{
+  const char *dir = svn_dirent_join(disk->path,
+                                    apr_psprintf(scratch_pool, "%02x",
+                                                 bucket),
+                                    scratch_pool);
+  apr_hash_t *dirents;
+  apr_hash_index_t *hi;
+  apr_array_header_t *files;
+  apr_uint64_t usage = 0;
+  apr_pool_t *iterpool;
+  int i;
+
+  svn_error_t *err = svn_io_get_dirents3(&dirents, dir, FALSE,
+                                         scratch_pool, scratch_pool);
+  if (err && APR_STATUS_IS_ENOENT(err->apr_err))
+    {
+      svn_error_clear(err);
+      disk->usage[bucket] = 0;
+      disk->scanned[bucket] = TRUE;
+      return SVN_NO_ERROR;
+    }
+  SVN_ERR(err);
+
+  files = apr_array_make(scratch_pool, apr_hash_count(dirents),
+                         sizeof(bucket_file_t *));
+  for (hi = apr_hash_first(scratch_pool, dirents); hi; hi = apr_hash_next(hi))
+    {
+      bucket_file_t *file = apr_palloc(scratch_pool, sizeof(*file));
+      file->name = apr_hash_this_key(hi);
+      file->dirent = apr_hash_this_val(hi);
+
+      usage += file->dirent->filesize;
+      if (file->dirent->kind == svn_node_file && is_item_file(file->name))
+        APR_ARRAY_PUSH(files, bucket_file_t *) = file;
+    }
+
+  /* Remove the oldest items until we are well below the limit. */
+  if (usage > disk->bucket_limit)
+    {
+      qsort(files->elts, files->nelts, files->elt_size, compare_mtime);
+
+      iterpool = svn_pool_create(scratch_pool);
+      for (i = 0;
+           i < files->nelts && usage > EVICTION_TARGET(disk->bucket_limit);
+           ++i)
+        {
+          bucket_file_t *file = APR_ARRAY_IDX(files, i, bucket_file_t *);
+          svn_pool_clear(iterpool);
+
+          /* Other processes may have removed the item already. */
+          SVN_ERR(svn_io_remove_file2(svn_dirent_join(dir, file->name,
+                                                      iterpool),
+                                      TRUE, iterpool));
+          usage -= file->dirent->filesize;
+        }
+
+      svn_pool_destroy(iterpool);
+    }
+
+  disk->usage[bucket] = usage;
+  disk->scanned[bucket] = TRUE;
+
+  return SVN_NO_ERROR;
+}
+
+/* Account for SIZE bytes having been added to BUCKET in DISK and remove
+ * old items if necessary.  The caller must hold DISK's mutex.
+ * Use SCRATCH_POOL for temporary allocations.
+ */
+static svn_error_t *
+add_to_bucket(svn_cache__disk_t *disk,
+              int bucket,
+              apr_uint64_t size,
+              apr_pool_t *scratch_pool)
+{
+  /* The initial scan will already see the new item. */
+  if (!disk->scanned[bucket])
+    return svn_error_trace(scan_bucket(disk, bucket, scratch_pool));
+
+  disk->usage[bucket] += size;
+  if (disk->usage[bucket] > disk->bucket_limit)
+    SVN_ERR(scan_bucket(disk, bucket, scratch_pool));
+
+  return SVN_NO_ERROR;
+}
+
+/* Core functionality of our getter functions: fetch the serialized item
+ * identified by KEY from the cache given by CACHE_VOID.  Return it in
+ * *DATA and *SIZE and indicate success in *FOUND.  Allocate the data in
+ * RESULT_POOL.
+ */
+static svn_error_t *
+disk_cache_internal_get(char **data,
+                        apr_size_t *size,
+                        svn_boolean_t *found,
+                        void *cache_void,
+                        const void *key,
+                        apr_pool_t *result_pool)
+{
+  disk_cache_t *cache = cache_void;
+  svn_stringbuf_t *full_key;
+  svn_stringbuf_t *contents;
+  const char *bucket_dir;
+  const char *path;
+  const item_header_t *header;
+  apr_size_t offset;
+  int bucket;
+  svn_error_t *err;
+
+  *found = FALSE;
+  if (key == NULL)
+    return SVN_NO_ERROR;
+
+  SVN_ERR(locate_item(&full_key, &bucket_dir, &path, &bucket, cache, key,
+                      result_pool));
+
+  err = svn_stringbuf_from_file2(&contents, path, result_pool);
+  if (err && APR_STATUS_IS_ENOENT(err->apr_err))
+    {
+      svn_error_clear(err);
+      return SVN_NO_ERROR;
+    }
+  SVN_ERR(err);
+
+  /* Validate the file contents.  Anything unexpected is a cache miss. */
+  if (contents->len < sizeof(*header))
+    return SVN_NO_ERROR;
+
+  header = (const item_header_t *)contents->data;
+  offset = sizeof(*header) + ALIGN_8(full_key->len);
+  if (   memcmp(header->magic, ITEM_MAGIC, sizeof(header->magic))
+      || header->key_len != full_key->len
+      || contents->len < offset
+      || header->data_len != contents->len - offset
+      || memcmp(contents->data + sizeof(*header), full_key->data,
+                full_key->len)
+      || header->checksum != svn__fnv1a_32(contents->data + offset,
+                                           contents->len - offset))
+    return SVN_NO_ERROR;
+
+  *data = contents->data + offset;
+  *size = contents->len - offset;
+  *found = TRUE;
+
+  return SVN_NO_ERROR;
+}
+
+static svn_error_t *
+disk_cache_get(void **value_p,
+               svn_boolean_t *found,
+               void *cache_void,
+               const void *key,
+               apr_pool_t *result_pool)
+{
+  disk_cache_t *cache = cache_void;
+  char *data;
+  apr_size_t data_len;
+  SVN_ERR(disk_cache_internal_get(&data,
+                                  &data_len,
+                                  found,
+                                  cache_void,
+                                  key,
+                                  result_pool));
+
+  /* If we found it, de-serialize it. */
+  if (*found)
+    {
+      if (cache->deserialize_func)
+        {
+          SVN_ERR((cache->deserialize_func)(value_p, data, data_len,
+                                            result_pool));
+        }
+      else
+        {
+          svn_stringbuf_t *value = svn_stringbuf_create_empty(result_pool);
+          value->data = data;
+          value->blocksize = data_len;
+          value->len = data_len - 1; /* account for trailing NUL */
+          *value_p = value;
+        }
+    }
+
+  return SVN_NO_ERROR;
+}
+
+/* Implement vtable.has_key in terms of the getter.
+ */
+static svn_error_t *
+disk_cache_has_key(svn_boolean_t *found,
+                   void *cache_void,
+                   const void *key,
+                   apr_pool_t *scratch_pool)
+{
+  char *data;
+  apr_size_t data_len;
+  SVN_ERR(disk_cache_internal_get(&data,
+                                  &data_len,
+                                  found,
+                                  cache_void,
+                                  key,
+                                  scratch_pool));
+
+  return SVN_NO_ERROR;
+}
+
+static svn_boolean_t
+disk_cache_is_cachable(void *cache_void, apr_size_t size)
+{
+  disk_cache_t *cache = cache_void;
+
+  /* Very large items would push too many others out of their bucket. */
+  return size <= cache->disk->bucket_limit / 2;
+}
+
+/* Core functionality of our setter functions: store LEN bytes of DATA
+ * to be identified by KEY in the cache given by CACHE_VOID.  Use
+ * SCRATCH_POOL for temporary allocations.
+ */
+static svn_error_t *
+disk_cache_internal_set(void *cache_void,
+                        const void *key,
+                        const char *data,
+                        apr_size_t len,
+                        apr_pool_t *scratch_pool)
+{
+  static const char padding[8] = { 0 };
+
+  disk_cache_t *cache = cache_void;
+  svn_stringbuf_t *full_key;
+  const char *bucket_dir;
+  const char *path;
+  const char *tmp_path;
+  apr_file_t *file;
+  item_header_t header;
+  int bucket;
+  svn_error_t *err;
+
+  if (!disk_cache_is_cachable(cache, len))
+    return SVN_NO_ERROR;
+
+  SVN_ERR(locate_item(&full_key, &bucket_dir, &path, &bucket, cache, key,
+                      scratch_pool));
+
+  /* Buckets get created on demand. */
+  err = svn_io_open_unique_file3(&file, &tmp_path, bucket_dir,
+                                 svn_io_file_del_none,
+                                 scratch_pool, scratch_pool);
+  if (err && APR_STATUS_IS_ENOENT(err->apr_err))
+    {
+      svn_error_clear(err);
+      SVN_ERR(svn_io_make_dir_recursively(bucket_dir, scratch_pool));
+      err = svn_io_open_unique_file3(&file, &tmp_path, bucket_dir,
+                                     svn_io_file_del_none,
+                                     scratch_pool, scratch_pool);
+    }
+  SVN_ERR(err);
+
+  memcpy(header.magic, ITEM_MAGIC, sizeof(header.magic));
+  header.key_len = (apr_uint32_t)full_key->len;
+  header.checksum = svn__fnv1a_32(data, len);
+  header.data_len = len;
+
+  err = svn_io_file_write_full(file, &header, sizeof(header), NULL,
+                               scratch_pool);
+  if (!err)
+    err = svn_io_file_write_full(file, full_key->data, full_key->len, NULL,
+                                 scratch_pool);
+  if (!err)
+    err = svn_io_file_write_full(file, padding,
+                                 ALIGN_8(full_key->len) - full_key->len,
+                                 NULL, scratch_pool);
+  if (!err)
+    err = svn_io_file_write_full(file, data, len, NULL, scratch_pool);
+
+  err = svn_error_compose_create(err, svn_io_file_close(file, scratch_pool));
+  if (!err)
+    err = svn_io_file_rename2(tmp_path, path, FALSE, scratch_pool);
+
+  if (err)
+    return svn_error_compose_create(err,
+                                    svn_io_remove_file2(tmp_path, TRUE,
+                                                        scratch_pool));
+
+  SVN_MUTEX__WITH_LOCK(cache->disk->mutex,
+                       add_to_bucket(cache->disk, bucket,
+                                     sizeof(header) + ALIGN_8(full_key->len)
+                                       + len,
+                                     scratch_pool));
+
+  return SVN_NO_ERROR;
+}
+
+static svn_error_t *
+disk_cache_set(void *cache_void,
+               const void *key,
+               void *value,
+               apr_pool_t *scratch_pool)
+{
+  disk_cache_t *cache = cache_void;
+  apr_pool_t *subpool;
+  void *data;
+  apr_size_t data_len;
+  svn_error_t *err;
+
+  if (key == NULL)
+    return SVN_NO_ERROR;
+
+  subpool = svn_pool_create(scratch_pool);
+  if (cache->serialize_func)
+    {
+      err = (cache->serialize_func)(&data, &data_len, value, subpool);
+    }
+  else
+    {
+      svn_stringbuf_t *value_str = value;
+      data = value_str->data;
+      data_len = value_str->len + 1; /* copy trailing NUL */
+      err = SVN_NO_ERROR;
+    }
+
+  if (!err)
+    err = disk_cache_internal_set(cache_void, key, data, data_len, subpool);
+
+  svn_pool_destroy(subpool);
+  return err;
+}
+
+static svn_error_t *
+disk_cache_get_partial(void **value_p,
+                       svn_boolean_t *found,
+                       void *cache_void,
+                       const void *key,
+                       svn_cache__partial_getter_func_t func,
+                       void *baton,
+                       apr_pool_t *result_pool)
+{
+  char *data;
+  apr_size_t size;
+  SVN_ERR(disk_cache_internal_get(&data,
+                                  &size,
+                                  found,
+                                  cache_void,
+                                  key,
+                                  result_pool));
+
+  /* If we found it, de-serialize it. */
+  return *found
+    ? func(value_p, data, size, baton, result_pool)
+    : SVN_NO_ERROR;
+}
+
+static svn_error_t *
+disk_cache_set_partial(void *cache_void,
+                       const void *key,
+                       svn_cache__partial_setter_func_t func,
+                       void *baton,
+                       apr_pool_t *scratch_pool)
+{
+  svn_error_t *err = SVN_NO_ERROR;
+
+  void *data;
+  apr_size_t size;
+  svn_boolean_t found = FALSE;
+
+  apr_pool_t *subpool = svn_pool_create(scratch_pool);
+  err = disk_cache_internal_get((char **)&data,
+                                &size,
+                                &found,
+                                cache_void,
+                                key,
+                                subpool);
+
+  /* If we found it, modify it and write it back to cache */
+  if (!err && found)
+    {
+      err = func(&data, &size, baton, subpool);
+      if (!err)
+        err = disk_cache_internal_set(cache_void, key, data, size, subpool);
+    }
+
+  svn_pool_destroy(subpool);
+  return err;
+}
+
+static svn_error_t *
+disk_cache_iter(svn_boolean_t *completed,
+                void *cache_void,
+                svn_iter_apr_hash_cb_t user_cb,
+                void *user_baton,
+                apr_pool_t *scratch_pool)
+{
+  return svn_error_create(SVN_ERR_UNSUPPORTED_FEATURE, NULL,
+                          _("Can't iterate a disk cache"));
+}
+
+static svn_error_t *
+disk_cache_get_info(void *cache_void,
+                    svn_cache__info_t *info,
+                    svn_boolean_t reset,
+                    apr_pool_t *result_pool)
+{
+  disk_cache_t *cache = cache_void;
+
+  info->id = apr_pstrdup(result_pool, cache->prefix);
+
+  /* we don't have any memory allocation info */
+
+  return SVN_NO_ERROR;
+}
+
+static svn_cache__vtable_t disk_cache_vtable = {
+  disk_cache_get,
+  disk_cache_has_key,
+  disk_cache_set,
+  disk_cache_iter,
+  disk_cache_is_cachable,
+  disk_cache_get_partial,
+  disk_cache_set_partial,
+  disk_cache_get_info
+};
+
+svn_error_t *
+svn_cache__disk_create(svn_cache__disk_t **disk_p,
+                       const char *path,
+                       apr_uint64_t max_size,
+                       apr_pool_t *result_pool)
+{
+  svn_cache__disk_t *disk = apr_pcalloc(result_pool, sizeof(*disk));
+
+  SVN_ERR(svn_io_make_dir_recursively(path, result_pool));
+
+  disk->path = apr_pstrdup(result_pool, path);
+  disk->bucket_limit = max_size / BUCKET_COUNT;
+  SVN_ERR(svn_mutex__init(&disk->mutex, TRUE, result_pool));
+
+  *disk_p = disk;
+  return SVN_NO_ERROR;
+}
+
+/* The process-global registry of disk cache stores, mapping their
+ * absolute paths to svn_cache__disk_t *.  All of it gets allocated in
+ * DISK_REGISTRY_POOL and lives until the end of the process.
+ */
+static apr_pool_t *disk_registry_pool = NULL;
+static apr_hash_t *disk_registry = NULL;
+static svn_mutex__t *disk_registry_mutex = NULL;
+static svn_atomic_t disk_registry_initialized = 0;
+
+/* Initializer function as required by svn_atomic__init_once.  Create the
+ * disk cache registry.  BATON and UNUSED_POOL are unused.
+ */
+static svn_error_t *
+initialize_disk_registry(void *baton, apr_pool_t *unused_pool)
+{
+  apr_pool_t *pool = svn_pool_create(NULL);
+
+  SVN_ERR(svn_mutex__init(&disk_registry_mutex, TRUE, pool));
+  disk_registry = apr_hash_make(pool);
+  disk_registry_pool = pool;
+
+  return SVN_NO_ERROR;
+}
+
+/* Set *DISK_P to the registered store for absolute directory PATH.
+ * Register a new store limited to MAX_SIZE bytes if there is none, yet.
+ * The caller must hold the registry mutex.
+ */
+static svn_error_t *
+get_registered_disk(svn_cache__disk_t **disk_p,
+                    const char *path,
+                    apr_uint64_t max_size)
+{
+  svn_cache__disk_t *disk = svn_hash_gets(disk_registry, path);
+
+  if (disk == NULL)
+    {
+      SVN_ERR(svn_cache__disk_create(&disk, path, max_size,
+                                     disk_registry_pool));
+      svn_hash_sets(disk_registry, disk->path, disk);
+    }
+
+  *disk_p = disk;
+  return SVN_NO_ERROR;
+}
+
+svn_error_t *
+svn_cache__get_global_disk_cache(svn_cache__disk_t **disk_p,
+                                 const char *path,
+                                 apr_uint64_t max_size,
+                                 apr_pool_t *scratch_pool)
+{
+  SVN_ERR(svn_atomic__init_once(&disk_registry_initialized,
+                                initialize_disk_registry, NULL, NULL));
+
+  SVN_ERR(svn_dirent_get_absolute(&path, path, scratch_pool));
+  SVN_MUTEX__WITH_LOCK(disk_registry_mutex,
+                       get_registered_disk(disk_p, path, max_size));
+
+  return SVN_NO_ERROR;
+}
+
+svn_error_t *
+svn_cache__create_disk_cache(svn_cache__t **cache_p,
+                             svn_cache__disk_t *disk,
+                             svn_cache__serialize_func_t serialize_func,
+                             svn_cache__deserialize_func_t deserialize_func,
+                             apr_ssize_t klen,
+                             const char *prefix,
+                             apr_pool_t *result_pool)
+{
+  svn_cache__t *wrapper = apr_pcalloc(result_pool, sizeof(*wrapper));
+  disk_cache_t *cache = apr_pcalloc(result_pool, sizeof(*cache));
+
+  cache->disk = disk;
+  cache->serialize_func = serialize_func;
+  cache->deserialize_func = deserialize_func;
+  cache->klen = klen;
+  cache->prefix = apr_pstrdup(result_pool, prefix);
+
+  wrapper->vtable = &disk_cache_vtable;
+  wrapper->cache_internal = cache;
+  wrapper->error_handler = 0;
+  wrapper->error_baton = 0;
+  wrapper->pretend_empty = !!getenv("SVN_X_DOES_NOT_MARK_THE_SPOT");
+
+  *cache_p = wrapper;
+  return SVN_NO_ERROR;
+}
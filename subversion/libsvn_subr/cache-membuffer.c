@@ -24,6 +24,7 @@
 #include <assert.h>
 #include <apr_md5.h>
 #include <apr_thread_rwlock.h>
+#include <apr_shm.h>
 
 #include "svn_pools.h"
 #include "svn_checksum.h"
@@ -129,6 +130,34 @@
  * to scale well despite that bottleneck, we simply segment the cache into
  * a number of independent caches (segments). Items will be multiplexed based
  * on their hash key.
+ *
+ * Plain item lookups, however, may also be done without taking the segment
+ * lock.  Every writer increments the segment's sequence counter once after
+ * acquiring the write lock and once before releasing it, i.e. the counter
+ * is odd while a modification is in progress.  A lock-free reader samples
+ * the counter before and after copying the item and only uses the result
+ * if the counter was even and did not change.  Otherwise, it falls back to
+ * the regular locked code path.  The only writes such readers do are
+ * plain, unsynchronized increments of the hit counters of the entry found
+ * and of the segment statistics.  Concurrent updates may get lost or even
+ * hit an entry that just got replaced, but hit counts are only heuristics
+ * for the eviction strategy anyway.
+ *
+ * Optionally, the whole cache - segment headers, directories and data
+ * buffers - may be placed in anonymous shared memory.  Processes forked
+ * after the cache has been created then map it at the same address and
+ * may use it just like a process-local cache.  Since all references
+ * within the cache are indexes and offsets, only the segment locks need
+ * to be different: they become cross-process mutexes.  The prefix pool,
+ * however, is process-local.  Shared caches therefore don't use it and
+ * always store the full keys.
+ *
+ * A process may die while holding the lock of a shared segment, e.g. in
+ * the middle of a write.  The segment locks are therefore robust
+ * process-shared pthread mutexes: the system hands the lock of a dead
+ * process to the next waiter, which resets the segment because its
+ * contents may be inconsistent.  Platforms without robust mutexes don't
+ * support shared caches at all.
  */
 
 /* APR's read-write lock implementation on Windows is horribly inefficient.
@@ -146,6 +175,36 @@
 #  define USE_SIMPLE_MUTEX 0
 #endif
 
+/* Locks for shared memory caches live in the shared memory themselves and
+ * must survive the death of their holder.  Only robust process-shared
+ * pthread mutexes provide both.
+ */
+#if APR_HAS_SHARED_MEMORY && defined(HAVE_PTHREAD_MUTEXATTR_SETROBUST) \
+    && defined(HAVE_PTHREAD_MUTEX_CONSISTENT)
+#  include <errno.h>
+#  include <pthread.h>
+#  define SHARED_CACHE_SUPPORTED 1
+#else
+#  define SHARED_CACHE_SUPPORTED 0
+#endif
+
+/* Lock-free lookups need read barriers that we can only portably express
+ * for some compilers.  Without thread support, the locks are no-ops and
+ * there is nothing to gain.  The debug code wants to check entries while
+ * holding the lock, so disable lock-free lookups for it as well.
+ */
+#if !APR_HAS_THREADS || defined(SVN_DEBUG_CACHE_MEMBUFFER)
+#  define USE_LOCK_FREE_READS 0
+#elif defined(__GNUC__) && defined(__ATOMIC_ACQUIRE)
+#  define USE_LOCK_FREE_READS 1
+#  define READ_BARRIER() __atomic_thread_fence(__ATOMIC_ACQUIRE)
+#elif defined(_MSC_VER)
+#  define USE_LOCK_FREE_READS 1
+#  define READ_BARRIER() MemoryBarrier()
+#else
+#  define USE_LOCK_FREE_READS 0
+#endif
+
 /* For more efficient copy operations, let's align all data items properly.
  * Since we can't portably align pointers, this is rather the item size
  * granularity which ensures *relative* alignment within the cache - still
@@ -805,29 +864,131 @@ struct svn_membuffer_t
 #elif (APR_HAS_THREADS && !USE_SIMPLE_MUTEX)
   /* Same for read-write lock. */
   apr_thread_rwlock_t *lock;
+#endif
+
+#if SHARED_CACHE_SUPPORTED
+  /* If the cache lives in shared memory, this robust cross-process lock
+   * in the same shared memory serializes all access to this segment and
+   * LOCK will be NULL.  NULL for process-local caches.
+   */
+  pthread_mutex_t *shared_lock;
+#endif
 
   /* If set, write access will wait until they get exclusive access.
    * Otherwise, they will become no-ops if the segment is currently
-   * read-locked.  Only used when LOCK is an r/w lock.
+   * locked.  Only used when LOCK is an r/w lock or with SHARED_LOCK.
    */
   svn_boolean_t allow_blocking_writes;
-#endif
 
   /* A write lock counter, must be either 0 or 1.
    * This one is only used in debug assertions to verify that you used
    * the correct multi-threading settings. */
   svn_atomic_t write_lock_count;
+
+  /* Incremented upon acquiring and before releasing the write lock,
+   * i.e. odd while the segment is being modified.  Lock-free readers use
+   * this to detect concurrent modifications.
+   */
+  volatile svn_atomic_t sequence;
 };
 
 /* Align integer VALUE to the next ITEM_ALIGNMENT boundary.
  */
 #define ALIGN_VALUE(value) (((value) + ITEM_ALIGNMENT-1) & -ITEM_ALIGNMENT)
 
+/* Remove all entries from the CACHE segment.  The caller must hold the
+ * write lock and have called begin_write().
+ */
+static void
+reset_segment(svn_membuffer_t *cache)
+{
+  /* Length of the group_initialized array in bytes.
+     See also svn_cache__membuffer_cache_create(). */
+  apr_size_t group_init_size
+    = 1 + (cache->group_count + cache->spare_group_count)
+            / (8 * GROUP_INIT_GRANULARITY);
+
+  /* Mark all groups as "not initialized", which implies "empty". */
+  cache->first_spare_group = NO_INDEX;
+  cache->max_spare_used = 0;
+
+  memset(cache->group_initialized, 0, group_init_size);
+
+  /* Unlink L1 contents. */
+  cache->l1.first = NO_INDEX;
+  cache->l1.last = NO_INDEX;
+  cache->l1.next = NO_INDEX;
+  cache->l1.current_data = cache->l1.start_offset;
+
+  /* Unlink L2 contents. */
+  cache->l2.first = NO_INDEX;
+  cache->l2.last = NO_INDEX;
+  cache->l2.next = NO_INDEX;
+  cache->l2.current_data = cache->l2.start_offset;
+
+  /* Reset content counters. */
+  cache->data_used = 0;
+  cache->used_entries = 0;
+}
+
+#if SHARED_CACHE_SUPPORTED
+/* Acquire the cross-process lock of the shared CACHE segment.  If BLOCKING
+ * is not set and the lock is currently taken, set *SUCCESS to FALSE and
+ * return immediately.
+ *
+ * If the previous holder died with the lock held, make the lock usable
+ * again and reset the segment since it may have been left inconsistent.
+ */
+static svn_error_t *
+shared_lock_cache(svn_membuffer_t *cache,
+                  svn_boolean_t blocking,
+                  svn_boolean_t *success)
+{
+  int status = blocking ? pthread_mutex_lock(cache->shared_lock)
+                        : pthread_mutex_trylock(cache->shared_lock);
+  if (status == EBUSY && !blocking)
+    {
+      *success = FALSE;
+      return SVN_NO_ERROR;
+    }
+
+  if (status == EOWNERDEAD)
+    {
+      status = pthread_mutex_consistent(cache->shared_lock);
+      if (status)
+        {
+          pthread_mutex_unlock(cache->shared_lock);
+          return svn_error_wrap_apr(status,
+                                    _("Can't recover shared cache mutex"));
+        }
+
+      /* Like any other modification, the reset must make the sequence
+       * counter odd while it lasts.  It already is if the previous holder
+       * died in the middle of a write. */
+      if ((svn_atomic_read(&cache->sequence) & 1) == 0)
+        svn_atomic_inc(&cache->sequence);
+      reset_segment(cache);
+      svn_atomic_inc(&cache->sequence);
+    }
+  else if (status)
+    {
+      return svn_error_wrap_apr(status, _("Can't lock shared cache mutex"));
+    }
+
+  return SVN_NO_ERROR;
+}
+#endif
+
 /* If locking is supported for CACHE, acquire a read lock for it.
  */
 static svn_error_t *
 read_lock_cache(svn_membuffer_t *cache)
 {
+#if SHARED_CACHE_SUPPORTED
+  if (cache->shared_lock)
+    return shared_lock_cache(cache, TRUE, NULL);
+#endif
+
 #if (APR_HAS_THREADS && USE_SIMPLE_MUTEX)
   return svn_mutex__lock(cache->lock);
 #elif (APR_HAS_THREADS && !USE_SIMPLE_MUTEX)
@@ -851,6 +1012,11 @@ read_lock_cache(svn_membuffer_t *cache)
 static svn_error_t *
 write_lock_cache(svn_membuffer_t *cache, svn_boolean_t *success)
 {
+#if SHARED_CACHE_SUPPORTED
+  if (cache->shared_lock)
+    return shared_lock_cache(cache, cache->allow_blocking_writes, success);
+#endif
+
 #if (APR_HAS_THREADS && USE_SIMPLE_MUTEX)
   return svn_mutex__lock(cache->lock);
 #elif (APR_HAS_THREADS && !USE_SIMPLE_MUTEX)
@@ -888,6 +1054,11 @@ write_lock_cache(svn_membuffer_t *cache, svn_boolean_t *success)
 static svn_error_t *
 force_write_lock_cache(svn_membuffer_t *cache)
 {
+#if SHARED_CACHE_SUPPORTED
+  if (cache->shared_lock)
+    return shared_lock_cache(cache, TRUE, NULL);
+#endif
+
 #if (APR_HAS_THREADS && USE_SIMPLE_MUTEX)
   return svn_mutex__lock(cache->lock);
 #elif (APR_HAS_THREADS && !USE_SIMPLE_MUTEX)
@@ -908,6 +1079,21 @@ force_write_lock_cache(svn_membuffer_t *cache)
 static svn_error_t *
 unlock_cache(svn_membuffer_t *cache, svn_error_t *err)
 {
+#if SHARED_CACHE_SUPPORTED
+  if (cache->shared_lock)
+    {
+      int status = pthread_mutex_unlock(cache->shared_lock);
+      if (err)
+        return err;
+
+      if (status)
+        return svn_error_wrap_apr(status,
+                                  _("Can't unlock shared cache mutex"));
+
+      return SVN_NO_ERROR;
+    }
+#endif
+
 #if (APR_HAS_THREADS && USE_SIMPLE_MUTEX)
   return svn_mutex__unlock(cache->lock, err);
 #elif (APR_HAS_THREADS && !USE_SIMPLE_MUTEX)
@@ -927,6 +1113,25 @@ unlock_cache(svn_membuffer_t *cache, svn_error_t *err)
 #endif
 }
 
+/* Tell lock-free readers that we are about to modify CACHE.
+ * The caller must hold the write lock.
+ */
+static APR_INLINE void
+begin_write(svn_membuffer_t *cache)
+{
+  svn_atomic_inc(&cache->sequence);
+}
+
+/* Tell lock-free readers that we are done modifying CACHE.  Return ERR.
+ * The caller must still hold the write lock.
+ */
+static APR_INLINE svn_error_t *
+end_write(svn_membuffer_t *cache, svn_error_t *err)
+{
+  svn_atomic_inc(&cache->sequence);
+  return err;
+}
+
 /* If supported, guard the execution of EXPR with a read lock to CACHE.
  * The macro has been modeled after SVN_MUTEX__WITH_LOCK.
  */
@@ -959,7 +1164,8 @@ do {                                                            \
       else                                                      \
         break;                                                  \
     }                                                           \
-  SVN_ERR(unlock_cache(cache, (expr)));                         \
+  begin_write(cache);                                           \
+  SVN_ERR(unlock_cache(cache, end_write(cache, (expr))));       \
 } while (0)
 
 /* Returns 0 if the entry group identified by GROUP_INDEX in CACHE has not
@@ -1832,17 +2038,58 @@ ensure_data_insertable_l1(svn_membuffer_t *cache, apr_size_t size)
    * right answer. */
 }
 
-svn_error_t *
-svn_cache__membuffer_cache_create(svn_membuffer_t **cache,
-                                  apr_size_t total_size,
-                                  apr_size_t directory_size,
-                                  apr_size_t segment_count,
-                                  svn_boolean_t thread_safe,
-                                  svn_boolean_t allow_blocking_writes,
-                                  apr_pool_t *pool)
+/* Sequentially hands out chunks of a pre-allocated memory block.
+ */
+typedef struct chunk_allocator_t
+{
+  /* Start of the next chunk to hand out. */
+  char *next;
+
+  /* End of the memory block. */
+  char *end;
+} chunk_allocator_t;
+
+/* Return the next SIZE bytes from ALLOCATOR, aligned to ITEM_ALIGNMENT.
+ * If ALLOCATOR is NULL, allocate the memory in POOL instead.  Return NULL
+ * if we ran out of memory.
+ */
+static void *
+cache_alloc(chunk_allocator_t *allocator,
+            apr_size_t size,
+            apr_pool_t *pool)
+{
+  void *result;
+  if (allocator == NULL)
+    return apr_palloc(pool, size);
+
+  size = ALIGN_VALUE(size);
+  if (size > (apr_size_t)(allocator->end - allocator->next))
+    return NULL;
+
+  result = allocator->next;
+  allocator->next += size;
+
+  return result;
+}
+
+/* Implement svn_cache__membuffer_cache_create() and
+ * svn_cache__membuffer_cache_create_shared().  If SHARED is set, place
+ * the cache in anonymous shared memory and use cross-process locks.
+ * THREAD_SAFE is ignored in that case.
+ */
+static svn_error_t *
+membuffer_cache_create(svn_membuffer_t **cache,
+                       apr_size_t total_size,
+                       apr_size_t directory_size,
+                       apr_size_t segment_count,
+                       svn_boolean_t thread_safe,
+                       svn_boolean_t allow_blocking_writes,
+                       svn_boolean_t shared,
+                       apr_pool_t *pool)
 {
   svn_membuffer_t *c;
   prefix_pool_t *prefix_pool;
+  chunk_allocator_t *allocator = NULL;
 
   apr_uint32_t seg;
   apr_uint32_t group_count;
@@ -1852,11 +2099,29 @@ svn_cache__membuffer_cache_create(svn_membuffer_t **cache,
   apr_uint64_t data_size;
   apr_uint64_t max_entry_size;
 
+#if !SHARED_CACHE_SUPPORTED
+  /* Without robust mutexes, a process dying with a segment lock held
+   * would block all others forever. */
+  if (shared)
+    return svn_error_wrap_apr(APR_ENOTIMPL,
+                              _("Can't create shared memory cache"));
+#endif
+
   /* Allocate 1% of the cache capacity to the prefix string pool.
+   * Prefix indexes are only valid within the current process, though.
+   * Shared caches get an empty prefix pool and store full keys instead.
    */
-  SVN_ERR(prefix_pool_create(&prefix_pool, total_size / 100, thread_safe,
-                             pool));
-  total_size -= total_size / 100;
+  if (shared)
+    {
+      SVN_ERR(prefix_pool_create(&prefix_pool, 0, FALSE, pool));
+      thread_safe = FALSE;
+    }
+  else
+    {
+      SVN_ERR(prefix_pool_create(&prefix_pool, total_size / 100,
+                                 thread_safe, pool));
+      total_size -= total_size / 100;
+    }
 
   /* Limit the total size (only relevant if we can address > 4GB)
    */
@@ -1910,9 +2175,6 @@ svn_cache__membuffer_cache_create(svn_membuffer_t **cache,
          && segment_count < MAX_SEGMENT_COUNT)
     segment_count *= 2;
 
-  /* allocate cache as an array of segments / cache objects */
-  c = apr_palloc(pool, segment_count * sizeof(*c));
-
   /* Split total cache size into segments of equal size
    */
   total_size /= segment_count;
@@ -1963,6 +2225,42 @@ svn_cache__membuffer_cache_create(svn_membuffer_t **cache,
   assert(spare_group_count > 0 && main_group_count > 0);
 
   group_init_size = 1 + group_count / (8 * GROUP_INIT_GRANULARITY);
+
+#if SHARED_CACHE_SUPPORTED
+  /* Allocate one shared memory block for all segments, including their
+   * headers, and hand out chunks from it.
+   */
+  if (shared)
+    {
+      apr_shm_t *shm;
+      apr_status_t status;
+      apr_uint64_t shm_size
+        = ALIGN_VALUE(segment_count * sizeof(*c))
+        + segment_count
+            * (  ALIGN_VALUE(group_count * sizeof(entry_group_t))
+               + ALIGN_VALUE(group_init_size)
+               + ALIGN_VALUE(data_size)
+               + ALIGN_VALUE(sizeof(pthread_mutex_t)));
+
+      if (shm_size > APR_SIZE_MAX)
+        return svn_error_wrap_apr(APR_ENOMEM, "OOM");
+
+      status = apr_shm_create(&shm, (apr_size_t)shm_size, NULL, pool);
+      if (status)
+        return svn_error_wrap_apr(status,
+                                  _("Can't create shared memory cache"));
+
+      allocator = apr_palloc(pool, sizeof(*allocator));
+      allocator->next = apr_shm_baseaddr_get(shm);
+      allocator->end = allocator->next + apr_shm_size_get(shm);
+    }
+#endif
+
+  /* allocate cache as an array of segments / cache objects */
+  c = cache_alloc(allocator, segment_count * sizeof(*c), pool);
+  if (c == NULL)
+    return svn_error_wrap_apr(APR_ENOMEM, "OOM");
+
   for (seg = 0; seg < segment_count; ++seg)
     {
       /* allocate buffers and initialize cache members
@@ -1978,12 +2276,16 @@ svn_cache__membuffer_cache_create(svn_membuffer_t **cache,
       /* Allocate but don't clear / zero the directory because it would add
          significantly to the server start-up time if the caches are large.
          Group initialization will take care of that in stead. */
-      c[seg].directory = apr_palloc(pool,
-                                    group_count * sizeof(entry_group_t));
+      c[seg].directory = cache_alloc(allocator,
+                                     group_count * sizeof(entry_group_t),
+                                     pool);
 
       /* Allocate and initialize directory entries as "not initialized",
          hence "unused" */
-      c[seg].group_initialized = apr_pcalloc(pool, group_init_size);
+      c[seg].group_initialized = cache_alloc(allocator, group_init_size,
+                                             pool);
+      if (c[seg].group_initialized)
+        memset(c[seg].group_initialized, 0, group_init_size);
 
       /* Allocate 1/4th of the data buffer to L1
        */
@@ -2004,7 +2306,8 @@ svn_cache__membuffer_cache_create(svn_membuffer_t **cache,
       c[seg].l2.current_data = c[seg].l2.start_offset;
 
       /* This cast is safe because DATA_SIZE <= MAX_SEGMENT_SIZE. */
-      c[seg].data = apr_palloc(pool, (apr_size_t)ALIGN_VALUE(data_size));
+      c[seg].data = cache_alloc(allocator,
+                                (apr_size_t)ALIGN_VALUE(data_size), pool);
       c[seg].data_used = 0;
       c[seg].max_entry_size = max_entry_size;
 
@@ -2016,7 +2319,9 @@ svn_cache__membuffer_cache_create(svn_membuffer_t **cache,
       /* were allocations successful?
        * If not, initialize a minimal cache structure.
        */
-      if (c[seg].data == NULL || c[seg].directory == NULL)
+      if (   c[seg].data == NULL
+          || c[seg].directory == NULL
+          || c[seg].group_initialized == NULL)
         {
           /* We are OOM. There is no need to proceed with "half a cache".
            */
@@ -2039,13 +2344,48 @@ svn_cache__membuffer_cache_create(svn_membuffer_t **cache,
           if (status)
             return svn_error_wrap_apr(status, _("Can't create cache mutex"));
         }
+#endif
+
+#if SHARED_CACHE_SUPPORTED
+      /* Processes and threads sharing the cache must be serialized by a
+       * lock that lives in the shared memory as well or is inherited by
+       * child processes without any further initialization.
+       */
+      c[seg].shared_lock = NULL;
+      if (shared)
+        {
+          pthread_mutexattr_t attr;
+          int status;
+
+          c[seg].shared_lock = cache_alloc(allocator,
+                                           sizeof(*c[seg].shared_lock),
+                                           pool);
+          if (c[seg].shared_lock == NULL)
+            return svn_error_wrap_apr(APR_ENOMEM, "OOM");
+
+          status = pthread_mutexattr_init(&attr);
+          if (!status)
+            status = pthread_mutexattr_setpshared(&attr,
+                                                  PTHREAD_PROCESS_SHARED);
+          if (!status)
+            status = pthread_mutexattr_setrobust(&attr,
+                                                 PTHREAD_MUTEX_ROBUST);
+          if (!status)
+            status = pthread_mutex_init(c[seg].shared_lock, &attr);
+          pthread_mutexattr_destroy(&attr);
+
+          if (status)
+            return svn_error_wrap_apr(status,
+                                      _("Can't create shared cache mutex"));
+        }
+#endif
 
       /* Select the behavior of write operations.
        */
       c[seg].allow_blocking_writes = allow_blocking_writes;
-#endif
       /* No writers at the moment. */
       c[seg].write_lock_count = 0;
+      c[seg].sequence = 0;
     }
 
   /* done here
@@ -2054,18 +2394,43 @@ svn_cache__membuffer_cache_create(svn_membuffer_t **cache,
   return SVN_NO_ERROR;
 }
 
+svn_error_t *
+svn_cache__membuffer_cache_create(svn_membuffer_t **cache,
+                                  apr_size_t total_size,
+                                  apr_size_t directory_size,
+                                  apr_size_t segment_count,
+                                  svn_boolean_t thread_safe,
+                                  svn_boolean_t allow_blocking_writes,
+                                  apr_pool_t *pool)
+{
+  return svn_error_trace(membuffer_cache_create(cache, total_size,
+                                                directory_size,
+                                                segment_count, thread_safe,
+                                                allow_blocking_writes, FALSE,
+                                                pool));
+}
+
+svn_error_t *
+svn_cache__membuffer_cache_create_shared(svn_membuffer_t **cache,
+                                         apr_size_t total_size,
+                                         apr_size_t directory_size,
+                                         apr_size_t segment_count,
+                                         svn_boolean_t allow_blocking_writes,
+                                         apr_pool_t *pool)
+{
+  return svn_error_trace(membuffer_cache_create(cache, total_size,
+                                                directory_size,
+                                                segment_count, TRUE,
+                                                allow_blocking_writes, TRUE,
+                                                pool));
+}
+
 svn_error_t *
 svn_cache__membuffer_clear(svn_membuffer_t *cache)
 {
   apr_size_t seg;
   apr_size_t segment_count = cache->segment_count;
 
-  /* Length of the group_initialized array in bytes.
-     See also svn_cache__membuffer_cache_create(). */
-  apr_size_t group_init_size
-    = 1 + (cache->group_count + cache->spare_group_count)
-            / (8 * GROUP_INIT_GRANULARITY);
-
   /* Clear segment by segment.  This implies that other thread may read
      and write to other segments after we cleared them and before the
      last segment is done.
@@ -2078,31 +2443,13 @@ svn_cache__membuffer_clear(svn_membuffer_t *cache)
     {
       /* Unconditionally acquire the write lock. */
       SVN_ERR(force_write_lock_cache(&cache[seg]));
+      begin_write(&cache[seg]);
 
-      /* Mark all groups as "not initialized", which implies "empty". */
-      cache[seg].first_spare_group = NO_INDEX;
-      cache[seg].max_spare_used = 0;
-
-      memset(cache[seg].group_initialized, 0, group_init_size);
-
-      /* Unlink L1 contents. */
-      cache[seg].l1.first = NO_INDEX;
-      cache[seg].l1.last = NO_INDEX;
-      cache[seg].l1.next = NO_INDEX;
-      cache[seg].l1.current_data = cache[seg].l1.start_offset;
-
-      /* Unlink L2 contents. */
-      cache[seg].l2.first = NO_INDEX;
-      cache[seg].l2.last = NO_INDEX;
-      cache[seg].l2.next = NO_INDEX;
-      cache[seg].l2.current_data = cache[seg].l2.start_offset;
-
-      /* Reset content counters. */
-      cache[seg].data_used = 0;
-      cache[seg].used_entries = 0;
+      reset_segment(&cache[seg]);
 
       /* Segment may be used again. */
-      SVN_ERR(unlock_cache(&cache[seg], SVN_NO_ERROR));
+      SVN_ERR(unlock_cache(&cache[seg], end_write(&cache[seg],
+                                                  SVN_NO_ERROR)));
     }
 
   /* done here */
@@ -2433,6 +2780,131 @@ membuffer_cache_get_internal(svn_membuffer_t *cache,
   return SVN_NO_ERROR;
 }
 
+#if USE_LOCK_FREE_READS
+
+/* Lock-free variant of membuffer_cache_get_internal().
+ *
+ * Try to find the item identified by TO_FIND in group GROUP_INDEX of CACHE
+ * and copy its serialized data without taking the segment lock.  If no
+ * writer interfered, set *BUFFER and *ITEM_SIZE just like
+ * membuffer_cache_get_internal() and return TRUE.  Otherwise, return FALSE
+ * and the caller has to repeat the lookup with the segment lock being held.
+ * Allocations will be done in RESULT_POOL.
+ *
+ * Because the segment may change at any time, we must not trust any of the
+ * indexes, offsets and sizes that we read from it before checking them.
+ */
+static svn_boolean_t
+membuffer_cache_get_lock_free(svn_membuffer_t *cache,
+                              apr_uint32_t group_index,
+                              const full_key_t *to_find,
+                              char **buffer,
+                              apr_size_t *item_size,
+                              apr_pool_t *result_pool)
+{
+  apr_uint32_t sequence = svn_atomic_read(&cache->sequence);
+  apr_uint64_t data_size = cache->l2.start_offset + cache->l2.size;
+  apr_uint32_t group_count = cache->group_count + cache->spare_group_count;
+  volatile entry_t *entry = NULL;
+  char *copy = NULL;
+  apr_size_t copy_size = 0;
+  apr_size_t size = 0;
+  apr_uint32_t chain_length;
+
+  /* Is some writer modifying the segment right now? */
+  if (sequence & 1)
+    return FALSE;
+
+  READ_BARRIER();
+
+  if (is_group_initialized(cache, group_index))
+    {
+      volatile entry_group_t *group = &cache->directory[group_index];
+
+      /* Look for a matching key.  Never follow more links than a sane
+       * chain may have. */
+      for (chain_length = 0;
+           entry == NULL && chain_length < MAX_GROUP_CHAIN_LENGTH;
+           ++chain_length)
+        {
+          apr_uint32_t used = group->header.used;
+          apr_uint32_t next = group->header.next;
+          apr_uint32_t i;
+
+          if (used > GROUP_SIZE)
+            return FALSE;
+
+          for (i = 0; i < used; ++i)
+            {
+              entry_key_t key = group->entries[i].key;
+              if (entry_keys_match(&key, &to_find->entry_key))
+                {
+                  entry = &group->entries[i];
+                  break;
+                }
+            }
+
+          if (entry || next == NO_INDEX)
+            break;
+
+          if (next >= group_count)
+            return FALSE;
+
+          group = &cache->directory[next];
+        }
+    }
+
+  if (entry)
+    {
+      apr_uint64_t offset = entry->offset;
+      apr_size_t key_len = to_find->entry_key.key_len;
+      size = entry->size;
+
+      /* Only access the data buffer within its bounds. */
+      if (   size > cache->max_entry_size
+          || key_len > size
+          || offset > data_size
+          || ALIGN_VALUE(size) > data_size - offset)
+        return FALSE;
+
+      /* Compare the full key.  If it does not match, there is no entry
+       * for TO_FIND, see find_entry(). */
+      if (   key_len
+          && memcmp(to_find->full_key.data, cache->data + offset, key_len))
+        {
+          entry = NULL;
+        }
+      else
+        {
+          copy_size = ALIGN_VALUE(size) - key_len;
+          copy = apr_palloc(result_pool, copy_size);
+          memcpy(copy, cache->data + offset + key_len, copy_size);
+          size -= key_len;
+        }
+    }
+
+  /* Did we read a consistent state? */
+  READ_BARRIER();
+  if (svn_atomic_read(&cache->sequence) != sequence)
+    return FALSE;
+
+  /* Count the access like increment_hit_counters() does, but without
+   * atomic operations.  Losing an update now and then is fine. */
+  cache->total_reads++;
+  if (entry)
+    {
+      entry->hit_count++;
+      cache->total_hits++;
+    }
+
+  *buffer = copy;
+  *item_size = size;
+
+  return TRUE;
+}
+
+#endif
+
 /* Look for the *ITEM identified by KEY. If no item has been stored
  * for KEY, *ITEM will be NULL. Otherwise, the DESERIALIZER is called
  * to re-construct the proper object from the serialized data.
@@ -2453,14 +2925,22 @@ membuffer_cache_get(svn_membuffer_t *cache,
   /* find the entry group that will hold the key.
    */
   group_index = get_group_index(&cache, &key->entry_key);
-  WITH_READ_LOCK(cache,
-                 membuffer_cache_get_internal(cache,
-                                              group_index,
-                                              key,
-                                              &buffer,
-                                              &size,
-                                              DEBUG_CACHE_MEMBUFFER_TAG
-                                              result_pool));
+
+#if USE_LOCK_FREE_READS
+  /* Most of the time, there will be no concurrent writer. */
+  if (!membuffer_cache_get_lock_free(cache, group_index, key, &buffer,
+                                     &size, result_pool))
+#endif
+    {
+      WITH_READ_LOCK(cache,
+                     membuffer_cache_get_internal(cache,
+                                                  group_index,
+                                                  key,
+                                                  &buffer,
+                                                  &size,
+                                                  DEBUG_CACHE_MEMBUFFER_TAG
+                                                  result_pool));
+    }
 
   /* re-construct the original data object from its serialized form.
    */
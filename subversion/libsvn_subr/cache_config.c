@@ -28,6 +28,7 @@
 
 #include "svn_pools.h"
 #include "svn_sorts.h"
+#include "svn_private_config.h"
 
 /* The cache settings as a process-wide singleton.
  */
@@ -64,6 +65,17 @@ static svn_cache_config_t cache_settings =
 #endif
 };
 
+/* If set, the process-global membuffer cache shall be created in shared
+ * memory.  See svn_cache__create_shared_global_membuffer_cache().
+ */
+static svn_boolean_t share_global_cache = FALSE;
+
+/* The process-global (singleton) membuffer cache and its initialization
+ * state.
+ */
+static svn_membuffer_t *global_cache = NULL;
+static svn_atomic_t global_cache_initialized = 0;
+
 /* Get the current FSFS cache configuration. */
 const svn_cache_config_t *
 svn_cache_config_get(void)
@@ -71,14 +83,90 @@ svn_cache_config_get(void)
   return &cache_settings;
 }
 
+/* Create a membuffer cache of CACHE_SIZE bytes in *CACHE, in shared
+ * memory if SHARED is set.  Leave *CACHE untouched if we can't get the
+ * memory for the pool to allocate it in.
+ */
+static svn_error_t *
+create_global_cache(svn_membuffer_t **cache,
+                    apr_uint64_t cache_size,
+                    svn_boolean_t shared)
+{
+  svn_error_t *err;
+
+  /* auto-allocate cache */
+  apr_allocator_t *allocator = NULL;
+  apr_pool_t *pool = NULL;
+
+  if (apr_allocator_create(&allocator))
+    return SVN_NO_ERROR;
+
+  /* Ensure that we free partially allocated data if we run OOM
+   * before the cache is complete: If the cache cannot be allocated
+   * in its full size, the create() function will clear the pool
+   * explicitly. The allocator will make sure that any memory no
+   * longer used by the pool will actually be returned to the OS.
+   *
+   * Please note that this pool and allocator is used *only* to
+   * allocate the large membuffer. All later dynamic allocations
+   * come from other, temporary pools and allocators.
+   */
+  apr_allocator_max_free_set(allocator, 1);
+
+  /* don't terminate upon OOM but make pool return a NULL pointer
+   * instead so we can disable caching gracefully and continue
+   * operation without membuffer caches.
+   */
+  apr_pool_create_ex(&pool, NULL, NULL, allocator);
+  if (pool == NULL)
+    return SVN_NO_ERROR;
+  apr_allocator_owner_set(allocator, pool);
+
+  if (shared)
+    err = svn_cache__membuffer_cache_create_shared(
+        cache,
+        (apr_size_t)cache_size,
+        (apr_size_t)(cache_size / 5),
+        0,
+        FALSE,
+        pool);
+  else
+    err = svn_cache__membuffer_cache_create(
+        cache,
+        (apr_size_t)cache_size,
+        (apr_size_t)(cache_size / 5),
+        0,
+        ! svn_cache_config_get()->single_threaded,
+        FALSE,
+        pool);
+
+  /* Memory cleanup */
+  if (err)
+    svn_pool_destroy(pool);
+
+  return svn_error_trace(err);
+}
+
+/* Baton type for initialize_cache(). */
+typedef struct init_baton_t
+{
+  /* Receives the process-global (singleton) membuffer cache. */
+  svn_membuffer_t **cache_p;
+
+  /* Set to the reason why the cache could not be shared, if it was to be
+   * shared and a per-process cache got created instead. */
+  svn_error_t *shared_err;
+} init_baton_t;
+
 /* Initializer function as required by svn_atomic__init_once.  Allocate
  * the process-global (singleton) membuffer cache and return it in the
- * svn_membuffer_t * in *BATON.  UNUSED_POOL is unused and should be NULL.
+ * *CACHE_P of the init_baton_t in BATON.  UNUSED_POOL is unused and should
+ * be NULL.
  */
 static svn_error_t *
 initialize_cache(void *baton, apr_pool_t *unused_pool)
 {
-  svn_membuffer_t **cache_p = baton;
+  init_baton_t *b = baton;
   svn_membuffer_t *cache = NULL;
 
   /* Limit the cache size to about half the available address space
@@ -90,53 +178,21 @@ initialize_cache(void *baton, apr_pool_t *unused_pool)
   /* Create caches at all? */
   if (cache_size)
     {
-      svn_error_t *err;
-
-      /* auto-allocate cache */
-      apr_allocator_t *allocator = NULL;
-      apr_pool_t *pool = NULL;
+      svn_error_t *err = create_global_cache(&cache, cache_size,
+                                             share_global_cache);
 
-      if (apr_allocator_create(&allocator))
-        return SVN_NO_ERROR;
-
-      /* Ensure that we free partially allocated data if we run OOM
-       * before the cache is complete: If the cache cannot be allocated
-       * in its full size, the create() function will clear the pool
-       * explicitly. The allocator will make sure that any memory no
-       * longer used by the pool will actually be returned to the OS.
-       *
-       * Please note that this pool and allocator is used *only* to
-       * allocate the large membuffer. All later dynamic allocations
-       * come from other, temporary pools and allocators.
-       */
-      apr_allocator_max_free_set(allocator, 1);
-
-      /* don't terminate upon OOM but make pool return a NULL pointer
-       * instead so we can disable caching gracefully and continue
-       * operation without membuffer caches.
-       */
-      apr_pool_create_ex(&pool, NULL, NULL, allocator);
-      if (pool == NULL)
-        return SVN_NO_ERROR;
-      apr_allocator_owner_set(allocator, pool);
-
-      err = svn_cache__membuffer_cache_create(
-          &cache,
-          (apr_size_t)cache_size,
-          (apr_size_t)(cache_size / 5),
-          0,
-          ! svn_cache_config_get()->single_threaded,
-          FALSE,
-          pool);
+      /* Without a shared cache, each process still gets its own one. */
+      if (err && share_global_cache)
+        {
+          b->shared_err = err;
+          err = create_global_cache(&cache, cache_size, FALSE);
+        }
 
       /* Some error occurred. Most likely it's an OOM error but we don't
-       * really care. Simply release all cache memory and disable caching
+       * really care. Simply disable caching.
        */
       if (err)
         {
-          /* Memory cleanup */
-          svn_pool_destroy(pool);
-
           /* Document that we actually don't have a cache. */
           cache_settings.cache_size = 0;
 
@@ -144,7 +200,7 @@ initialize_cache(void *baton, apr_pool_t *unused_pool)
         }
 
       /* done */
-      *cache_p = cache;
+      *b->cache_p = cache;
     }
 
   return SVN_NO_ERROR;
@@ -158,11 +214,13 @@ initialize_cache(void *baton, apr_pool_t *unused_pool)
 svn_membuffer_t *
 svn_cache__get_global_membuffer_cache(void)
 {
-  static svn_membuffer_t *cache = NULL;
-  static svn_atomic_t initialized = 0;
-
+  init_baton_t baton = { &global_cache, NULL };
   svn_error_t *err
-    = svn_atomic__init_once(&initialized, initialize_cache, &cache, NULL);
+    = svn_atomic__init_once(&global_cache_initialized, initialize_cache,
+                            &baton, NULL);
+
+  /* A per-process cache is all we wanted here. */
+  svn_error_clear(baton.shared_err);
   if (err)
     {
       /* no caches today ... */
@@ -170,7 +228,30 @@ svn_cache__get_global_membuffer_cache(void)
       return NULL;
     }
 
-  return cache;
+  return global_cache;
+}
+
+svn_error_t *
+svn_cache__create_shared_global_membuffer_cache(void)
+{
+  init_baton_t baton = { &global_cache, NULL };
+  svn_error_t *err;
+
+  if (svn_atomic_read(&global_cache_initialized))
+    {
+      if (share_global_cache)
+        return SVN_NO_ERROR;
+
+      return svn_error_create(SVN_ERR_INCORRECT_PARAMS, NULL,
+                              _("The global cache has already been "
+                                "created"));
+    }
+
+  share_global_cache = TRUE;
+  err = svn_atomic__init_once(&global_cache_initialized, initialize_cache,
+                              &baton, NULL);
+
+  return svn_error_trace(svn_error_compose_create(baton.shared_err, err));
 }
 
 void
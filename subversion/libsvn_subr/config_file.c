@@ -1155,6 +1155,8 @@ svn_config_ensure(const char *config_dir, apr_pool_t *pool)
         "###                              HTTP operation."                   NL
         "###   http-chunked-requests      Whether to use chunked transfer"   NL
         "###                              encoding for HTTP requests body."  NL
+        "###   http-use-http2             Whether to negotiate HTTP/2 for"   NL
+        "###                              https connections."                NL
         "###   http-auth-types            List of HTTP authentication types."NL
         "###   ssl-authority-files        List of files, each of a trusted CA"
                                                                              NL
@@ -1553,6 +1555,33 @@ svn_config_ensure(const char *config_dir, apr_pool_t *pool)
         "### returning an error.  The default is 10000, i.e. 10 seconds."    NL
         "### Longer values may be useful when exclusive locking is enabled." NL
         "# busy-timeout = 10000"                                             NL
+        "### Set the number of threads that 'svn status' uses to scan"      NL
+        "### the working copy for local modifications.  Values larger than"  NL
+        "### 1 speed up the scan of large working copies, in particular on"  NL
+        "### slow or networked file systems.  This has no effect when"       NL
+        "### exclusive locking is enabled.  The default is 1."               NL
+        "# status-jobs = 1"                                                  NL
+        "### Set to true to let long-running clients, e.g. IDE plug-ins,"    NL
+        "### ask the operating system to report changes to working copy"     NL
+        "### directories.  Directories without reported changes are not"     NL
+        "### read again by later status or commit operations.  This is"      NL
+        "### currently only supported on Linux."                             NL
+        "# change-monitor = false"                                           NL
+        "### Set the number of threads that checkout, update and similar"    NL
+        "### operations use to write files into the working copy.  Values"   NL
+        "### larger than 1 speed up the installation of many files, in"      NL
+        "### particular on slow or networked file systems.  The default"     NL
+        "### is 1."                                                          NL
+        "# install-jobs = 1"                                                 NL
+        "### Set to true to store new pristine copies of files compressed"  NL
+        "### in the working copy administrative area.  This saves disk"      NL
+        "### space for large working copies, at the expense of some CPU"     NL
+        "### time.  Pristines that are already stored are not affected."     NL
+        "### Compression needs the working copy format of Subversion 1.15,"  NL
+        "### which new working copies are then created in and which"         NL
+        "### 'svn upgrade' upgrades existing ones to; older clients can't"   NL
+        "### use such working copies."                                       NL
+        "# compress-pristines = false"                                       NL
         ;
 
       err = svn_io_file_open(&f, path,
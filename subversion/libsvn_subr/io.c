@@ -51,6 +51,11 @@
 #include <fcntl.h>
 #endif
 
+#ifdef HAVE_LINUX_FS_H
+#include <sys/ioctl.h>
+#include <linux/fs.h>
+#endif
+
 #include "svn_hash.h"
 #include "svn_types.h"
 #include "svn_dirent_uri.h"
@@ -880,8 +885,86 @@ svn_io_temp_dir(const char **dir,
 
 /*** Creating, copying and appending files. ***/
 
+#if defined(FICLONE) || defined(HAVE_COPY_FILE_RANGE)
+/* Maximum number of bytes to pass to a single copy_file_range() call. */
+#define COPY_FILE_RANGE_CHUNK_SIZE 0x40000000
+
+/* Try to have the OS copy the contents of FROM_FILE to the empty TO_FILE
+ * without passing the data through user space.  Both files must be at
+ * offset 0.
+ *
+ * Where the file system supports it, e.g. on btrfs and XFS, make TO_FILE
+ * share the data blocks with FROM_FILE (reflink) and set *DONE to TRUE.
+ * Otherwise, let the kernel copy as much of the data as it can, set *DONE
+ * to FALSE and leave both file pointers at the end of the data that has
+ * been copied so far.  The caller is then expected to copy the remainder,
+ * if any, which also covers data appended to FROM_FILE in the meantime.
+ */
+static apr_status_t
+copy_contents_in_kernel(svn_boolean_t *done,
+                        apr_file_t *from_file,
+                        apr_file_t *to_file)
+{
+  apr_os_file_t from_fd;
+  apr_os_file_t to_fd;
+  apr_status_t status;
+
+  *done = FALSE;
+
+  status = apr_os_file_get(&from_fd, from_file);
+  if (status)
+    return status;
+  status = apr_os_file_get(&to_fd, to_file);
+  if (status)
+    return status;
+
+#ifdef FICLONE
+  /* This fails if e.g. the file system does not support reflinks or if
+   * the files are on different file systems.  Simply try the next option
+   * in that case. */
+  if (ioctl(to_fd, FICLONE, from_fd) == 0)
+    {
+      *done = TRUE;
+      return APR_SUCCESS;
+    }
+#endif
+
+#ifdef HAVE_COPY_FILE_RANGE
+  {
+    apr_finfo_t finfo;
+    apr_off_t remaining;
+
+    /* Some kernels report EOF early for files on special file systems.
+     * So, don't rely on that and copy exactly as much as we expect. */
+    status = apr_file_info_get(&finfo, APR_FINFO_SIZE, from_file);
+    if (status)
+      return status;
+
+    for (remaining = finfo.size; remaining > 0; )
+      {
+        apr_size_t chunk = remaining > COPY_FILE_RANGE_CHUNK_SIZE
+                         ? COPY_FILE_RANGE_CHUNK_SIZE
+                         : (apr_size_t)remaining;
+        ssize_t copied = copy_file_range(from_fd, NULL, to_fd, NULL,
+                                         chunk, 0);
+
+        /* Older kernels don't support copying across file systems etc.
+         * Let the caller copy whatever is left. */
+        if (copied <= 0)
+          break;
+
+        remaining -= copied;
+      }
+  }
+#endif
+
+  return APR_SUCCESS;
+}
+#endif
+
 /* Transfer the contents of FROM_FILE to TO_FILE, using POOL for temporary
- * allocations.
+ * allocations.  Where available, let the OS do the copying and fall back
+ * to reading and writing the data ourselves.
  *
  * NOTE: We don't use apr_copy_file() for this, since it takes filenames
  * as parameters.  Since we want to copy to a temporary file
@@ -894,6 +977,13 @@ copy_contents(apr_file_t *from_file,
               apr_file_t *to_file,
               apr_pool_t *pool)
 {
+#if defined(FICLONE) || defined(HAVE_COPY_FILE_RANGE)
+  svn_boolean_t done;
+  apr_status_t status = copy_contents_in_kernel(&done, from_file, to_file);
+  if (status || done)
+    return status;
+#endif
+
   /* Copy bytes till the cows come home. */
   while (1)
     {
@@ -117,6 +117,19 @@ sqlite_profiler(void *data, const char *sql, sqlite3_uint64 duration)
 }
 #endif
 
+/* An sqlite commit callback that counts the commits of the
+   svn_sqlite__db_t DATA. */
+static int
+count_commit(void *data)
+{
+  svn_sqlite__db_t *db = data;
+
+  db->commit_count++;
+
+  /* Let the commit go ahead. */
+  return 0;
+}
+
 #if defined(SVN_DEBUG) && defined(SQLITE_CONFIG_LOG)
 static void
 sqlite_error_log(void* baton, int err, const char* msg)
@@ -142,6 +155,9 @@ struct svn_sqlite__db_t
   svn_sqlite__stmt_t **prepared_stmts;
   apr_pool_t *state_pool;
 
+  /* Number of transactions committed through this connection. */
+  apr_uint64_t commit_count;
+
 #ifdef SVN_UNICODE_NORMALIZATION_FIXES
   /* Buffers for SQLite extensoins. */
   svn_membuf_t sqlext_buf1;
@@ -1133,6 +1149,7 @@ svn_sqlite__open(svn_sqlite__db_t **db, const char *path,
 #ifdef SQLITE3_PROFILE
   sqlite3_profile((*db)->db3, sqlite_profiler, (*db)->db3);
 #endif
+  sqlite3_commit_hook((*db)->db3, count_commit, *db);
 
   SVN_SQLITE__ERR_CLOSE(exec_sql(*db,
               /* The default behavior of the LIKE operator is to ignore case
@@ -1458,6 +1475,12 @@ svn_sqlite__with_lock(svn_sqlite__db_t *db,
   return SVN_NO_ERROR;
 }
 
+apr_uint64_t
+svn_sqlite__get_commit_count(svn_sqlite__db_t *db)
+{
+  return db->commit_count;
+}
+
 svn_error_t *
 svn_sqlite__hotcopy(const char *src_path,
                     const char *dst_path,
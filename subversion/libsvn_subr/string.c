@@ -37,6 +37,10 @@
 
 #include "svn_private_config.h"
 
+#if SVN__SSE2_IS_OK
+#include <emmintrin.h>
+#endif
+
 
 
 /* Allocate the space for a memory buffer from POOL.
@@ -1508,6 +1512,19 @@ svn_cstring__match_length(const char *a,
 {
   apr_size_t pos = 0;
 
+#if SVN__SSE2_IS_OK
+
+  /* Compare 16 bytes at a time.  Upon mismatch, the word-wise and
+   * byte-wise loops below will find the exact position. */
+  for (; max_len - pos >= sizeof(__m128i); pos += sizeof(__m128i))
+    {
+      __m128i chunk_a = _mm_loadu_si128((const __m128i *)(a + pos));
+      __m128i chunk_b = _mm_loadu_si128((const __m128i *)(b + pos));
+      if (_mm_movemask_epi8(_mm_cmpeq_epi8(chunk_a, chunk_b)) != 0xffff)
+        break;
+    }
+
+#endif
 #if SVN_UNALIGNED_ACCESS_IS_OK
 
   /* Chunky processing is so much faster ...
@@ -1536,6 +1553,20 @@ svn_cstring__reverse_match_length(const char *a,
 {
   apr_size_t pos = 0;
 
+#if SVN__SSE2_IS_OK
+
+  /* Compare 16 bytes at a time, see svn_cstring__match_length(). */
+  for (; max_len - pos >= sizeof(__m128i); pos += sizeof(__m128i))
+    {
+      const char *start_a = a - pos - sizeof(__m128i);
+      const char *start_b = b - pos - sizeof(__m128i);
+      __m128i chunk_a = _mm_loadu_si128((const __m128i *)start_a);
+      __m128i chunk_b = _mm_loadu_si128((const __m128i *)start_b);
+      if (_mm_movemask_epi8(_mm_cmpeq_epi8(chunk_a, chunk_b)) != 0xffff)
+        break;
+    }
+
+#endif
 #if SVN_UNALIGNED_ACCESS_IS_OK
 
   /* Chunky processing is so much faster ...
@@ -1544,12 +1575,11 @@ svn_cstring__reverse_match_length(const char *a,
    * because A and B will probably have different alignment. So, skipping
    * the first few chars until alignment is reached is not an option.
    */
-  for (pos = sizeof(apr_size_t); pos <= max_len; pos += sizeof(apr_size_t))
-    if (*(const apr_size_t*)(a - pos) != *(const apr_size_t*)(b - pos))
+  for (; max_len - pos >= sizeof(apr_size_t); pos += sizeof(apr_size_t))
+    if (*(const apr_size_t*)(a - pos - sizeof(apr_size_t))
+        != *(const apr_size_t*)(b - pos - sizeof(apr_size_t)))
       break;
 
-  pos -= sizeof(apr_size_t);
-
 #endif
 
   /* If we find a mismatch at -pos, pos-1 characters matched.
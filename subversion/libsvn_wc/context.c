@@ -27,6 +27,7 @@
 #include "svn_pools.h"
 #include "svn_dirent_uri.h"
 #include "svn_path.h"
+#include "svn_config.h"
 
 #include "wc.h"
 #include "wc_db.h"
@@ -73,6 +74,27 @@ svn_wc_context_create(svn_wc_context_t **wc_ctx,
                           FALSE, TRUE, ctx->state_pool, scratch_pool));
   ctx->close_db_on_destroy = TRUE;
 
+  if (config)
+    {
+      svn_boolean_t use_monitor;
+
+      SVN_ERR(svn_config_get_bool((svn_config_t *)config, &use_monitor,
+                                  SVN_CONFIG_SECTION_WORKING_COPY,
+                                  SVN_CONFIG_OPTION_CHANGE_MONITOR,
+                                  FALSE));
+      if (use_monitor)
+        {
+          /* Where not supported, simply don't use it. */
+          svn_error_t *err = svn_wc__monitor_create(&ctx->monitor,
+                                                    ctx->state_pool);
+          if (err)
+            {
+              svn_error_clear(err);
+              ctx->monitor = NULL;
+            }
+        }
+    }
+
   apr_pool_cleanup_register(result_pool, ctx, close_ctx_apr,
                             apr_pool_cleanup_null);
 
@@ -0,0 +1,459 @@
+/*
+ * monitor.c :  cache directory listings as long as the OS reports no change
+ *
+ * ====================================================================
+ *    Licensed to the Apache Software Foundation (ASF) under one
+ *    or more contributor license agreements.  See the NOTICE file
+ *    distributed with this work for additional information
+ *    regarding copyright ownership.  The ASF licenses this file
+ *    to you under the Apache License, Version 2.0 (the
+ *    "License"); you may not use this file except in compliance
+ *    with the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing,
+ *    software distributed under the License is distributed on an
+ *    "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *    KIND, either express or implied.  See the License for the
+ *    specific language governing permissions and limitations
+ *    under the License.
+ * ====================================================================
+ */
+
+#include <apr_pools.h>
+#include <apr_hash.h>
+#include <apr_strings.h>
+
+#ifdef HAVE_SYS_INOTIFY_H
+#include <errno.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+#endif
+
+#include "svn_types.h"
+#include "svn_pools.h"
+#include "svn_dirent_uri.h"
+#include "svn_hash.h"
+#include "svn_io.h"
+
+#include "private/svn_mutex.h"
+
+#include "monitor.h"
+
+#include "svn_private_config.h"
+
+
+#ifdef HAVE_SYS_INOTIFY_H
+
+/* The events that may change the result of svn_io_get_dirents3() for a
+   watched directory or that tell us that the watch became useless. */
+#define WATCH_MASK (IN_ATTRIB | IN_CREATE | IN_DELETE | IN_MODIFY     \
+                    | IN_MOVED_FROM | IN_MOVED_TO                     \
+                    | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR)
+
+/* A directory that we have been asked about. */
+typedef struct monitored_dir_t
+{
+  /* The directory's path.  Allocated in the monitor's pool. */
+  const char *local_abspath;
+
+  /* The inotify watch descriptor or -1 if we don't watch the directory. */
+  int wd;
+
+  /* Set when a change has been reported since we started watching. */
+  svn_boolean_t changed;
+
+  /* The remembered listing or NULL.  Allocated in DIRENTS_POOL. */
+  apr_hash_t *dirents;
+  svn_boolean_t only_check_type;
+  apr_pool_t *dirents_pool;
+} monitored_dir_t;
+
+struct svn_wc__monitor_t
+{
+  /* Users may run in different threads, so serialize all access. */
+  svn_mutex__t *mutex;
+
+  /* The inotify instance. */
+  int fd;
+
+  /* All directories we have been asked about, keyed by path. */
+  apr_hash_t *dirs;
+
+  /* The watched directories, keyed by their watch descriptor. */
+  apr_hash_t *watches;
+
+  /* Pool with a thread-safe allocator for all of the above. */
+  apr_pool_t *pool;
+};
+
+/* APR cleanup function closing the inotify instance of the
+   svn_wc__monitor_t in DATA and releasing all of its memory. */
+static apr_status_t
+close_monitor(void *data)
+{
+  svn_wc__monitor_t *monitor = data;
+
+  close(monitor->fd);
+  svn_pool_destroy(monitor->pool);
+
+  return APR_SUCCESS;
+}
+
+/* Drop the remembered listing of DIR and mark it as changed. */
+static void
+invalidate_dir(monitored_dir_t *dir)
+{
+  if (dir->dirents_pool)
+    svn_pool_destroy(dir->dirents_pool);
+
+  dir->dirents = NULL;
+  dir->dirents_pool = NULL;
+  dir->changed = TRUE;
+}
+
+/* Invalidate all directories in MONITOR at or below LOCAL_ABSPATH.  If
+   LOCAL_ABSPATH is NULL, invalidate all directories.  Use SCRATCH_POOL for
+   temporary allocations. */
+static void
+invalidate_tree(svn_wc__monitor_t *monitor,
+                const char *local_abspath,
+                apr_pool_t *scratch_pool)
+{
+  apr_hash_index_t *hi;
+
+  for (hi = apr_hash_first(scratch_pool, monitor->dirs);
+       hi;
+       hi = apr_hash_next(hi))
+    {
+      monitored_dir_t *dir = apr_hash_this_val(hi);
+
+      if (!local_abspath
+          || svn_dirent_is_ancestor(local_abspath, dir->local_abspath))
+        invalidate_dir(dir);
+    }
+}
+
+/* Stop associating DIR with its watch descriptor in MONITOR and, if
+   REMOVE_WATCH is set, tell the kernel to drop the watch. */
+static void
+unwatch_dir(svn_wc__monitor_t *monitor,
+            monitored_dir_t *dir,
+            svn_boolean_t remove_watch)
+{
+  if (dir->wd < 0)
+    return;
+
+  if (apr_hash_get(monitor->watches, &dir->wd, sizeof(dir->wd)) == dir)
+    {
+      apr_hash_set(monitor->watches, &dir->wd, sizeof(dir->wd), NULL);
+      if (remove_watch)
+        inotify_rm_watch(monitor->fd, dir->wd);
+    }
+
+  dir->wd = -1;
+}
+
+/* Update MONITOR according to EVENT.  Use SCRATCH_POOL for temporary
+   allocations. */
+static void
+handle_event(svn_wc__monitor_t *monitor,
+             const struct inotify_event *event,
+             apr_pool_t *scratch_pool)
+{
+  monitored_dir_t *dir;
+
+  /* We lost events. */
+  if (event->mask & IN_Q_OVERFLOW)
+    {
+      invalidate_tree(monitor, NULL, scratch_pool);
+      return;
+    }
+
+  dir = apr_hash_get(monitor->watches, &event->wd, sizeof(event->wd));
+  if (!dir)
+    return;
+
+  if (event->mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED
+                     | IN_UNMOUNT))
+    {
+      /* The watch is not on LOCAL_ABSPATH anymore.  Sub-directory watches
+         may have moved with it, so don't trust them either. */
+      invalidate_tree(monitor, dir->local_abspath, scratch_pool);
+      unwatch_dir(monitor, dir, !(event->mask & IN_IGNORED));
+    }
+  else if (event->len && (event->mask & IN_ISDIR))
+    {
+      /* A sub-directory got replaced. */
+      invalidate_dir(dir);
+      invalidate_tree(monitor,
+                      svn_dirent_join(dir->local_abspath, event->name,
+                                      scratch_pool),
+                      scratch_pool);
+    }
+  else
+    {
+      invalidate_dir(dir);
+    }
+}
+
+/* Read all pending change events for MONITOR from the kernel and
+   process them.  Use SCRATCH_POOL for temporary allocations. */
+static svn_error_t *
+process_events(svn_wc__monitor_t *monitor,
+               apr_pool_t *scratch_pool)
+{
+  union
+  {
+    struct inotify_event event;
+    char data[4096];
+  } buffer;
+
+  while (TRUE)
+    {
+      const char *p;
+      ssize_t len = read(monitor->fd, buffer.data, sizeof(buffer.data));
+
+      if (len < 0)
+        {
+          if (errno == EINTR)
+            continue;
+          if (errno == EAGAIN || errno == EWOULDBLOCK)
+            break;
+
+          return svn_error_wrap_apr(apr_get_os_error(),
+                                    _("Can't read change events"));
+        }
+
+      if (len == 0)
+        break;
+
+      for (p = buffer.data; p < buffer.data + len; )
+        {
+          const struct inotify_event *event = (const void *)p;
+
+          handle_event(monitor, event, scratch_pool);
+          p += sizeof(*event) + event->len;
+        }
+    }
+
+  return SVN_NO_ERROR;
+}
+
+/* Make sure that MONITOR has an entry for LOCAL_ABSPATH and return it in
+   *DIR.  Start watching the directory that is currently at LOCAL_ABSPATH
+   and reset the entry's CHANGED flag, unless we can't watch it. */
+static svn_error_t *
+watch_dir(monitored_dir_t **dir,
+          svn_wc__monitor_t *monitor,
+          const char *local_abspath)
+{
+  monitored_dir_t *result = svn_hash_gets(monitor->dirs, local_abspath);
+  int wd;
+
+  if (!result)
+    {
+      result = apr_pcalloc(monitor->pool, sizeof(*result));
+      result->local_abspath = apr_pstrdup(monitor->pool, local_abspath);
+      result->wd = -1;
+      svn_hash_sets(monitor->dirs, result->local_abspath, result);
+    }
+
+  *dir = result;
+
+  /* This is cheap if we already watch this directory but the path might
+     refer to a different directory now. */
+  wd = inotify_add_watch(monitor->fd, local_abspath, WATCH_MASK);
+  if (wd != result->wd)
+    unwatch_dir(monitor, result, TRUE);
+
+  /* Running out of watches or the directory being gone is not an error.
+     We simply won't remember anything.  The same applies to the same
+     directory being reachable via multiple paths. */
+  if (wd < 0)
+    {
+      invalidate_dir(result);
+      return SVN_NO_ERROR;
+    }
+
+  if (result->wd < 0)
+    {
+      if (apr_hash_get(monitor->watches, &wd, sizeof(wd)))
+        {
+          invalidate_dir(result);
+          return SVN_NO_ERROR;
+        }
+
+      result->wd = wd;
+      apr_hash_set(monitor->watches, &result->wd, sizeof(result->wd),
+                   result);
+    }
+
+  result->changed = FALSE;
+
+  return SVN_NO_ERROR;
+}
+
+/* Return a deep copy of DIRENTS allocated in RESULT_POOL. */
+static apr_hash_t *
+dup_dirents(apr_hash_t *dirents,
+            apr_pool_t *result_pool)
+{
+  apr_hash_t *result = apr_hash_make(result_pool);
+  apr_hash_index_t *hi;
+
+  for (hi = apr_hash_first(NULL, dirents); hi; hi = apr_hash_next(hi))
+    {
+      const char *name = apr_hash_this_key(hi);
+      const svn_io_dirent2_t *dirent = apr_hash_this_val(hi);
+
+      svn_hash_sets(result, apr_pstrdup(result_pool, name),
+                    svn_io_dirent2_dup(dirent, result_pool));
+    }
+
+  return result;
+}
+
+/* The guts of svn_wc__monitor_get_dirents(), called with the mutex held. */
+static svn_error_t *
+get_dirents(apr_hash_t **dirents,
+            svn_wc__monitor_t *monitor,
+            const char *local_abspath,
+            svn_boolean_t only_check_type,
+            apr_pool_t *result_pool,
+            apr_pool_t *scratch_pool)
+{
+  monitored_dir_t *dir;
+
+  SVN_ERR(process_events(monitor, scratch_pool));
+
+  dir = svn_hash_gets(monitor->dirs, local_abspath);
+  if (dir && dir->dirents && (only_check_type || !dir->only_check_type))
+    {
+      *dirents = dup_dirents(dir->dirents, result_pool);
+      return SVN_NO_ERROR;
+    }
+
+  *dirents = NULL;
+  return svn_error_trace(watch_dir(&dir, monitor, local_abspath));
+}
+
+/* The guts of svn_wc__monitor_set_dirents(), called with the mutex held. */
+static svn_error_t *
+set_dirents(svn_wc__monitor_t *monitor,
+            const char *local_abspath,
+            apr_hash_t *dirents,
+            svn_boolean_t only_check_type,
+            apr_pool_t *scratch_pool)
+{
+  monitored_dir_t *dir;
+
+  SVN_ERR(process_events(monitor, scratch_pool));
+
+  /* Only remember DIRENTS if we watched the directory all the time
+     since before DIRENTS got read. */
+  dir = svn_hash_gets(monitor->dirs, local_abspath);
+  if (!dir || dir->changed || dir->wd < 0)
+    return SVN_NO_ERROR;
+
+  if (dir->dirents_pool)
+    svn_pool_destroy(dir->dirents_pool);
+
+  dir->dirents_pool = svn_pool_create(monitor->pool);
+  dir->dirents = dup_dirents(dirents, dir->dirents_pool);
+  dir->only_check_type = only_check_type;
+
+  return SVN_NO_ERROR;
+}
+
+svn_error_t *
+svn_wc__monitor_create(svn_wc__monitor_t **monitor,
+                       apr_pool_t *result_pool)
+{
+  svn_wc__monitor_t *result = apr_pcalloc(result_pool, sizeof(*result));
+
+  result->fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (result->fd < 0)
+    return svn_error_wrap_apr(apr_get_os_error(),
+                              _("Can't initialize change monitor"));
+
+  /* The monitor may be used by multiple threads, so it needs its own,
+     thread-safe allocator. */
+  result->pool = apr_allocator_owner_get(svn_pool_create_allocator(TRUE));
+  result->dirs = apr_hash_make(result->pool);
+  result->watches = apr_hash_make(result->pool);
+  SVN_ERR(svn_mutex__init(&result->mutex, TRUE, result->pool));
+
+  apr_pool_cleanup_register(result_pool, result, close_monitor,
+                            apr_pool_cleanup_null);
+
+  *monitor = result;
+
+  return SVN_NO_ERROR;
+}
+
+svn_error_t *
+svn_wc__monitor_get_dirents(apr_hash_t **dirents,
+                            svn_wc__monitor_t *monitor,
+                            const char *local_abspath,
+                            svn_boolean_t only_check_type,
+                            apr_pool_t *result_pool,
+                            apr_pool_t *scratch_pool)
+{
+  SVN_MUTEX__WITH_LOCK(monitor->mutex,
+                       get_dirents(dirents, monitor, local_abspath,
+                                   only_check_type, result_pool,
+                                   scratch_pool));
+
+  return SVN_NO_ERROR;
+}
+
+svn_error_t *
+svn_wc__monitor_set_dirents(svn_wc__monitor_t *monitor,
+                            const char *local_abspath,
+                            apr_hash_t *dirents,
+                            svn_boolean_t only_check_type,
+                            apr_pool_t *scratch_pool)
+{
+  SVN_MUTEX__WITH_LOCK(monitor->mutex,
+                       set_dirents(monitor, local_abspath, dirents,
+                                   only_check_type, scratch_pool));
+
+  return SVN_NO_ERROR;
+}
+
+#else /* !HAVE_SYS_INOTIFY_H */
+
+svn_error_t *
+svn_wc__monitor_create(svn_wc__monitor_t **monitor,
+                       apr_pool_t *result_pool)
+{
+  return svn_error_create(SVN_ERR_UNSUPPORTED_FEATURE, NULL,
+                          _("Change monitoring is not supported on this "
+                            "platform"));
+}
+
+svn_error_t *
+svn_wc__monitor_get_dirents(apr_hash_t **dirents,
+                            svn_wc__monitor_t *monitor,
+                            const char *local_abspath,
+                            svn_boolean_t only_check_type,
+                            apr_pool_t *result_pool,
+                            apr_pool_t *scratch_pool)
+{
+  *dirents = NULL;
+  return SVN_NO_ERROR;
+}
+
+svn_error_t *
+svn_wc__monitor_set_dirents(svn_wc__monitor_t *monitor,
+                            const char *local_abspath,
+                            apr_hash_t *dirents,
+                            svn_boolean_t only_check_type,
+                            apr_pool_t *scratch_pool)
+{
+  return SVN_NO_ERROR;
+}
+
+#endif /* HAVE_SYS_INOTIFY_H */
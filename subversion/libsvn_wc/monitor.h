@@ -0,0 +1,98 @@
+/*
+ * monitor.h :  cache directory listings as long as the OS reports no change
+ *
+ * ====================================================================
+ *    Licensed to the Apache Software Foundation (ASF) under one
+ *    or more contributor license agreements.  See the NOTICE file
+ *    distributed with this work for additional information
+ *    regarding copyright ownership.  The ASF licenses this file
+ *    to you under the Apache License, Version 2.0 (the
+ *    "License"); you may not use this file except in compliance
+ *    with the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing,
+ *    software distributed under the License is distributed on an
+ *    "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *    KIND, either express or implied.  See the License for the
+ *    specific language governing permissions and limitations
+ *    under the License.
+ * ====================================================================
+ */
+
+
+#ifndef SVN_LIBSVN_WC_MONITOR_H
+#define SVN_LIBSVN_WC_MONITOR_H
+
+#include <apr_pools.h>
+#include <apr_hash.h>
+
+#include "svn_types.h"
+#include "svn_error.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+
+/* A change monitor remembers the result of svn_io_get_dirents3() for
+   directories and asks the OS to report any change to them, e.g. via
+   Linux' inotify.  As long as no change has been reported for a directory,
+   its remembered listing is still accurate and there is no need to read
+   and stat() it again.
+
+   This is only useful to long-running clients that scan the same working
+   copies repeatedly, e.g. IDE integrations running 'status' after every
+   edit.  The monitor is shared by all users of a svn_wc_context_t and may
+   be used from multiple threads.
+
+   Changes made to a file through a hard link in another directory will
+   not be noticed.  Also, the size and time stamps of sub-directories in a
+   remembered listing may be outdated; only their kind is reliable. */
+typedef struct svn_wc__monitor_t svn_wc__monitor_t;
+
+/* Set *MONITOR to a new, empty change monitor allocated in RESULT_POOL.
+   Return SVN_ERR_UNSUPPORTED_FEATURE if this platform cannot monitor
+   directories. */
+svn_error_t *
+svn_wc__monitor_create(svn_wc__monitor_t **monitor,
+                       apr_pool_t *result_pool);
+
+/* Set *DIRENTS to the svn_io_dirent2_t listing of directory LOCAL_ABSPATH
+   that has been given to svn_wc__monitor_set_dirents() before, if it is
+   still up-to-date according to MONITOR.  If ONLY_CHECK_TYPE is FALSE,
+   this requires the listing to contain all fields.  Otherwise, set
+   *DIRENTS to NULL and start monitoring LOCAL_ABSPATH, so that the caller
+   may read the listing from disk and store it in MONITOR.
+
+   Allocate *DIRENTS in RESULT_POOL.  Use SCRATCH_POOL for temporary
+   allocations. */
+svn_error_t *
+svn_wc__monitor_get_dirents(apr_hash_t **dirents,
+                            svn_wc__monitor_t *monitor,
+                            const char *local_abspath,
+                            svn_boolean_t only_check_type,
+                            apr_pool_t *result_pool,
+                            apr_pool_t *scratch_pool);
+
+/* Store a copy of DIRENTS as returned by svn_io_get_dirents3() for
+   LOCAL_ABSPATH and ONLY_CHECK_TYPE in MONITOR.  The listing must have
+   been read after svn_wc__monitor_get_dirents() returned NULL for
+   LOCAL_ABSPATH.  If a change has been reported since, DIRENTS may already
+   be outdated and will not be stored.
+
+   Use SCRATCH_POOL for temporary allocations. */
+svn_error_t *
+svn_wc__monitor_set_dirents(svn_wc__monitor_t *monitor,
+                            const char *local_abspath,
+                            apr_hash_t *dirents,
+                            svn_boolean_t only_check_type,
+                            apr_pool_t *scratch_pool);
+
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* SVN_LIBSVN_WC_MONITOR_H */
@@ -51,6 +51,7 @@
 #include "private/svn_wc_private.h"
 #include "private/svn_fspath.h"
 #include "private/svn_editor.h"
+#include "private/svn_task.h"
 
 
 /* The file internal variant of svn_wc_status3_t, with slightly more
@@ -94,12 +95,20 @@ struct walk_status_baton
   /* Externals info harvested during the status run. */
   apr_hash_t *externals;
 
+  /* Remembered directory listings, if available.  May be NULL. */
+  svn_wc__monitor_t *monitor;
+
   /*** Repository lock handling ***/
   /* The repository root URL, if set. */
   const char *repos_root;
 
   /* Repository locks, if set. */
   apr_hash_t *repos_locks;
+
+  /* When walking concurrently, the task processing the current directory.
+     Sub-directories will then become sub-tasks instead of being walked
+     recursively.  NULL otherwise. */
+  struct dir_status_task_t *dir_task;
 };
 
 /*** Editor batons ***/
@@ -1042,6 +1051,21 @@ get_dir_status(const struct walk_status_baton *wb,
                void *cancel_baton,
                apr_pool_t *scratch_pool);
 
+/* Add a sub-task to DIR_TASK that walks the versioned directory
+   LOCAL_ABSPATH with depth infinity, skipping its own status.  This is
+   the concurrent equivalent of calling get_dir_status() for it.
+
+   The remaining parameters correspond to get_dir_status(). */
+static svn_error_t *
+add_dir_status_task(struct dir_status_task_t *dir_task,
+                    const char *local_abspath,
+                    const char *parent_repos_root_url,
+                    const char *parent_repos_relpath,
+                    const char *parent_repos_uuid,
+                    const apr_array_header_t *ignore_patterns,
+                    svn_boolean_t get_all,
+                    svn_boolean_t no_ignore);
+
 /* Send out a status structure according to the information gathered on one
  * child node. (Basically this function is the guts of the loop in
  * get_dir_status() and of get_child_status().)
@@ -1123,15 +1147,21 @@ one_child_status(const struct walk_status_baton *wb,
       if (depth == svn_depth_infinity
           && info->has_descendants /* is dir, or was dir and tc descendants */)
         {
-          SVN_ERR(get_dir_status(wb, local_abspath, TRUE,
-                                 dir_repos_root_url, dir_repos_relpath,
-                                 dir_repos_uuid, info,
-                                 dirent, ignore_patterns,
-                                 svn_depth_infinity, get_all,
-                                 no_ignore,
-                                 status_func, status_baton,
-                                 cancel_func, cancel_baton,
-                                 scratch_pool));
+          if (wb->dir_task)
+            SVN_ERR(add_dir_status_task(wb->dir_task, local_abspath,
+                                        dir_repos_root_url, dir_repos_relpath,
+                                        dir_repos_uuid, ignore_patterns,
+                                        get_all, no_ignore));
+          else
+            SVN_ERR(get_dir_status(wb, local_abspath, TRUE,
+                                   dir_repos_root_url, dir_repos_relpath,
+                                   dir_repos_uuid, info,
+                                   dirent, ignore_patterns,
+                                   svn_depth_infinity, get_all,
+                                   no_ignore,
+                                   status_func, status_baton,
+                                   cancel_func, cancel_baton,
+                                   scratch_pool));
         }
 
       return SVN_NO_ERROR;
@@ -1188,6 +1218,52 @@ one_child_status(const struct walk_status_baton *wb,
   return SVN_NO_ERROR;
 }
 
+/* Set *DIRENTS to the svn_io_dirent2_t listing of LOCAL_ABSPATH as needed
+   for WB.  If LOCAL_ABSPATH does not exist or is not a directory, that
+   listing will be empty.  Reuse the listing remembered by WB->MONITOR,
+   if available.
+
+   Allocate *DIRENTS in RESULT_POOL and temporaries in SCRATCH_POOL. */
+static svn_error_t *
+read_dirents(apr_hash_t **dirents,
+             const struct walk_status_baton *wb,
+             const char *local_abspath,
+             apr_pool_t *result_pool,
+             apr_pool_t *scratch_pool)
+{
+  svn_error_t *err;
+
+  if (wb->monitor)
+    {
+      SVN_ERR(svn_wc__monitor_get_dirents(dirents, wb->monitor,
+                                          local_abspath,
+                                          wb->ignore_text_mods,
+                                          result_pool, scratch_pool));
+      if (*dirents)
+        return SVN_NO_ERROR;
+    }
+
+  err = svn_io_get_dirents3(dirents, local_abspath,
+                            wb->ignore_text_mods /* only_check_type*/,
+                            result_pool, scratch_pool);
+  if (err
+      && (APR_STATUS_IS_ENOENT(err->apr_err)
+          || SVN__APR_STATUS_IS_ENOTDIR(err->apr_err)))
+    {
+      svn_error_clear(err);
+      *dirents = apr_hash_make(result_pool);
+      return SVN_NO_ERROR;
+    }
+  SVN_ERR(err);
+
+  if (wb->monitor)
+    SVN_ERR(svn_wc__monitor_set_dirents(wb->monitor, local_abspath,
+                                        *dirents, wb->ignore_text_mods,
+                                        scratch_pool));
+
+  return SVN_NO_ERROR;
+}
+
 /* Send svn_wc_status3_t * structures for the directory LOCAL_ABSPATH and
    for all its child nodes (according to DEPTH) through STATUS_FUNC /
    STATUS_BATON.
@@ -1234,7 +1310,6 @@ get_dir_status(const struct walk_status_baton *wb,
   apr_array_header_t *sorted_children;
   apr_array_header_t *collected_ignore_patterns = NULL;
   apr_pool_t *iterpool;
-  svn_error_t *err;
   int i;
 
   if (cancel_func)
@@ -1246,20 +1321,8 @@ get_dir_status(const struct walk_status_baton *wb,
   iterpool = svn_pool_create(scratch_pool);
 
   if (wb->check_working_copy)
-    {
-      err = svn_io_get_dirents3(&dirents, local_abspath,
-                                wb->ignore_text_mods /* only_check_type*/,
-                                scratch_pool, iterpool);
-      if (err
-          && (APR_STATUS_IS_ENOENT(err->apr_err)
-              || SVN__APR_STATUS_IS_ENOTDIR(err->apr_err)))
-        {
-          svn_error_clear(err);
-          dirents = apr_hash_make(scratch_pool);
-        }
-      else
-        SVN_ERR(err);
-    }
+    SVN_ERR(read_dirents(&dirents, wb, local_abspath,
+                         scratch_pool, iterpool));
   else
     dirents = apr_hash_make(scratch_pool);
 
@@ -1468,6 +1531,283 @@ get_child_status(const struct walk_status_baton *wb,
 
 
 
+/*** Concurrent status walk ***/
+
+/* With many directories, most of the time of a status walk is spent
+ * reading from wc.db and stat()ing files.  This can be done concurrently
+ * for separate directories.  We use the svn_task__t framework with one
+ * task per versioned directory.  Its process function walks the directory
+ * in a worker thread with its own svn_wc__db_t and collects the status
+ * structures instead of sending them.  Whenever it reaches a versioned
+ * sub-directory, it adds a sub-task for it and hands the status structures
+ * collected so far in as partial output.  The output functions then send
+ * them from the calling thread in the same order as the recursive walk.
+ */
+
+/* A status structure that has been collected by a directory status task. */
+typedef struct collected_status_t
+{
+  const char *local_abspath;
+  svn_wc_status3_t *status;
+} collected_status_t;
+
+/* State of the directory status task that is currently being processed
+   by a worker thread. */
+struct dir_status_task_t
+{
+  /* The task itself. */
+  svn_task__t *task;
+
+  /* The walk_status_baton used for the whole walk.  Its DB member must
+     not be used by the worker. */
+  const struct walk_status_baton *wb;
+
+  /* Status structures collected since the last sub-task has been added.
+     Array of collected_status_t, allocated in RESULT_POOL. */
+  apr_array_header_t *statii;
+
+  /* Result pool of the current task's process function. */
+  apr_pool_t *result_pool;
+};
+
+/* Process baton for a directory status task. */
+typedef struct dir_status_baton_t
+{
+  /* The walk_status_baton used for the whole walk. */
+  const struct walk_status_baton *wb;
+
+  /* These correspond to the parameters of get_dir_status(). */
+  const char *local_abspath;
+  svn_boolean_t skip_this_dir;
+  const char *parent_repos_root_url;
+  const char *parent_repos_relpath;
+  const char *parent_repos_uuid;
+  const struct svn_wc__db_info_t *dir_info;
+  const svn_io_dirent2_t *dirent;
+  const apr_array_header_t *ignore_patterns;
+  svn_depth_t depth;
+  svn_boolean_t get_all;
+  svn_boolean_t no_ignore;
+} dir_status_baton_t;
+
+/* Output baton for directory status tasks: the caller's status callback. */
+typedef struct dir_status_output_baton_t
+{
+  svn_wc_status_func4_t status_func;
+  void *status_baton;
+} dir_status_output_baton_t;
+
+/* Start a new batch of collected status structures in DIR_TASK. */
+static void
+reset_collected_statii(struct dir_status_task_t *dir_task)
+{
+  dir_task->statii = apr_array_make(dir_task->result_pool, 16,
+                                    sizeof(collected_status_t));
+}
+
+/* Implements svn_wc_status_func4_t.
+   Append a copy of STATUS for PATH to the struct dir_status_task_t given
+   as BATON. */
+static svn_error_t *
+collect_status(void *baton,
+               const char *path,
+               const svn_wc_status3_t *status,
+               apr_pool_t *scratch_pool)
+{
+  struct dir_status_task_t *dir_task = baton;
+  collected_status_t *item = apr_array_push(dir_task->statii);
+
+  item->local_abspath = apr_pstrdup(dir_task->result_pool, path);
+  item->status = svn_wc_dup_status3(status, dir_task->result_pool);
+
+  return SVN_NO_ERROR;
+}
+
+/* Implements svn_task__thread_context_constructor_t.
+   Open a separate svn_wc__db_t similar to the one given as CONTEXT_BATON
+   and return it in *THREAD_CONTEXT. */
+static svn_error_t *
+open_worker_db(void **thread_context,
+               void *context_baton,
+               apr_pool_t *result_pool,
+               apr_pool_t *scratch_pool)
+{
+  svn_wc__db_t *db;
+  SVN_ERR(svn_wc__db_open_similar(&db, context_baton, result_pool,
+                                  scratch_pool));
+  *thread_context = db;
+
+  return SVN_NO_ERROR;
+}
+
+/* Implements svn_task__output_func_t.
+   Send the collected_status_t array given as RESULT through the status
+   callback in the dir_status_output_baton_t OUTPUT_BATON. */
+static svn_error_t *
+dir_status_output(svn_task__t *task,
+                  void *result,
+                  void *output_baton,
+                  svn_cancel_func_t cancel_func,
+                  void *cancel_baton,
+                  apr_pool_t *result_pool,
+                  apr_pool_t *scratch_pool)
+{
+  const apr_array_header_t *statii = result;
+  dir_status_output_baton_t *ob = output_baton;
+  apr_pool_t *iterpool = svn_pool_create(scratch_pool);
+  int i;
+
+  if (cancel_func)
+    SVN_ERR(cancel_func(cancel_baton));
+
+  for (i = 0; i < statii->nelts; i++)
+    {
+      const collected_status_t *item
+        = &APR_ARRAY_IDX(statii, i, collected_status_t);
+
+      svn_pool_clear(iterpool);
+      SVN_ERR(ob->status_func(ob->status_baton, item->local_abspath,
+                              item->status, iterpool));
+    }
+
+  svn_pool_destroy(iterpool);
+
+  return SVN_NO_ERROR;
+}
+
+/* Implements svn_task__process_func_t.
+   Walk the directory described by the dir_status_baton_t PROCESS_BATON
+   like get_dir_status() would, using the svn_wc__db_t in THREAD_CONTEXT.
+   The result is the array of collected_status_t that remains after the
+   last sub-task has been added, if any. */
+static svn_error_t *
+dir_status_process(void **result,
+                   svn_task__t *task,
+                   void *thread_context,
+                   void *process_baton,
+                   svn_cancel_func_t cancel_func,
+                   void *cancel_baton,
+                   apr_pool_t *result_pool,
+                   apr_pool_t *scratch_pool)
+{
+  dir_status_baton_t *baton = process_baton;
+  struct dir_status_task_t dir_task;
+  struct walk_status_baton wb = *baton->wb;
+
+  dir_task.task = task;
+  dir_task.wb = baton->wb;
+  dir_task.result_pool = result_pool;
+  reset_collected_statii(&dir_task);
+
+  wb.db = thread_context;
+  wb.dir_task = &dir_task;
+
+  SVN_ERR(get_dir_status(&wb, baton->local_abspath, baton->skip_this_dir,
+                         baton->parent_repos_root_url,
+                         baton->parent_repos_relpath,
+                         baton->parent_repos_uuid,
+                         baton->dir_info, baton->dirent,
+                         baton->ignore_patterns, baton->depth,
+                         baton->get_all, baton->no_ignore,
+                         collect_status, &dir_task,
+                         cancel_func, cancel_baton,
+                         scratch_pool));
+
+  *result = dir_task.statii->nelts ? dir_task.statii : NULL;
+
+  return SVN_NO_ERROR;
+}
+
+static svn_error_t *
+add_dir_status_task(struct dir_status_task_t *dir_task,
+                    const char *local_abspath,
+                    const char *parent_repos_root_url,
+                    const char *parent_repos_relpath,
+                    const char *parent_repos_uuid,
+                    const apr_array_header_t *ignore_patterns,
+                    svn_boolean_t get_all,
+                    svn_boolean_t no_ignore)
+{
+  apr_pool_t *sub_task_pool = svn_task__create_process_pool(dir_task->task);
+  dir_status_baton_t *sub_task_baton
+    = apr_pcalloc(sub_task_pool, sizeof(*sub_task_baton));
+
+  sub_task_baton->wb = dir_task->wb;
+  sub_task_baton->local_abspath = apr_pstrdup(sub_task_pool, local_abspath);
+  sub_task_baton->skip_this_dir = TRUE;
+  sub_task_baton->parent_repos_root_url
+    = apr_pstrdup(sub_task_pool, parent_repos_root_url);
+  sub_task_baton->parent_repos_relpath
+    = apr_pstrdup(sub_task_pool, parent_repos_relpath);
+  sub_task_baton->parent_repos_uuid
+    = apr_pstrdup(sub_task_pool, parent_repos_uuid);
+
+  /* The sub-task will read the directory's info from its own DB. */
+  sub_task_baton->dir_info = NULL;
+  sub_task_baton->dirent = NULL;
+
+  /* IGNORE_PATTERNS are the ones passed to the walk and remain valid. */
+  sub_task_baton->ignore_patterns = ignore_patterns;
+  sub_task_baton->depth = svn_depth_infinity;
+  sub_task_baton->get_all = get_all;
+  sub_task_baton->no_ignore = no_ignore;
+
+  /* Everything collected so far must be sent before the sub-directory. */
+  SVN_ERR(svn_task__add_similar(dir_task->task, sub_task_pool,
+                                dir_task->statii->nelts ? dir_task->statii
+                                                        : NULL,
+                                sub_task_baton));
+  reset_collected_statii(dir_task);
+
+  return SVN_NO_ERROR;
+}
+
+/* Like get_dir_status() for the directory LOCAL_ABSPATH given with its
+   DIR_INFO and DIRENT but walk sub-directories concurrently using up to
+   JOBS threads.  WB->DB must not be opened with exclusive locking.
+
+   The remaining parameters correspond to get_dir_status(). */
+static svn_error_t *
+get_dir_status_concurrently(const struct walk_status_baton *wb,
+                            const char *local_abspath,
+                            const struct svn_wc__db_info_t *dir_info,
+                            const svn_io_dirent2_t *dirent,
+                            const apr_array_header_t *ignore_patterns,
+                            svn_depth_t depth,
+                            svn_boolean_t get_all,
+                            svn_boolean_t no_ignore,
+                            int jobs,
+                            svn_wc_status_func4_t status_func,
+                            void *status_baton,
+                            svn_cancel_func_t cancel_func,
+                            void *cancel_baton,
+                            apr_pool_t *scratch_pool)
+{
+  dir_status_baton_t root_baton = { 0 };
+  dir_status_output_baton_t output_baton;
+
+  root_baton.wb = wb;
+  root_baton.local_abspath = local_abspath;
+  root_baton.skip_this_dir = FALSE;
+  root_baton.dir_info = dir_info;
+  root_baton.dirent = dirent;
+  root_baton.ignore_patterns = ignore_patterns;
+  root_baton.depth = depth;
+  root_baton.get_all = get_all;
+  root_baton.no_ignore = no_ignore;
+
+  output_baton.status_func = status_func;
+  output_baton.status_baton = status_baton;
+
+  return svn_error_trace(svn_task__run(jobs,
+                                       dir_status_process, &root_baton,
+                                       dir_status_output, &output_baton,
+                                       open_worker_db, wb->db,
+                                       cancel_func, cancel_baton,
+                                       scratch_pool, scratch_pool));
+}
+
+
 /*** Helpers ***/
 
 /* A faux status callback function for stashing STATUS item in an hash
@@ -2426,6 +2766,26 @@ close_file(void *file_baton,
                           SVN_INVALID_REVNUM, repos_lock, pool);
 }
 
+/* Implement svn_wc__internal_walk_status() and, if JOBS is larger than 1,
+   svn_wc__walk_status_concurrently().  In the latter case, DB must not be
+   opened with exclusive locking.  Use the directory listings remembered
+   by MONITOR, if not NULL. */
+static svn_error_t *
+walk_status(svn_wc__db_t *db,
+            const char *local_abspath,
+            svn_depth_t depth,
+            svn_boolean_t get_all,
+            svn_boolean_t no_ignore,
+            svn_boolean_t ignore_text_mods,
+            const apr_array_header_t *ignore_patterns,
+            int jobs,
+            svn_wc__monitor_t *monitor,
+            svn_wc_status_func4_t status_func,
+            void *status_baton,
+            svn_cancel_func_t cancel_func,
+            void *cancel_baton,
+            apr_pool_t *scratch_pool);
+
 /* An svn_delta_editor_t function. */
 static svn_error_t *
 close_edit(void *edit_baton,
@@ -2439,18 +2799,20 @@ close_edit(void *edit_baton,
   if (eb->root_opened)
     return SVN_NO_ERROR;
 
-  SVN_ERR(svn_wc__internal_walk_status(eb->db,
-                                       eb->target_abspath,
-                                       eb->default_depth,
-                                       eb->get_all,
-                                       eb->no_ignore,
-                                       FALSE,
-                                       eb->ignores,
-                                       eb->status_func,
-                                       eb->status_baton,
-                                       eb->cancel_func,
-                                       eb->cancel_baton,
-                                       pool));
+  SVN_ERR(walk_status(eb->db,
+                      eb->target_abspath,
+                      eb->default_depth,
+                      eb->get_all,
+                      eb->no_ignore,
+                      FALSE,
+                      eb->ignores,
+                      1,
+                      eb->wb.monitor,
+                      eb->status_func,
+                      eb->status_baton,
+                      eb->cancel_func,
+                      eb->cancel_baton,
+                      pool));
 
   return SVN_NO_ERROR;
 }
@@ -2513,6 +2875,8 @@ svn_wc__get_status_editor(const svn_delta_editor_t **editor,
   eb->wb.check_working_copy = check_working_copy;
   eb->wb.repos_locks      = NULL;
   eb->wb.repos_root       = NULL;
+  eb->wb.dir_task         = NULL;
+  eb->wb.monitor          = wc_ctx->monitor;
 
   SVN_ERR(svn_wc__db_externals_defined_below(&eb->wb.externals,
                                              wc_ctx->db, eb->target_abspath,
@@ -2619,19 +2983,21 @@ stat_wc_dirent_case_sensitive(const svn_io_dirent2_t **dirent,
                                 result_pool, scratch_pool));
 }
 
-svn_error_t *
-svn_wc__internal_walk_status(svn_wc__db_t *db,
-                             const char *local_abspath,
-                             svn_depth_t depth,
-                             svn_boolean_t get_all,
-                             svn_boolean_t no_ignore,
-                             svn_boolean_t ignore_text_mods,
-                             const apr_array_header_t *ignore_patterns,
-                             svn_wc_status_func4_t status_func,
-                             void *status_baton,
-                             svn_cancel_func_t cancel_func,
-                             void *cancel_baton,
-                             apr_pool_t *scratch_pool)
+static svn_error_t *
+walk_status(svn_wc__db_t *db,
+            const char *local_abspath,
+            svn_depth_t depth,
+            svn_boolean_t get_all,
+            svn_boolean_t no_ignore,
+            svn_boolean_t ignore_text_mods,
+            const apr_array_header_t *ignore_patterns,
+            int jobs,
+            svn_wc__monitor_t *monitor,
+            svn_wc_status_func4_t status_func,
+            void *status_baton,
+            svn_cancel_func_t cancel_func,
+            void *cancel_baton,
+            apr_pool_t *scratch_pool)
 {
   struct walk_status_baton wb;
   const svn_io_dirent2_t *dirent;
@@ -2644,6 +3010,8 @@ svn_wc__internal_walk_status(svn_wc__db_t *db,
   wb.check_working_copy = TRUE;
   wb.repos_root = NULL;
   wb.repos_locks = NULL;
+  wb.dir_task = NULL;
+  wb.monitor = monitor;
 
   /* Use the caller-provided ignore patterns if provided; the build-time
      configured defaults otherwise. */
@@ -2690,19 +3058,28 @@ svn_wc__internal_walk_status(svn_wc__db_t *db,
       && info->status != svn_wc__db_status_excluded
       && info->status != svn_wc__db_status_server_excluded)
     {
-      SVN_ERR(get_dir_status(&wb,
-                             local_abspath,
-                             FALSE /* skip_root */,
-                             NULL, NULL, NULL,
-                             info,
-                             dirent,
-                             ignore_patterns,
-                             depth,
-                             get_all,
-                             no_ignore,
-                             status_func, status_baton,
-                             cancel_func, cancel_baton,
-                             scratch_pool));
+      /* Only recursive walks benefit from concurrency. */
+      if (jobs > 1 && SVN_DEPTH_IS_RECURSIVE(depth))
+        SVN_ERR(get_dir_status_concurrently(&wb, local_abspath, info, dirent,
+                                            ignore_patterns, depth, get_all,
+                                            no_ignore, jobs,
+                                            status_func, status_baton,
+                                            cancel_func, cancel_baton,
+                                            scratch_pool));
+      else
+        SVN_ERR(get_dir_status(&wb,
+                               local_abspath,
+                               FALSE /* skip_root */,
+                               NULL, NULL, NULL,
+                               info,
+                               dirent,
+                               ignore_patterns,
+                               depth,
+                               get_all,
+                               no_ignore,
+                               status_func, status_baton,
+                               cancel_func, cancel_baton,
+                               scratch_pool));
     }
   else
     {
@@ -2735,6 +3112,69 @@ svn_wc__internal_walk_status(svn_wc__db_t *db,
   return SVN_NO_ERROR;
 }
 
+svn_error_t *
+svn_wc__internal_walk_status(svn_wc__db_t *db,
+                             const char *local_abspath,
+                             svn_depth_t depth,
+                             svn_boolean_t get_all,
+                             svn_boolean_t no_ignore,
+                             svn_boolean_t ignore_text_mods,
+                             const apr_array_header_t *ignore_patterns,
+                             svn_wc_status_func4_t status_func,
+                             void *status_baton,
+                             svn_cancel_func_t cancel_func,
+                             void *cancel_baton,
+                             apr_pool_t *scratch_pool)
+{
+  return svn_error_trace(walk_status(db, local_abspath, depth, get_all,
+                                     no_ignore, ignore_text_mods,
+                                     ignore_patterns, 1, NULL,
+                                     status_func, status_baton,
+                                     cancel_func, cancel_baton,
+                                     scratch_pool));
+}
+
+svn_error_t *
+svn_wc__walk_status_concurrently(svn_wc_context_t *wc_ctx,
+                                 const char *local_abspath,
+                                 svn_depth_t depth,
+                                 svn_boolean_t get_all,
+                                 svn_boolean_t no_ignore,
+                                 svn_boolean_t ignore_text_mods,
+                                 const apr_array_header_t *ignore_patterns,
+                                 int jobs,
+                                 svn_wc_status_func4_t status_func,
+                                 void *status_baton,
+                                 svn_cancel_func_t cancel_func,
+                                 void *cancel_baton,
+                                 apr_pool_t *scratch_pool)
+{
+  if (jobs > 1)
+    {
+      /* Worker threads need their own DB contexts.  Those are cheap to
+         create as they only connect to wc.db when being used.  If we can't
+         get one, fall back to a sequential walk. */
+      svn_wc__db_t *probe_db;
+      svn_error_t *err = svn_wc__db_open_similar(&probe_db, wc_ctx->db,
+                                                 scratch_pool, scratch_pool);
+      if (err && err->apr_err == SVN_ERR_UNSUPPORTED_FEATURE)
+        {
+          svn_error_clear(err);
+          jobs = 1;
+        }
+      else
+        SVN_ERR(err);
+    }
+
+  return svn_error_trace(walk_status(wc_ctx->db, local_abspath, depth,
+                                     get_all, no_ignore, ignore_text_mods,
+                                     ignore_patterns, jobs,
+                                     wc_ctx->monitor,
+                                     status_func, status_baton,
+                                     cancel_func, cancel_baton,
+                                     scratch_pool));
+}
+
 svn_error_t *
 svn_wc_walk_status(svn_wc_context_t *wc_ctx,
                    const char *local_abspath,
@@ -2749,19 +3189,20 @@ svn_wc_walk_status(svn_wc_context_t *wc_ctx,
                    void *cancel_baton,
                    apr_pool_t *scratch_pool)
 {
-  return svn_error_trace(
-           svn_wc__internal_walk_status(wc_ctx->db,
-                                        local_abspath,
-                                        depth,
-                                        get_all,
-                                        no_ignore,
-                                        ignore_text_mods,
-                                        ignore_patterns,
-                                        status_func,
-                                        status_baton,
-                                        cancel_func,
-                                        cancel_baton,
-                                        scratch_pool));
+  return svn_error_trace(walk_status(wc_ctx->db,
+                                     local_abspath,
+                                     depth,
+                                     get_all,
+                                     no_ignore,
+                                     ignore_text_mods,
+                                     ignore_patterns,
+                                     1,
+                                     wc_ctx->monitor,
+                                     status_func,
+                                     status_baton,
+                                     cancel_func,
+                                     cancel_baton,
+                                     scratch_pool));
 }
 
 
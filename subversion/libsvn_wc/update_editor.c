@@ -193,6 +193,11 @@ struct edit_baton
      edited/added files with the last-commit-time. */
   svn_boolean_t use_commit_times;
 
+  /* Whether to leave writing working files from the pristine store to the
+     work queue, which writes them concurrently, instead of writing them
+     while their text is being received. */
+  svn_boolean_t queue_installs;
+
   /* Was the root actually opened (was this a non-empty edit)? */
   svn_boolean_t root_opened;
 
@@ -468,8 +473,8 @@ get_empty_tmp_file(const char **tmp_filename,
   return SVN_NO_ERROR;
 }
 
-/* An APR pool cleanup handler.  This runs the working queue for an
-   editor baton. */
+/* An APR pool cleanup handler.  This commits the pending DB changes and
+   runs the working queue for an editor baton. */
 static apr_status_t
 cleanup_edit_baton(void *edit_baton)
 {
@@ -477,9 +482,12 @@ cleanup_edit_baton(void *edit_baton)
   svn_error_t *err;
   apr_pool_t *pool = apr_pool_parent_get(eb->pool);
 
-  err = svn_wc__wq_run(eb->db, eb->wcroot_abspath,
-                       NULL /* cancel_func */, NULL /* cancel_baton */,
-                       pool);
+  err = svn_wc__db_batch_end(eb->db, eb->wcroot_abspath, pool);
+
+  if (! err)
+    err = svn_wc__wq_run(eb->db, eb->wcroot_abspath,
+                         NULL /* cancel_func */, NULL /* cancel_baton */,
+                         pool);
 
   if (err)
     {
@@ -2196,13 +2204,12 @@ add_directory(const char *path,
                                      (! db->shadowed
                                       && status == svn_wc__db_status_added),
                                      tree_conflict, NULL,
+                                     /* Make sure there is a real directory
+                                        at LOCAL_ABSPATH, unless we are just
+                                        updating the DB */
+                                     ! db->shadowed,
                                      scratch_pool));
 
-  /* Make sure there is a real directory at LOCAL_ABSPATH, unless we are just
-     updating the DB */
-  if (!db->shadowed)
-    SVN_ERR(svn_wc__ensure_directory(db->local_abspath, scratch_pool));
-
   if (tree_conflict != NULL)
     {
       db->edit_conflict = tree_conflict;
@@ -3767,6 +3774,11 @@ lazy_open_target(svn_stream_t **stream_p,
       /* No need to provision the working file. */
       file_writer = NULL;
     }
+  else if (fb->edit_baton->queue_installs)
+    {
+      /* close_file() will have the work queue install it. */
+      file_writer = NULL;
+    }
   else
     {
       SVN_ERR(open_working_file_writer(&file_writer, fb, fb->pool,
@@ -4700,6 +4712,22 @@ close_file(void *file_baton,
         svn_hash_sets(eb->wcroot_iprops, fb->local_abspath, NULL);
     }
 
+  /* Let the work queue write the working file from the pristine store,
+     concurrently with other files. */
+  if (install_pristine && !install_from && !fb->file_writer
+      && eb->queue_installs)
+    {
+      SVN_ERR(svn_wc__wq_build_file_install(&work_item, eb->db,
+                                            fb->local_abspath,
+                                            NULL /* source_abspath */,
+                                            eb->use_commit_times,
+                                            TRUE /* record_fileinfo */,
+                                            scratch_pool, scratch_pool));
+      all_work_items = svn_wc__wq_merge(all_work_items, work_item,
+                                        scratch_pool);
+      install_pristine = FALSE;
+    }
+
   /* We have to install the working file from the pristine, but we did not
      receive it as the part of this edit.  Or we did receive it, but have to
      install from a different file.  Either way, reset the writer and copy
@@ -5047,6 +5075,8 @@ close_edit(void *edit_baton,
      cleanup at the end of this function. */
   apr_pool_cleanup_kill(eb->pool, eb, cleanup_edit_baton);
 
+  SVN_ERR(svn_wc__db_batch_end(eb->db, eb->wcroot_abspath, eb->pool));
+
   SVN_ERR(svn_wc__wq_run(eb->db, eb->wcroot_abspath,
                          eb->cancel_func, eb->cancel_baton,
                          eb->pool));
@@ -5134,6 +5164,7 @@ make_editor(svn_revnum_t *target_revision,
   eb = apr_pcalloc(edit_pool, sizeof(*eb));
   eb->pool                     = edit_pool;
   eb->use_commit_times         = use_commit_times;
+  eb->queue_installs           = svn_wc__db_get_install_jobs(db) > 1;
   eb->target_revision          = target_revision;
   eb->repos_root               = repos_root;
   eb->repos_uuid               = repos_uuid;
@@ -5175,6 +5206,11 @@ make_editor(svn_revnum_t *target_revision,
   eb->dir_dirents              = apr_hash_make(edit_pool);
   eb->ext_patterns             = preserved_exts;
 
+  /* Group the DB changes for the many nodes of an edit into fewer
+     transactions.  Work items still run only after their changes have
+     been committed. */
+  SVN_ERR(svn_wc__db_batch_begin(db, eb->wcroot_abspath, scratch_pool));
+
   apr_pool_cleanup_register(edit_pool, eb, cleanup_edit_baton,
                             apr_pool_cleanup_null);
 
@@ -1425,6 +1425,18 @@ bump_to_31(void *baton,
   return SVN_NO_ERROR;
 }
 
+static svn_error_t *
+bump_to_32(void *baton,
+           svn_sqlite__db_t *sdb,
+           apr_pool_t *scratch_pool)
+{
+  /* Compressed pristines are only ever created by newer clients, so there
+     is nothing to convert. */
+  SVN_ERR(svn_sqlite__exec_statements(sdb, STMT_UPGRADE_TO_32));
+
+  return SVN_NO_ERROR;
+}
+
 static svn_error_t *
 upgrade_apply_dav_cache(svn_sqlite__db_t *sdb,
                         const char *dir_relpath,
@@ -1633,11 +1645,16 @@ svn_wc__upgrade_sdb(int *result_format,
                     const char *wcroot_abspath,
                     svn_sqlite__db_t *sdb,
                     int start_format,
+                    int target_format,
                     apr_pool_t *scratch_pool)
 {
   struct bump_baton bb;
 
+  SVN_ERR_ASSERT(target_format >= SVN_WC__DEFAULT_VERSION
+                 && target_format <= SVN_WC__VERSION);
+
   bb.wcroot_abspath = wcroot_abspath;
+  *result_format = start_format;
 
   if (start_format < SVN_WC__WC_NG_VERSION /* 12 */)
     return svn_error_createf(SVN_ERR_WC_UPGRADE_REQUIRED, NULL,
@@ -1672,8 +1689,8 @@ svn_wc__upgrade_sdb(int *result_format,
   /* ### need lock-out. only one upgrade at a time. note that other code
      ### cannot use this un-upgraded database until we finish the upgrade.  */
 
-  /* Note: none of these have "break" statements; the fall-through is
-     intentional. */
+  /* Note: none of these have "break" statements, except where an optional
+     format would follow; the fall-through is intentional. */
   switch (start_format)
     {
       case 29:
@@ -1686,6 +1703,16 @@ svn_wc__upgrade_sdb(int *result_format,
                                              scratch_pool));
         *result_format = 31;
         /* FALLTHROUGH  */
+
+      case 31:
+        /* Format 32 is only needed for compressed pristines. */
+        if (target_format < SVN_WC__HAS_COMPRESSED_PRISTINES)
+          break;
+
+        SVN_ERR(svn_sqlite__with_transaction(sdb, bump_to_32, &bb,
+                                             scratch_pool));
+        *result_format = 32;
+        /* FALLTHROUGH  */
       /* ### future bumps go here.  */
 #if 0
       case XXX-1:
@@ -1698,12 +1725,12 @@ svn_wc__upgrade_sdb(int *result_format,
       case SVN_WC__VERSION:
         /* already upgraded */
         *result_format = SVN_WC__VERSION;
-
-        SVN_SQLITE__WITH_LOCK(
-            svn_wc__db_install_schema_statistics(sdb, scratch_pool),
-            sdb);
     }
 
+  SVN_SQLITE__WITH_LOCK(
+      svn_wc__db_install_schema_statistics(sdb, scratch_pool),
+      sdb);
+
 #ifdef SVN_DEBUG
   if (*result_format != start_format)
     {
@@ -1905,15 +1932,18 @@ svn_wc_upgrade(svn_wc_context_t *wc_ctx,
   const char *root_adm_abspath;
   svn_error_t *err;
   int result_format;
+  int target_format;
   svn_boolean_t bumped_format;
 
   /* Try upgrading a wc-ng-style working copy. */
   SVN_ERR(svn_wc__db_open(&db, NULL /* ### config */, TRUE, FALSE,
                           scratch_pool, scratch_pool));
 
+  /* Upgrade to the format that WC_CTX creates working copies in. */
+  target_format = svn_wc__db_get_target_format(wc_ctx->db);
 
   err = svn_wc__db_bump_format(&result_format, &bumped_format,
-                               db, local_abspath,
+                               db, local_abspath, target_format,
                                scratch_pool);
   if (err)
     {
@@ -1933,7 +1963,7 @@ svn_wc_upgrade(svn_wc_context_t *wc_ctx,
       /* Auto-upgrade worked! */
       SVN_ERR(svn_wc__db_close(db));
 
-      SVN_ERR_ASSERT(result_format == SVN_WC__VERSION);
+      SVN_ERR_ASSERT(result_format >= target_format);
 
       if (bumped_format && notify_func)
         {
@@ -1989,6 +2019,7 @@ svn_wc_upgrade(svn_wc_context_t *wc_ctx,
                                    &data.repos_id, &data.wc_id,
                                    db, data.root_abspath,
                                    this_dir->repos, this_dir->uuid,
+                                   target_format,
                                    scratch_pool));
 
   /* Migrate the entries over to the new database.
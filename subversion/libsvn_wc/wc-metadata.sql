@@ -80,7 +80,7 @@ CREATE UNIQUE INDEX I_LOCAL_ABSPATH ON WCROOT (local_abspath);
    derived from the 'checksum' column.  Each pristine text is referenced by
    any number of rows in the NODES and ACTUAL_NODE tables.
 
-   In future, the pristine text file may be compressed.
+   Since format 32, the pristine text file may be compressed.
  */
 CREATE TABLE PRISTINE (
   /* The SHA-1 checksum of the pristine text. This is a unique key. The
@@ -88,13 +88,14 @@ CREATE TABLE PRISTINE (
      pristine texts referenced from this database. */
   checksum  TEXT NOT NULL PRIMARY KEY,
 
-  /* Enumerated values specifying type of compression. The only value
-     supported so far is NULL, meaning that no compression has been applied
-     and the pristine text is stored verbatim in the file. */
+  /* Enumerated values specifying type of compression. NULL means that no
+     compression has been applied and the pristine text is stored verbatim
+     in the file.  Since format 32, 1 means that the file is a sequence of
+     LZ4-compressed blocks, see wc_db_pristine.c. */
   compression  INTEGER,
 
-  /* The size in bytes of the file in which the pristine text is stored.
-     Used to verify the pristine file is "proper". */
+  /* The size in bytes of the pristine text, i.e. of the file in which it
+     is stored unless it is compressed. */
   size  INTEGER NOT NULL,
 
   /* The number of rows in the NODES table that have a 'checksum' column
@@ -564,7 +565,7 @@ CREATE UNIQUE INDEX I_EXTERNALS_DEFINED ON EXTERNALS (wc_id,
 
 
 PRAGMA user_version =
--- define: SVN_WC__VERSION
+-- define: SVN_WC__DEFAULT_VERSION
 ;
 
 
@@ -699,9 +700,11 @@ WHERE l.op_depth = 0
 
 
 /* ------------------------------------------------------------------------- */
-/* Format 32 ....  */
-/* -- STMT_UPGRADE_TO_32
-PRAGMA user_version = 32; */
+
+/* Format 32 allows the PRISTINE.compression column to be set, i.e. pristine
+   text files may be compressed.  Existing pristines are kept as they are. */
+-- STMT_UPGRADE_TO_32
+PRAGMA user_version = 32;
 
 
 /* ------------------------------------------------------------------------- */
@@ -37,6 +37,7 @@
 #include "private/svn_skel.h"
 
 #include "wc_db.h"
+#include "monitor.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -161,10 +162,25 @@ extern "C" {
  * == 1.9.x shipped with format 31
  * == 1.10.x shipped with format 31
  *
+ * The bump to 32 allows pristine texts to be stored compressed, as recorded
+ * in the 'compression' column of the PRISTINE table.  Working copies are
+ * only created in or upgraded to this format when pristine compression is
+ * enabled, so that older clients can keep using them otherwise.
+ *
  * Please document any further format changes here.
  */
 
-#define SVN_WC__VERSION 31
+#define SVN_WC__VERSION 32
+
+/* The oldest format that we use without requiring an upgrade.  */
+#define SVN_WC__SUPPORTED_VERSION 31
+
+/* The format that new working copies are created in and that older ones
+   are upgraded to, unless pristine compression asks for a newer one.  */
+#define SVN_WC__DEFAULT_VERSION 31
+
+/* A version < this can't store compressed pristine texts.  */
+#define SVN_WC__HAS_COMPRESSED_PRISTINES 32
 
 
 /* Formats <= this have no concept of "revert text-base/props".  */
@@ -229,6 +245,10 @@ struct svn_wc_context_t
 
   /* The state pool for this context. */
   apr_pool_t *state_pool;
+
+  /* Remembers directory listings between status walks, if enabled by
+     SVN_CONFIG_OPTION_CHANGE_MONITOR.  NULL otherwise. */
+  svn_wc__monitor_t *monitor;
 };
 
 /**
@@ -586,6 +606,7 @@ svn_wc__internal_get_origin(svn_boolean_t *is_copy,
 
 /* Upgrade the wc sqlite database given in SDB for the wc located at
    WCROOT_ABSPATH. It's current/starting format is given by START_FORMAT.
+   The database is upgraded to TARGET_FORMAT, but never downgraded.
    After the upgrade is complete (to as far as the automatic upgrade will
    perform), the resulting format is RESULT_FORMAT. All allocations are
    performed in SCRATCH_POOL.  */
@@ -594,6 +615,7 @@ svn_wc__upgrade_sdb(int *result_format,
                     const char *wcroot_abspath,
                     svn_sqlite__db_t *sdb,
                     int start_format,
+                    int target_format,
                     apr_pool_t *scratch_pool);
 
 /* Create a conflict skel from the old separated data */
@@ -1365,6 +1365,7 @@ init_db(/* output values */
         const char *root_node_repos_relpath,
         svn_revnum_t root_node_revision,
         svn_depth_t root_node_depth,
+        int target_format,
         apr_pool_t *scratch_pool)
 {
   svn_sqlite__stmt_t *stmt;
@@ -1372,6 +1373,11 @@ init_db(/* output values */
   /* Create the database's schema.  */
   SVN_ERR(svn_sqlite__exec_statements(db, STMT_CREATE_SCHEMA));
 
+  /* The schema is that of SVN_WC__DEFAULT_VERSION; newer formats only
+     differ in what they allow to be stored. */
+  if (target_format >= SVN_WC__HAS_COMPRESSED_PRISTINES)
+    SVN_ERR(svn_sqlite__exec_statements(db, STMT_UPGRADE_TO_32));
+
   SVN_ERR(svn_wc__db_install_schema_statistics(db, scratch_pool));
 
   /* Insert the repository. */
@@ -1418,6 +1424,8 @@ init_db(/* output values */
    If ROOT_NODE_REPOS_RELPATH is not NULL, insert a BASE node at
    the working copy root with repository relpath ROOT_NODE_REPOS_RELPATH,
    revision ROOT_NODE_REVISION and depth ROOT_NODE_DEPTH.
+
+   Create the database in format TARGET_FORMAT.
    */
 static svn_error_t *
 create_db(svn_sqlite__db_t **sdb,
@@ -1432,6 +1440,7 @@ create_db(svn_sqlite__db_t **sdb,
           svn_depth_t root_node_depth,
           svn_boolean_t exclusive,
           apr_int32_t timeout,
+          int target_format,
           apr_pool_t *result_pool,
           apr_pool_t *scratch_pool)
 {
@@ -1444,7 +1453,8 @@ create_db(svn_sqlite__db_t **sdb,
   SVN_SQLITE__WITH_LOCK(init_db(repos_id, wc_id,
                                 *sdb, repos_root_url, repos_uuid,
                                 root_node_repos_relpath, root_node_revision,
-                                root_node_depth, scratch_pool),
+                                root_node_depth, target_format,
+                                scratch_pool),
                         *sdb);
 
   return SVN_NO_ERROR;
@@ -1487,7 +1497,7 @@ svn_wc__db_init(svn_wc__db_t *db,
   SVN_ERR(create_db(&sdb, &repos_id, &wc_id, local_abspath, repos_root_url,
                     repos_uuid, SDB_FILE,
                     repos_relpath, initial_rev, depth, sqlite_exclusive,
-                    sqlite_timeout,
+                    sqlite_timeout, svn_wc__db_get_target_format(db),
                     db->state_pool, scratch_pool));
 
   /* Create the WCROOT for this directory.  */
@@ -1685,6 +1695,8 @@ svn_wc__db_base_add_directory(svn_wc__db_t *db,
       ibb.new_actual_props = new_actual_props;
     }
 
+  SVN_ERR(svn_wc__db_batch_step_internal(wcroot));
+
   /* Insert the directory and all its children transactionally.
 
      Note: old children can stick around, even if they are no longer present
@@ -1709,6 +1721,7 @@ svn_wc__db_base_add_incomplete_directory(svn_wc__db_t *db,
                                          svn_boolean_t delete_working,
                                          svn_skel_t *conflict,
                                          svn_skel_t *work_items,
+                                         svn_boolean_t create_directory,
                                          apr_pool_t *scratch_pool)
 {
   svn_wc__db_wcroot_t *wcroot;
@@ -1742,10 +1755,20 @@ svn_wc__db_base_add_incomplete_directory(svn_wc__db_t *db,
   ibb.conflict = conflict;
   ibb.work_items = work_items;
 
+  SVN_ERR(svn_wc__db_batch_step_internal(wcroot));
+
   SVN_WC__DB_WITH_TXN(
             insert_base_node(&ibb, wcroot, local_relpath, scratch_pool),
             wcroot);
 
+  if (create_directory)
+    SVN_ERR(svn_wc__db_batch_install_dir_internal(wcroot, local_abspath,
+                                                  scratch_pool));
+
+  /* Conflict resolvers may look at the directory right away. */
+  if (conflict)
+    SVN_ERR(svn_wc__db_batch_commit_internal(wcroot));
+
   SVN_ERR(flush_entries(wcroot, local_abspath, svn_depth_empty, scratch_pool));
 
   return SVN_NO_ERROR;
@@ -1776,7 +1799,8 @@ db_record_fileinfo(svn_wc__db_wcroot_t *wcroot,
 
 
 /* Install the working file provided by FILE_WRITER, optionally
-   recording its fileinfo. */
+   recording its fileinfo.  Within a batch, the file is put in place
+   once the batch has been committed. */
 static svn_error_t *
 install_working_file(svn_wc__db_wcroot_t *wcroot,
                      const char *local_relpath,
@@ -1803,8 +1827,9 @@ install_working_file(svn_wc__db_wcroot_t *wcroot,
     }
 
   local_abspath = svn_dirent_join(wcroot->abspath, local_relpath, scratch_pool);
-  SVN_ERR(svn_wc__working_file_writer_install(file_writer, local_abspath,
-                                              scratch_pool));
+  SVN_ERR(svn_wc__db_batch_install_file_internal(wcroot, file_writer,
+                                                 local_abspath,
+                                                 scratch_pool));
 
   return SVN_NO_ERROR;
 }
@@ -1888,6 +1913,8 @@ svn_wc__db_base_add_file(svn_wc__db_t *db,
   ibb.conflict = conflict;
   ibb.work_items = work_items;
 
+  SVN_ERR(svn_wc__db_batch_step_internal(wcroot));
+
   if (file_writer)
     {
       /* Atomically update the db and install the file (installation
@@ -1905,6 +1932,10 @@ svn_wc__db_base_add_file(svn_wc__db_t *db,
         wcroot);
     }
 
+  /* Conflict resolvers may look at the file right away. */
+  if (conflict)
+    SVN_ERR(svn_wc__db_batch_commit_internal(wcroot));
+
   /* If this used to be a directory we should remove children so pass
    * depth infinity. */
   SVN_ERR(flush_entries(wcroot, local_abspath, svn_depth_infinity,
@@ -1988,6 +2019,8 @@ svn_wc__db_base_add_symlink(svn_wc__db_t *db,
   ibb.conflict = conflict;
   ibb.work_items = work_items;
 
+  SVN_ERR(svn_wc__db_batch_step_internal(wcroot));
+
   SVN_WC__DB_WITH_TXN(
             insert_base_node(&ibb, wcroot, local_relpath, scratch_pool),
             wcroot);
@@ -2060,10 +2093,16 @@ add_excluded_or_not_present_node(svn_wc__db_t *db,
   ibb.conflict = conflict;
   ibb.work_items = work_items;
 
+  SVN_ERR(svn_wc__db_batch_step_internal(wcroot));
+
   SVN_WC__DB_WITH_TXN(
             insert_base_node(&ibb, wcroot, local_relpath, scratch_pool),
             wcroot);
 
+  /* Conflict resolvers may look at the working copy right away. */
+  if (conflict)
+    SVN_ERR(svn_wc__db_batch_commit_internal(wcroot));
+
   /* If this used to be a directory we should remove children so pass
    * depth infinity. */
   SVN_ERR(flush_entries(wcroot, local_abspath, svn_depth_infinity,
@@ -6682,6 +6721,7 @@ svn_wc__db_op_mark_conflict(svn_wc__db_t *db,
                               local_abspath, scratch_pool, scratch_pool));
   VERIFY_USABLE_WCROOT(wcroot);
 
+  SVN_ERR(svn_wc__db_batch_step_internal(wcroot));
   SVN_ERR(svn_wc__db_mark_conflict_internal(wcroot, local_relpath,
                                             conflict_skel, scratch_pool));
 
@@ -6689,6 +6729,9 @@ svn_wc__db_op_mark_conflict(svn_wc__db_t *db,
   if (work_items)
     SVN_ERR(add_work_items(wcroot->sdb, work_items, scratch_pool));
 
+  /* Conflict resolvers may look at the working copy right away. */
+  SVN_ERR(svn_wc__db_batch_commit_internal(wcroot));
+
   SVN_ERR(flush_entries(wcroot, local_abspath, svn_depth_empty, scratch_pool));
 
   return SVN_NO_ERROR;
@@ -13411,6 +13454,7 @@ svn_wc__db_upgrade_begin(svn_sqlite__db_t **sdb,
                          const char *dir_abspath,
                          const char *repos_root_url,
                          const char *repos_uuid,
+                         int target_format,
                          apr_pool_t *scratch_pool)
 {
   svn_wc__db_wcroot_t *wcroot;
@@ -13422,6 +13466,7 @@ svn_wc__db_upgrade_begin(svn_sqlite__db_t **sdb,
                     NULL, SVN_INVALID_REVNUM, svn_depth_unknown,
                     TRUE /* exclusive */,
                     0 /* timeout */,
+                    target_format,
                     wc_db->state_pool, scratch_pool));
 
   SVN_ERR(svn_wc__db_pdh_create_wcroot(&wcroot,
@@ -13540,6 +13585,8 @@ svn_wc__db_wq_add(svn_wc__db_t *db,
                               wri_abspath, scratch_pool, scratch_pool));
   VERIFY_USABLE_WCROOT(wcroot);
 
+  SVN_ERR(svn_wc__db_batch_step_internal(wcroot));
+
   /* Add the work item(s) to the WORK_QUEUE.  */
   return svn_error_trace(add_work_items(wcroot->sdb, work_item,
                                         scratch_pool));
@@ -13612,6 +13659,10 @@ svn_wc__db_wq_fetch_next(apr_uint64_t *id,
                               wri_abspath, scratch_pool, scratch_pool));
   VERIFY_USABLE_WCROOT(wcroot);
 
+  /* Work items may only run once the changes that queued them have
+     been committed. */
+  SVN_ERR(svn_wc__db_batch_commit_internal(wcroot));
+
   SVN_WC__DB_WITH_TXN(
     wq_fetch_next(id, work_item,
                   wcroot, local_relpath, completed_id,
@@ -13673,6 +13724,9 @@ svn_wc__db_wq_record_and_fetch_next(apr_uint64_t *id,
                               wri_abspath, scratch_pool, scratch_pool));
   VERIFY_USABLE_WCROOT(wcroot);
 
+  /* See svn_wc__db_wq_fetch_next(). */
+  SVN_ERR(svn_wc__db_batch_commit_internal(wcroot));
+
   SVN_WC__DB_WITH_TXN(
     svn_error_compose_create(
             wq_fetch_next(id, work_item,
@@ -13684,6 +13738,105 @@ svn_wc__db_wq_record_and_fetch_next(apr_uint64_t *id,
   return SVN_NO_ERROR;
 }
 
+svn_error_t *
+svn_wc__db_wq_fetch_following(apr_array_header_t **ids,
+                              apr_array_header_t **work_items,
+                              svn_wc__db_t *db,
+                              const char *wri_abspath,
+                              apr_uint64_t after_id,
+                              int max_items,
+                              apr_pool_t *result_pool,
+                              apr_pool_t *scratch_pool)
+{
+  svn_wc__db_wcroot_t *wcroot;
+  const char *local_relpath;
+  svn_sqlite__stmt_t *stmt;
+  svn_boolean_t have_row;
+
+  SVN_ERR_ASSERT(svn_dirent_is_absolute(wri_abspath));
+
+  SVN_ERR(svn_wc__db_wcroot_parse_local_abspath(&wcroot, &local_relpath, db,
+                              wri_abspath, scratch_pool, scratch_pool));
+  VERIFY_USABLE_WCROOT(wcroot);
+
+  /* See svn_wc__db_wq_fetch_next(). */
+  SVN_ERR(svn_wc__db_batch_commit_internal(wcroot));
+
+  *ids = apr_array_make(result_pool, max_items, sizeof(apr_uint64_t));
+  *work_items = apr_array_make(result_pool, max_items, sizeof(svn_skel_t *));
+
+  SVN_ERR(svn_sqlite__get_statement(&stmt, wcroot->sdb,
+                                    STMT_SELECT_WORK_ITEMS_AFTER));
+  SVN_ERR(svn_sqlite__bindf(stmt, "id", (apr_int64_t)after_id, max_items));
+  SVN_ERR(svn_sqlite__step(&have_row, stmt));
+
+  while (have_row)
+    {
+      apr_size_t len;
+      const void *val;
+
+      APR_ARRAY_PUSH(*ids, apr_uint64_t) = svn_sqlite__column_int64(stmt, 0);
+
+      val = svn_sqlite__column_blob(stmt, 1, &len, result_pool);
+      APR_ARRAY_PUSH(*work_items, svn_skel_t *)
+        = svn_skel__parse(val, len, result_pool);
+
+      SVN_ERR(svn_sqlite__step(&have_row, stmt));
+    }
+
+  return svn_error_trace(svn_sqlite__reset(stmt));
+}
+
+/* The body of svn_wc__db_wq_record_and_complete().
+ */
+static svn_error_t *
+wq_record_and_complete(svn_wc__db_wcroot_t *wcroot,
+                       const apr_array_header_t *completed_ids,
+                       apr_hash_t *record_map,
+                       apr_pool_t *scratch_pool)
+{
+  svn_sqlite__stmt_t *stmt;
+  int i;
+
+  SVN_ERR(svn_sqlite__get_statement(&stmt, wcroot->sdb,
+                                    STMT_DELETE_WORK_ITEM));
+  for (i = 0; i < completed_ids->nelts; i++)
+    {
+      SVN_ERR(svn_sqlite__bind_int64(stmt, 1,
+                                     APR_ARRAY_IDX(completed_ids, i,
+                                                   apr_uint64_t)));
+      SVN_ERR(svn_sqlite__step_done(stmt));
+    }
+
+  if (record_map)
+    SVN_ERR(wq_record(wcroot, record_map, scratch_pool));
+
+  return SVN_NO_ERROR;
+}
+
+svn_error_t *
+svn_wc__db_wq_record_and_complete(svn_wc__db_t *db,
+                                  const char *wri_abspath,
+                                  const apr_array_header_t *completed_ids,
+                                  apr_hash_t *record_map,
+                                  apr_pool_t *scratch_pool)
+{
+  svn_wc__db_wcroot_t *wcroot;
+  const char *local_relpath;
+
+  SVN_ERR_ASSERT(svn_dirent_is_absolute(wri_abspath));
+
+  SVN_ERR(svn_wc__db_wcroot_parse_local_abspath(&wcroot, &local_relpath, db,
+                              wri_abspath, scratch_pool, scratch_pool));
+  VERIFY_USABLE_WCROOT(wcroot);
+
+  SVN_WC__DB_WITH_TXN(
+    wq_record_and_complete(wcroot, completed_ids, record_map, scratch_pool),
+    wcroot);
+
+  return SVN_NO_ERROR;
+}
+
 
 
 /* ### temporary API. remove before release.  */
@@ -16088,6 +16241,7 @@ svn_wc__db_bump_format(int *result_format,
                        svn_boolean_t *bumped_format,
                        svn_wc__db_t *db,
                        const char *wcroot_abspath,
+                       int target_format,
                        apr_pool_t *scratch_pool)
 {
   svn_sqlite__db_t *sdb;
@@ -16132,7 +16286,7 @@ svn_wc__db_bump_format(int *result_format,
 
   SVN_ERR(svn_sqlite__read_schema_version(&format, sdb, scratch_pool));
   err = svn_wc__upgrade_sdb(result_format, wcroot_abspath,
-                            sdb, format, scratch_pool);
+                            sdb, format, target_format, scratch_pool);
 
   if (err == SVN_NO_ERROR && bumped_format)
     *bumped_format = (*result_format > format);
@@ -278,6 +278,75 @@ svn_error_t *
 svn_wc__db_close(svn_wc__db_t *db);
 
 
+/* Set *DB to a new DB context that uses the same settings as TEMPLATE_DB
+   but shares no state with it, in particular no SQLite connections.
+   Such a context may be used by another thread while TEMPLATE_DB is in use.
+
+   Return SVN_ERR_UNSUPPORTED_FEATURE if TEMPLATE_DB uses exclusive SQLite
+   locking, because a second context could not read the databases then.
+
+   The context is allocated in RESULT_POOL, see svn_wc__db_open().
+   Temporary allocations will be made in SCRATCH_POOL.  */
+svn_error_t *
+svn_wc__db_open_similar(svn_wc__db_t **db,
+                        svn_wc__db_t *template_db,
+                        apr_pool_t *result_pool,
+                        apr_pool_t *scratch_pool);
+
+
+/* Return the number of threads that svn_wc__wq_run() may use to install
+   files for DB, as configured when DB was opened.  This is at least 1.  */
+apr_int32_t
+svn_wc__db_get_install_jobs(svn_wc__db_t *db);
+
+/* Note that svn_wc__wq_run() has installed COUNT files for DB
+   concurrently.  The total is kept for tests and diagnostics.  */
+void
+svn_wc__db_add_concurrent_installs(svn_wc__db_t *db,
+                                   int count);
+
+/* Return the format that DB creates new working copies in and that
+   svn_wc_upgrade() upgrades older ones to.  This is SVN_WC__DEFAULT_VERSION
+   unless DB is configured to compress pristine texts.  */
+int
+svn_wc__db_get_target_format(svn_wc__db_t *db);
+
+/* Start grouping the changes made to the working copy containing
+   WRI_ABSPATH into larger SQLite transactions, instead of committing
+   every operation on its own.  This saves a commit, and the syncing of
+   the journal that comes with it, per node when many nodes are changed.
+
+   Only svn_wc__db_base_add_*(), svn_wc__db_op_mark_conflict() and
+   svn_wc__db_wq_add() join a batch; every one of them still runs in a
+   transaction of its own within the batch, so it either completes or has
+   no effect.  The batch is committed before work items are fetched for
+   running, before pristine texts are removed, after a bounded number of
+   operations and when batching ends.  Work items thus keep running only
+   after the changes that queued them have been committed.
+
+   Working files installed by svn_wc__db_base_add_file() and directories
+   created by svn_wc__db_base_add_incomplete_directory() are put in place
+   right after their batch has been committed, so that nothing appears on
+   disk before the node it belongs to has been committed.  Operations that
+   record a conflict commit the batch right away, because conflict
+   resolvers may look at the working copy.
+
+   Use SCRATCH_POOL for temporary allocations. */
+svn_error_t *
+svn_wc__db_batch_begin(svn_wc__db_t *db,
+                       const char *wri_abspath,
+                       apr_pool_t *scratch_pool);
+
+/* Commit the current batch of the working copy containing WRI_ABSPATH, if
+   any, and stop batching that svn_wc__db_batch_begin() started.
+
+   Use SCRATCH_POOL for temporary allocations. */
+svn_error_t *
+svn_wc__db_batch_end(svn_wc__db_t *db,
+                     const char *wri_abspath,
+                     apr_pool_t *scratch_pool);
+
+
 /* Initialize the SDB for LOCAL_ABSPATH, which should be a working copy path.
 
    A REPOSITORY row will be constructed for the repository identified by
@@ -463,6 +532,11 @@ svn_wc__db_base_add_directory(svn_wc__db_t *db,
 /* Add a new directory in BASE, whether WORKING nodes exist or not. Mark it
    as incomplete and with revision REVISION. If REPOS_RELPATH is not NULL,
    apply REPOS_RELPATH, REPOS_ROOT_URL and REPOS_UUID.
+
+   If CREATE_DIRECTORY is TRUE, also make sure that there is a directory at
+   LOCAL_ABSPATH.  Within a batch (see svn_wc__db_batch_begin()), that
+   happens once the batch has been committed.
+
    Perform all temporary allocations in SCRATCH_POOL.
    */
 svn_error_t *
@@ -477,6 +551,7 @@ svn_wc__db_base_add_incomplete_directory(svn_wc__db_t *db,
                                          svn_boolean_t delete_working,
                                          svn_skel_t *conflict,
                                          svn_skel_t *work_items,
+                                         svn_boolean_t create_directory,
                                          apr_pool_t *scratch_pool);
 
 
@@ -920,6 +995,10 @@ svn_wc__db_base_get_lock_tokens_recursive(apr_hash_t **lock_tokens,
    ### This is temporary - callers should not be looking at the file
    directly.
 
+   If the pristine text is stored compressed, the path is that of a
+   temporary uncompressed copy outside the working copy, which is removed
+   when RESULT_POOL is cleared or destroyed.
+
    Allocate the path in RESULT_POOL. */
 svn_error_t *
 svn_wc__db_pristine_get_path(const char **pristine_abspath,
@@ -940,6 +1019,24 @@ svn_wc__db_pristine_get_future_path(const char **pristine_abspath,
                                     apr_pool_t *result_pool,
                                     apr_pool_t *scratch_pool);
 
+/* Set *COMPRESSED to TRUE if the pristine text identified by SHA1_CHECKSUM
+   within the WC identified by WRI_ABSPATH is stored compressed, i.e. if
+   its file must be read through svn_wc__db_pristine_decompress().  Set it
+   to FALSE if the text is stored as-is or not present at all. */
+svn_error_t *
+svn_wc__db_pristine_is_compressed(svn_boolean_t *compressed,
+                                  svn_wc__db_t *db,
+                                  const char *wri_abspath,
+                                  const svn_checksum_t *sha1_checksum,
+                                  apr_pool_t *scratch_pool);
+
+/* Return a readable stream, allocated in RESULT_POOL, that yields the text
+   of the compressed pristine file read from STORED.  Closing the returned
+   stream closes STORED. */
+svn_stream_t *
+svn_wc__db_pristine_decompress(svn_stream_t *stored,
+                               apr_pool_t *result_pool);
+
 
 /* If requested set *CONTENTS to a readable stream that will yield the pristine
    text identified by SHA1_CHECKSUM (must be a SHA-1 checksum) within the WC
@@ -2954,7 +3051,8 @@ svn_wc__db_install_schema_statistics(svn_sqlite__db_t *sdb,
 /* Create a new wc.db file for LOCAL_DIR_ABSPATH, which is going to be a
    working copy for the repository REPOS_ROOT_URL with uuid REPOS_UUID.
    Return the raw sqlite handle, repository id and working copy id
-   and store the database in WC_DB.
+   and store the database in WC_DB.  Create the database in format
+   TARGET_FORMAT.
 
    Perform temporary allocations in SCRATCH_POOL. */
 svn_error_t *
@@ -2965,6 +3063,7 @@ svn_wc__db_upgrade_begin(svn_sqlite__db_t **sdb,
                          const char *local_dir_abspath,
                          const char *repos_root_url,
                          const char *repos_uuid,
+                         int target_format,
                          apr_pool_t *scratch_pool);
 
 /* Simply insert (or replace) one row in the EXTERNALS table. */
@@ -2982,7 +3081,9 @@ svn_wc__db_upgrade_insert_external(svn_wc__db_t *db,
                                    apr_pool_t *scratch_pool);
 
 /* Upgrade the metadata concerning the WC at WCROOT_ABSPATH, in DB,
- * to the SVN_WC__VERSION format.
+ * to the TARGET_FORMAT format, as returned by
+ * svn_wc__db_get_target_format().  Working copies in a newer format are
+ * left in that format.
  *
  * This function is used for upgrading wc-ng working copies to a newer
  * wc-ng format. If a pre-1.7 working copy is found, this function
@@ -3000,6 +3101,7 @@ svn_wc__db_bump_format(int *result_format,
                        svn_boolean_t *bumped_format,
                        svn_wc__db_t *db,
                        const char *wcroot_abspath,
+                       int target_format,
                        apr_pool_t *scratch_pool);
 
 /* @} */
@@ -3055,6 +3157,37 @@ svn_wc__db_wq_record_and_fetch_next(apr_uint64_t *id,
                                     apr_pool_t *result_pool,
                                     apr_pool_t *scratch_pool);
 
+/* In the WCROOT associated with DB and WRI_ABSPATH, fetch up to MAX_ITEMS
+   work items that follow the work item AFTER_ID in queue order, without
+   marking anything as completed.  Set *IDS to an array of their apr_uint64_t
+   identifiers and *WORK_ITEMS to an array of the svn_skel_t * work items,
+   in the same order.  Both arrays are empty if there are no such items.
+
+   RESULT_POOL will be used to allocate the arrays and work items, and
+   SCRATCH_POOL will be used for all temporary allocations.  */
+svn_error_t *
+svn_wc__db_wq_fetch_following(apr_array_header_t **ids,
+                              apr_array_header_t **work_items,
+                              svn_wc__db_t *db,
+                              const char *wri_abspath,
+                              apr_uint64_t after_id,
+                              int max_items,
+                              apr_pool_t *result_pool,
+                              apr_pool_t *scratch_pool);
+
+/* In the WCROOT associated with DB and WRI_ABSPATH, mark all work items
+   in COMPLETED_IDS (an array of apr_uint64_t) as completed and record the
+   timestamps and sizes in RECORD_MAP, which may be NULL.  All of this
+   happens in a single transaction.
+
+   Use SCRATCH_POOL for all temporary allocations.  */
+svn_error_t *
+svn_wc__db_wq_record_and_complete(svn_wc__db_t *db,
+                                  const char *wri_abspath,
+                                  const apr_array_header_t *completed_ids,
+                                  apr_hash_t *record_map,
+                                  apr_pool_t *scratch_pool);
+
 
 /* @} */
 
@@ -25,11 +25,14 @@
 
 #define SVN_WC__I_AM_WC_DB
 
+#include <string.h>
+
 #include "svn_pools.h"
 #include "svn_io.h"
 #include "svn_dirent_uri.h"
 
 #include "private/svn_io_private.h"
+#include "private/svn_subr_private.h"
 
 #include "wc.h"
 #include "wc_db.h"
@@ -40,6 +43,276 @@
 #define PRISTINE_STORAGE_RELPATH "pristine"
 #define PRISTINE_TEMPDIR_RELPATH "tmp"
 
+/* Values of the PRISTINE.compression column.  NULL means "not compressed". */
+#define PRISTINE_COMPRESSION_LZ4 1
+
+/* Compressed pristine text files are a sequence of blocks, each holding
+   up to this many bytes of the text.  Every block is stored as its length,
+   encoded with svn__encode_uint(), followed by the output of
+   svn__compress_lz4() for that part of the text. */
+#define PRISTINE_BLOCK_SIZE 0x10000
+
+/* Upper limit for the stored size of a block, used to detect corruption.
+   svn__compress_lz4() never produces more than the uncompressed data plus
+   its length header. */
+#define PRISTINE_MAX_STORED_BLOCK_SIZE \
+  (PRISTINE_BLOCK_SIZE + SVN__MAX_ENCODED_UINT_LEN)
+
+
+/* Baton for a stream that compresses the text written to it. */
+typedef struct compress_baton_t
+{
+  /* The stream to write the compressed blocks to. */
+  svn_stream_t *inner;
+
+  /* Text that has not been written to INNER, yet. */
+  svn_stringbuf_t *text;
+
+  /* Buffer for the current compressed block. */
+  svn_stringbuf_t *compressed;
+
+  /* Total number of bytes written to this stream. */
+  svn_filesize_t text_size;
+} compress_baton_t;
+
+/* Compress the pending text in BATON and write it as one block. */
+static svn_error_t *
+write_compressed_block(compress_baton_t *baton)
+{
+  unsigned char header[SVN__MAX_ENCODED_UINT_LEN];
+  apr_size_t len;
+
+  SVN_ERR(svn__compress_lz4(baton->text->data, baton->text->len,
+                            baton->compressed));
+
+  len = svn__encode_uint(header, baton->compressed->len) - header;
+  SVN_ERR(svn_stream_write(baton->inner, (const char *)header, &len));
+
+  len = baton->compressed->len;
+  SVN_ERR(svn_stream_write(baton->inner, baton->compressed->data, &len));
+
+  svn_stringbuf_setempty(baton->text);
+
+  return SVN_NO_ERROR;
+}
+
+/* Implements svn_write_fn_t for compress_baton_t. */
+static svn_error_t *
+compress_write(void *baton,
+               const char *data,
+               apr_size_t *len)
+{
+  compress_baton_t *b = baton;
+  apr_size_t remaining = *len;
+
+  b->text_size += *len;
+  while (remaining > 0)
+    {
+      apr_size_t chunk = PRISTINE_BLOCK_SIZE - b->text->len;
+      if (chunk > remaining)
+        chunk = remaining;
+
+      svn_stringbuf_appendbytes(b->text, data, chunk);
+      data += chunk;
+      remaining -= chunk;
+
+      if (b->text->len == PRISTINE_BLOCK_SIZE)
+        SVN_ERR(write_compressed_block(b));
+    }
+
+  return SVN_NO_ERROR;
+}
+
+/* Implements svn_close_fn_t for compress_baton_t. */
+static svn_error_t *
+compress_close(void *baton)
+{
+  compress_baton_t *b = baton;
+
+  if (b->text->len > 0)
+    SVN_ERR(write_compressed_block(b));
+
+  return svn_error_trace(svn_stream_close(b->inner));
+}
+
+/* Return a writable stream that compresses all text written to it into
+   the format of PRISTINE_COMPRESSION_LZ4 and writes the result to INNER.
+   Closing the stream closes INNER.  Set *BATON to the stream's baton.
+   Allocate everything in RESULT_POOL. */
+static svn_stream_t *
+compressed_stream(compress_baton_t **baton,
+                  svn_stream_t *inner,
+                  apr_pool_t *result_pool)
+{
+  compress_baton_t *b = apr_pcalloc(result_pool, sizeof(*b));
+  svn_stream_t *stream;
+
+  b->inner = inner;
+  b->text = svn_stringbuf_create_ensure(PRISTINE_BLOCK_SIZE, result_pool);
+  b->compressed = svn_stringbuf_create_empty(result_pool);
+
+  stream = svn_stream_create(b, result_pool);
+  svn_stream_set_write(stream, compress_write);
+  svn_stream_set_close(stream, compress_close);
+
+  *baton = b;
+  return stream;
+}
+
+/* Baton for a stream that decompresses a compressed pristine text. */
+typedef struct decompress_baton_t
+{
+  /* The stream to read the compressed blocks from. */
+  svn_stream_t *inner;
+
+  /* Buffer for the current compressed block. */
+  svn_stringbuf_t *compressed;
+
+  /* The text of the current block and how much of it has been read. */
+  svn_stringbuf_t *text;
+  apr_size_t offset;
+} decompress_baton_t;
+
+/* Return an error for a corrupt compressed pristine text. */
+static svn_error_t *
+corrupt_compressed_pristine(void)
+{
+  return svn_error_create(SVN_ERR_WC_CORRUPT_TEXT_BASE, NULL,
+                          _("Compressed pristine text is corrupt"));
+}
+
+/* Read the next block from BATON->INNER and decompress it into
+   BATON->TEXT.  Set *EOF if there are no more blocks. */
+static svn_error_t *
+read_compressed_block(svn_boolean_t *eof,
+                      decompress_baton_t *baton)
+{
+  unsigned char header[SVN__MAX_ENCODED_UINT_LEN];
+  apr_uint64_t block_size;
+  apr_size_t i;
+  apr_size_t len;
+
+  /* Read the block size byte by byte; it ends with the first byte that
+     has the continuation bit cleared. */
+  for (i = 0; i < sizeof(header); i++)
+    {
+      len = 1;
+      SVN_ERR(svn_stream_read_full(baton->inner, (char *)&header[i], &len));
+      if (len == 0)
+        {
+          if (i > 0)
+            return svn_error_trace(corrupt_compressed_pristine());
+
+          *eof = TRUE;
+          return SVN_NO_ERROR;
+        }
+
+      if ((header[i] & 0x80) == 0)
+        break;
+    }
+
+  if (i == sizeof(header)
+      || svn__decode_uint(&block_size, header, header + i + 1) == NULL
+      || block_size > PRISTINE_MAX_STORED_BLOCK_SIZE)
+    return svn_error_trace(corrupt_compressed_pristine());
+
+  svn_stringbuf_setempty(baton->compressed);
+  svn_stringbuf_ensure(baton->compressed, (apr_size_t)block_size);
+
+  len = (apr_size_t)block_size;
+  SVN_ERR(svn_stream_read_full(baton->inner, baton->compressed->data, &len));
+  if (len != block_size)
+    return svn_error_trace(corrupt_compressed_pristine());
+
+  SVN_ERR(svn__decompress_lz4(baton->compressed->data, len, baton->text,
+                              PRISTINE_BLOCK_SIZE));
+  baton->offset = 0;
+
+  *eof = FALSE;
+  return SVN_NO_ERROR;
+}
+
+/* Implements svn_read_fn_t for decompress_baton_t. */
+static svn_error_t *
+decompress_read(void *baton,
+                char *buffer,
+                apr_size_t *len)
+{
+  decompress_baton_t *b = baton;
+  apr_size_t available;
+
+  while (b->offset == b->text->len)
+    {
+      svn_boolean_t eof;
+
+      SVN_ERR(read_compressed_block(&eof, b));
+      if (eof)
+        {
+          *len = 0;
+          return SVN_NO_ERROR;
+        }
+    }
+
+  available = b->text->len - b->offset;
+  if (*len > available)
+    *len = available;
+
+  memcpy(buffer, b->text->data + b->offset, *len);
+  b->offset += *len;
+
+  return SVN_NO_ERROR;
+}
+
+/* Implements svn_read_fn_t for decompress_baton_t. */
+static svn_error_t *
+decompress_read_full(void *baton,
+                     char *buffer,
+                     apr_size_t *len)
+{
+  apr_size_t total = 0;
+
+  while (total < *len)
+    {
+      apr_size_t chunk = *len - total;
+
+      SVN_ERR(decompress_read(baton, buffer + total, &chunk));
+      if (chunk == 0)
+        break;
+
+      total += chunk;
+    }
+
+  *len = total;
+  return SVN_NO_ERROR;
+}
+
+/* Implements svn_close_fn_t for decompress_baton_t. */
+static svn_error_t *
+decompress_close(void *baton)
+{
+  decompress_baton_t *b = baton;
+
+  return svn_error_trace(svn_stream_close(b->inner));
+}
+
+svn_stream_t *
+svn_wc__db_pristine_decompress(svn_stream_t *stored,
+                               apr_pool_t *result_pool)
+{
+  decompress_baton_t *b = apr_pcalloc(result_pool, sizeof(*b));
+  svn_stream_t *stream;
+
+  b->inner = stored;
+  b->compressed = svn_stringbuf_create_empty(result_pool);
+  b->text = svn_stringbuf_create_ensure(PRISTINE_BLOCK_SIZE, result_pool);
+
+  stream = svn_stream_create(b, result_pool);
+  svn_stream_set_read2(stream, decompress_read, decompress_read_full);
+  svn_stream_set_close(stream, decompress_close);
+
+  return stream;
+}
+
 
 
 /* Returns in PRISTINE_ABSPATH a new string allocated from RESULT_POOL,
@@ -92,6 +365,56 @@ get_pristine_fname(const char **pristine_abspath,
   return SVN_NO_ERROR;
 }
 
+/* Set *COMPRESSED to whether the pristine text identified by SHA1_CHECKSUM
+   is stored compressed in WCROOT.  If there is no such pristine, set it to
+   FALSE.  Use SCRATCH_POOL for temporary allocations. */
+static svn_error_t *
+get_pristine_compressed(svn_boolean_t *compressed,
+                        svn_wc__db_wcroot_t *wcroot,
+                        const svn_checksum_t *sha1_checksum,
+                        apr_pool_t *scratch_pool)
+{
+  svn_sqlite__stmt_t *stmt;
+  svn_boolean_t have_row;
+
+  SVN_ERR(svn_sqlite__get_statement(&stmt, wcroot->sdb,
+                                    STMT_SELECT_PRISTINE_SIZE));
+  SVN_ERR(svn_sqlite__bind_checksum(stmt, 1, sha1_checksum, scratch_pool));
+  SVN_ERR(svn_sqlite__step(&have_row, stmt));
+
+  *compressed = have_row && !svn_sqlite__column_is_null(stmt, 1);
+
+  return svn_error_trace(svn_sqlite__reset(stmt));
+}
+
+/* Set *PLAIN_ABSPATH to the path of a new uncompressed copy of the
+   compressed pristine text stored at PRISTINE_ABSPATH.  The copy is a
+   temporary file outside the working copy, which is removed when
+   RESULT_POOL is cleared or destroyed.
+
+   Allocate *PLAIN_ABSPATH in RESULT_POOL and use SCRATCH_POOL for
+   temporary allocations. */
+static svn_error_t *
+make_plain_copy(const char **plain_abspath,
+                const char *pristine_abspath,
+                apr_pool_t *result_pool,
+                apr_pool_t *scratch_pool)
+{
+  svn_stream_t *src_stream;
+  svn_stream_t *dst_stream;
+
+  SVN_ERR(svn_stream_open_readonly(&src_stream, pristine_abspath,
+                                   scratch_pool, scratch_pool));
+  src_stream = svn_wc__db_pristine_decompress(src_stream, scratch_pool);
+
+  SVN_ERR(svn_stream_open_unique(&dst_stream, plain_abspath, NULL,
+                                 svn_io_file_del_on_pool_cleanup,
+                                 result_pool, scratch_pool));
+
+  return svn_error_trace(svn_stream_copy3(src_stream, dst_stream,
+                                          NULL, NULL, scratch_pool));
+}
+
 
 svn_error_t *
 svn_wc__db_pristine_get_path(const char **pristine_abspath,
@@ -104,6 +427,7 @@ svn_wc__db_pristine_get_path(const char **pristine_abspath,
   svn_wc__db_wcroot_t *wcroot;
   const char *local_relpath;
   svn_boolean_t present;
+  svn_boolean_t compressed;
 
   SVN_ERR_ASSERT(pristine_abspath != NULL);
   SVN_ERR_ASSERT(svn_dirent_is_absolute(wri_abspath));
@@ -134,6 +458,13 @@ svn_wc__db_pristine_get_path(const char **pristine_abspath,
                              sha1_checksum,
                              result_pool, scratch_pool));
 
+  /* Callers want to read the file directly, so give them the text. */
+  SVN_ERR(get_pristine_compressed(&compressed, wcroot, sha1_checksum,
+                                  scratch_pool));
+  if (compressed)
+    SVN_ERR(make_plain_copy(pristine_abspath, *pristine_abspath,
+                            result_pool, scratch_pool));
+
   return SVN_NO_ERROR;
 }
 
@@ -150,6 +481,29 @@ svn_wc__db_pristine_get_future_path(const char **pristine_abspath,
   return SVN_NO_ERROR;
 }
 
+svn_error_t *
+svn_wc__db_pristine_is_compressed(svn_boolean_t *compressed,
+                                  svn_wc__db_t *db,
+                                  const char *wri_abspath,
+                                  const svn_checksum_t *sha1_checksum,
+                                  apr_pool_t *scratch_pool)
+{
+  svn_wc__db_wcroot_t *wcroot;
+  const char *local_relpath;
+
+  SVN_ERR_ASSERT(svn_dirent_is_absolute(wri_abspath));
+  SVN_ERR_ASSERT(sha1_checksum != NULL);
+  SVN_ERR_ASSERT(sha1_checksum->kind == svn_checksum_sha1);
+
+  SVN_ERR(svn_wc__db_wcroot_parse_local_abspath(&wcroot, &local_relpath, db,
+                              wri_abspath, scratch_pool, scratch_pool));
+  VERIFY_USABLE_WCROOT(wcroot);
+
+  return svn_error_trace(get_pristine_compressed(compressed, wcroot,
+                                                 sha1_checksum,
+                                                 scratch_pool));
+}
+
 /* Set *CONTENTS to a readable stream from which the pristine text
  * identified by SHA1_CHECKSUM and PRISTINE_ABSPATH can be read from the
  * pristine store of WCROOT.  If SIZE is not null, set *SIZE to the size
@@ -176,6 +530,7 @@ pristine_read_txn(svn_stream_t **contents,
 {
   svn_sqlite__stmt_t *stmt;
   svn_boolean_t have_row;
+  svn_boolean_t compressed;
 
   /* Check that this pristine text is present in the store.  (The presence
    * of the file is not sufficient.) */
@@ -186,6 +541,7 @@ pristine_read_txn(svn_stream_t **contents,
 
   if (size)
     *size = svn_sqlite__column_int64(stmt, 0);
+  compressed = have_row && !svn_sqlite__column_is_null(stmt, 1);
 
   SVN_ERR(svn_sqlite__reset(stmt));
   if (! have_row)
@@ -209,6 +565,9 @@ pristine_read_txn(svn_stream_t **contents,
       SVN_ERR(svn_io_file_open(&file, pristine_abspath, APR_READ,
                                APR_OS_DEFAULT, result_pool));
       *contents = svn_stream_from_aprfile2(file, FALSE, result_pool);
+
+      if (compressed)
+        *contents = svn_wc__db_pristine_decompress(*contents, result_pool);
     }
 
   return SVN_NO_ERROR;
@@ -287,6 +646,9 @@ pristine_install_txn(svn_sqlite__db_t *sdb,
                      const svn_checksum_t *sha1_checksum,
                      /* The pristine text's MD-5 checksum. */
                      const svn_checksum_t *md5_checksum,
+                     /* The size of the text, if it has been compressed
+                        while writing INSTALL_STREAM.  Otherwise, -1. */
+                     svn_filesize_t compressed_text_size,
                      apr_pool_t *scratch_pool)
 {
   svn_sqlite__stmt_t *stmt;
@@ -305,22 +667,31 @@ pristine_install_txn(svn_sqlite__db_t *sdb,
       /* Consistency checks.  Verify both files exist and match.
        * ### We could check much more. */
       {
-        apr_finfo_t finfo;
         apr_off_t size;
+        apr_off_t stored_size;
 
         SVN_ERR(svn_stream__install_finalize(NULL, &size, install_stream,
                                              scratch_pool));
-
-        SVN_ERR(svn_io_stat(&finfo, pristine_abspath, APR_FINFO_SIZE,
-                            scratch_pool));
-        if (size != finfo.size)
+        if (compressed_text_size >= 0)
+          size = compressed_text_size;
+
+        /* Either file may be compressed, so compare the text sizes. */
+        SVN_ERR(svn_sqlite__get_statement(&stmt, sdb,
+                                          STMT_SELECT_PRISTINE_SIZE));
+        SVN_ERR(svn_sqlite__bind_checksum(stmt, 1, sha1_checksum,
+                                          scratch_pool));
+        SVN_ERR(svn_sqlite__step_row(stmt));
+        stored_size = svn_sqlite__column_int64(stmt, 0);
+        SVN_ERR(svn_sqlite__reset(stmt));
+
+        if (size != stored_size)
           {
             return svn_error_createf(
               SVN_ERR_WC_CORRUPT_TEXT_BASE, NULL,
               _("New pristine text '%s' has different size: %s versus %s"),
               svn_checksum_to_cstring_display(sha1_checksum, scratch_pool),
               apr_off_t_toa(scratch_pool, size),
-              apr_off_t_toa(scratch_pool, finfo.size));
+              apr_off_t_toa(scratch_pool, stored_size));
           }
       }
 #endif
@@ -345,7 +716,16 @@ pristine_install_txn(svn_sqlite__db_t *sdb,
     SVN_ERR(svn_sqlite__get_statement(&stmt, sdb, STMT_INSERT_PRISTINE));
     SVN_ERR(svn_sqlite__bind_checksum(stmt, 1, sha1_checksum, scratch_pool));
     SVN_ERR(svn_sqlite__bind_checksum(stmt, 2, md5_checksum, scratch_pool));
-    SVN_ERR(svn_sqlite__bind_int64(stmt, 3, size));
+    if (compressed_text_size >= 0)
+      {
+        SVN_ERR(svn_sqlite__bind_int64(stmt, 3, compressed_text_size));
+        SVN_ERR(svn_sqlite__bind_int64(stmt, 4, PRISTINE_COMPRESSION_LZ4));
+      }
+    else
+      {
+        /* Leave the compression unbound, i.e. NULL. */
+        SVN_ERR(svn_sqlite__bind_int64(stmt, 3, size));
+      }
     SVN_ERR(svn_sqlite__insert(NULL, stmt));
   }
 
@@ -356,6 +736,9 @@ struct svn_wc__db_install_data_t
 {
   svn_wc__db_wcroot_t *wcroot;
   svn_stream_t *inner_stream;
+
+  /* Set if the text gets compressed before writing it to INNER_STREAM. */
+  compress_baton_t *compress_baton;
 };
 
 svn_error_t *
@@ -390,6 +773,11 @@ svn_wc__db_pristine_prepare_install(svn_stream_t **stream,
 
   (*install_data)->inner_stream = *stream;
 
+  if (db->compress_pristines
+      && wcroot->format >= SVN_WC__HAS_COMPRESSED_PRISTINES)
+    *stream = compressed_stream(&(*install_data)->compress_baton, *stream,
+                                result_pool);
+
   if (md5_checksum)
     *stream = svn_stream_checksummed2(*stream, NULL, md5_checksum,
                                       svn_checksum_md5, FALSE, result_pool);
@@ -408,6 +796,7 @@ svn_wc__db_pristine_install(svn_wc__db_install_data_t *install_data,
 {
   svn_wc__db_wcroot_t *wcroot = install_data->wcroot;
   const char *pristine_abspath;
+  svn_filesize_t compressed_text_size = -1;
 
   SVN_ERR_ASSERT(sha1_checksum != NULL);
   SVN_ERR_ASSERT(sha1_checksum->kind == svn_checksum_sha1);
@@ -418,14 +807,28 @@ svn_wc__db_pristine_install(svn_wc__db_install_data_t *install_data,
                              sha1_checksum,
                              scratch_pool, scratch_pool));
 
+  if (install_data->compress_baton)
+    compressed_text_size = install_data->compress_baton->text_size;
+
   /* Ensure the SQL txn has at least a 'RESERVED' lock before we start looking
-   * at the disk, to ensure no concurrent pristine install/delete txn. */
-  SVN_SQLITE__WITH_IMMEDIATE_TXN(
-    pristine_install_txn(wcroot->sdb,
-                         install_data->inner_stream, pristine_abspath,
-                         sha1_checksum, md5_checksum,
-                         scratch_pool),
-    wcroot->sdb);
+   * at the disk, to ensure no concurrent pristine install/delete txn.
+   * An open batch already holds that lock and can't nest another BEGIN. */
+  if (wcroot->batch_txn_open)
+    SVN_SQLITE__WITH_LOCK(
+      pristine_install_txn(wcroot->sdb,
+                           install_data->inner_stream, pristine_abspath,
+                           sha1_checksum, md5_checksum,
+                           compressed_text_size,
+                           scratch_pool),
+      wcroot->sdb);
+  else
+    SVN_SQLITE__WITH_IMMEDIATE_TXN(
+      pristine_install_txn(wcroot->sdb,
+                           install_data->inner_stream, pristine_abspath,
+                           sha1_checksum, md5_checksum,
+                           compressed_text_size,
+                           scratch_pool),
+      wcroot->sdb);
 
   return SVN_NO_ERROR;
 }
@@ -516,13 +919,15 @@ svn_wc__db_pristine_get_sha1(const svn_checksum_t **sha1_checksum,
 }
 
 /* Handle the moving of a pristine from SRC_WCROOT to DST_WCROOT. The existing
-   pristine in SRC_WCROOT is described by CHECKSUM, MD5_CHECKSUM and SIZE */
+   pristine in SRC_WCROOT is described by CHECKSUM, MD5_CHECKSUM, SIZE and
+   COMPRESSION.  The stored file is copied as-is. */
 static svn_error_t *
 maybe_transfer_one_pristine(svn_wc__db_wcroot_t *src_wcroot,
                             svn_wc__db_wcroot_t *dst_wcroot,
                             const svn_checksum_t *checksum,
                             const svn_checksum_t *md5_checksum,
                             apr_int64_t size,
+                            svn_boolean_t compressed,
                             svn_cancel_func_t cancel_func,
                             void *cancel_baton,
                             apr_pool_t *scratch_pool)
@@ -542,6 +947,11 @@ maybe_transfer_one_pristine(svn_wc__db_wcroot_t *src_wcroot,
   SVN_ERR(svn_sqlite__bind_checksum(stmt, 2, md5_checksum, scratch_pool));
   SVN_ERR(svn_sqlite__bind_int64(stmt, 3, size));
 
+  /* Working copies that can't store compressed texts get the plain one. */
+  if (compressed
+      && dst_wcroot->format >= SVN_WC__HAS_COMPRESSED_PRISTINES)
+    SVN_ERR(svn_sqlite__bind_int64(stmt, 4, PRISTINE_COMPRESSION_LZ4));
+
   SVN_ERR(svn_sqlite__update(&affected_rows, stmt));
 
   if (affected_rows == 0)
@@ -559,6 +969,9 @@ maybe_transfer_one_pristine(svn_wc__db_wcroot_t *src_wcroot,
 
   SVN_ERR(svn_stream_open_readonly(&src_stream, src_abspath,
                                    scratch_pool, scratch_pool));
+  if (compressed
+      && dst_wcroot->format < SVN_WC__HAS_COMPRESSED_PRISTINES)
+    src_stream = svn_wc__db_pristine_decompress(src_stream, scratch_pool);
 
   /* ### Should we verify the SHA1 or MD5 here, or is that too expensive? */
   SVN_ERR(svn_stream_copy3(src_stream, dst_stream,
@@ -625,6 +1038,7 @@ pristine_transfer_txn(svn_wc__db_wcroot_t *src_wcroot,
       const svn_checksum_t *checksum;
       const svn_checksum_t *md5_checksum;
       apr_int64_t size;
+      svn_boolean_t compressed;
       svn_error_t *err;
 
       svn_pool_clear(iterpool);
@@ -632,9 +1046,11 @@ pristine_transfer_txn(svn_wc__db_wcroot_t *src_wcroot,
       SVN_ERR(svn_sqlite__column_checksum(&checksum, stmt, 0, iterpool));
       SVN_ERR(svn_sqlite__column_checksum(&md5_checksum, stmt, 1, iterpool));
       size = svn_sqlite__column_int64(stmt, 2);
+      compressed = !svn_sqlite__column_is_null(stmt, 3);
 
       err = maybe_transfer_one_pristine(src_wcroot, dst_wcroot,
                                         checksum, md5_checksum, size,
+                                        compressed,
                                         cancel_func, cancel_baton,
                                         iterpool);
 
@@ -746,6 +1162,9 @@ pristine_remove_if_unreferenced(svn_wc__db_wcroot_t *wcroot,
   SVN_ERR(get_pristine_fname(&pristine_abspath, wcroot->abspath,
                              sha1_checksum, scratch_pool, scratch_pool));
 
+  /* The state before a pending batch may still reference this pristine. */
+  SVN_ERR(svn_wc__db_batch_commit_internal(wcroot));
+
   /* Ensure the SQL txn has at least a 'RESERVED' lock before we start looking
    * at the disk, to ensure no concurrent pristine install/delete txn. */
   SVN_SQLITE__WITH_IMMEDIATE_TXN(
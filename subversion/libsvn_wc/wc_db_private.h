@@ -52,6 +52,14 @@ struct svn_wc__db_t {
   /* Busy timeout in ms., 0 for the libsvn_subr default. */
   apr_int32_t timeout;
 
+  /* Number of threads that the work queue may use to install files, and
+     the number of files it has installed concurrently so far. */
+  apr_int32_t install_jobs;
+  apr_uint64_t concurrent_installs;
+
+  /* Should new pristine texts be stored compressed? */
+  svn_boolean_t compress_pristines;
+
   /* Map a given working copy directory to its relevant data.
      const char *local_abspath -> svn_wc__db_wcroot_t *wcroot  */
   apr_hash_t *dir_data;
@@ -107,6 +115,19 @@ typedef struct svn_wc__db_wcroot_t {
      const char *local_abspath -> svn_wc_adm_access_t *adm_access */
   apr_hash_t *access_cache;
 
+  /* Whether svn_wc__db_batch_begin() is in effect for this wcroot, whether
+     the SQLite transaction of the current batch is open and how many
+     operations it holds. */
+  svn_boolean_t batching;
+  svn_boolean_t batch_txn_open;
+  int batch_ops;
+
+  /* Working files and directories of nodes in the current batch that may
+     only be put in place once the batch has been committed, and the pool
+     that holds them.  See svn_wc__db_batch_install_file_internal(). */
+  apr_array_header_t *batch_installs;
+  apr_pool_t *batch_pool;
+
 } svn_wc__db_wcroot_t;
 
 
@@ -117,6 +138,46 @@ svn_wc__db_close_many_wcroots(apr_hash_t *roots,
                               apr_pool_t *scratch_pool);
 
 
+/* If batching is in effect for WCROOT, make sure that the transaction of
+   the current batch is open, so that the transaction of the operation
+   about to be performed becomes part of it.  Commit the batch first if it
+   already holds the maximum number of operations. */
+svn_error_t *
+svn_wc__db_batch_step_internal(svn_wc__db_wcroot_t *wcroot);
+
+/* Commit the transaction of the current batch in WCROOT, if any, and then
+   put the working files and directories of its nodes in place.  Batching
+   stays in effect; the next batched operation starts a new transaction.
+
+   This must be called before any change is made outside the database
+   that relies on the changes made so far, e.g. before running work
+   items or removing pristine texts. */
+svn_error_t *
+svn_wc__db_batch_commit_internal(svn_wc__db_wcroot_t *wcroot);
+
+/* Install the working file provided by FILE_WRITER, which must have been
+   finalized, at LOCAL_ABSPATH in WCROOT.  If the transaction of a batch
+   is open, only move the file to a temporary location now and put it in
+   place once the batch has been committed, so that it never appears on
+   disk before its node has been committed.  Otherwise, install it right
+   away.
+
+   Use SCRATCH_POOL for temporary allocations. */
+svn_error_t *
+svn_wc__db_batch_install_file_internal(
+  svn_wc__db_wcroot_t *wcroot,
+  svn_wc__working_file_writer_t *file_writer,
+  const char *local_abspath,
+  apr_pool_t *scratch_pool);
+
+/* Like svn_wc__db_batch_install_file_internal(), but make sure that there
+   is a directory at LOCAL_ABSPATH. */
+svn_error_t *
+svn_wc__db_batch_install_dir_internal(svn_wc__db_wcroot_t *wcroot,
+                                      const char *local_abspath,
+                                      apr_pool_t *scratch_pool);
+
+
 /* Construct a new svn_wc__db_wcroot_t. The WCROOT_ABSPATH and SDB parameters
    must have lifetime of at least RESULT_POOL.  */
 svn_error_t *
@@ -155,7 +216,8 @@ svn_wc__db_verify_no_work(svn_sqlite__db_t *sdb);
 /* Assert that the given WCROOT is usable.
    NOTE: the expression is multiply-evaluated!!  */
 #define VERIFY_USABLE_WCROOT(wcroot)  SVN_ERR_ASSERT(               \
-    (wcroot) != NULL && (wcroot)->format == SVN_WC__VERSION)
+    (wcroot) != NULL && (wcroot)->format >= SVN_WC__SUPPORTED_VERSION      \
+    && (wcroot)->format <= SVN_WC__VERSION)
 
 /* Check if the WCROOT is usable for light db operations such as path
    calculations */
@@ -43,6 +43,10 @@
 #define UNKNOWN_WC_ID ((apr_int64_t) -1)
 #define FORMAT_FROM_SDB (-1)
 
+/* The number of batched operations after which a batch gets committed,
+   limiting both the size of the transaction and what a crash may lose. */
+#define MAX_BATCH_OPERATIONS 256
+
 /* #define VERIFY_ON_CLOSE */
 
 /* Get the format version from a wc-1 directory. If it is not a working copy
@@ -185,6 +189,32 @@ verify_db_cb(void *baton,
 }
 #endif
 
+/* A working file or directory of a node in the current batch that gets
+   put in place once the batch is committed. */
+typedef struct batch_install_t
+{
+  /* Where the file or directory belongs. */
+  const char *local_abspath;
+
+  /* The temporary file to move to LOCAL_ABSPATH, or NULL to create a
+     directory there. */
+  const char *tmp_abspath;
+} batch_install_t;
+
+/* An APR pool pre-cleanup handler for the pool of the wcroot DATA.  Commit
+   its batch while the pool with the pending installs still exists, which
+   is no longer the case by the time close_wcroot() gets to run. */
+static apr_status_t
+flush_batch(void *data)
+{
+  svn_wc__db_wcroot_t *wcroot = data;
+
+  if (wcroot->sdb != NULL)
+    svn_error_clear(svn_wc__db_batch_commit_internal(wcroot));
+
+  return APR_SUCCESS;
+}
+
 /* */
 static apr_status_t
 close_wcroot(void *data)
@@ -194,6 +224,10 @@ close_wcroot(void *data)
 
   SVN_ERR_ASSERT_NO_RETURN(wcroot->sdb != NULL);
 
+  /* Every operation in a batch has completed or rolled back on its own,
+     so keep what has been done, just like without batching. */
+  svn_error_clear(svn_wc__db_batch_commit_internal(wcroot));
+
 #if defined(VERIFY_ON_CLOSE) && defined(SVN_DEBUG)
   if (getenv("SVN_CMDLINE_VERIFY_SQL_AT_CLOSE"))
     {
@@ -231,6 +265,7 @@ svn_wc__db_open(svn_wc__db_t **db,
   (*db)->config = config;
   (*db)->verify_format = !open_without_upgrade;
   (*db)->enforce_empty_wq = enforce_empty_wq;
+  (*db)->install_jobs = 1;
   (*db)->dir_data = apr_hash_make(result_pool);
 
   (*db)->state_pool = result_pool;
@@ -240,7 +275,9 @@ svn_wc__db_open(svn_wc__db_t **db,
     {
       svn_error_t *err;
       svn_boolean_t sqlite_exclusive = FALSE;
+      svn_boolean_t compress_pristines = FALSE;
       apr_int64_t timeout;
+      apr_int64_t install_jobs;
 
       err = svn_config_get_bool(config, &sqlite_exclusive,
                                 SVN_CONFIG_SECTION_WORKING_COPY,
@@ -261,12 +298,116 @@ svn_wc__db_open(svn_wc__db_t **db,
         svn_error_clear(err);
       else
         (*db)->timeout = (apr_int32_t)timeout;
+
+      err = svn_config_get_int64(config, &install_jobs,
+                                 SVN_CONFIG_SECTION_WORKING_COPY,
+                                 SVN_CONFIG_OPTION_INSTALL_JOBS,
+                                 1);
+      if (err || install_jobs < 1 || install_jobs > APR_INT32_MAX)
+        svn_error_clear(err);
+      else
+        (*db)->install_jobs = (apr_int32_t)install_jobs;
+
+      err = svn_config_get_bool(config, &compress_pristines,
+                                SVN_CONFIG_SECTION_WORKING_COPY,
+                                SVN_CONFIG_OPTION_COMPRESS_PRISTINES,
+                                FALSE);
+      if (err)
+        svn_error_clear(err);
+      else
+        (*db)->compress_pristines = compress_pristines;
     }
 
   return SVN_NO_ERROR;
 }
 
 
+svn_error_t *
+svn_wc__db_open_similar(svn_wc__db_t **db,
+                        svn_wc__db_t *template_db,
+                        apr_pool_t *result_pool,
+                        apr_pool_t *scratch_pool)
+{
+  if (template_db->exclusive)
+    return svn_error_create(SVN_ERR_UNSUPPORTED_FEATURE, NULL,
+                            _("Can't share a working copy database that "
+                              "is opened exclusively"));
+
+  /* Don't pass the config; svn_config_t is not safe to read from multiple
+     threads and we copy the settings derived from it below. */
+  SVN_ERR(svn_wc__db_open(db, NULL, !template_db->verify_format,
+                          template_db->enforce_empty_wq,
+                          result_pool, scratch_pool));
+  (*db)->timeout = template_db->timeout;
+  (*db)->install_jobs = template_db->install_jobs;
+  (*db)->compress_pristines = template_db->compress_pristines;
+
+  return SVN_NO_ERROR;
+}
+
+
+apr_int32_t
+svn_wc__db_get_install_jobs(svn_wc__db_t *db)
+{
+  return db->install_jobs;
+}
+
+void
+svn_wc__db_add_concurrent_installs(svn_wc__db_t *db,
+                                   int count)
+{
+  db->concurrent_installs += count;
+}
+
+
+int
+svn_wc__db_get_target_format(svn_wc__db_t *db)
+{
+  return db->compress_pristines ? SVN_WC__HAS_COMPRESSED_PRISTINES
+                                : SVN_WC__DEFAULT_VERSION;
+}
+
+
+svn_error_t *
+svn_wc__db_batch_begin(svn_wc__db_t *db,
+                       const char *wri_abspath,
+                       apr_pool_t *scratch_pool)
+{
+  svn_wc__db_wcroot_t *wcroot;
+  const char *local_relpath;
+
+  SVN_ERR_ASSERT(svn_dirent_is_absolute(wri_abspath));
+
+  SVN_ERR(svn_wc__db_wcroot_parse_local_abspath(&wcroot, &local_relpath, db,
+                              wri_abspath, scratch_pool, scratch_pool));
+  VERIFY_USABLE_WCROOT(wcroot);
+
+  wcroot->batching = TRUE;
+
+  return SVN_NO_ERROR;
+}
+
+
+svn_error_t *
+svn_wc__db_batch_end(svn_wc__db_t *db,
+                     const char *wri_abspath,
+                     apr_pool_t *scratch_pool)
+{
+  svn_wc__db_wcroot_t *wcroot;
+  const char *local_relpath;
+
+  SVN_ERR_ASSERT(svn_dirent_is_absolute(wri_abspath));
+
+  SVN_ERR(svn_wc__db_wcroot_parse_local_abspath(&wcroot, &local_relpath, db,
+                              wri_abspath, scratch_pool, scratch_pool));
+  VERIFY_USABLE_WCROOT(wcroot);
+
+  wcroot->batching = FALSE;
+
+  return svn_error_trace(svn_wc__db_batch_commit_internal(wcroot));
+}
+
+
 svn_error_t *
 svn_wc__db_close(svn_wc__db_t *db)
 {
@@ -337,7 +478,7 @@ svn_wc__db_pdh_create_wcroot(svn_wc__db_wcroot_t **wcroot,
   /* Verify that no work items exists. If they do, then our integrity is
      suspect and, thus, we cannot upgrade this database.  */
   if (format >= SVN_WC__HAS_WORK_QUEUE &&
-      format < SVN_WC__VERSION && verify_format)
+      format < SVN_WC__SUPPORTED_VERSION && verify_format)
     {
       svn_error_t *err = svn_wc__db_verify_no_work(sdb);
       if (err)
@@ -345,7 +486,7 @@ svn_wc__db_pdh_create_wcroot(svn_wc__db_wcroot_t **wcroot,
           /* Special message for attempts to upgrade a 1.7-dev wc with
              outstanding workqueue items. */
           if (err->apr_err == SVN_ERR_WC_CLEANUP_REQUIRED
-              && format < SVN_WC__VERSION && verify_format)
+              && format < SVN_WC__SUPPORTED_VERSION && verify_format)
             err = svn_error_quick_wrap(err, _("Cleanup with an older 1.7 "
                                               "client before upgrading with "
                                               "this client"));
@@ -354,7 +495,7 @@ svn_wc__db_pdh_create_wcroot(svn_wc__db_wcroot_t **wcroot,
     }
 
   /* Auto-upgrade the SDB if possible.  */
-  if (format < SVN_WC__VERSION && verify_format)
+  if (format < SVN_WC__SUPPORTED_VERSION && verify_format)
     {
       return svn_error_createf(SVN_ERR_WC_UPGRADE_REQUIRED, NULL,
                                _("The working copy at '%s'\nis too old "
@@ -363,7 +504,8 @@ svn_wc__db_pdh_create_wcroot(svn_wc__db_wcroot_t **wcroot,
                                  "upgrade the working copy first.\n"),
                                svn_dirent_local_style(wcroot_abspath,
                                                       scratch_pool),
-                               format, SVN_VERSION, SVN_WC__VERSION);
+                               format, SVN_VERSION,
+                               SVN_WC__SUPPORTED_VERSION);
     }
 
   *wcroot = apr_palloc(result_pool, sizeof(**wcroot));
@@ -377,12 +519,168 @@ svn_wc__db_pdh_create_wcroot(svn_wc__db_wcroot_t **wcroot,
   (*wcroot)->owned_locks = apr_array_make(result_pool, 8,
                                           sizeof(svn_wc__db_wclock_t));
   (*wcroot)->access_cache = apr_hash_make(result_pool);
+  (*wcroot)->batching = FALSE;
+  (*wcroot)->batch_txn_open = FALSE;
+  (*wcroot)->batch_ops = 0;
+  (*wcroot)->batch_installs = apr_array_make(result_pool, 0,
+                                             sizeof(batch_install_t *));
+  (*wcroot)->batch_pool = svn_pool_create(result_pool);
 
   /* SDB will be NULL for pre-NG working copies. We only need to run a
      cleanup when the SDB is present.  */
   if (sdb != NULL)
-    apr_pool_cleanup_register(result_pool, *wcroot, close_wcroot,
-                              apr_pool_cleanup_null);
+    {
+      apr_pool_pre_cleanup_register(result_pool, *wcroot, flush_batch);
+      apr_pool_cleanup_register(result_pool, *wcroot, close_wcroot,
+                                apr_pool_cleanup_null);
+    }
+  return SVN_NO_ERROR;
+}
+
+
+svn_error_t *
+svn_wc__db_batch_step_internal(svn_wc__db_wcroot_t *wcroot)
+{
+  if (! wcroot->batching)
+    return SVN_NO_ERROR;
+
+  if (wcroot->batch_ops >= MAX_BATCH_OPERATIONS)
+    SVN_ERR(svn_wc__db_batch_commit_internal(wcroot));
+
+  if (! wcroot->batch_txn_open)
+    {
+      /* Take the RESERVED lock right away, so that nested transactions
+         that need it, like pristine installs, don't have to. */
+      SVN_ERR(svn_sqlite__begin_immediate_transaction(wcroot->sdb));
+      wcroot->batch_txn_open = TRUE;
+      wcroot->batch_ops = 0;
+    }
+
+  wcroot->batch_ops++;
+  return SVN_NO_ERROR;
+}
+
+/* Move the temporary file TMP_ABSPATH to LOCAL_ABSPATH, creating missing
+   parent directories as svn_wc__working_file_writer_install() does. */
+static svn_error_t *
+install_batch_file(const char *tmp_abspath,
+                   const char *local_abspath,
+                   apr_pool_t *scratch_pool)
+{
+  svn_error_t *err;
+
+  err = svn_io_file_rename2(tmp_abspath, local_abspath, FALSE, scratch_pool);
+  if (err && APR_STATUS_IS_ENOENT(err->apr_err))
+    {
+      svn_error_t *err2;
+
+      err2 = svn_io_make_dir_recursively(svn_dirent_dirname(local_abspath,
+                                                            scratch_pool),
+                                         scratch_pool);
+      if (err2)
+        return svn_error_trace(svn_error_compose_create(err, err2));
+
+      svn_error_clear(err);
+      err = svn_io_file_rename2(tmp_abspath, local_abspath, FALSE,
+                                scratch_pool);
+    }
+
+  return svn_error_trace(err);
+}
+
+svn_error_t *
+svn_wc__db_batch_commit_internal(svn_wc__db_wcroot_t *wcroot)
+{
+  svn_error_t *err;
+  int i;
+
+  if (! wcroot->batch_txn_open)
+    return SVN_NO_ERROR;
+
+  wcroot->batch_txn_open = FALSE;
+  wcroot->batch_ops = 0;
+
+  /* The operations in the batch ran in savepoints of their own, which
+     have been released or rolled back already. */
+  err = svn_sqlite__finish_transaction(wcroot->sdb, SVN_NO_ERROR);
+
+  /* Now that their nodes are committed, put the files and directories of
+     the batch in place, in the order they were added.  After a failure,
+     only remove the remaining temporary files. */
+  for (i = 0; i < wcroot->batch_installs->nelts; i++)
+    {
+      const batch_install_t *install
+        = APR_ARRAY_IDX(wcroot->batch_installs, i, const batch_install_t *);
+
+      if (err)
+        {
+          if (install->tmp_abspath)
+            svn_error_clear(svn_io_remove_file2(install->tmp_abspath, TRUE,
+                                                wcroot->batch_pool));
+        }
+      else if (install->tmp_abspath)
+        err = install_batch_file(install->tmp_abspath,
+                                 install->local_abspath,
+                                 wcroot->batch_pool);
+      else
+        err = svn_wc__ensure_directory(install->local_abspath,
+                                       wcroot->batch_pool);
+    }
+
+  apr_array_clear(wcroot->batch_installs);
+  svn_pool_clear(wcroot->batch_pool);
+
+  return svn_error_trace(err);
+}
+
+svn_error_t *
+svn_wc__db_batch_install_file_internal(
+  svn_wc__db_wcroot_t *wcroot,
+  svn_wc__working_file_writer_t *file_writer,
+  const char *local_abspath,
+  apr_pool_t *scratch_pool)
+{
+  batch_install_t *install;
+
+  if (! wcroot->batch_txn_open)
+    return svn_error_trace(svn_wc__working_file_writer_install(file_writer,
+                                                               local_abspath,
+                                                               scratch_pool));
+
+  /* Give up the writer's own temporary file, which the caller cleans up
+     once we return, in favor of one that lives as long as the batch. */
+  install = apr_palloc(wcroot->batch_pool, sizeof(*install));
+  install->local_abspath = apr_pstrdup(wcroot->batch_pool, local_abspath);
+  SVN_ERR(svn_io_open_unique_file3(NULL, &install->tmp_abspath,
+                                   svn_wc__adm_child(wcroot->abspath,
+                                                     SVN_WC__ADM_TMP,
+                                                     scratch_pool),
+                                   svn_io_file_del_none,
+                                   wcroot->batch_pool, scratch_pool));
+  SVN_ERR(svn_wc__working_file_writer_install(file_writer,
+                                              install->tmp_abspath,
+                                              scratch_pool));
+
+  APR_ARRAY_PUSH(wcroot->batch_installs, batch_install_t *) = install;
+  return SVN_NO_ERROR;
+}
+
+svn_error_t *
+svn_wc__db_batch_install_dir_internal(svn_wc__db_wcroot_t *wcroot,
+                                      const char *local_abspath,
+                                      apr_pool_t *scratch_pool)
+{
+  batch_install_t *install;
+
+  if (! wcroot->batch_txn_open)
+    return svn_error_trace(svn_wc__ensure_directory(local_abspath,
+                                                    scratch_pool));
+
+  install = apr_palloc(wcroot->batch_pool, sizeof(*install));
+  install->local_abspath = apr_pstrdup(wcroot->batch_pool, local_abspath);
+  install->tmp_abspath = NULL;
+
+  APR_ARRAY_PUSH(wcroot->batch_installs, batch_install_t *) = install;
   return SVN_NO_ERROR;
 }
 
@@ -42,6 +42,7 @@
 #include "private/svn_io_private.h"
 #include "private/svn_wc_private.h"
 #include "private/svn_skel.h"
+#include "private/svn_task.h"
 
 
 /* Workqueue operation names.  */
@@ -468,74 +469,89 @@ svn_wc__wq_build_postupgrade(svn_skel_t **work_item,
 
 /* OP_FILE_INSTALL */
 
-/* Process the OP_FILE_INSTALL work item WORK_ITEM.
- * See svn_wc__wq_build_file_install() which generates this work item.
- * Implements (struct work_item_dispatch).func. */
+/* Everything needed to write a working file for an OP_FILE_INSTALL work
+   item.  Gathering this requires access to the WC DB while writing the
+   file does not, so the latter may happen in a worker thread. */
+typedef struct file_install_t
+{
+  /* The file to install and where to read its contents from. */
+  const char *local_abspath;
+  const char *source_abspath;
+
+  /* Whether SOURCE_ABSPATH is a compressed pristine text. */
+  svn_boolean_t source_compressed;
+
+  /* Where to put the temporary file before moving it into place. */
+  const char *temp_dir_abspath;
+
+  /* Translation and file flags, see svn_wc__working_file_writer_open(). */
+  apr_time_t final_mtime;
+  svn_subst_eol_style_t eol_style;
+  const char *eol;
+  apr_hash_t *keywords;
+  svn_boolean_t is_special;
+  svn_boolean_t is_executable;
+  svn_boolean_t is_readonly;
+
+  /* Whether the timestamp and size of the installed file shall be
+     recorded in the WC DB. */
+  svn_boolean_t record_fileinfo;
+} file_install_t;
+
+/* Read everything from DB that is needed to process the OP_FILE_INSTALL
+   work item WORK_ITEM and return it in *INSTALL, allocated in RESULT_POOL.
+   Use SCRATCH_POOL for temporary allocations. */
 static svn_error_t *
-run_file_install(work_item_baton_t *wqb,
-                 svn_wc__db_t *db,
-                 const svn_skel_t *work_item,
-                 const char *wri_abspath,
-                 svn_cancel_func_t cancel_func,
-                 void *cancel_baton,
-                 apr_pool_t *scratch_pool)
+prepare_file_install(file_install_t **install,
+                     svn_wc__db_t *db,
+                     const svn_skel_t *work_item,
+                     const char *wri_abspath,
+                     apr_pool_t *result_pool,
+                     apr_pool_t *scratch_pool)
 {
   const svn_skel_t *arg1 = work_item->children->next;
   const svn_skel_t *arg4 = arg1->next->next->next;
+  file_install_t *fi = apr_pcalloc(result_pool, sizeof(*fi));
   const char *local_relpath;
-  const char *local_abspath;
   svn_boolean_t use_commit_times;
-  svn_boolean_t record_fileinfo;
-  svn_stream_t *src_stream;
-  const char *temp_dir_abspath;
   apr_int64_t val;
   const char *wcroot_abspath;
-  const char *source_abspath;
   const svn_checksum_t *checksum;
   apr_hash_t *props;
-  svn_boolean_t is_special;
-  svn_boolean_t is_executable;
   svn_boolean_t needs_lock;
   const char *eol_propval;
-  svn_subst_eol_style_t eol_style;
-  const char *eol;
   const char *keywords_propval;
-  apr_hash_t *keywords;
   apr_time_t changed_date;
   svn_revnum_t changed_rev;
   const char *changed_author;
-  apr_time_t final_mtime;
   svn_wc__db_status_t status;
   svn_wc__db_lock_t *lock;
   const char *repos_relpath;
   const char *repos_root_url;
-  svn_wc__working_file_writer_t *file_writer;
-  apr_time_t record_mtime;
-  apr_off_t record_size;
-  svn_boolean_t is_readonly;
 
   local_relpath = apr_pstrmemdup(scratch_pool, arg1->data, arg1->len);
-  SVN_ERR(svn_wc__db_from_relpath(&local_abspath, db, wri_abspath,
-                                  local_relpath, scratch_pool, scratch_pool));
+  SVN_ERR(svn_wc__db_from_relpath(&fi->local_abspath, db, wri_abspath,
+                                  local_relpath, result_pool, scratch_pool));
 
   SVN_ERR(svn_skel__parse_int(&val, arg1->next, scratch_pool));
   use_commit_times = (val != 0);
   SVN_ERR(svn_skel__parse_int(&val, arg1->next->next, scratch_pool));
-  record_fileinfo = (val != 0);
+  fi->record_fileinfo = (val != 0);
 
   SVN_ERR(svn_wc__db_read_node_install_info(&wcroot_abspath,
                                             &checksum, &props,
                                             &changed_date,
-                                            db, local_abspath, wri_abspath,
-                                            scratch_pool, scratch_pool));
+                                            db, fi->local_abspath,
+                                            wri_abspath,
+                                            result_pool, scratch_pool));
 
   if (arg4 != NULL)
     {
       /* Use the provided path for the source.  */
       local_relpath = apr_pstrmemdup(scratch_pool, arg4->data, arg4->len);
-      SVN_ERR(svn_wc__db_from_relpath(&source_abspath, db, wri_abspath,
+      SVN_ERR(svn_wc__db_from_relpath(&fi->source_abspath, db, wri_abspath,
                                       local_relpath,
-                                      scratch_pool, scratch_pool));
+                                      result_pool, scratch_pool));
     }
   else if (! checksum)
     {
@@ -550,42 +566,45 @@ run_file_install(work_item_baton_t *wqb,
                                _("Can't install '%s' from pristine store, "
                                  "because no checksum is recorded for this "
                                  "file"),
-                               svn_dirent_local_style(local_abspath,
+                               svn_dirent_local_style(fi->local_abspath,
                                                       scratch_pool));
     }
   else
     {
-      SVN_ERR(svn_wc__db_pristine_get_future_path(&source_abspath,
+      SVN_ERR(svn_wc__db_pristine_get_future_path(&fi->source_abspath,
                                                   wcroot_abspath,
                                                   checksum,
-                                                  scratch_pool, scratch_pool));
+                                                  result_pool, scratch_pool));
+      SVN_ERR(svn_wc__db_pristine_is_compressed(&fi->source_compressed,
+                                                db, wri_abspath, checksum,
+                                                scratch_pool));
     }
 
   /* Where is the Right Place to put a temp file in this working copy?  */
-  SVN_ERR(svn_wc__db_temp_wcroot_tempdir(&temp_dir_abspath,
+  SVN_ERR(svn_wc__db_temp_wcroot_tempdir(&fi->temp_dir_abspath,
                                          db, wcroot_abspath,
-                                         scratch_pool, scratch_pool));
+                                         result_pool, scratch_pool));
 
   SVN_ERR(svn_wc__db_read_info(&status, NULL, NULL, &repos_relpath,
                                &repos_root_url, NULL, &changed_rev, NULL,
                                &changed_author, NULL, NULL, NULL, NULL,
                                NULL, NULL, NULL, &lock, NULL, NULL,
                                NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
-                               db, local_abspath,
+                               db, fi->local_abspath,
                                scratch_pool, scratch_pool));
   /* Handle special statuses (e.g. added) */
   if (!repos_relpath)
      SVN_ERR(svn_wc__db_read_repos_info(NULL, &repos_relpath,
                                         &repos_root_url, NULL,
-                                        db, local_abspath,
+                                        db, fi->local_abspath,
                                         scratch_pool, scratch_pool));
 
-  is_special = svn_prop_get_value(props, SVN_PROP_SPECIAL) != NULL;
-  is_executable = svn_prop_get_value(props, SVN_PROP_EXECUTABLE) != NULL;
+  fi->is_special = svn_prop_get_value(props, SVN_PROP_SPECIAL) != NULL;
+  fi->is_executable = svn_prop_get_value(props, SVN_PROP_EXECUTABLE) != NULL;
   needs_lock = svn_prop_get_value(props, SVN_PROP_NEEDS_LOCK) != NULL;
 
   eol_propval = svn_prop_get_value(props, SVN_PROP_EOL_STYLE);
-  svn_subst_eol_style_from_value(&eol_style, &eol, eol_propval);
+  svn_subst_eol_style_from_value(&fi->eol_style, &fi->eol, eol_propval);
 
   keywords_propval = svn_prop_get_value(props, SVN_PROP_KEYWORDS);
   if (keywords_propval)
@@ -593,67 +612,116 @@ run_file_install(work_item_baton_t *wqb,
       const char *url =
         svn_path_url_add_component2(repos_root_url, repos_relpath, scratch_pool);
 
-      SVN_ERR(svn_subst_build_keywords3(&keywords, keywords_propval,
+      SVN_ERR(svn_subst_build_keywords3(&fi->keywords, keywords_propval,
                                         apr_psprintf(scratch_pool, "%ld",
                                                      changed_rev),
                                         url, repos_root_url, changed_date,
-                                        changed_author, scratch_pool));
+                                        changed_author, result_pool));
     }
   else
     {
-      keywords = NULL;
+      fi->keywords = NULL;
     }
 
   if (use_commit_times && changed_date)
-    final_mtime = changed_date;
+    fi->final_mtime = changed_date;
   else
-    final_mtime = -1;
+    fi->final_mtime = -1;
 
   if (needs_lock && !lock && status != svn_wc__db_status_added)
-    is_readonly = TRUE;
+    fi->is_readonly = TRUE;
   else
-    is_readonly = FALSE;
+    fi->is_readonly = FALSE;
+
+  *install = fi;
+  return SVN_NO_ERROR;
+}
+
+/* Write the working file described by INSTALL.  If INSTALL->RECORD_FILEINFO
+   is set, return the timestamp and size of the new file in *RECORD_MTIME
+   and *RECORD_SIZE.  Otherwise, set them to -1.
+
+   This does not access the WC DB and may be called from any thread.
+   Use SCRATCH_POOL for temporary allocations. */
+static svn_error_t *
+perform_file_install(apr_time_t *record_mtime,
+                     apr_off_t *record_size,
+                     const file_install_t *install,
+                     svn_cancel_func_t cancel_func,
+                     void *cancel_baton,
+                     apr_pool_t *scratch_pool)
+{
+  svn_stream_t *src_stream;
+  svn_wc__working_file_writer_t *file_writer;
 
   SVN_ERR(svn_wc__working_file_writer_open(&file_writer,
-                                           temp_dir_abspath,
-                                           final_mtime,
-                                           eol_style,
-                                           eol,
+                                           install->temp_dir_abspath,
+                                           install->final_mtime,
+                                           install->eol_style,
+                                           install->eol,
                                            TRUE /* repair_eol */,
-                                           keywords,
-                                           is_special,
-                                           is_executable,
-                                           is_readonly,
+                                           install->keywords,
+                                           install->is_special,
+                                           install->is_executable,
+                                           install->is_readonly,
                                            scratch_pool,
                                            scratch_pool));
 
-  SVN_ERR(svn_stream_open_readonly(&src_stream, source_abspath,
+  SVN_ERR(svn_stream_open_readonly(&src_stream, install->source_abspath,
                                    scratch_pool, scratch_pool));
+  if (install->source_compressed)
+    src_stream = svn_wc__db_pristine_decompress(src_stream, scratch_pool);
 
   SVN_ERR(svn_stream_copy3(src_stream,
                            svn_wc__working_file_writer_get_stream(file_writer),
                            cancel_func, cancel_baton,
                            scratch_pool));
 
-  if (record_fileinfo)
+  if (install->record_fileinfo)
     {
-      SVN_ERR(svn_wc__working_file_writer_finalize(&record_mtime, &record_size,
+      SVN_ERR(svn_wc__working_file_writer_finalize(record_mtime, record_size,
                                                    file_writer, scratch_pool));
     }
   else
     {
       SVN_ERR(svn_wc__working_file_writer_finalize(NULL, NULL, file_writer,
                                                    scratch_pool));
-      record_mtime = -1;
-      record_size = -1;
+      *record_mtime = -1;
+      *record_size = -1;
     }
 
-  SVN_ERR(svn_wc__working_file_writer_install(file_writer, local_abspath,
+  SVN_ERR(svn_wc__working_file_writer_install(file_writer,
+                                              install->local_abspath,
                                               scratch_pool));
 
-  if (record_fileinfo)
+  return SVN_NO_ERROR;
+}
+
+/* Process the OP_FILE_INSTALL work item WORK_ITEM.
+ * See svn_wc__wq_build_file_install() which generates this work item.
+ * Implements (struct work_item_dispatch).func. */
+static svn_error_t *
+run_file_install(work_item_baton_t *wqb,
+                 svn_wc__db_t *db,
+                 const svn_skel_t *work_item,
+                 const char *wri_abspath,
+                 svn_cancel_func_t cancel_func,
+                 void *cancel_baton,
+                 apr_pool_t *scratch_pool)
+{
+  file_install_t *install;
+  apr_time_t record_mtime;
+  apr_off_t record_size;
+
+  SVN_ERR(prepare_file_install(&install, db, work_item, wri_abspath,
+                               scratch_pool, scratch_pool));
+  SVN_ERR(perform_file_install(&record_mtime, &record_size, install,
+                               cancel_func, cancel_baton, scratch_pool));
+
+  if (install->record_fileinfo)
     {
-      wq_record_fileinfo(wqb, local_abspath, record_mtime, record_size);
+      wq_record_fileinfo(wqb, install->local_abspath, record_mtime,
+                         record_size);
     }
 
   return SVN_NO_ERROR;
@@ -1500,6 +1568,326 @@ dispatch_work_item(work_item_baton_t *wqb,
 }
 
 
+/* Wrap ERR, which occurred while running work item ID with contents
+   WORK_ITEM in the queue of WRI_ABSPATH, in an error that tells the user
+   which work item failed.  Use SCRATCH_POOL for temporary allocations. */
+static svn_error_t *
+wrap_work_item_error(svn_error_t *err,
+                     const char *wri_abspath,
+                     apr_uint64_t id,
+                     const svn_skel_t *work_item,
+                     apr_pool_t *scratch_pool)
+{
+  const char *skel = svn_skel__unparse(work_item, scratch_pool)->data;
+
+  return svn_error_createf(SVN_ERR_WC_BAD_ADM_LOG, err,
+                           _("Failed to run the WC DB work queue "
+                             "associated with '%s', work item %d %s"),
+                           svn_dirent_local_style(wri_abspath,
+                                                  scratch_pool),
+                           (int)id, skel);
+}
+
+/* Concurrent file installation:
+ *
+ * With more than one install job configured, the update editor leaves
+ * writing the working files of checkouts and updates to the work queue,
+ * which then holds one OP_FILE_INSTALL item per file.  Most of the time is
+ * spent translating and writing those files.  Consecutive install items
+ * for different files taking their contents from the pristine store are
+ * independent of each other, so we may write them in parallel.
+ *
+ * The data needed for each such item is read from the WC DB in the main
+ * thread.  The working files are then written by svn_task__t workers that
+ * don't touch the WC DB at all.  The output functions collect the file
+ * info to record in queue order.  Finally, the whole batch is marked as
+ * completed in the same transaction that records the file info.
+ *
+ * Should we fail or get interrupted, the whole batch stays in the queue
+ * and will be run again, just as a single item would.  This is safe
+ * because installing a working file is idempotent.
+ */
+
+/* Maximum number of install work items to run in one batch. */
+#define MAX_INSTALL_BATCH 256
+
+/* Process baton for a single file install sub-task. */
+typedef struct install_task_baton_t
+{
+  /* What to install, prepared in the main thread. */
+  const file_install_t *install;
+
+  /* The work item being run, for error reporting. */
+  apr_uint64_t id;
+  const svn_skel_t *work_item;
+  const char *wri_abspath;
+} install_task_baton_t;
+
+/* Result of a file install sub-task if the file info shall be recorded. */
+typedef struct install_task_result_t
+{
+  const char *local_abspath;
+  apr_time_t mtime;
+  apr_off_t size;
+} install_task_result_t;
+
+/* Process baton for the root task of a concurrent install batch. */
+typedef struct install_batch_baton_t
+{
+  /* Parallel arrays of apr_uint64_t work item ids, svn_skel_t * work items
+     and file_install_t * prepared data. */
+  const apr_array_header_t *ids;
+  const apr_array_header_t *work_items;
+  const apr_array_header_t *installs;
+
+  /* Where the queue lives. */
+  const char *wri_abspath;
+
+  /* Output baton for the sub-tasks. */
+  work_item_baton_t *wqb;
+} install_batch_baton_t;
+
+/* Return TRUE, if WORK_ITEM is an OP_FILE_INSTALL item that reads from the
+   pristine store and may therefore run concurrently with other such items
+   for different files. */
+static svn_boolean_t
+is_concurrent_install(const svn_skel_t *work_item)
+{
+  const svn_skel_t *arg1;
+
+  if (! svn_skel__matches_atom(work_item->children, OP_FILE_INSTALL))
+    return FALSE;
+
+  arg1 = work_item->children->next;
+  return arg1->next->next->next == NULL;
+}
+
+/* Implements svn_task__output_func_t.
+ * Record the file info given as install_task_result_t in RESULT in the
+ * work_item_baton_t OUTPUT_BATON.
+ */
+static svn_error_t *
+install_task_output(svn_task__t *task,
+                    void *result,
+                    void *output_baton,
+                    svn_cancel_func_t cancel_func,
+                    void *cancel_baton,
+                    apr_pool_t *result_pool,
+                    apr_pool_t *scratch_pool)
+{
+  install_task_result_t *info = result;
+
+  wq_record_fileinfo(output_baton, info->local_abspath, info->mtime,
+                     info->size);
+
+  return SVN_NO_ERROR;
+}
+
+/* Implements svn_task__process_func_t.
+ * Write the working file for the install_task_baton_t in PROCESS_BATON.
+ * The result is an install_task_result_t if the file info shall be
+ * recorded and NULL otherwise.
+ */
+static svn_error_t *
+install_task_process(void **result,
+                     svn_task__t *task,
+                     void *thread_context,
+                     void *process_baton,
+                     svn_cancel_func_t cancel_func,
+                     void *cancel_baton,
+                     apr_pool_t *result_pool,
+                     apr_pool_t *scratch_pool)
+{
+  install_task_baton_t *baton = process_baton;
+  install_task_result_t *info;
+  apr_time_t record_mtime;
+  apr_off_t record_size;
+  svn_error_t *err;
+
+  err = perform_file_install(&record_mtime, &record_size, baton->install,
+                             cancel_func, cancel_baton, scratch_pool);
+  if (err)
+    return svn_error_trace(wrap_work_item_error(err, baton->wri_abspath,
+                                                baton->id, baton->work_item,
+                                                scratch_pool));
+
+  if (! baton->install->record_fileinfo)
+    {
+      *result = NULL;
+      return SVN_NO_ERROR;
+    }
+
+  info = apr_pcalloc(result_pool, sizeof(*info));
+  info->local_abspath = baton->install->local_abspath;
+  info->mtime = record_mtime;
+  info->size = record_size;
+  *result = info;
+
+  return SVN_NO_ERROR;
+}
+
+/* Implements svn_task__process_func_t.
+ * Add an install_task_process() sub-task to TASK for every install in the
+ * install_batch_baton_t in PROCESS_BATON.  There is no output.
+ */
+static svn_error_t *
+install_batch_process(void **result,
+                      svn_task__t *task,
+                      void *thread_context,
+                      void *process_baton,
+                      svn_cancel_func_t cancel_func,
+                      void *cancel_baton,
+                      apr_pool_t *result_pool,
+                      apr_pool_t *scratch_pool)
+{
+  install_batch_baton_t *baton = process_baton;
+  int i;
+
+  for (i = 0; i < baton->installs->nelts; i++)
+    {
+      apr_pool_t *sub_task_pool = svn_task__create_process_pool(task);
+      install_task_baton_t *sub_task_baton
+        = apr_pcalloc(sub_task_pool, sizeof(*sub_task_baton));
+
+      sub_task_baton->install = APR_ARRAY_IDX(baton->installs, i,
+                                              const file_install_t *);
+      sub_task_baton->id = APR_ARRAY_IDX(baton->ids, i, apr_uint64_t);
+      sub_task_baton->work_item = APR_ARRAY_IDX(baton->work_items, i,
+                                                const svn_skel_t *);
+      sub_task_baton->wri_abspath = baton->wri_abspath;
+
+      SVN_ERR(svn_task__add(task, sub_task_pool, NULL,
+                            install_task_process, sub_task_baton,
+                            install_task_output, baton->wqb));
+    }
+
+  *result = NULL;
+
+  return SVN_NO_ERROR;
+}
+
+/* The work item ID with contents WORK_ITEM is at the head of the queue of
+   WRI_ABSPATH in DB and satisfies is_concurrent_install().  Find the queued
+   items following it that may be installed concurrently with it and return
+   the ids and work items of all of them, starting with ID, in *IDS and
+   *WORK_ITEMS.  No two of them will install the same file.
+
+   Allocate the results in RESULT_POOL and use SCRATCH_POOL for temporary
+   allocations. */
+static svn_error_t *
+collect_install_batch(apr_array_header_t **ids,
+                      apr_array_header_t **work_items,
+                      svn_wc__db_t *db,
+                      const char *wri_abspath,
+                      apr_uint64_t id,
+                      svn_skel_t *work_item,
+                      apr_pool_t *result_pool,
+                      apr_pool_t *scratch_pool)
+{
+  apr_array_header_t *following_ids;
+  apr_array_header_t *following_items;
+  apr_hash_t *targets = apr_hash_make(scratch_pool);
+  const svn_skel_t *target;
+  int i;
+
+  SVN_ERR(svn_wc__db_wq_fetch_following(&following_ids, &following_items,
+                                        db, wri_abspath, id,
+                                        MAX_INSTALL_BATCH - 1,
+                                        result_pool, scratch_pool));
+
+  *ids = apr_array_make(result_pool, following_ids->nelts + 1,
+                        sizeof(apr_uint64_t));
+  *work_items = apr_array_make(result_pool, following_ids->nelts + 1,
+                               sizeof(svn_skel_t *));
+
+  APR_ARRAY_PUSH(*ids, apr_uint64_t) = id;
+  APR_ARRAY_PUSH(*work_items, svn_skel_t *) = work_item;
+  target = work_item->children->next;
+  apr_hash_set(targets, target->data, target->len, target);
+
+  for (i = 0; i < following_items->nelts; i++)
+    {
+      svn_skel_t *item = APR_ARRAY_IDX(following_items, i, svn_skel_t *);
+
+      if (! is_concurrent_install(item))
+        break;
+
+      /* All local relpaths are relative to the same WRI, so equal
+         targets have equal representations. */
+      target = item->children->next;
+      if (apr_hash_get(targets, target->data, target->len))
+        break;
+
+      apr_hash_set(targets, target->data, target->len, target);
+      APR_ARRAY_PUSH(*ids, apr_uint64_t)
+        = APR_ARRAY_IDX(following_ids, i, apr_uint64_t);
+      APR_ARRAY_PUSH(*work_items, svn_skel_t *) = item;
+    }
+
+  return SVN_NO_ERROR;
+}
+
+/* Run the OP_FILE_INSTALL work items with the given IDS and WORK_ITEMS
+   from the queue of WRI_ABSPATH in DB concurrently, using up to
+   INSTALL_JOBS threads.  Record the file info to store in WQB.
+   Use SCRATCH_POOL for temporary allocations. */
+static svn_error_t *
+run_file_installs(work_item_baton_t *wqb,
+                  svn_wc__db_t *db,
+                  const char *wri_abspath,
+                  const apr_array_header_t *ids,
+                  const apr_array_header_t *work_items,
+                  apr_int32_t install_jobs,
+                  svn_cancel_func_t cancel_func,
+                  void *cancel_baton,
+                  apr_pool_t *scratch_pool)
+{
+  apr_pool_t *iterpool = svn_pool_create(scratch_pool);
+  apr_array_header_t *installs = apr_array_make(scratch_pool, ids->nelts,
+                                                sizeof(file_install_t *));
+  install_batch_baton_t batch_baton;
+  int i;
+
+  /* Read everything from the WC DB before handing the batch to workers. */
+  for (i = 0; i < work_items->nelts; i++)
+    {
+      const svn_skel_t *work_item = APR_ARRAY_IDX(work_items, i,
+                                                  const svn_skel_t *);
+      file_install_t *install;
+      svn_error_t *err;
+
+      svn_pool_clear(iterpool);
+
+      err = prepare_file_install(&install, db, work_item, wri_abspath,
+                                 scratch_pool, iterpool);
+      if (err)
+        return svn_error_trace(wrap_work_item_error(
+                                 err, wri_abspath,
+                                 APR_ARRAY_IDX(ids, i, apr_uint64_t),
+                                 work_item, scratch_pool));
+
+      APR_ARRAY_PUSH(installs, file_install_t *) = install;
+    }
+
+  svn_pool_destroy(iterpool);
+
+  batch_baton.ids = ids;
+  batch_baton.work_items = work_items;
+  batch_baton.installs = installs;
+  batch_baton.wri_abspath = wri_abspath;
+  batch_baton.wqb = wqb;
+
+  SVN_ERR(svn_task__run(install_jobs,
+                        install_batch_process, &batch_baton,
+                        NULL, NULL,
+                        NULL, NULL,
+                        cancel_func, cancel_baton,
+                        scratch_pool, scratch_pool));
+
+  return SVN_NO_ERROR;
+}
+
+
 svn_error_t *
 svn_wc__wq_run(svn_wc__db_t *db,
                const char *wri_abspath,
@@ -1509,6 +1897,7 @@ svn_wc__wq_run(svn_wc__db_t *db,
 {
   apr_pool_t *iterpool = svn_pool_create(scratch_pool);
   apr_uint64_t last_id = 0;
+  apr_int32_t install_jobs = svn_wc__db_get_install_jobs(db);
   work_item_baton_t wib = { 0 };
   wib.result_pool = svn_pool_create(scratch_pool);
 
@@ -1569,19 +1958,42 @@ svn_wc__wq_run(svn_wc__db_t *db,
       if (work_item == NULL)
         break;
 
+      /* Install a run of independent files concurrently, if requested. */
+      if (install_jobs > 1 && is_concurrent_install(work_item))
+        {
+          apr_array_header_t *ids;
+          apr_array_header_t *work_items;
+
+          SVN_ERR(collect_install_batch(&ids, &work_items, db, wri_abspath,
+                                        id, work_item, iterpool, iterpool));
+          if (ids->nelts > 1)
+            {
+              SVN_ERR(run_file_installs(&wib, db, wri_abspath,
+                                        ids, work_items, install_jobs,
+                                        cancel_func, cancel_baton,
+                                        iterpool));
+
+              /* Only now that all files are in place, remove their work
+                 items from the queue. */
+              SVN_ERR(svn_wc__db_wq_record_and_complete(db, wri_abspath, ids,
+                                                        wib.record_map,
+                                                        iterpool));
+              svn_wc__db_add_concurrent_installs(db, ids->nelts);
+
+              svn_pool_clear(wib.result_pool);
+              wib.record_map = NULL;
+              wib.used = FALSE;
+              last_id = 0;
+              continue;
+            }
+        }
+
       err = dispatch_work_item(&wib, db, wri_abspath, work_item,
                                cancel_func, cancel_baton, iterpool);
       if (err)
-        {
-          const char *skel = svn_skel__unparse(work_item, scratch_pool)->data;
-
-          return svn_error_createf(SVN_ERR_WC_BAD_ADM_LOG, err,
-                                   _("Failed to run the WC DB work queue "
-                                     "associated with '%s', work item %d %s"),
-                                   svn_dirent_local_style(wri_abspath,
-                                                          scratch_pool),
-                                   (int)id, skel);
-        }
+        return svn_error_trace(wrap_work_item_error(err, wri_abspath, id,
+                                                    work_item,
+                                                    scratch_pool));
 
       /* The work item finished without error. Mark it completed
          in the next loop.  */
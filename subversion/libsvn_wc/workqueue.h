@@ -85,7 +85,10 @@ svn_wc__wq_merge(svn_skel_t *work_item1,
 
 
 /* For the WCROOT identified by the DB and WRI_ABSPATH pair, run any
-   work items that may be present in its workqueue.  */
+   work items that may be present in its workqueue.
+
+   If svn_wc__db_get_install_jobs() is larger than 1 for DB, consecutive
+   file installs from the pristine store will be run concurrently.  */
 svn_error_t *
 svn_wc__wq_run(svn_wc__db_t *db,
                const char *wri_abspath,
@@ -197,6 +197,7 @@ get_option(const dav_resource *resource,
     { SVN_DAV_NS_DAV_SVN_EPHEMERAL_TXNPROPS,  { 1,  8, 0, ""} },
     { SVN_DAV_NS_DAV_SVN_SVNDIFF1,            { 1, 10, 0, ""} },
     { SVN_DAV_NS_DAV_SVN_SVNDIFF2,            { 1, 10, 0, ""} },
+    { SVN_DAV_NS_DAV_SVN_SVNDIFF3,            { 1, 15, 0, ""} },
     { SVN_DAV_NS_DAV_SVN_PUT_RESULT_CHECKSUM, { 1, 10, 0, ""} },
   };
 
@@ -366,6 +367,12 @@ get_option(const dav_resource *resource,
                                      capabilities[i].min_version.patch)))
         continue;
 
+      /* Don't promise to accept svndiff3 if we can't decode it. */
+      if (strcmp(capabilities[i].capability_name,
+                 SVN_DAV_NS_DAV_SVN_SVNDIFF3) == 0
+          && !svn__zstd_available())
+        continue;
+
       apr_table_addn(r->headers_out, "DAV",
                      apr_pstrdup(r->pool, capabilities[i].capability_name));
     }
@@ -76,7 +76,8 @@ check_lib_versions(void)
 
 enum svnfsfs__cmdline_options_t
   {
-    svnfsfs__version = SVN_OPT_FIRST_LONGOPT_ID
+    svnfsfs__version = SVN_OPT_FIRST_LONGOPT_ID,
+    svnfsfs__paths_file
   };
 
 /* Option codes and descriptions.
@@ -104,6 +105,12 @@ static const apr_getopt_option_t options_table[] =
      N_("size of the extra in-memory cache in MB used to\n"
         "                             minimize redundant operations. Default: 16.")},
 
+    {"limit",         'l', 1,
+     N_("process only the youngest ARG revisions")},
+
+    {"paths-file",    svnfsfs__paths_file, 1,
+     N_("read repository paths from file ARG")},
+
     {NULL}
   };
 
@@ -169,6 +176,25 @@ static const svn_opt_subcommand_desc3_t cmd_table[] =
    )},
    {'M'} },
 
+  {"warm-up", subcommand__warm_up, {0}, {N_(
+    "usage: svnfsfs warm-up REPOS_PATH [-r LOWER[:UPPER] | -l COUNT]\n"
+    "                               [--paths-file FILE]\n"
+    "\n"), N_(
+    "Read the changed paths lists and all nodes of the given revisions and\n"
+    "the paths listed in FILE, if any, to populate the repository caches.\n"
+    "Without -r and -l, all revisions are read unless --paths-file is given.\n"
+    "\n"), N_(
+    "FILE may contain one repository path per line or be an svnserve or\n"
+    "mod_dav_svn operational log.  The first word on each line that starts\n"
+    "with '/' is taken as the path.  Paths are looked up in HEAD.\n"
+    "\n"), N_(
+    "The caches of this process are discarded when it exits.  This command is\n"
+    "therefore only useful with caches that persist, i.e. if 'disk-cache-path'\n"
+    "has been set in the repository's fsfs.conf.  To warm up the in-memory\n"
+    "caches of a server, use svnserve's --warm-up-cache option instead.\n"
+   )},
+   {'r', 'l', svnfsfs__paths_file, 'q', 'M'} },
+
   { NULL, NULL, {0}, {NULL}, {0} }
 };
 
@@ -308,6 +334,16 @@ sub_main(int *exit_code, int argc, const char *argv[], apr_pool_t *pool)
       case 'q':
         opt_state.quiet = TRUE;
         break;
+      case 'l':
+        SVN_ERR(svn_cstring_atoi(&opt_state.limit, opt_arg));
+        if (opt_state.limit <= 0)
+          return svn_error_create(SVN_ERR_CL_ARG_PARSING_ERROR, NULL,
+                                  _("Argument to --limit must be positive"));
+        break;
+      case svnfsfs__paths_file:
+        SVN_ERR(svn_utf_cstring_to_utf8(&utf8_opt_arg, opt_arg, pool));
+        opt_state.paths_file = svn_dirent_internal_style(utf8_opt_arg, pool);
+        break;
       case 'h':
       case '?':
         opt_state.help = TRUE;
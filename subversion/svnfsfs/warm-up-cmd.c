@@ -0,0 +1,151 @@
+/* warm-up-cmd.c -- implements the warm-up sub-command.
+ *
+ * ====================================================================
+ *    Licensed to the Apache Software Foundation (ASF) under one
+ *    or more contributor license agreements.  See the NOTICE file
+ *    distributed with this work for additional information
+ *    regarding copyright ownership.  The ASF licenses this file
+ *    to you under the Apache License, Version 2.0 (the
+ *    "License"); you may not use this file except in compliance
+ *    with the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing,
+ *    software distributed under the License is distributed on an
+ *    "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *    KIND, either express or implied.  See the License for the
+ *    specific language governing permissions and limitations
+ *    under the License.
+ * ====================================================================
+ */
+
+#include "svn_fs.h"
+#include "svn_hash.h"
+#include "svn_io.h"
+#include "svn_path.h"
+#include "svn_pools.h"
+#include "svn_sorts.h"
+#include "private/svn_fs_fs_private.h"
+
+#include "svn_private_config.h"
+#include "svnfsfs.h"
+
+/* Read the file at FILENAME and return the repository paths found in it
+ * in *PATHS, allocated in RESULT_POOL.  Each line of the file may either
+ * be a plain repository path or a line from an svnserve or mod_dav_svn
+ * operational log.  In both cases, the first word starting with '/' is
+ * taken to be the (URI-encoded) path.  Lines without such a word will be
+ * skipped.  Use SCRATCH_POOL for temporary allocations.
+ */
+static svn_error_t *
+read_paths_file(apr_array_header_t **paths,
+                const char *filename,
+                apr_pool_t *result_pool,
+                apr_pool_t *scratch_pool)
+{
+  svn_stringbuf_t *contents;
+  apr_array_header_t *lines;
+  apr_hash_t *seen = apr_hash_make(scratch_pool);
+  int i;
+
+  SVN_ERR(svn_stringbuf_from_file2(&contents, filename, scratch_pool));
+  lines = svn_cstring_split(contents->data, "\r\n", TRUE, scratch_pool);
+
+  *paths = apr_array_make(result_pool, lines->nelts, sizeof(const char *));
+  for (i = 0; i < lines->nelts; i++)
+    {
+      const char *line = APR_ARRAY_IDX(lines, i, const char *);
+      apr_array_header_t *words = svn_cstring_split(line, " \t", TRUE,
+                                                    scratch_pool);
+      int k;
+
+      for (k = 0; k < words->nelts; k++)
+        {
+          const char *word = APR_ARRAY_IDX(words, k, const char *);
+          if (word[0] == '/')
+            {
+              /* Access logs tend to repeat the same paths many times. */
+              if (!svn_hash_gets(seen, word))
+                {
+                  svn_hash_sets(seen, word, word);
+                  APR_ARRAY_PUSH(*paths, const char *)
+                    = svn_path_uri_decode(word, result_pool);
+                }
+
+              break;
+            }
+        }
+    }
+
+  return SVN_NO_ERROR;
+}
+
+/* Our progress function simply prints the REVISION number and makes it
+ * appear immediately.
+ */
+static void
+print_progress(svn_revnum_t revision,
+               void *baton,
+               apr_pool_t *pool)
+{
+  printf("%8ld", revision);
+  fflush(stdout);
+}
+
+/* This implements `svn_opt_subcommand_t'. */
+svn_error_t *
+subcommand__warm_up(apr_getopt_t *os, void *baton, apr_pool_t *pool)
+{
+  svnfsfs__opt_state *opt_state = baton;
+  svn_fs_t *fs;
+  svn_fs_fs__ioctl_warm_caches_input_t input = {0};
+  apr_array_header_t *paths = NULL;
+  svn_revnum_t youngest;
+
+  SVN_ERR(open_fs(&fs, opt_state->repository_path, pool));
+  SVN_ERR(svn_fs_youngest_rev(&youngest, fs, pool));
+
+  /* Select the revisions to read.  Without -r and --limit, read all of
+   * them unless we have been asked for specific paths only. */
+  if (opt_state->start_revision.kind == svn_opt_revision_number)
+    {
+      input.start_rev = opt_state->start_revision.value.number;
+      input.end_rev = opt_state->end_revision.kind == svn_opt_revision_number
+                    ? opt_state->end_revision.value.number
+                    : input.start_rev;
+    }
+  else if (opt_state->limit > 0)
+    {
+      input.end_rev = youngest;
+      input.start_rev = MAX(0, youngest - opt_state->limit + 1);
+    }
+  else if (opt_state->paths_file)
+    {
+      input.start_rev = youngest + 1;
+      input.end_rev = youngest;
+    }
+  else
+    {
+      input.start_rev = 0;
+      input.end_rev = youngest;
+    }
+
+  if (opt_state->paths_file)
+    SVN_ERR(read_paths_file(&paths, opt_state->paths_file, pool, pool));
+  input.paths = paths;
+
+  if (!opt_state->quiet)
+    {
+      printf("Warming up caches\n");
+      input.progress_func = print_progress;
+    }
+
+  SVN_ERR(svn_fs_ioctl(fs, SVN_FS_FS__IOCTL_WARM_CACHES, &input, NULL,
+                       check_cancel, NULL, pool, pool));
+
+  if (!opt_state->quiet)
+    printf("\n");
+
+  return SVN_NO_ERROR;
+}
@@ -0,0 +1,346 @@
+/*
+ * repos_cache.c : Implementation of the svnserve repository cache
+ *
+ * ====================================================================
+ *    Licensed to the Apache Software Foundation (ASF) under one
+ *    or more contributor license agreements.  See the NOTICE file
+ *    distributed with this work for additional information
+ *    regarding copyright ownership.  The ASF licenses this file
+ *    to you under the Apache License, Version 2.0 (the
+ *    "License"); you may not use this file except in compliance
+ *    with the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing,
+ *    software distributed under the License is distributed on an
+ *    "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *    KIND, either express or implied.  See the License for the
+ *    specific language governing permissions and limitations
+ *    under the License.
+ * ====================================================================
+ */
+
+
+
+#define APR_WANT_STRFUNC
+#include <apr_want.h>
+
+#include "svn_dirent_uri.h"
+#include "svn_error.h"
+#include "svn_fs.h"
+#include "svn_io.h"
+#include "svn_pools.h"
+#include "svn_repos.h"
+
+#include "private/svn_mutex.h"
+
+#include "svn_private_config.h"
+#include "repos_cache.h"
+
+/* Maximum number of unused repository instances kept per process.
+ */
+#define MAX_IDLE_ENTRIES 32
+
+/* Unused repository instances older than this will be closed.  Keep it
+ * short such that the cache does not hold on to repositories that have
+ * been replaced on disk, e.g. by "svnadmin hotcopy".
+ */
+#define MAX_IDLE_TIME apr_time_from_sec(30)
+
+/* Repository instances opened longer ago than this will be closed, no
+ * matter how often they are being reused.
+ */
+#define MAX_AGE apr_time_from_sec(300)
+
+/* Some per-connection settings, e.g. the hooks environment path, get
+ * allocated in the repository's pool.  Close a repository after that many
+ * connections used it, so it won't grow without bounds.
+ */
+#define MAX_USES 1024
+
+/* A single opened repository.
+ */
+typedef struct cache_entry_t
+{
+  /* Root pool owning this structure and REPOS. */
+  apr_pool_t *pool;
+
+  /* The cache that this entry belongs to. */
+  repos_cache_t *cache;
+
+  /* Repository root directory, used as the lookup key. */
+  const char *repos_root;
+
+  /* The opened repository. */
+  svn_repos_t *repos;
+
+  /* Number of connections that used REPOS so far. */
+  int uses;
+
+  /* When REPOS has been opened. */
+  apr_time_t opened;
+
+  /* Inode and modification time of the filesystem's format file at the
+   * time REPOS has been opened. */
+  apr_ino_t format_inode;
+  apr_time_t format_mtime;
+
+  /* When the entry has been returned to the cache. */
+  apr_time_t released;
+
+  /* Next older unused entry in the cache. */
+  struct cache_entry_t *next;
+} cache_entry_t;
+
+struct repos_cache_t
+{
+  /* Unused entries, most recently released first. */
+  cache_entry_t *idle;
+
+  /* Number of entries in IDLE. */
+  int idle_count;
+
+  /* mutex used to serialize access to this structure */
+  svn_mutex__t *mutex;
+};
+
+svn_error_t *
+repos_cache__create(repos_cache_t **cache,
+                    svn_boolean_t thread_safe,
+                    apr_pool_t *pool)
+{
+  repos_cache_t *result = apr_pcalloc(pool, sizeof(*result));
+
+  SVN_ERR(svn_mutex__init(&result->mutex, thread_safe, pool));
+  *cache = result;
+
+  return SVN_NO_ERROR;
+}
+
+/* Close all unused entries in CACHE that were released before NOW minus
+ * MAX_IDLE_TIME, that were opened before NOW minus MAX_AGE or that exceed
+ * MAX_IDLE_ENTRIES.
+ * The caller must hold the CACHE's mutex.
+ */
+static void
+prune_idle_entries(repos_cache_t *cache,
+                   apr_time_t now)
+{
+  cache_entry_t **link = &cache->idle;
+  int count = 0;
+
+  while (*link)
+    {
+      cache_entry_t *entry = *link;
+
+      if (   count < MAX_IDLE_ENTRIES
+          && now - entry->released < MAX_IDLE_TIME
+          && now - entry->opened < MAX_AGE)
+        {
+          link = &entry->next;
+          count++;
+        }
+      else
+        {
+          *link = entry->next;
+          svn_pool_destroy(entry->pool);
+        }
+    }
+
+  cache->idle_count = count;
+}
+
+/* Remove the most recently released entry for REPOS_ROOT from CACHE and
+ * return it in *ENTRY.  Set *ENTRY to NULL if there is none.
+ * The caller must hold the CACHE's mutex.
+ */
+static svn_error_t *
+take_idle_entry(cache_entry_t **entry,
+                repos_cache_t *cache,
+                const char *repos_root)
+{
+  cache_entry_t **link;
+
+  prune_idle_entries(cache, apr_time_now());
+
+  *entry = NULL;
+  for (link = &cache->idle; *link; link = &(*link)->next)
+    if (strcmp((*link)->repos_root, repos_root) == 0)
+      {
+        *entry = *link;
+        *link = (*entry)->next;
+        cache->idle_count--;
+        break;
+      }
+
+  return SVN_NO_ERROR;
+}
+
+/* Add ENTRY to its cache as the most recently released one.
+ * The caller must hold the cache's mutex.
+ */
+static svn_error_t *
+add_idle_entry(cache_entry_t *entry)
+{
+  repos_cache_t *cache = entry->cache;
+
+  entry->released = apr_time_now();
+  entry->next = cache->idle;
+  cache->idle = entry;
+  cache->idle_count++;
+
+  prune_idle_entries(cache, entry->released);
+
+  return SVN_NO_ERROR;
+}
+
+/* Set *INODE and *MTIME to the identity of the filesystem format file
+ * of the repository at REPOS_ROOT.  "svnadmin hotcopy" and re-creating
+ * the repository replace that file.  Use SCRATCH_POOL for temporary
+ * allocations.
+ */
+static svn_error_t *
+get_format_stamp(apr_ino_t *inode,
+                 apr_time_t *mtime,
+                 const char *repos_root,
+                 apr_pool_t *scratch_pool)
+{
+  apr_finfo_t finfo;
+  const char *path = svn_dirent_join_many(scratch_pool, repos_root,
+                                          "db", "format",
+                                          SVN_VA_NULL);
+
+  SVN_ERR(svn_io_stat(&finfo, path, APR_FINFO_INODE | APR_FINFO_MTIME,
+                      scratch_pool));
+  *inode = finfo.inode;
+  *mtime = finfo.mtime;
+
+  return SVN_NO_ERROR;
+}
+
+/* Return TRUE, if the repository in ENTRY has not been replaced on disk
+ * since it has been opened.  Use SCRATCH_POOL for temporary allocations.
+ */
+static svn_boolean_t
+is_current(cache_entry_t *entry,
+           apr_pool_t *scratch_pool)
+{
+  apr_ino_t inode;
+  apr_time_t mtime;
+  svn_error_t *err = get_format_stamp(&inode, &mtime, entry->repos_root,
+                                      scratch_pool);
+
+  /* If we can't tell, don't reuse the repository. */
+  if (err)
+    {
+      svn_error_clear(err);
+      return FALSE;
+    }
+
+  return inode == entry->format_inode && mtime == entry->format_mtime;
+}
+
+/* Implements warning_func_t.  Unused entries have no connection
+ * to report warnings to. */
+static void
+ignore_warning(void *baton,
+               svn_error_t *err)
+{
+}
+
+/* Pool cleanup function returning the cache_entry_t given by DATA to its
+ * cache.  Since the pool that used the repository is going away, drop all
+ * references into it first.
+ */
+static apr_status_t
+release_entry(void *data)
+{
+  cache_entry_t *entry = data;
+  svn_fs_t *fs = svn_repos_fs(entry->repos);
+  svn_error_t *err;
+
+  if (entry->uses >= MAX_USES)
+    {
+      svn_pool_destroy(entry->pool);
+      return APR_SUCCESS;
+    }
+
+  err = svn_fs_set_access(fs, NULL);
+  if (!err)
+    err = svn_repos_remember_client_capabilities(entry->repos, NULL);
+  svn_fs_set_warning_func(fs, ignore_warning, NULL);
+
+  if (!err)
+    SVN_MUTEX__WITH_LOCK(entry->cache->mutex, add_idle_entry(entry));
+
+  /* If we could not reset the repository, don't reuse it. */
+  if (err)
+    {
+      svn_error_clear(err);
+      svn_pool_destroy(entry->pool);
+    }
+
+  return APR_SUCCESS;
+}
+
+svn_error_t *
+repos_cache__open(svn_repos_t **repos,
+                  repos_cache_t *cache,
+                  const char *repos_root,
+                  apr_hash_t *fs_config,
+                  apr_pool_t *result_pool,
+                  apr_pool_t *scratch_pool)
+{
+  cache_entry_t *entry;
+
+  if (cache == NULL)
+    return svn_error_trace(svn_repos_open3(repos, repos_root, fs_config,
+                                           result_pool, scratch_pool));
+
+  SVN_MUTEX__WITH_LOCK(cache->mutex,
+                       take_idle_entry(&entry, cache, repos_root));
+
+  /* A cached instance would keep serving the old repository after it
+   * has been replaced on disk. */
+  if (entry && !is_current(entry, scratch_pool))
+    {
+      svn_pool_destroy(entry->pool);
+      entry = NULL;
+    }
+
+  if (entry == NULL)
+    {
+      /* Entries get handed from thread to thread, but only one of them
+       * uses an entry at any given time. */
+      apr_pool_t *pool
+        = apr_allocator_owner_get(svn_pool_create_allocator(FALSE));
+      svn_error_t *err;
+
+      entry = apr_pcalloc(pool, sizeof(*entry));
+      entry->pool = pool;
+      entry->cache = cache;
+      entry->repos_root = apr_pstrdup(pool, repos_root);
+      entry->opened = apr_time_now();
+
+      /* Take the stamp first, so a repository replaced while we open it
+       * won't be mistaken for a current one later. */
+      err = get_format_stamp(&entry->format_inode, &entry->format_mtime,
+                             repos_root, scratch_pool);
+      if (!err)
+        err = svn_repos_open3(&entry->repos, repos_root, fs_config, pool,
+                              scratch_pool);
+      if (err)
+        {
+          svn_pool_destroy(pool);
+          return svn_error_trace(err);
+        }
+    }
+
+  entry->uses++;
+  apr_pool_cleanup_register(result_pool, entry, release_entry,
+                            apr_pool_cleanup_null);
+  *repos = entry->repos;
+
+  return SVN_NO_ERROR;
+}
@@ -0,0 +1,73 @@
+/*
+ * repos_cache.h : Public definitions for the Repository Cache
+ *
+ * ====================================================================
+ *    Licensed to the Apache Software Foundation (ASF) under one
+ *    or more contributor license agreements.  See the NOTICE file
+ *    distributed with this work for additional information
+ *    regarding copyright ownership.  The ASF licenses this file
+ *    to you under the Apache License, Version 2.0 (the
+ *    "License"); you may not use this file except in compliance
+ *    with the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing,
+ *    software distributed under the License is distributed on an
+ *    "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *    KIND, either express or implied.  See the License for the
+ *    specific language governing permissions and limitations
+ *    under the License.
+ * ====================================================================
+ */
+
+#ifndef REPOS_CACHE_H
+#define REPOS_CACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#include "server.h"
+
+
+
+/* Opaque per-process cache of opened repositories that are currently not
+ * used by any connection.  Clients that reconnect within a short time
+ * get an already opened repository, skipping the costs of opening the
+ * repository and its filesystem, e.g. reading the format files and
+ * initializing the filesystem caches.  Access to the cache will be
+ * serialized among threads within the same process.
+ */
+typedef struct repos_cache_t repos_cache_t;
+
+/* In POOL, create an empty repository cache and return it in *CACHE.
+ * If THREAD_SAFE is set, the cache may be used by multiple threads.
+ */
+svn_error_t *
+repos_cache__create(repos_cache_t **cache,
+                    svn_boolean_t thread_safe,
+                    apr_pool_t *pool);
+
+/* Set *REPOS to the repository at REPOS_ROOT, opened with FS_CONFIG.
+ * Take it from CACHE if possible, otherwise open it.  Cached instances
+ * are not reused once the repository has been replaced on disk.  In both cases,
+ * REPOS is for the exclusive use by the caller and will be returned to
+ * CACHE when RESULT_POOL gets cleared or destroyed.  CACHE may be NULL,
+ * in which case this is equivalent to svn_repos_open3().
+ *
+ * Use SCRATCH_POOL for temporary allocations.
+ */
+svn_error_t *
+repos_cache__open(svn_repos_t **repos,
+                  repos_cache_t *cache,
+                  const char *repos_root,
+                  apr_hash_t *fs_config,
+                  apr_pool_t *result_pool,
+                  apr_pool_t *scratch_pool);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* REPOS_CACHE_H */
@@ -54,6 +54,7 @@
 #include "private/svn_log.h"
 #include "private/svn_mergeinfo_private.h"
 #include "private/svn_ra_svn_private.h"
+#include "private/svn_subr_private.h"
 #include "private/svn_fspath.h"
 
 #ifdef HAVE_UNISTD_H
@@ -62,6 +63,7 @@
 
 #include "server.h"
 #include "logger.h"
+#include "repos_cache.h"
 
 typedef struct commit_callback_baton_t {
   apr_pool_t *pool;
@@ -828,8 +830,11 @@ static svn_error_t *must_have_access(svn_ra_svn_conn_t *conn,
      authentication whether authz will work or not.  We force
      requiring a username because we need one to be able to check
      authz configuration again with a different user credentials than
-     the first time round. */
+     the first time round.  Within a pipeline, the client has already
+     sent the commands that follow this one, so it could not answer
+     an auth request; let it retry this command afterwards instead. */
   if (b->client_info->user == NULL
+      && !b->pipelining
       && b->repository->auth_access >= req
       && (b->client_info->tunnel_user || b->repository->pwdb
           || b->repository->use_sasl))
@@ -838,10 +843,21 @@ static svn_error_t *must_have_access(svn_ra_svn_conn_t *conn,
   /* Now that an authentication has been done get the new take of
      authz on the request. */
   if (! lookup_access(pool, b, required, path, needs_username))
-    return svn_error_create(SVN_ERR_RA_SVN_CMD_ERR,
-                            error_create_and_log(SVN_ERR_RA_NOT_AUTHORIZED,
-                                                 NULL, NULL, b),
-                            NULL);
+    {
+      svn_error_t *err;
+
+      /* The client retries each of these after the pipeline, so log
+         them just once when the pipeline ends. */
+      if (b->pipelining)
+        {
+          b->pipeline_denials++;
+          err = svn_error_create(SVN_ERR_RA_NOT_AUTHORIZED, NULL, NULL);
+        }
+      else
+        err = error_create_and_log(SVN_ERR_RA_NOT_AUTHORIZED, NULL, NULL, b);
+
+      return svn_error_create(SVN_ERR_RA_SVN_CMD_ERR, err, NULL);
+    }
 
   /* Else, access is granted, and there is much rejoicing. */
   SVN_ERR(create_fs_access(b, pool));
@@ -1154,6 +1170,47 @@ reparent(svn_ra_svn_conn_t *conn,
   return SVN_NO_ERROR;
 }
 
+static svn_error_t *
+begin_pipeline(svn_ra_svn_conn_t *conn,
+               apr_pool_t *pool,
+               svn_ra_svn__list_t *params,
+               void *baton)
+{
+  server_baton_t *b = baton;
+
+  SVN_ERR(trivial_auth_request(conn, pool, b));
+  b->pipelining = TRUE;
+  b->pipeline_denials = 0;
+  SVN_ERR(svn_ra_svn__write_cmd_response(conn, pool, ""));
+  return SVN_NO_ERROR;
+}
+
+static svn_error_t *
+end_pipeline(svn_ra_svn_conn_t *conn,
+             apr_pool_t *pool,
+             svn_ra_svn__list_t *params,
+             void *baton)
+{
+  server_baton_t *b = baton;
+
+  SVN_ERR(trivial_auth_request(conn, pool, b));
+  b->pipelining = FALSE;
+
+  if (b->pipeline_denials)
+    {
+      svn_error_t *err
+        = svn_error_createf(SVN_ERR_RA_NOT_AUTHORIZED, NULL,
+                            _("%d pipelined commands were not authorized"),
+                            b->pipeline_denials);
+      log_error(err, b);
+      svn_error_clear(err);
+      b->pipeline_denials = 0;
+    }
+
+  SVN_ERR(svn_ra_svn__write_cmd_response(conn, pool, ""));
+  return SVN_NO_ERROR;
+}
+
 static svn_error_t *
 get_latest_rev(svn_ra_svn_conn_t *conn,
                apr_pool_t *pool,
@@ -3813,6 +3870,8 @@ static const svn_ra_svn__cmd_entry_t main_commands[] = {
   { "get-deleted-rev", get_deleted_rev },
   { "get-iprops",      get_inherited_props },
   { "list",            list },
+  { "begin-pipeline",  begin_pipeline },
+  { "end-pipeline",    end_pipeline },
   { NULL }
 };
 
@@ -3873,7 +3932,9 @@ repos_path_valid(const char *path)
  * and fs_path fields of REPOSITORY.  VHOST and READ_ONLY flags are the
  * same as in the server baton.
  *
- * CONFIG_POOL shall be used to load config objects.
+ * CONFIG_POOL shall be used to load config objects.  If REPOS_CACHE is
+ * not NULL, take the repository from it and return it there once
+ * RESULT_POOL gets cleaned up.
  *
  * Use SCRATCH_POOL for temporary allocations.
  *
@@ -3886,6 +3947,7 @@ find_repos(const char *url,
            svn_config_t *cfg,
            repository_t *repository,
            svn_repos__config_pool_t *config_pool,
+           repos_cache_t *repos_cache,
            apr_hash_t *fs_config,
            svn_repos_authz_warning_func_t authz_warning_func,
            void *authz_warning_baton,
@@ -3931,8 +3993,9 @@ find_repos(const char *url,
                              "No repository found in '%s'", url);
 
   /* Open the repository and fill in b with the resulting information. */
-  SVN_ERR(svn_repos_open3(&repository->repos, repository->repos_root,
-                          fs_config, result_pool, scratch_pool));
+  SVN_ERR(repos_cache__open(&repository->repos, repos_cache,
+                            repository->repos_root, fs_config,
+                            result_pool, scratch_pool));
   SVN_ERR(svn_repos_remember_client_capabilities(repository->repos,
                                                  repository->capabilities));
   repository->fs = svn_repos_fs(repository->repos);
@@ -4239,7 +4302,7 @@ construct_server_baton(server_baton_t **baton,
    * send an empty mechlist. */
   if (params->compression_level > 0)
     SVN_ERR(svn_ra_svn__write_cmd_response(conn, scratch_pool,
-                                           "nn()(wwwwwwwwwwwww)",
+                                           "nn()(wwwwwwwwwwwwww?w)",
                                            (apr_uint64_t) 2, (apr_uint64_t) 2,
                                            SVN_RA_SVN_CAP_EDIT_PIPELINE,
                                            SVN_RA_SVN_CAP_SVNDIFF1,
@@ -4253,11 +4316,15 @@ construct_server_baton(server_baton_t **baton,
                                            SVN_RA_SVN_CAP_INHERITED_PROPS,
                                            SVN_RA_SVN_CAP_EPHEMERAL_TXNPROPS,
                                            SVN_RA_SVN_CAP_GET_FILE_REVS_REVERSE,
-                                           SVN_RA_SVN_CAP_LIST
+                                           SVN_RA_SVN_CAP_LIST,
+                                           SVN_RA_SVN_CAP_PIPELINING,
+                                           svn__zstd_available()
+                                             ? SVN_RA_SVN_CAP_SVNDIFF3_ACCEPTED
+                                             : NULL
                                            ));
   else
     SVN_ERR(svn_ra_svn__write_cmd_response(conn, scratch_pool,
-                                           "nn()(wwwwwwwwwww)",
+                                           "nn()(wwwwwwwwwwww)",
                                            (apr_uint64_t) 2, (apr_uint64_t) 2,
                                            SVN_RA_SVN_CAP_EDIT_PIPELINE,
                                            SVN_RA_SVN_CAP_ABSENT_ENTRIES,
@@ -4269,7 +4336,8 @@ construct_server_baton(server_baton_t **baton,
                                            SVN_RA_SVN_CAP_INHERITED_PROPS,
                                            SVN_RA_SVN_CAP_EPHEMERAL_TXNPROPS,
                                            SVN_RA_SVN_CAP_GET_FILE_REVS_REVERSE,
-                                           SVN_RA_SVN_CAP_LIST
+                                           SVN_RA_SVN_CAP_LIST,
+                                           SVN_RA_SVN_CAP_PIPELINING
                                            ));
 
   /* Read client response, which we assume to be in version 2 format:
@@ -4336,6 +4404,7 @@ construct_server_baton(server_baton_t **baton,
   err = handle_config_error(find_repos(client_url, params->root, b->vhost,
                                        b->read_only, params->cfg,
                                        b->repository, params->config_pool,
+                                       params->repos_cache,
                                        params->fs_config,
                                        handle_authz_warning, b,
                                        conn_pool, scratch_pool),
@@ -4432,6 +4501,62 @@ construct_server_baton(server_baton_t **baton,
   return SVN_NO_ERROR;
 }
 
+/* Return a hash mapping command names to entries in MAIN_COMMANDS,
+   allocated in POOL. */
+static apr_hash_t *
+make_command_hash(apr_pool_t *pool)
+{
+  const svn_ra_svn__cmd_entry_t *command;
+  apr_hash_t *cmd_hash = apr_hash_make(pool);
+
+  for (command = main_commands; command->cmdname; command++)
+    svn_hash_sets(cmd_hash, command->cmdname, command);
+
+  return cmd_hash;
+}
+
+/* Create the ra_svn connection object for CONNECTION and construct its
+   server baton, unless that has already happened.  Use POOL for
+   temporary allocations. */
+static svn_error_t *
+init_connection(connection_t *connection,
+                apr_pool_t *pool)
+{
+  apr_status_t ar;
+
+  if (connection->conn)
+    return SVN_NO_ERROR;
+
+  /* Enable TCP keep-alives on the socket so we time out when
+   * the connection breaks due to network-layer problems.
+   * If the peer has dropped the connection due to a network partition
+   * or a crash, or if the peer no longer considers the connection
+   * valid because we are behind a NAT and our public IP has changed,
+   * it will respond to the keep-alive probe with a RST instead of an
+   * acknowledgment segment, which will cause svn to abort the session
+   * even while it is currently blocked waiting for data from the peer. */
+  ar = apr_socket_opt_set(connection->usock, APR_SO_KEEPALIVE, 1);
+  if (ar)
+    {
+      /* It's not a fatal error if we cannot enable keep-alives. */
+    }
+
+  /* create the connection, configure ports etc. */
+  connection->conn
+    = svn_ra_svn_create_conn5(connection->usock, NULL, NULL,
+                              connection->params->compression_level,
+                              connection->params->zero_copy_limit,
+                              connection->params->error_check_interval,
+                              connection->params->max_request_size,
+                              connection->params->max_response_size,
+                              connection->pool);
+
+  /* Construct server baton and open the repository for the first time. */
+  return svn_error_trace(construct_server_baton(&connection->baton,
+                                                connection->conn,
+                                                connection->params, pool));
+}
+
 svn_error_t *
 serve_interruptable(svn_boolean_t *terminate_p,
                     connection_t *connection,
@@ -4440,47 +4565,13 @@ serve_interruptable(svn_boolean_t *terminate_p,
 {
   svn_boolean_t terminate = FALSE;
   svn_error_t *err = NULL;
-  const svn_ra_svn__cmd_entry_t *command;
   apr_pool_t *iterpool = svn_pool_create(pool);
 
   /* Prepare command parser. */
-  apr_hash_t *cmd_hash = apr_hash_make(pool);
-  for (command = main_commands; command->cmdname; command++)
-    svn_hash_sets(cmd_hash, command->cmdname, command);
+  apr_hash_t *cmd_hash = make_command_hash(pool);
 
   /* Auto-initialize connection */
-  if (! connection->conn)
-    {
-      apr_status_t ar;
-
-      /* Enable TCP keep-alives on the socket so we time out when
-       * the connection breaks due to network-layer problems.
-       * If the peer has dropped the connection due to a network partition
-       * or a crash, or if the peer no longer considers the connection
-       * valid because we are behind a NAT and our public IP has changed,
-       * it will respond to the keep-alive probe with a RST instead of an
-       * acknowledgment segment, which will cause svn to abort the session
-       * even while it is currently blocked waiting for data from the peer. */
-      ar = apr_socket_opt_set(connection->usock, APR_SO_KEEPALIVE, 1);
-      if (ar)
-        {
-          /* It's not a fatal error if we cannot enable keep-alives. */
-        }
-
-      /* create the connection, configure ports etc. */
-      connection->conn
-        = svn_ra_svn_create_conn5(connection->usock, NULL, NULL,
-                                  connection->params->compression_level,
-                                  connection->params->zero_copy_limit,
-                                  connection->params->error_check_interval,
-                                  connection->params->max_request_size,
-                                  connection->params->max_response_size,
-                                  connection->pool);
-
-      /* Construct server baton and open the repository for the first time. */
-      err = construct_server_baton(&connection->baton, connection->conn,
-                                   connection->params, pool);
-    }
+  err = init_connection(connection, pool);
 
   /* If we can't access the repo for some reason, end this connection. */
   if (err)
@@ -4529,6 +4620,45 @@ serve_interruptable(svn_boolean_t *terminate_p,
   return svn_error_trace(err);
 }
 
+svn_error_t *
+serve_pending(svn_boolean_t *terminate_p,
+              connection_t *connection,
+              apr_pool_t *pool)
+{
+  svn_boolean_t terminate = FALSE;
+  svn_boolean_t has_command = TRUE;
+  apr_hash_t *cmd_hash = make_command_hash(pool);
+  apr_pool_t *iterpool = svn_pool_create(pool);
+  svn_error_t *err;
+
+  /* The server speaks first, so a new connection has to be initialized
+   * right away rather than waiting for input. */
+  err = init_connection(connection, pool);
+  if (err)
+    terminate = TRUE;
+
+  /* Handle everything the client has sent so far.  Pipelining clients
+   * may have sent several commands at once, and those may be sitting in
+   * our receive buffer where a poll on the socket would not see them. */
+  while (!terminate && !err && has_command)
+    {
+      svn_pool_clear(iterpool);
+
+      err = svn_ra_svn__has_command(&has_command, &terminate,
+                                    connection->conn, iterpool);
+      if (!err && has_command && !terminate)
+        err = svn_ra_svn__handle_command(&terminate, cmd_hash,
+                                         connection->baton,
+                                         connection->conn,
+                                         FALSE, iterpool);
+    }
+
+  svn_pool_destroy(iterpool);
+  *terminate_p = terminate || err;
+
+  return svn_error_trace(err);
+}
+
 svn_error_t *serve(svn_ra_svn_conn_t *conn,
                    serve_params_t *params,
                    apr_pool_t *pool)
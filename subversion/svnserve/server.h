@@ -90,6 +90,10 @@ typedef struct server_baton_t {
                               May be NULL even if log_file is not. */
   svn_boolean_t read_only; /* Disallow write access (global flag) */
   svn_boolean_t vhost;     /* Use virtual-host-based path to repo. */
+  svn_boolean_t pipelining; /* Between begin-pipeline and end-pipeline;
+                               don't start authentication exchanges. */
+  int pipeline_denials;     /* Commands in the current pipeline that
+                               failed authorization; logged at its end. */
   apr_pool_t *pool;
 } server_baton_t;
 
@@ -127,6 +131,10 @@ typedef struct serve_params_t {
   /* all configurations should be opened through this factory */
   svn_repos__config_pool_t *config_pool;
 
+  /* unused opened repositories to be reused by later connections;
+     possibly NULL. */
+  struct repos_cache_t *repos_cache;
+
   /* The FS configuration to be applied to all repositories.
      It mainly contains things like cache settings. */
   apr_hash_t *fs_config;
@@ -221,6 +229,19 @@ serve_interruptable(svn_boolean_t *terminate_p,
                     svn_boolean_t (* is_busy)(connection_t *),
                     apr_pool_t *pool);
 
+/* Serve the commands that have already arrived on CONNECTION, without
+   waiting for any further input.  Set *TERMINATE_P to TRUE if the
+   connection got terminated or failed and should be closed.
+
+   As with serve_interruptable(), CONNECTION->CONN may be NULL for the
+   first call, in which case we send the greeting and wait for the
+   client's response before looking for commands.
+ */
+svn_error_t *
+serve_pending(svn_boolean_t *terminate_p,
+              connection_t *connection,
+              apr_pool_t *pool);
+
 /* Initialize the Cyrus SASL library. POOL is used for allocations. */
 svn_error_t *cyrus_init(apr_pool_t *pool);
 
@@ -49,17 +49,21 @@
 #include "svn_version.h"
 #include "svn_io.h"
 #include "svn_hash.h"
+#include "svn_sorts.h"
 
 #include "svn_private_config.h"
 
 #include "private/svn_dep_compat.h"
 #include "private/svn_cmdline_private.h"
 #include "private/svn_atomic.h"
+#include "private/svn_cache.h"
+#include "private/svn_fs_fs_private.h"
 #include "private/svn_mutex.h"
 #include "private/svn_subr_private.h"
 
 #if APR_HAS_THREADS
 #    include <apr_thread_pool.h>
+#    include <apr_poll.h>
 #endif
 
 #include "winservice.h"
@@ -70,6 +74,7 @@
 
 #include "server.h"
 #include "logger.h"
+#include "repos_cache.h"
 
 /* The strategy for handling incoming connections.  Some of these may be
    unavailable due to platform limitations. */
@@ -145,6 +150,12 @@ enum run_mode {
  */
 #define THREADPOOL_THREAD_IDLE_LIMIT 1000000
 
+/* Size of the pollset for idle connections in event-loop mode.  With the
+ * epoll and kqueue backends, this does not limit the number of idle
+ * connections but only the number of ready ones reported per poll call.
+ */
+#define EVENT_LOOP_POLLSET_SIZE 1024
+
 /* Number of client to server connections that may concurrently in the
  * TCP 3-way handshake state, i.e. are in the process of being created.
  *
@@ -222,6 +233,9 @@ void winservice_notify_stop(void)
 #define SVNSERVE_OPT_MAX_REQUEST     274
 #define SVNSERVE_OPT_MAX_RESPONSE    275
 #define SVNSERVE_OPT_CACHE_NODEPROPS 276
+#define SVNSERVE_OPT_SHARED_CACHE    277
+#define SVNSERVE_OPT_WARM_UP_CACHE   278
+#define SVNSERVE_OPT_EVENT_LOOP      279
 
 /* Text macro because we can't use #ifdef sections inside a N_("...")
    macro expansion. */
@@ -325,6 +339,24 @@ static const apr_getopt_option_t svnserve__options[] =
         "Default is yes.\n"
         "                             "
         "[used for FSFS repositories only]")},
+    {"shared-memory-cache", SVNSERVE_OPT_SHARED_CACHE, 0,
+     N_("share one in-memory cache (see --memory-cache-size)\n"
+        "                             "
+        "between all connection processes instead of giving\n"
+        "                             "
+        "each process its own cache.\n"
+        "                             "
+        "[mode: daemon, connection handling: fork]")},
+    {"warm-up-cache", SVNSERVE_OPT_WARM_UP_CACHE, 1,
+     N_("before accepting connections, read the youngest\n"
+        "                             "
+        "ARG revisions of the repository at --root or, if\n"
+        "                             "
+        "that is not a repository, of each repository\n"
+        "                             "
+        "directly below it into the caches.\n"
+        "                             "
+        "[mode: daemon; used for FSFS repositories only]")},
     {"client-speed", SVNSERVE_OPT_CLIENT_SPEED, 1,
      N_("Optimize network handling based on the assumption\n"
         "                             "
@@ -362,6 +394,17 @@ static const apr_getopt_option_t svnserve__options[] =
         "                             "
         "Default is " APR_STRINGIFY(THREADPOOL_MAX_SIZE) "."
         ONLY_AVAILABLE_WITH_THEADS)},
+    {"event-loop",       SVNSERVE_OPT_EVENT_LOOP, 0,
+     N_("Wait for commands on idle connections in a single\n"
+        "                             "
+        "event loop and occupy server threads only while\n"
+        "                             "
+        "commands are being processed.  Useful for many\n"
+        "                             "
+        "long-lived, mostly idle connections.\n"
+        "                             "
+        "Requires epoll, kqueue or event port support."
+        ONLY_AVAILABLE_WITH_THEADS)},
 #endif
     {"max-request-size", SVNSERVE_OPT_MAX_REQUEST, 1,
      N_("Maximum acceptable size of a client request in MB.\n"
@@ -656,6 +699,114 @@ static void * APR_THREAD_FUNC serve_thread(apr_thread_t *tid, void *data)
   return NULL;
 }
 
+/* In event-loop mode, the connections that are waiting for their next
+   command.  NULL in all other modes. */
+static apr_pollset_t *idle_connections = NULL;
+
+/* Add CONNECTION to IDLE_CONNECTIONS.  The event loop will hand it back
+   to a worker thread as soon as more input arrives. */
+static svn_error_t *
+park_connection(connection_t *connection)
+{
+  apr_pollfd_t pfd = { 0 };
+  apr_status_t status;
+
+  pfd.p = connection->pool;
+  pfd.desc_type = APR_POLL_SOCKET;
+  pfd.desc.s = connection->usock;
+  pfd.reqevents = APR_POLLIN;
+  pfd.client_data = connection;
+
+  status = apr_pollset_add(idle_connections, &pfd);
+  if (status)
+    return svn_error_wrap_apr(status, _("Can't wait for client input"));
+
+  return SVN_NO_ERROR;
+}
+
+/* Serve the commands that the connection given by DATA has received so
+   far.  Then, rather than blocking this thread until the next command
+   comes in, park the connection in IDLE_CONNECTIONS. */
+static void * APR_THREAD_FUNC serve_event_thread(apr_thread_t *tid,
+                                                 void *data)
+{
+  svn_boolean_t done;
+  connection_t *connection = data;
+  svn_error_t *err;
+
+  apr_pool_t *pool = svn_root_pools__acquire_pool(connection_pools);
+
+  /* process the actual requests and log errors */
+  err = serve_pending(&done, connection, pool);
+  if (!err && !done)
+    err = park_connection(connection);
+
+  /* Once parked, CONNECTION may already be served by another thread. */
+  if (err)
+    {
+      logger__log_error(connection->params->logger, err, NULL,
+                        get_client_info(connection->conn, connection->params,
+                                        pool));
+      svn_error_clear(err);
+      done = TRUE;
+    }
+  svn_root_pools__release_pool(pool, connection_pools);
+
+  if (done)
+    close_connection(connection);
+
+  return NULL;
+}
+
+/* The event loop: wait for input on any of the IDLE_CONNECTIONS and hand
+   the respective connections over to THREADS.  DATA is the
+   serve_params_t of the server. */
+static void * APR_THREAD_FUNC event_loop_thread(apr_thread_t *tid,
+                                                void *data)
+{
+  serve_params_t *params = data;
+
+  while (TRUE)
+    {
+      const apr_pollfd_t *ready;
+      apr_int32_t count, i;
+      apr_status_t status;
+
+      status = apr_pollset_poll(idle_connections, -1, &count, &ready);
+      if (APR_STATUS_IS_EINTR(status) || APR_STATUS_IS_TIMEUP(status))
+        continue;
+
+      if (status)
+        {
+          svn_error_t *err
+            = svn_error_wrap_apr(status, _("Can't poll idle connections"));
+          logger__log_error(params->logger, err, NULL, NULL);
+          svn_error_clear(err);
+          continue;
+        }
+
+      for (i = 0; i < count; i++)
+        {
+          connection_t *connection = ready[i].client_data;
+
+          apr_pollset_remove(idle_connections, &ready[i]);
+          status = apr_thread_pool_push(threads, serve_event_thread,
+                                        connection, 0, NULL);
+          if (status)
+            {
+              svn_error_t *err
+                = svn_error_wrap_apr(status, _("Can't push task"));
+              logger__log_error(params->logger, err, NULL, NULL);
+              svn_error_clear(err);
+              close_connection(connection);
+            }
+        }
+    }
+
+  /* NOTREACHED */
+  return NULL;
+}
+
 #endif
 
 /* Write the PID of the current process as a decimal number, followed by a
@@ -678,6 +829,96 @@ static svn_error_t *write_pid_file(const char *filename, apr_pool_t *pool)
   return SVN_NO_ERROR;
 }
 
+/* Read the youngest REV_COUNT revisions of the repository at PATH into
+   the caches, opening it with FS_CONFIG.  Quietly skip non-FSFS
+   repositories.  Use SCRATCH_POOL for temporary allocations. */
+static svn_error_t *
+warm_up_repository(const char *path,
+                   int rev_count,
+                   apr_hash_t *fs_config,
+                   apr_pool_t *scratch_pool)
+{
+  svn_repos_t *repos;
+  svn_fs_t *fs;
+  svn_revnum_t youngest;
+  svn_fs_fs__ioctl_warm_caches_input_t input = {0};
+  svn_error_t *err;
+
+  SVN_ERR(svn_repos_open3(&repos, path, fs_config, scratch_pool,
+                          scratch_pool));
+  fs = svn_repos_fs(repos);
+  SVN_ERR(svn_fs_youngest_rev(&youngest, fs, scratch_pool));
+
+  input.start_rev = MAX(0, youngest - rev_count + 1);
+  input.end_rev = youngest;
+  err = svn_fs_ioctl(fs, SVN_FS_FS__IOCTL_WARM_CACHES, &input, NULL,
+                     NULL, NULL, scratch_pool, scratch_pool);
+  if (err && err->apr_err == SVN_ERR_FS_UNRECOGNIZED_IOCTL_CODE)
+    {
+      svn_error_clear(err);
+      err = SVN_NO_ERROR;
+    }
+
+  return svn_error_trace(err);
+}
+
+/* Warm up the caches for the repository at ROOT or, if ROOT is not a
+   repository, for all repositories immediately below it, as described for
+   warm_up_repository() with REV_COUNT and FS_CONFIG.  Failures are not
+   fatal; they will be reported through LOGGER.  Use SCRATCH_POOL for
+   temporary allocations. */
+static svn_error_t *
+warm_up_caches(const char *root,
+               int rev_count,
+               apr_hash_t *fs_config,
+               logger_t *logger,
+               apr_pool_t *scratch_pool)
+{
+  apr_hash_t *dirents;
+  apr_hash_index_t *hi;
+  apr_pool_t *iterpool;
+  const char *repos_root = svn_repos_find_root_path(root, scratch_pool);
+
+  if (repos_root && strcmp(repos_root, root) == 0)
+    {
+      svn_error_t *err = warm_up_repository(root, rev_count, fs_config,
+                                            scratch_pool);
+      logger__log_warning(logger, err, NULL, NULL);
+      svn_error_clear(err);
+
+      return SVN_NO_ERROR;
+    }
+
+  SVN_ERR(svn_io_get_dirents3(&dirents, root, TRUE, scratch_pool,
+                              scratch_pool));
+
+  iterpool = svn_pool_create(scratch_pool);
+  for (hi = apr_hash_first(scratch_pool, dirents); hi; hi = apr_hash_next(hi))
+    {
+      const char *name = apr_hash_this_key(hi);
+      svn_io_dirent2_t *dirent = apr_hash_this_val(hi);
+      const char *path;
+
+      if (dirent->kind != svn_node_dir)
+        continue;
+
+      svn_pool_clear(iterpool);
+      path = svn_dirent_join(root, name, iterpool);
+      repos_root = svn_repos_find_root_path(path, iterpool);
+      if (repos_root && strcmp(repos_root, path) == 0)
+        {
+          svn_error_t *err = warm_up_repository(path, rev_count, fs_config,
+                                                iterpool);
+          logger__log_warning(logger, err, NULL, NULL);
+          svn_error_clear(err);
+        }
+    }
+
+  svn_pool_destroy(iterpool);
+
+  return SVN_NO_ERROR;
+}
+
 /* Version compatibility check */
 static svn_error_t *
 check_lib_versions(void)
@@ -725,6 +966,8 @@ sub_main(int *exit_code, int argc, const char *argv[], apr_pool_t *pool)
   svn_boolean_t cache_txdeltas = TRUE;
   svn_boolean_t cache_revprops = FALSE;
   svn_boolean_t use_block_read = FALSE;
+  svn_boolean_t shared_cache = FALSE;
+  int warm_up_rev_count = 0;
   apr_uint16_t port = SVN_RA_SVN_PORT;
   const char *host = NULL;
   int family = APR_INET;
@@ -742,6 +985,7 @@ sub_main(int *exit_code, int argc, const char *argv[], apr_pool_t *pool)
   svn_node_kind_t kind;
   apr_size_t min_thread_count = THREADPOOL_MIN_SIZE;
   apr_size_t max_thread_count = THREADPOOL_MAX_SIZE;
+  svn_boolean_t use_event_loop = FALSE;
 #ifdef SVN_HAVE_SASL
   SVN_ERR(cyrus_init(pool));
 #endif
@@ -766,6 +1010,7 @@ sub_main(int *exit_code, int argc, const char *argv[], apr_pool_t *pool)
   params.compression_level = SVN_DELTA_COMPRESSION_LEVEL_DEFAULT;
   params.logger = NULL;
   params.config_pool = NULL;
+  params.repos_cache = NULL;
   params.fs_config = NULL;
   params.vhost = FALSE;
   params.username_case = CASE_ASIS;
@@ -929,6 +1174,14 @@ sub_main(int *exit_code, int argc, const char *argv[], apr_pool_t *pool)
           use_block_read = svn_tristate__from_word(arg) == svn_tristate_true;
           break;
 
+        case SVNSERVE_OPT_SHARED_CACHE:
+          shared_cache = TRUE;
+          break;
+
+        case SVNSERVE_OPT_WARM_UP_CACHE:
+          SVN_ERR(svn_cstring_atoi(&warm_up_rev_count, arg));
+          break;
+
         case SVNSERVE_OPT_CLIENT_SPEED:
           {
             apr_size_t bandwidth = (apr_size_t)apr_strtoi64(arg, NULL, 0);
@@ -962,6 +1215,10 @@ sub_main(int *exit_code, int argc, const char *argv[], apr_pool_t *pool)
           max_thread_count = (apr_size_t)apr_strtoi64(arg, NULL, 0);
           break;
 
+        case SVNSERVE_OPT_EVENT_LOOP:
+          use_event_loop = TRUE;
+          break;
+
 #ifdef WIN32
         case SVNSERVE_OPT_SERVICE:
           if (run_mode != run_mode_service)
@@ -1036,6 +1293,17 @@ sub_main(int *exit_code, int argc, const char *argv[], apr_pool_t *pool)
       return SVN_NO_ERROR;
     }
 
+  if (use_event_loop && handling_mode != connection_mode_thread)
+    {
+      svn_error_clear(svn_cmdline_fputs(
+                      _("You may only specify --event-loop together "
+                        "with -T\n"),
+                      stderr, pool));
+      usage(argv[0], pool);
+      *exit_code = EXIT_FAILURE;
+      return SVN_NO_ERROR;
+    }
+
   /* construct object pools */
   is_multi_threaded = handling_mode == connection_mode_thread;
   params.fs_config = apr_hash_make(pool);
@@ -1054,6 +1322,12 @@ sub_main(int *exit_code, int argc, const char *argv[], apr_pool_t *pool)
                                         is_multi_threaded,
                                         pool));
 
+  /* Forked processes exit after serving a single connection, so there
+   * is nobody to hand a repository over to. */
+  if (handling_mode != connection_mode_fork)
+    SVN_ERR(repos_cache__create(&params.repos_cache, is_multi_threaded,
+                                pool));
+
   /* If a configuration file is specified, load it and any referenced
    * password and authorization files. */
   if (config_filename)
@@ -1295,8 +1569,23 @@ sub_main(int *exit_code, int argc, const char *argv[], apr_pool_t *pool)
       }
 
     svn_cache_config_set(&settings);
+
+    /* Child processes inherit the shared cache created here.  Without it,
+       they still get per-process caches. */
+    if (shared_cache && handling_mode == connection_mode_fork)
+      {
+        err = svn_cache__create_shared_global_membuffer_cache();
+        logger__log_warning(params.logger, err, NULL, NULL);
+        svn_error_clear(err);
+      }
   }
 
+  /* Populate the caches before serving the first request.  Forked child
+   * processes will see the data even if the cache has not been shared. */
+  if (warm_up_rev_count > 0)
+    SVN_ERR(warm_up_caches(params.root, warm_up_rev_count, params.fs_config,
+                           params.logger, pool));
+
 #if APR_HAS_THREADS
   SVN_ERR(svn_root_pools__create(&connection_pools));
 
@@ -1323,6 +1612,23 @@ sub_main(int *exit_code, int argc, const char *argv[], apr_pool_t *pool)
 
       /* don't queue requests unless we reached the worker thread limit */
       apr_thread_pool_threshold_set(threads, 0);
+
+      if (use_event_loop)
+        {
+          apr_thread_t *tid;
+
+          status = apr_pollset_create(&idle_connections,
+                                      EVENT_LOOP_POLLSET_SIZE, pool,
+                                      APR_POLLSET_THREADSAFE);
+          if (status)
+            return svn_error_wrap_apr(status, _("Can't create event loop"));
+
+          status = apr_thread_create(&tid, NULL, event_loop_thread, &params,
+                                     pool);
+          if (status)
+            return svn_error_wrap_apr(status,
+                                      _("Can't create event loop thread"));
+        }
     }
   else
     {
@@ -1373,8 +1679,10 @@ sub_main(int *exit_code, int argc, const char *argv[], apr_pool_t *pool)
 #if APR_HAS_THREADS
           attach_connection(connection);
 
-          status = apr_thread_pool_push(threads, serve_thread, connection,
-                                        0, NULL);
+          status = apr_thread_pool_push(threads,
+                                        use_event_loop ? serve_event_thread
+                                                       : serve_thread,
+                                        connection, 0, NULL);
           if (status)
             {
               return svn_error_wrap_apr(status, _("Can't push task"));
@@ -3242,6 +3242,35 @@ def filtered_ls_top_level_path(sbox):
     exit_code, output, error = svntest.actions.run_and_verify_svn(
       [], [], 'ls', f_path, '--search=*/*', *extra_opts)
 
+def rm_many_urls_one_session(sbox):
+  "remove many URLs with pipelined requests"
+
+  sbox.build(create_wc=False)
+
+  # Deleting URLs checks all targets of a repository with one batch of
+  # pipelined requests.  Over ra_svn, the server receives them in one go
+  # and must answer all of them, even if it parks the connection in
+  # between (svnserve -T --event-loop).
+  files = [ 'iota', 'A/mu', 'A/B/lambda', 'A/B/E/alpha', 'A/B/E/beta',
+            'A/D/gamma', 'A/D/G/pi', 'A/D/G/rho', 'A/D/G/tau',
+            'A/D/H/chi', 'A/D/H/omega', 'A/D/H/psi' ]
+  urls = [ sbox.repo_url + '/' + f for f in files ]
+
+  svntest.actions.run_and_verify_svn(None, [], 'rm', '-m', 'log_msg', *urls)
+
+  # A missing target among many must still be reported.
+  expected_err = ".*URL '.*/A/mu' does not exist.*"
+  svntest.actions.run_and_verify_svn(None, expected_err,
+                                     'rm', '-m', 'log_msg',
+                                     sbox.repo_url + '/A/B',
+                                     sbox.repo_url + '/A/mu',
+                                     sbox.repo_url + '/A/D')
+
+  expected_output = svntest.verify.UnorderedOutput(['B/\n', 'C/\n',
+                                                    'D/\n'])
+  svntest.actions.run_and_verify_svn(expected_output, [],
+                                     'ls', sbox.repo_url + '/A')
+
 
 ########################################################################
 # Run the tests
@@ -3318,6 +3347,7 @@ test_list = [ None,
               null_update_last_changed_revision,
               null_prop_update_last_changed_revision,
               filtered_ls_top_level_path,
+              rm_many_urls_one_session,
              ]
 
 if __name__ == '__main__':
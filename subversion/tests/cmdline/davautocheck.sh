@@ -74,6 +74,9 @@
 #
 #  make davautocheck USE_SSL=1              # run over https
 #
+#  make davautocheck USE_HTTP2=1            # run over https with mod_http2;
+#                                           # needs a threaded MPM
+#
 #  make davautocheck USE_HTTPV1=1           # sets SVNAdvertiseV2Protocol off
 #
 #  make davautocheck APACHE_MPM=event       # specifies the 2.4 MPM
@@ -213,6 +216,11 @@ if [ ${USE_HTTPV1:+set} ]; then
  ADVERTISE_V2_PROTOCOL=off
 fi
 
+# Pick up $USE_HTTP2; http/2 is only negotiated during the TLS handshake
+if [ ${USE_HTTP2:+set} ]; then
+ USE_SSL=1
+fi
+
 # Pick up $SVN_PATH_AUTHZ
 SVN_PATH_AUTHZ_LINE=""
 if [ ${SVN_PATH_AUTHZ:+set} ]; then
@@ -330,6 +338,10 @@ if [ ${USE_SSL:+set} ]; then
     LOAD_MOD_SSL=$(get_loadmodule_config mod_ssl) \
       || fail "SSL module not found"
 fi
+if [ ${USE_HTTP2:+set} ]; then
+    LOAD_MOD_HTTP2=$(get_loadmodule_config mod_http2) \
+      || fail "HTTP2 module not found"
+fi
 
 # Stop any previous instances, os we can re-use the port.
 if [ -x $STOPSCRIPT ]; then $STOPSCRIPT ; sleep 1; fi
@@ -445,6 +457,7 @@ __EOF__
 cat > "$HTTPD_CFG" <<__EOF__
 $LOAD_MOD_MPM
 $LOAD_MOD_SSL
+$LOAD_MOD_HTTP2
 $LOAD_MOD_LOG_CONFIG
 $LOAD_MOD_MIME
 $LOAD_MOD_ALIAS
@@ -501,6 +514,12 @@ SSLCertificateKeyFile $SSL_CERTIFICATE_KEY_FILE
 __EOF__
 fi
 
+if [ ${USE_HTTP2:+set} ]; then
+cat >> "$HTTPD_CFG" <<__EOF__
+Protocols h2 http/1.1
+__EOF__
+fi
+
 cat >> "$HTTPD_CFG" <<__EOF__
 Listen              $HTTPD_PORT
 ServerName          localhost
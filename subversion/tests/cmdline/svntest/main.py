@@ -719,6 +719,12 @@ exclusive-locking = true
       http_proxy_password_str = "http-proxy-password=%s" % \
                                      (options.http_proxy_password)
 
+    # Offer http/2 whenever we talk to an https server; the server
+    # decides whether it is used.
+    http2_str = ""
+    if options.ssl_cert:
+      http2_str = "http-use-http2=yes"
+
     server_contents = """
 #
 [global]
@@ -726,10 +732,11 @@ exclusive-locking = true
 %s
 %s
 %s
+%s
 store-plaintext-passwords=yes
 store-passwords=yes
 """ % (http_library_str, http_proxy_str, http_proxy_username_str,
-       http_proxy_password_str)
+       http_proxy_password_str, http2_str)
 
   file_write(cfgfile_cfg, config_contents)
   file_write(cfgfile_srv, server_contents)
@@ -0,0 +1,367 @@
+/*
+ * compose-test.c:  Test and benchmark delta window composition
+ *
+ * ====================================================================
+ *    Licensed to the Apache Software Foundation (ASF) under one
+ *    or more contributor license agreements.  See the NOTICE file
+ *    distributed with this work for additional information
+ *    regarding copyright ownership.  The ASF licenses this file
+ *    to you under the Apache License, Version 2.0 (the
+ *    "License"); you may not use this file except in compliance
+ *    with the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing,
+ *    software distributed under the License is distributed on an
+ *    "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *    KIND, either express or implied.  See the License for the
+ *    specific language governing permissions and limitations
+ *    under the License.
+ * ====================================================================
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <apr_pools.h>
+#include <apr_time.h>
+
+#include "../svn_test.h"
+
+#include "svn_types.h"
+#include "svn_error.h"
+#include "svn_delta.h"
+#include "svn_io.h"
+#include "svn_pools.h"
+#include "svn_string.h"
+
+#include "private/svn_delta_private.h"
+
+/* Size of the initial text in the chains.  This needs to stay below
+   the delta window size, so every delta is a single window. */
+#define BASE_TEXT_SIZE (64 * 1024)
+
+/* Upper limit for the texts produced by mutate_text(). */
+#define MAX_TEXT_SIZE (96 * 1024)
+
+#ifndef MIN
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
+
+/* Return a text of LEN random lines of printable characters.
+   Allocate it in POOL. */
+static svn_stringbuf_t *
+random_text(apr_size_t len, apr_uint32_t *seed, apr_pool_t *pool)
+{
+  svn_stringbuf_t *text = svn_stringbuf_create_ensure(len, pool);
+  apr_size_t i;
+
+  for (i = 0; i < len; ++i)
+    {
+      apr_uint32_t r = svn_test_rand(seed) % 64;
+      text->data[i] = r < 4 ? '\n' : (char)('0' + r);
+    }
+
+  text->data[len] = '\0';
+  text->len = len;
+
+  return text;
+}
+
+/* Return a copy of TEXT with a few random insertions, deletions and
+   block moves applied to it, similar to a typical commit.  Allocate the
+   result in POOL. */
+static svn_stringbuf_t *
+mutate_text(const svn_stringbuf_t *text, apr_uint32_t *seed, apr_pool_t *pool)
+{
+  svn_stringbuf_t *result = svn_stringbuf_dup(text, pool);
+  int count = 1 + svn_test_rand(seed) % 8;
+  int i;
+
+  for (i = 0; i < count; ++i)
+    {
+      apr_size_t pos = svn_test_rand(seed) % result->len;
+      apr_size_t len = MIN(1 + svn_test_rand(seed) % 256, result->len - pos);
+
+      switch (svn_test_rand(seed) % 3)
+        {
+          case 0:
+            if (len < result->len)
+              svn_stringbuf_remove(result, pos, len);
+            break;
+
+          case 1:
+            {
+              svn_stringbuf_t *insertion = random_text(len, seed, pool);
+              svn_stringbuf_insert(result, pos, insertion->data,
+                                   insertion->len);
+            }
+            break;
+
+          default:
+            {
+              apr_size_t source = svn_test_rand(seed) % (result->len - len + 1);
+              svn_stringbuf_t *block
+                = svn_stringbuf_ncreate(result->data + source, len, pool);
+              svn_stringbuf_insert(result, pos, block->data, block->len);
+            }
+            break;
+        }
+    }
+
+  if (result->len > MAX_TEXT_SIZE)
+    svn_stringbuf_chop(result, result->len - MAX_TEXT_SIZE);
+
+  return result;
+}
+
+/* Set *WINDOW to the delta window transforming SOURCE into TARGET.
+   Allocate it in POOL. */
+static svn_error_t *
+make_window(svn_txdelta_window_t **window,
+            svn_stringbuf_t *source,
+            svn_stringbuf_t *target,
+            apr_pool_t *pool)
+{
+  svn_txdelta_stream_t *stream;
+
+  svn_txdelta2(&stream,
+               svn_stream_from_stringbuf(source, pool),
+               svn_stream_from_stringbuf(target, pool),
+               FALSE, pool);
+  SVN_ERR(svn_txdelta_next_window(window, stream, pool));
+  SVN_TEST_ASSERT(*window != NULL);
+
+  return SVN_NO_ERROR;
+}
+
+/* Create a history of CHAIN_LENGTH + 1 versions of a random text.
+   Return the oldest version in *BASE, the newest in *HEAD and the
+   CHAIN_LENGTH windows between them, oldest first, in *WINDOWS.
+   Allocate all of them in POOL. */
+static svn_error_t *
+make_chain(svn_stringbuf_t **base,
+           svn_stringbuf_t **head,
+           apr_array_header_t **windows,
+           int chain_length,
+           apr_uint32_t *seed,
+           apr_pool_t *pool)
+{
+  svn_stringbuf_t *text;
+  int i;
+
+  *base = random_text(BASE_TEXT_SIZE, seed, pool);
+  *windows = apr_array_make(pool, chain_length,
+                            sizeof(const svn_txdelta_window_t *));
+
+  text = *base;
+  for (i = 0; i < chain_length; ++i)
+    {
+      svn_stringbuf_t *next = mutate_text(text, seed, pool);
+      svn_txdelta_window_t *window;
+
+      SVN_ERR(make_window(&window, text, next, pool));
+      APR_ARRAY_PUSH(*windows, const svn_txdelta_window_t *) = window;
+
+      text = next;
+    }
+
+  *head = text;
+
+  return SVN_NO_ERROR;
+}
+
+/* Compose WINDOWS by calling svn_txdelta_compose_windows() for each
+   element, the way callers did before there was a chain API.  Return
+   the result allocated in RESULT_POOL. */
+static svn_txdelta_window_t *
+compose_pairwise(const apr_array_header_t *windows,
+                 apr_pool_t *result_pool)
+{
+  svn_txdelta_window_t *composite
+    = svn_txdelta_window_dup(APR_ARRAY_IDX(windows, 0,
+                                           const svn_txdelta_window_t *),
+                             result_pool);
+  int i;
+
+  for (i = 1; i < windows->nelts; ++i)
+    composite = svn_txdelta_compose_windows(
+                  composite,
+                  APR_ARRAY_IDX(windows, i, const svn_txdelta_window_t *),
+                  result_pool);
+
+  return composite;
+}
+
+/* Verify that applying COMPOSITE to BASE results in HEAD. */
+static svn_error_t *
+verify_composite(svn_txdelta_window_t *composite,
+                 const svn_stringbuf_t *base,
+                 const svn_stringbuf_t *head,
+                 apr_pool_t *pool)
+{
+  apr_size_t len = composite->tview_len;
+  char *result = apr_palloc(pool, len);
+
+  SVN_TEST_ASSERT(composite->sview_offset == 0);
+  SVN_TEST_ASSERT(composite->sview_len == base->len);
+
+  svn_txdelta_apply_instructions(composite, base->data, result, &len);
+  SVN_TEST_ASSERT(len == head->len);
+  SVN_TEST_ASSERT(memcmp(result, head->data, len) == 0);
+
+  return SVN_NO_ERROR;
+}
+
+static svn_error_t *
+compose_chain_test(apr_pool_t *pool)
+{
+  apr_uint32_t seed = 0x12345678;
+  apr_pool_t *iterpool = svn_pool_create(pool);
+  int chain_length;
+
+  for (chain_length = 1; chain_length <= 32; ++chain_length)
+    {
+      svn_stringbuf_t *base, *head;
+      apr_array_header_t *windows;
+      svn_txdelta_window_t *composite;
+
+      svn_pool_clear(iterpool);
+
+      SVN_ERR(make_chain(&base, &head, &windows, chain_length, &seed,
+                         iterpool));
+
+      composite = svn_txdelta__compose_window_chain(windows, iterpool,
+                                                    iterpool);
+      SVN_ERR(verify_composite(composite, base, head, iterpool));
+
+      composite = compose_pairwise(windows, iterpool);
+      SVN_ERR(verify_composite(composite, base, head, iterpool));
+    }
+
+  svn_pool_destroy(iterpool);
+
+  return SVN_NO_ERROR;
+}
+
+static svn_error_t *
+compose_chain_self_contained_test(apr_pool_t *pool)
+{
+  apr_uint32_t seed = 0x87654321;
+  svn_stringbuf_t *base, *head;
+  apr_array_header_t *windows;
+  svn_txdelta_window_t *composite;
+  svn_txdelta_window_t *window;
+  svn_stringbuf_t *empty = svn_stringbuf_create_empty(pool);
+
+  /* Put a window without source copies into the middle of the chain.
+     The composite must not depend on anything before that window. */
+  SVN_ERR(make_chain(&base, &head, &windows, 8, &seed, pool));
+  SVN_ERR(make_window(&window, empty, head, pool));
+  SVN_TEST_ASSERT(window->src_ops == 0);
+  APR_ARRAY_IDX(windows, 4, const svn_txdelta_window_t *) = window;
+
+  /* Windows 5 to 7 now apply to HEAD and produce some other text. */
+  {
+    svn_stringbuf_t *text = head;
+    int i;
+
+    for (i = 5; i < windows->nelts; ++i)
+      {
+        svn_stringbuf_t *next = mutate_text(text, &seed, pool);
+        SVN_ERR(make_window(&window, text, next, pool));
+        APR_ARRAY_IDX(windows, i, const svn_txdelta_window_t *) = window;
+        text = next;
+      }
+
+    head = text;
+  }
+
+  /* Give the skipped windows a source view that differs from the
+     self-contained one. */
+  window = svn_txdelta_window_dup(APR_ARRAY_IDX(windows, 0,
+                                                const svn_txdelta_window_t *),
+                                  pool);
+  window->sview_offset = 1234;
+  APR_ARRAY_IDX(windows, 0, const svn_txdelta_window_t *) = window;
+
+  composite = svn_txdelta__compose_window_chain(windows, pool, pool);
+  SVN_TEST_ASSERT(composite->src_ops == 0);
+  SVN_TEST_ASSERT(composite->sview_offset == 0);
+  SVN_TEST_ASSERT(composite->sview_len == 0);
+  SVN_ERR(verify_composite(composite, empty, head, pool));
+
+  return SVN_NO_ERROR;
+}
+
+/* Microbenchmark comparing svn_txdelta__compose_window_chain() against
+   repeated svn_txdelta_compose_windows() calls on a long chain.  Run the
+   test with --verbose to see the timings. */
+static svn_error_t *
+compose_chain_bench(const svn_test_opts_t *opts,
+                    apr_pool_t *pool)
+{
+  enum { CHAIN_LENGTH = 128, REPETITIONS = 16 };
+
+  apr_uint32_t seed = 0x5eed;
+  apr_pool_t *iterpool = svn_pool_create(pool);
+  svn_stringbuf_t *base, *head;
+  apr_array_header_t *windows;
+  svn_txdelta_window_t *composite = NULL;
+  apr_time_t start, pairwise_time, chain_time;
+  int i;
+
+  SVN_ERR(make_chain(&base, &head, &windows, CHAIN_LENGTH, &seed, pool));
+
+  start = apr_time_now();
+  for (i = 0; i < REPETITIONS; ++i)
+    {
+      svn_pool_clear(iterpool);
+      composite = compose_pairwise(windows, iterpool);
+    }
+  pairwise_time = apr_time_now() - start;
+  SVN_ERR(verify_composite(composite, base, head, pool));
+
+  start = apr_time_now();
+  for (i = 0; i < REPETITIONS; ++i)
+    {
+      svn_pool_clear(iterpool);
+      composite = svn_txdelta__compose_window_chain(windows, iterpool,
+                                                    iterpool);
+    }
+  chain_time = apr_time_now() - start;
+  SVN_ERR(verify_composite(composite, base, head, pool));
+
+  if (opts->verbose)
+    {
+      printf("Composing %d chains of %d windows:\n",
+             REPETITIONS, CHAIN_LENGTH);
+      printf("  pairwise: %8" APR_TIME_T_FMT " usec\n", pairwise_time);
+      printf("  chain:    %8" APR_TIME_T_FMT " usec\n", chain_time);
+    }
+
+  svn_pool_destroy(iterpool);
+
+  return SVN_NO_ERROR;
+}
+
+
+
+/* The test table.  */
+
+static int max_threads = -1;
+
+static struct svn_test_descriptor_t test_funcs[] =
+  {
+    SVN_TEST_NULL,
+    SVN_TEST_PASS2(compose_chain_test,
+                   "compose delta window chains"),
+    SVN_TEST_PASS2(compose_chain_self_contained_test,
+                   "compose chain with a self-contained window"),
+    SVN_TEST_OPTS_PASS(compose_chain_bench,
+                       "benchmark composing a long window chain"),
+    SVN_TEST_NULL
+  };
+
+SVN_TEST_MAIN
@@ -36,6 +36,9 @@
 #include "svn_delta.h"
 #include "svn_pools.h"
 #include "svn_error.h"
+#include "private/svn_delta_private.h"
+#include "private/svn_string_private.h"
+#include "private/svn_subr_private.h"
 
 #include "../../libsvn_delta/delta.h"
 #include "delta-window-test.h"
@@ -280,9 +283,11 @@ copy_tempfile(apr_file_t *fp, apr_pool_t *pool)
 
 
 
-/* (Note: *LAST_SEED is an output parameter.) */
+/* Encode svndiff using up to JOBS worker threads.
+   (Note: *LAST_SEED is an output parameter.) */
 static svn_error_t *
 do_random_test(apr_pool_t *pool,
+               int jobs,
                apr_uint32_t *last_seed)
 {
   apr_uint32_t seed, maxlen;
@@ -330,8 +335,9 @@ do_random_test(apr_pool_t *pool,
 
       /* Make stage 2: encode the text delta in svndiff format using
                        varying svndiff versions and compression levels. */
-      svn_txdelta_to_svndiff3(&handler, &handler_baton, stream, i % 3,
-                              i % 10, delta_pool);
+      svn_txdelta__to_svndiff_parallel(&handler, &handler_baton, stream,
+                                       i % (svn__zstd_available() ? 4 : 3),
+                                       i % 10, jobs, delta_pool);
 
       /* Make stage 1: create the text delta.  */
       svn_txdelta2(&txdelta_stream,
@@ -363,7 +369,18 @@ static svn_error_t *
 random_test(apr_pool_t *pool)
 {
   apr_uint32_t seed;
-  svn_error_t *err = do_random_test(pool, &seed);
+  svn_error_t *err = do_random_test(pool, 1, &seed);
+  if (err)
+    fprintf(stderr, "SEED: %lu\n", (unsigned long)seed);
+  return err;
+}
+
+/* Implements svn_test_driver_t. */
+static svn_error_t *
+random_parallel_svndiff_test(apr_pool_t *pool)
+{
+  apr_uint32_t seed;
+  svn_error_t *err = do_random_test(pool, 4, &seed);
   if (err)
     fprintf(stderr, "SEED: %lu\n", (unsigned long)seed);
   return err;
@@ -426,7 +443,8 @@ do_random_combine_test(apr_pool_t *pool,
 
       /* Make stage 2: encode the text delta in svndiff format using
                        varying svndiff versions and compression levels. */
-      svn_txdelta_to_svndiff3(&handler, &handler_baton, stream, i % 3,
+      svn_txdelta_to_svndiff3(&handler, &handler_baton, stream,
+                              i % (svn__zstd_available() ? 4 : 3),
                               i % 10, delta_pool);
 
       /* Make stage 1: create the text deltas.  */
@@ -605,6 +623,140 @@ random_txdelta_to_svndiff_stream_test(apr_pool_t *pool)
   return err;
 }
 
+/* Size of the buffers used by the checksum and match length tests. */
+#define MATCH_BUFFER_SIZE 512
+
+/* Fill the MATCH_BUFFER_SIZE bytes at BUFFER with pseudo-random data from
+   SEED.  Depending on ITERATION, use the full byte range, only a few
+   distinct values or only 0xff, the latter being the worst case for
+   intermediate sums. */
+static void
+fill_match_buffer(char *buffer, int iteration, apr_uint32_t *seed)
+{
+  int i;
+
+  for (i = 0; i < MATCH_BUFFER_SIZE; i++)
+    switch (iteration % 3)
+      {
+        case 0:  buffer[i] = (char)svn_test_rand(seed); break;
+        case 1:  buffer[i] = (char)(0x7e + svn_test_rand(seed) % 4); break;
+        default: buffer[i] = (char)0xff; break;
+      }
+}
+
+/* Return the number of equal bytes at the start of A and B, looking at
+   no more than MAX_LEN bytes.  Reference for svn_cstring__match_length. */
+static apr_size_t
+reference_match_length(const char *a, const char *b, apr_size_t max_len)
+{
+  apr_size_t pos = 0;
+
+  while (pos < max_len && a[pos] == b[pos])
+    ++pos;
+
+  return pos;
+}
+
+/* Return the number of equal bytes just before A and B, looking at no
+   more than MAX_LEN bytes.  Reference for
+   svn_cstring__reverse_match_length. */
+static apr_size_t
+reference_reverse_match_length(const char *a,
+                               const char *b,
+                               apr_size_t max_len)
+{
+  apr_size_t pos = 0;
+
+  while (pos < max_len && *(a - pos - 1) == *(b - pos - 1))
+    ++pos;
+
+  return pos;
+}
+
+/* Compare the (possibly vectorized) checksum and match length functions
+   used by the xdelta algorithm against their portable counterparts.
+   (Note: *LAST_SEED is an output parameter.) */
+static svn_error_t *
+do_random_match_test(apr_pool_t *pool,
+                     apr_uint32_t *last_seed)
+{
+  apr_uint32_t seed;
+  apr_uint32_t maxlen;
+  apr_size_t bytes_range;
+  apr_size_t blocksize = svn_txdelta__match_blocksize();
+  int i;
+  int iterations;
+  int dump_files;
+  int print_windows;
+  const char *random_bytes;
+  char *a = apr_palloc(pool, MATCH_BUFFER_SIZE);
+  char *b = apr_palloc(pool, MATCH_BUFFER_SIZE);
+
+  init_params(&seed, &maxlen, &iterations, &dump_files, &print_windows,
+              &random_bytes, &bytes_range, pool);
+
+  SVN_TEST_ASSERT(blocksize <= MATCH_BUFFER_SIZE / 2);
+
+  for (i = 0; i < iterations; i++)
+    {
+      apr_size_t start, len, mismatch;
+
+      *last_seed = seed;
+      fill_match_buffer(a, i, &seed);
+
+      /* Checksums for blocks at every offset, i.e. any alignment and
+         ending right at the end of the buffer. */
+      for (start = 0; start + blocksize <= MATCH_BUFFER_SIZE; start++)
+        SVN_TEST_INT_ASSERT(svn_txdelta__adler32_block(a + start, FALSE),
+                            svn_txdelta__adler32_block(a + start, TRUE));
+
+      /* Let B differ from A at a single random position.  The 0xff-only
+         iterations keep B identical to A. */
+      memcpy(b, a, MATCH_BUFFER_SIZE);
+      mismatch = svn_test_rand(&seed) % MATCH_BUFFER_SIZE;
+      if (i % 3 != 2)
+        b[mismatch] = (char)~b[mismatch];
+
+      /* Any combination of misaligned starts with lengths covering all
+         tail sizes of the vectorized loops. */
+      for (start = 0; start < 16; start++)
+        for (len = 0; start + len <= MATCH_BUFFER_SIZE; len += 1 + len / 32)
+          {
+            apr_size_t b_start = (start * 7 + len) % 16;
+
+            if (b_start + len > MATCH_BUFFER_SIZE)
+              continue;
+
+            SVN_TEST_INT_ASSERT(svn_cstring__match_length(a + start,
+                                                          b + b_start, len),
+                                reference_match_length(a + start,
+                                                       b + b_start, len));
+            SVN_TEST_INT_ASSERT(svn_cstring__match_length(a + start,
+                                                          b + start, len),
+                                reference_match_length(a + start,
+                                                       b + start, len));
+            SVN_TEST_INT_ASSERT(
+              svn_cstring__reverse_match_length(a + start + len,
+                                                b + start + len, len),
+              reference_reverse_match_length(a + start + len,
+                                             b + start + len, len));
+          }
+    }
+
+  return SVN_NO_ERROR;
+}
+
+/* Implements svn_test_driver_t. */
+static svn_error_t *
+random_match_test(apr_pool_t *pool)
+{
+  apr_uint32_t seed;
+  svn_error_t *err = do_random_match_test(pool, &seed);
+  if (err)
+    fprintf(stderr, "SEED: %lu\n", (unsigned long)seed);
+  return err;
+}
+
 /* Change to 1 to enable the unit test for the delta combiner's range index: */
 #if 0
 #include "range-index-test.h"
@@ -625,6 +777,10 @@ static struct svn_test_descriptor_t test_funcs[] =
                    "random combine delta test"),
     SVN_TEST_PASS2(random_txdelta_to_svndiff_stream_test,
                    "random txdelta to svndiff stream test"),
+    SVN_TEST_PASS2(random_parallel_svndiff_test,
+                   "random parallel svndiff test"),
+    SVN_TEST_PASS2(random_match_test,
+                   "random xdelta checksum and match length test"),
 #ifdef SVN_RANGE_INDEX_TEST_H
     SVN_TEST_PASS2(random_range_index_test,
                    "random range index test"),
@@ -26,47 +26,42 @@
 
 #include "../../libsvn_delta/compose_delta.c"
 
-static range_index_node_t *prev_node, *prev_prev_node;
 static apr_size_t
-walk_range_index(range_index_node_t *node, const char **msg)
+walk_range_index(range_index_t *ndx, const char **msg)
 {
-  apr_off_t ret;
+  int i;
 
-  if (node == NULL)
-    return 0;
-
-  ret = walk_range_index(node->left, msg);
-  if (ret > 0)
-    return ret;
-
-  if (prev_node != NULL
-      && node->target_offset > 0
-      && (prev_node->offset >= node->offset
-          || (prev_node->limit >= node->limit)))
-    {
-      ret = node->target_offset;
-      node->target_offset = -node->target_offset;
-      *msg = "Oops, the previous node ate me.";
-      return ret;
-    }
-  if (prev_prev_node != NULL
-      && prev_node->target_offset > 0
-      && prev_prev_node->limit > node->offset)
+  for (i = 1; i < ndx->ranges->nelts; ++i)
     {
-      ret = prev_node->target_offset;
-      prev_node->target_offset = -prev_node->target_offset;
-      *msg = "Arrgh, my neighbours are conspiring against me.";
-      return ret;
+      range_index_entry_t *const prev_node = &RANGE(ndx, i - 1);
+      range_index_entry_t *const node = &RANGE(ndx, i);
+
+      if (node->target_offset > 0
+          && (prev_node->offset >= node->offset
+              || (prev_node->limit >= node->limit)))
+        {
+          apr_size_t ret = node->target_offset;
+          node->target_offset = -node->target_offset;
+          *msg = "Oops, the previous node ate me.";
+          return ret;
+        }
+      if (i > 1
+          && prev_node->target_offset > 0
+          && RANGE(ndx, i - 2).limit > node->offset)
+        {
+          apr_size_t ret = prev_node->target_offset;
+          prev_node->target_offset = -prev_node->target_offset;
+          *msg = "Arrgh, my neighbours are conspiring against me.";
+          return ret;
+        }
     }
-  prev_prev_node = prev_node;
-  prev_node = node;
 
-  return walk_range_index(node->right, msg);
+  return 0;
 }
 
 
 static void
-print_node_data(range_index_node_t *node, const char *msg, apr_off_t ndx)
+print_node_data(range_index_entry_t *node, const char *msg, apr_off_t ndx)
 {
   if (-node->target_offset == ndx)
     {
@@ -86,40 +81,12 @@ print_node_data(range_index_node_t *node, const char *msg, apr_off_t ndx)
 }
 
 static void
-print_range_index_r(range_index_node_t *node, const char *msg, apr_off_t ndx)
+print_range_index(range_index_t *ndx, const char *msg, apr_off_t ret)
 {
-  if (node == NULL)
-    return;
-
-  print_range_index_r(node->left, msg, ndx);
-  print_node_data(node, msg, ndx);
-  print_range_index_r(node->right, msg, ndx);
-}
+  int i;
 
-static void
-print_range_index_i(range_index_node_t *node, const char *msg, apr_off_t ndx)
-{
-  if (node == NULL)
-    return;
-
-  while (node->prev)
-    node = node->prev;
-
-  do
-    {
-      print_node_data(node, msg, ndx);
-      node = node->next;
-    }
-  while (node);
-}
-
-static void
-print_range_index(range_index_node_t *node, const char *msg, apr_off_t ndx)
-{
-  printf("  (recursive)\n");
-  print_range_index_r(node, msg, ndx);
-  printf("  (iterative)\n");
-  print_range_index_i(node, msg, ndx);
+  for (i = 0; i < ndx->ranges->nelts; ++i)
+    print_node_data(&RANGE(ndx, i), msg, ret);
 }
 
 
@@ -139,7 +106,8 @@ random_range_index_test(apr_pool_t *pool)
   apr_size_t bytes_range;
   int i, iterations, dump_files, print_windows;
   const char *random_bytes;
-  range_index_t *ndx;
+  range_index_t ndx;
+  apr_array_header_t *list;
   int tgt_cp = 0, src_cp = 0;
 
   /* Initialize parameters and print out the seed in case we dump core
@@ -150,43 +118,46 @@ random_range_index_test(apr_pool_t *pool)
   /* ### This test is expected to fail randomly at the moment, so don't
      enable it by default. --xbc */
 
-  ndx = create_range_index(pool);
+  init_range_index(&ndx, pool);
+  list = apr_array_make(pool, 16, sizeof(range_list_entry_t));
   for (i = 1; i <= iterations; ++i)
     {
       apr_size_t offset = svn_test_rand(&seed) % 47;
       apr_size_t limit = offset + svn_test_rand(&seed) % 16 + 1;
-      range_list_node_t *list, *r;
       apr_size_t ret;
       const char *msg2;
+      int k;
 
       printf("%3d: Inserting [%3"APR_SIZE_T_FMT",%3"APR_SIZE_T_FMT") ...",
              i, offset, limit);
-      splay_range_index(offset, ndx);
-      list = build_range_list(offset, limit, ndx);
-      insert_range(offset, limit, i, ndx);
-      prev_prev_node = prev_node = NULL;
-      ret = walk_range_index(ndx->tree, &msg2);
+      seek_range_index(offset, &ndx);
+      build_range_list(list, offset, limit, &ndx);
+      insert_range(offset, limit, i, &ndx);
+      ret = walk_range_index(&ndx, &msg2);
       if (ret == 0)
         {
-          for (r = list; r; r = r->next)
-            printf(" %s[%3"APR_SIZE_T_FMT",%3"APR_SIZE_T_FMT")",
-                   (r->kind == range_from_source ?
-                    (++src_cp, "S") : (++tgt_cp, "T")),
-                   r->offset, r->limit);
-          free_range_list(list, ndx);
+          for (k = 0; k < list->nelts; ++k)
+            {
+              const range_list_entry_t *r
+                = &APR_ARRAY_IDX(list, k, range_list_entry_t);
+              printf(" %s[%3"APR_SIZE_T_FMT",%3"APR_SIZE_T_FMT")",
+                     (r->kind == range_from_source ?
+                      (++src_cp, "S") : (++tgt_cp, "T")),
+                     r->offset, r->limit);
+            }
           printf(" OK\n");
         }
       else
         {
           printf(" Ooops!\n");
-          print_range_index(ndx->tree, msg2, ret);
+          print_range_index(&ndx, msg2, ret);
           check_copy_count(src_cp, tgt_cp);
           return svn_error_create(SVN_ERR_TEST_FAILED, NULL, "insert_range");
         }
     }
 
   printf("Final tree state:\n");
-  print_range_index(ndx->tree, "", iterations + 1);
+  print_range_index(&ndx, "", iterations + 1);
   check_copy_count(src_cp, tgt_cp);
   return SVN_NO_ERROR;
 }
@@ -28,7 +28,9 @@
 #include "svn_types.h"
 #include "svn_error.h"
 #include "svn_delta.h"
+#include "svn_pools.h"
 
+#include "private/svn_delta_private.h"
 #include "private/svn_subr_private.h"
 
 static svn_error_t *
@@ -97,6 +99,98 @@ stream_window_test(apr_pool_t *pool)
 }
 
 
+/* Run svn_txdelta__cdc() on SOURCE and TARGET, apply the resulting delta
+   to SOURCE and verify that it produces TARGET.  Return the total amount
+   of new data in the delta in *NEW_DATA_LEN. */
+static svn_error_t *
+run_and_apply_delta(apr_size_t *new_data_len,
+                    const svn_string_t *source,
+                    const svn_string_t *target,
+                    apr_pool_t *pool)
+{
+  svn_txdelta_stream_t *txstream;
+  svn_txdelta_window_handler_t handler;
+  void *handler_baton;
+  svn_stringbuf_t *result = svn_stringbuf_create_empty(pool);
+  apr_pool_t *iterpool = svn_pool_create(pool);
+
+  svn_txdelta__cdc(&txstream, svn_stream_from_string(source, pool),
+                   svn_stream_from_string(target, pool), TRUE, pool);
+  svn_txdelta_apply(svn_stream_from_string(source, pool),
+                    svn_stream_from_stringbuf(result, pool),
+                    NULL, NULL, pool, &handler, &handler_baton);
+
+  *new_data_len = 0;
+  while (1)
+    {
+      svn_txdelta_window_t *window;
+
+      svn_pool_clear(iterpool);
+      SVN_ERR(svn_txdelta_next_window(&window, txstream, iterpool));
+      SVN_ERR(handler(window, handler_baton));
+      if (window == NULL)
+        break;
+
+      if (window->new_data)
+        *new_data_len += window->new_data->len;
+    }
+  svn_pool_destroy(iterpool);
+
+  SVN_TEST_ASSERT(result->len == target->len);
+  SVN_TEST_ASSERT(memcmp(result->data, target->data, target->len) == 0);
+
+  return SVN_NO_ERROR;
+}
+
+static svn_error_t *
+cdc_window_test(apr_pool_t *pool)
+{
+  const apr_size_t size = 1024 * 1024;
+  svn_stringbuf_t *source = svn_stringbuf_create_ensure(size, pool);
+  svn_stringbuf_t *inserted;
+  svn_string_t source_str;
+  svn_string_t target_str;
+  apr_uint32_t seed = 0x12345678;
+  apr_size_t new_data_len;
+  apr_size_t i;
+
+  /* Incompressible data, so that matches can only come from the source. */
+  for (i = 0; i < size; i++)
+    {
+      seed = seed * 1103515245 + 12345;
+      svn_stringbuf_appendbyte(source, (char)(seed >> 24));
+    }
+  source_str.data = source->data;
+  source_str.len = source->len;
+
+  /* Insert some data near the start, shifting everything behind it. */
+  inserted = svn_stringbuf_create_ensure(size + 1000, pool);
+  svn_stringbuf_appendbytes(inserted, source->data, 100);
+  for (i = 0; i < 1000; i++)
+    svn_stringbuf_appendbyte(inserted, (char)i);
+  svn_stringbuf_appendbytes(inserted, source->data + 100, size - 100);
+  target_str.data = inserted->data;
+  target_str.len = inserted->len;
+
+  SVN_ERR(run_and_apply_delta(&new_data_len, &source_str, &target_str,
+                              pool));
+  SVN_TEST_ASSERT(new_data_len < target_str.len / 2);
+
+  /* Remove data from the start, shifting everything the other way. */
+  target_str.data = source->data + 777;
+  target_str.len = source->len - 777;
+
+  SVN_ERR(run_and_apply_delta(&new_data_len, &source_str, &target_str,
+                              pool));
+  SVN_TEST_ASSERT(new_data_len < target_str.len / 2);
+
+  /* Identical texts still work. */
+  SVN_ERR(run_and_apply_delta(&new_data_len, &source_str, &source_str,
+                              pool));
+
+  return SVN_NO_ERROR;
+}
+
 
 /* The test table.  */
 
@@ -107,6 +201,8 @@ static struct svn_test_descriptor_t test_funcs[] =
     SVN_TEST_NULL,
     SVN_TEST_PASS2(stream_window_test,
                    "txdelta stream and windows test"),
+    SVN_TEST_PASS2(cdc_window_test,
+                   "content-defined chunking delta test"),
     SVN_TEST_NULL
   };
 
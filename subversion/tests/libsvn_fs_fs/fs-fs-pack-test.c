@@ -23,6 +23,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <apr_pools.h>
+#include <apr_thread_proc.h>
 
 #include "../svn_test.h"
 #include "../../libsvn_fs/fs-loader.h"
@@ -191,7 +192,7 @@ create_packed_filesystem(const char *dir,
   /* Now pack the FS */
   pnb.expected_shard = 0;
   pnb.expected_action = svn_fs_pack_notify_start;
-  return svn_fs_pack(dir, pack_notify, &pnb, NULL, NULL, pool);
+  return svn_fs_pack2(dir, 1, pack_notify, &pnb, NULL, NULL, pool);
 }
 
 /* Create a packed FSFS filesystem for revprop tests at REPO_NAME with
@@ -226,7 +227,7 @@ prepare_revprop_repo(svn_fs_t **fs,
   svn_pool_destroy(subpool);
 
   /* Pack the repository. */
-  SVN_ERR(svn_fs_pack(repo_name, NULL, NULL, NULL, NULL, pool));
+  SVN_ERR(svn_fs_pack2(repo_name, 1, NULL, NULL, NULL, NULL, pool));
 
   return SVN_NO_ERROR;
 }
@@ -663,7 +664,7 @@ recover_fully_packed(const svn_test_opts_t *opts,
   SVN_ERR(svn_fs_commit_txn(&conflict, &after_rev, txn, subpool));
   SVN_TEST_ASSERT(SVN_IS_VALID_REVNUM(after_rev));
   svn_pool_destroy(subpool);
-  SVN_ERR(svn_fs_pack(REPO_NAME, NULL, NULL, NULL, NULL, pool));
+  SVN_ERR(svn_fs_pack2(REPO_NAME, 1, NULL, NULL, NULL, NULL, pool));
   SVN_ERR(svn_fs_recover(REPO_NAME, NULL, NULL, pool));
 
   /* Now, delete the youngest revprop file, and recover again.  This
@@ -1002,7 +1003,7 @@ upgrade_txns_to_log_addressing(const svn_test_opts_t *opts,
   /* Pack repo to verify that old and new shard get packed according to
      their respective addressing mode */
 
-  SVN_ERR(svn_fs_pack(repo_name, NULL, NULL, NULL, NULL, pool));
+  SVN_ERR(svn_fs_pack2(repo_name, 1, NULL, NULL, NULL, NULL, pool));
 
   /* verify that our changes got in */
 
@@ -1796,7 +1797,7 @@ pack_with_limited_memory(const svn_test_opts_t *opts,
 
       /* Pack it with a narrow memory budget. */
       SVN_ERR(svn_fs_open2(&fs, dir, NULL, iterpool, iterpool));
-      SVN_ERR(svn_fs_fs__pack(fs, max_mem, NULL, NULL, NULL, NULL,
+      SVN_ERR(svn_fs_fs__pack(fs, max_mem, 1, NULL, NULL, NULL, NULL,
                               iterpool));
 
       /* To be sure: Verify that we didn't break the repo. */
@@ -1812,6 +1813,112 @@ pack_with_limited_memory(const svn_test_opts_t *opts,
 #undef MAX_REV
 #undef SHARD_SIZE
 
+/* ------------------------------------------------------------------------ */
+/* Pack many shards concurrently and check that notifications still arrive
+   in shard order and that the result is a valid, fully packed repo. */
+#define REPO_NAME "test-repo-pack-concurrently"
+#define SHARD_SIZE 3
+#define MAX_REV 38
+static svn_error_t *
+pack_concurrently(const svn_test_opts_t *opts,
+                  apr_pool_t *pool)
+{
+  struct pack_notify_baton pnb;
+  svn_fs_t *fs;
+  svn_revnum_t min_unpacked;
+
+  /* Bail (with success) on known-untestable scenarios */
+  if (strcmp(opts->fs_type, "fsfs") != 0)
+    return svn_error_create(SVN_ERR_TEST_SKIPPED, NULL, NULL);
+
+  SVN_ERR(create_non_packed_filesystem(REPO_NAME, opts, MAX_REV, SHARD_SIZE,
+                                       pool));
+
+  pnb.expected_shard = 0;
+  pnb.expected_action = svn_fs_pack_notify_start;
+  SVN_ERR(svn_fs_pack2(REPO_NAME, 4, pack_notify, &pnb, NULL, NULL, pool));
+
+  /* All shards must have been switched to their packed form. */
+  SVN_TEST_ASSERT(pnb.expected_shard == (MAX_REV + 1) / SHARD_SIZE);
+  SVN_TEST_ASSERT(pnb.expected_action == svn_fs_pack_notify_start);
+
+  SVN_ERR(svn_fs_open2(&fs, REPO_NAME, NULL, pool, pool));
+  SVN_ERR(svn_fs_fs__min_unpacked_rev(&min_unpacked, fs, pool));
+  SVN_TEST_ASSERT(min_unpacked == (MAX_REV + 1) / SHARD_SIZE * SHARD_SIZE);
+
+  /* To be sure: Verify that we didn't break the repo. */
+  SVN_ERR(svn_fs_verify(REPO_NAME, NULL, 0, MAX_REV, NULL, NULL, NULL, NULL,
+                        pool));
+
+  return SVN_NO_ERROR;
+}
+#undef REPO_NAME
+#undef MAX_REV
+#undef SHARD_SIZE
+
+/* ------------------------------------------------------------------------ */
+/* Hotcopy a partly packed repository concurrently and check that the
+   notifications arrive in revision order and that the copy is valid. */
+#define REPO_NAME "test-repo-hotcopy-concurrently"
+#define SHARD_SIZE 3
+#define MAX_REV 40
+
+/* Implements svn_fs_hotcopy_notify_t.  BATON is the svn_revnum_t that
+   we expect as START_REVISION. */
+static void
+hotcopy_notify(void *baton,
+               svn_revnum_t start_revision,
+               svn_revnum_t end_revision,
+               apr_pool_t *scratch_pool)
+{
+  svn_revnum_t *expected_rev = baton;
+
+  SVN_ERR_ASSERT_NO_RETURN(start_revision == *expected_rev);
+  SVN_ERR_ASSERT_NO_RETURN(start_revision <= end_revision);
+  *expected_rev = end_revision + 1;
+}
+
+static svn_error_t *
+hotcopy_concurrently(const svn_test_opts_t *opts,
+                     apr_pool_t *pool)
+{
+  const char *dst_path = REPO_NAME "-copy";
+  svn_revnum_t expected_rev = 0;
+  svn_revnum_t youngest;
+  svn_revnum_t min_unpacked;
+  svn_fs_t *fs;
+
+  /* Bail (with success) on known-untestable scenarios */
+  if (strcmp(opts->fs_type, "fsfs") != 0)
+    return svn_error_create(SVN_ERR_TEST_SKIPPED, NULL, NULL);
+
+  /* Create a repo with packed shards and some non-packed revisions. */
+  SVN_ERR(create_non_packed_filesystem(REPO_NAME, opts, MAX_REV, SHARD_SIZE,
+                                       pool));
+  SVN_ERR(svn_fs_pack2(REPO_NAME, 1, NULL, NULL, NULL, NULL, pool));
+
+  SVN_ERR(svn_io_remove_dir2(dst_path, TRUE, NULL, NULL, pool));
+  svn_test_add_dir_cleanup(dst_path);
+
+  SVN_ERR(svn_fs_hotcopy4(REPO_NAME, dst_path, FALSE, FALSE, 4,
+                          hotcopy_notify, &expected_rev, NULL, NULL, pool));
+  SVN_TEST_ASSERT(expected_rev == MAX_REV + 1);
+
+  SVN_ERR(svn_fs_open2(&fs, dst_path, NULL, pool, pool));
+  SVN_ERR(svn_fs_youngest_rev(&youngest, fs, pool));
+  SVN_TEST_ASSERT(youngest == MAX_REV);
+  SVN_ERR(svn_fs_fs__min_unpacked_rev(&min_unpacked, fs, pool));
+  SVN_TEST_ASSERT(min_unpacked == (MAX_REV + 1) / SHARD_SIZE * SHARD_SIZE);
+
+  SVN_ERR(svn_fs_verify(dst_path, NULL, 0, MAX_REV, NULL, NULL, NULL, NULL,
+                        pool));
+
+  return SVN_NO_ERROR;
+}
+#undef REPO_NAME
+#undef MAX_REV
+#undef SHARD_SIZE
+
 /* ------------------------------------------------------------------------ */
 
 #define REPO_NAME "test-repo-large_delta_against_plain"
@@ -1888,6 +1995,206 @@ large_delta_against_plain(const svn_test_opts_t *opts,
 
 #undef REPO_NAME
 
+/* ------------------------------------------------------------------------ */
+#define REPO_NAME "test-repo-group_commits"
+#define COMMIT_COUNT 8
+
+#if APR_HAS_THREADS
+
+/* Baton for group_commit_thread(). */
+typedef struct group_commit_baton_t
+{
+  /* Number of the file to add. */
+  int number;
+
+  /* Out: The revision created and the error, if any. */
+  svn_revnum_t rev;
+  svn_error_t *err;
+} group_commit_baton_t;
+
+/* Add file /fN to HEAD of the group commit test repository, with N being
+   BATON->NUMBER.  Use POOL for allocations. */
+static svn_error_t *
+commit_numbered_file(group_commit_baton_t *baton,
+                     apr_pool_t *pool)
+{
+  svn_fs_t *fs;
+  fs_fs_data_t *ffd;
+  svn_fs_txn_t *txn;
+  svn_fs_root_t *root;
+  const char *path = apr_psprintf(pool, "f%d", baton->number);
+  svn_revnum_t youngest;
+  apr_uint64_t next_node_id, next_copy_id;
+  svn_error_t *err;
+
+  SVN_ERR(svn_fs_open2(&fs, REPO_NAME, NULL, pool, pool));
+  ffd = fs->fsap_data;
+  ffd->group_commits = TRUE;
+
+  /* All transactions are based on r0 and must be merged with whatever
+     got committed before them. */
+  SVN_ERR(svn_fs_begin_txn(&txn, fs, 0, pool));
+  SVN_ERR(svn_fs_txn_root(&root, txn, pool));
+  SVN_ERR(svn_fs_make_file(root, path, pool));
+  SVN_ERR(svn_test__set_file_contents(root, path, path, pool));
+  err = svn_fs_commit_txn(NULL, &baton->rev, txn, pool);
+  if (err)
+    {
+      /* A failed commit must not leave its FS believing in revisions
+         that have not been published. */
+      svn_error_t *err2 = svn_fs_fs__read_current(&youngest, &next_node_id,
+                                                  &next_copy_id, fs, pool);
+      if (!err2 && ffd->youngest_rev_cache > youngest)
+        err2 = svn_error_createf(SVN_ERR_TEST_FAILED, NULL,
+                                 "FS assumes r%ld to exist after failed "
+                                 "commit", ffd->youngest_rev_cache);
+
+      return svn_error_compose_create(err2, err);
+    }
+
+  return SVN_NO_ERROR;
+}
+
+static void * APR_THREAD_FUNC
+group_commit_thread(apr_thread_t *tid, void *data)
+{
+  group_commit_baton_t *baton = data;
+  apr_pool_t *pool = svn_pool_create(NULL);
+
+  baton->err = commit_numbered_file(baton, pool);
+
+  svn_pool_destroy(pool);
+  apr_thread_exit(tid, APR_SUCCESS);
+
+  return NULL;
+}
+
+/* Implements svn_fs_fs__with_write_lock() 'body' callback type.
+   While the write lock blocks all commits, wait until the commits not
+   taken by the current group leader queued up for the next group.  Fail
+   unless at least two of them did.  BATON is the svn_fs_t. */
+static svn_error_t *
+wait_for_group(void *baton,
+               apr_pool_t *pool)
+{
+  svn_fs_t *fs = baton;
+  fs_fs_data_t *ffd = fs->fsap_data;
+  apr_time_t deadline = apr_time_now() + apr_time_from_sec(5);
+  int queued = 0;
+
+  while (queued < COMMIT_COUNT && apr_time_now() < deadline)
+    {
+      apr_sleep(1000);
+      SVN_MUTEX__WITH_LOCK(ffd->shared->group_commit_lock,
+                           (queued = ffd->shared->group_commits_queued,
+                            SVN_NO_ERROR));
+    }
+
+  SVN_TEST_ASSERT(queued >= 2);
+  return SVN_NO_ERROR;
+}
+
+#endif
+
+static svn_error_t *
+group_commits(const svn_test_opts_t *opts,
+              apr_pool_t *pool)
+{
+#if APR_HAS_THREADS
+  svn_fs_t *fs;
+  fs_fs_data_t *ffd;
+  svn_fs_root_t *root;
+  svn_revnum_t youngest;
+  apr_thread_t *threads[COMMIT_COUNT + 1];
+  group_commit_baton_t batons[COMMIT_COUNT + 1];
+  svn_boolean_t rev_seen[COMMIT_COUNT + 1] = { FALSE };
+  svn_error_t *err = SVN_NO_ERROR;
+  int conflicts = 0;
+  int i;
+
+  if (strcmp(opts->fs_type, "fsfs") != 0)
+    return svn_error_create(SVN_ERR_TEST_SKIPPED, NULL, NULL);
+
+  SVN_ERR(svn_test__create_fs(&fs, REPO_NAME, opts, pool));
+
+  ffd = fs->fsap_data;
+  if (ffd->format < SVN_FS_FS__MIN_NO_GLOBAL_IDS_FORMAT)
+    return svn_error_create(SVN_ERR_TEST_SKIPPED, NULL, NULL);
+
+  /* Commit from many threads at once.  The last one adds the same file as
+     the first one, so one of these two must fail with a conflict. */
+  for (i = 0; i <= COMMIT_COUNT; ++i)
+    {
+      apr_status_t status;
+
+      batons[i].number = i < COMMIT_COUNT ? i : 0;
+      batons[i].rev = SVN_INVALID_REVNUM;
+      batons[i].err = SVN_NO_ERROR;
+
+      status = apr_thread_create(&threads[i], NULL, group_commit_thread,
+                                 &batons[i], pool);
+      if (status)
+        return svn_error_wrap_apr(status, "Can't create thread");
+    }
+
+  /* Hold the commits back until they have to be processed as a group. */
+  err = svn_fs_fs__with_write_lock(fs, wait_for_group, fs, pool);
+
+  for (i = 0; i <= COMMIT_COUNT; ++i)
+    {
+      apr_status_t retval;
+      apr_status_t status = apr_thread_join(&retval, threads[i]);
+      if (status)
+        return svn_error_wrap_apr(status, "Can't join thread");
+
+      if (batons[i].number == 0 && batons[i].err
+          && batons[i].err->apr_err == SVN_ERR_FS_CONFLICT)
+        {
+          svn_error_clear(batons[i].err);
+          conflicts++;
+        }
+      else
+        {
+          err = svn_error_compose_create(err, batons[i].err);
+        }
+    }
+
+  SVN_ERR(err);
+  SVN_TEST_ASSERT(conflicts == 1);
+
+  /* Every other commit must have gotten a revision of its own. */
+  SVN_ERR(svn_fs_youngest_rev(&youngest, fs, pool));
+  SVN_TEST_ASSERT(youngest == COMMIT_COUNT);
+
+  for (i = 0; i <= COMMIT_COUNT; ++i)
+    {
+      if (!SVN_IS_VALID_REVNUM(batons[i].rev))
+        continue;
+
+      SVN_TEST_ASSERT(batons[i].rev > 0 && batons[i].rev <= COMMIT_COUNT);
+      SVN_TEST_ASSERT(!rev_seen[batons[i].rev]);
+      rev_seen[batons[i].rev] = TRUE;
+    }
+
+  /* None of the changes may have been lost in the merges. */
+  SVN_ERR(svn_fs_revision_root(&root, fs, youngest, pool));
+  for (i = 0; i < COMMIT_COUNT; ++i)
+    {
+      const char *path = apr_psprintf(pool, "f%d", i);
+      svn_stringbuf_t *contents;
+
+      SVN_ERR(svn_test__get_file_contents(root, path, &contents, pool));
+      SVN_TEST_STRING_ASSERT(contents->data, path);
+    }
+
+  return SVN_NO_ERROR;
+#else
+  return svn_error_create(SVN_ERR_TEST_SKIPPED, NULL, NULL);
+#endif
+}
+
+#undef REPO_NAME
+#undef COMMIT_COUNT
 
 
 /* The test table.  */
@@ -1943,6 +2250,12 @@ static struct svn_test_descriptor_t test_funcs[] =
                        "pack with limited memory for metadata"),
     SVN_TEST_OPTS_PASS(large_delta_against_plain,
                        "large deltas against PLAIN, issue #4658"),
+    SVN_TEST_OPTS_PASS(pack_concurrently,
+                       "pack multiple shards concurrently"),
+    SVN_TEST_OPTS_PASS(hotcopy_concurrently,
+                       "hotcopy multiple shards concurrently"),
+    SVN_TEST_OPTS_PASS(group_commits,
+                       "concurrent commits with group commits enabled"),
     SVN_TEST_NULL
   };
 
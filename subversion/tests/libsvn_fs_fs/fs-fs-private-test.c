@@ -25,17 +25,22 @@
 
 #include "../svn_test.h"
 
+#include "svn_dirent_uri.h"
 #include "svn_hash.h"
+#include "svn_io.h"
 #include "svn_pools.h"
 #include "svn_props.h"
 #include "svn_fs.h"
 
+#include "private/svn_batch_fsync.h"
+#include "private/svn_cache.h"
 #include "private/svn_string_private.h"
 #include "private/svn_fs_fs_private.h"
 #include "private/svn_subr_private.h"
 
 #include "../../libsvn_fs_fs/index.h"
 #include "../../libsvn_fs_fs/rep-cache.h"
+#include "../../libsvn_fs_fs/util.h"
 #include "../../libsvn_fs/fs-loader.h"
 
 #include "../svn_test_fs.h"
@@ -424,7 +429,7 @@ load_index(const svn_test_opts_t *opts, apr_pool_t *pool)
   SVN_ERR(svn_fs_ioctl(svn_repos_fs(repos), SVN_FS_FS__IOCTL_LOAD_INDEX,
                        &load_input, NULL, NULL, NULL, pool, pool));
 
-  SVN_TEST_ASSERT_ERROR(svn_repos_verify_fs3(repos, rev, rev, FALSE, FALSE,
+  SVN_TEST_ASSERT_ERROR(svn_repos_verify_fs4(repos, rev, rev, 1, FALSE, FALSE,
                                              NULL, NULL, NULL, NULL, NULL,
                                              NULL, pool),
                         SVN_ERR_FS_INDEX_CORRUPTION);
@@ -434,7 +439,7 @@ load_index(const svn_test_opts_t *opts, apr_pool_t *pool)
   load_input.entries = entries;
   SVN_ERR(svn_fs_ioctl(svn_repos_fs(repos), SVN_FS_FS__IOCTL_LOAD_INDEX,
                        &load_input, NULL, NULL, NULL, pool, pool));
-  SVN_ERR(svn_repos_verify_fs3(repos, rev, rev, FALSE, FALSE, NULL, NULL,
+  SVN_ERR(svn_repos_verify_fs4(repos, rev, rev, 1, FALSE, FALSE, NULL, NULL,
                                NULL, NULL, NULL, NULL, pool));
 
   return SVN_NO_ERROR;
@@ -499,6 +504,181 @@ build_rep_cache(const svn_test_opts_t *opts, apr_pool_t *pool)
   return SVN_NO_ERROR;
 }
 
+/* ------------------------------------------------------------------------ */
+
+static svn_error_t *
+warm_caches(const svn_test_opts_t *opts, apr_pool_t *pool)
+{
+  svn_fs_t *fs;
+  fs_fs_data_t *ffd;
+  svn_fs_txn_t *txn;
+  svn_fs_root_t *txn_root;
+  svn_fs_root_t *rev_root;
+  svn_revnum_t rev;
+  apr_array_header_t *paths;
+  apr_hash_t *entries;
+  svn_cache__info_t noderev_info, dir_info;
+  svn_membuffer_t *membuffer;
+  svn_fs_fs__ioctl_warm_caches_input_t input = {0};
+  const char *repo_name = "test-repo-warm-caches-test";
+
+  /* Bail (with success) on known-untestable scenarios */
+  if (strcmp(opts->fs_type, "fsfs") != 0)
+    return svn_error_create(SVN_ERR_TEST_SKIPPED, NULL,
+                            "this will test FSFS repositories only");
+
+  /* We need to see what ends up in the caches. */
+  membuffer = svn_cache__get_global_membuffer_cache();
+  if (membuffer == NULL)
+    return svn_error_create(SVN_ERR_TEST_SKIPPED, NULL,
+                            "this test requires the membuffer cache");
+
+  SVN_ERR(svn_test__create_fs2(&fs, repo_name, opts, NULL, pool));
+
+  /* Add the Greek tree and modify it a bit. */
+  SVN_ERR(svn_fs_begin_txn(&txn, fs, 0, pool));
+  SVN_ERR(svn_fs_txn_root(&txn_root, txn, pool));
+  SVN_ERR(svn_test__create_greek_tree(txn_root, pool));
+  SVN_ERR(svn_fs_commit_txn(NULL, &rev, txn, pool));
+  SVN_TEST_ASSERT(SVN_IS_VALID_REVNUM(rev));
+
+  SVN_ERR(svn_fs_begin_txn(&txn, fs, rev, pool));
+  SVN_ERR(svn_fs_txn_root(&txn_root, txn, pool));
+  SVN_ERR(svn_test__set_file_contents(txn_root, "A/mu", "new mu\n", pool));
+  SVN_ERR(svn_fs_change_node_prop(txn_root, "A/B", "p",
+                                  svn_string_create("v", pool), pool));
+  SVN_ERR(svn_fs_commit_txn(NULL, &rev, txn, pool));
+  SVN_TEST_ASSERT(SVN_IS_VALID_REVNUM(rev));
+
+  /* Paths in HEAD, including some that don't exist. */
+  paths = apr_array_make(pool, 4, sizeof(const char *));
+  APR_ARRAY_PUSH(paths, const char *) = "/A/D/G";
+  APR_ARRAY_PUSH(paths, const char *) = "A/mu";
+  APR_ARRAY_PUSH(paths, const char *) = "/A/mu/not-a-dir";
+  APR_ARRAY_PUSH(paths, const char *) = "/does/not/exist";
+
+  /* Start with a fresh FS instance and empty caches, so that nothing left
+     over from the commits above can be mistaken for warmed-up data. */
+  SVN_ERR(svn_fs_open2(&fs, repo_name, NULL, pool, pool));
+  ffd = fs->fsap_data;
+  SVN_ERR(svn_cache__membuffer_clear(membuffer));
+  SVN_ERR(svn_cache__get_info(ffd->node_revision_cache, &noderev_info,
+                              TRUE, pool));
+  SVN_ERR(svn_cache__get_info(ffd->dir_cache, &dir_info, TRUE, pool));
+
+  /* All revisions plus paths. */
+  input.start_rev = SVN_INVALID_REVNUM;
+  input.end_rev = SVN_INVALID_REVNUM;
+  input.paths = paths;
+  SVN_ERR(svn_fs_ioctl(fs, SVN_FS_FS__IOCTL_WARM_CACHES,
+                       &input, NULL, NULL, NULL, pool, pool));
+
+  /* The warm-up must have populated the caches ... */
+  SVN_ERR(svn_cache__get_info(ffd->node_revision_cache, &noderev_info,
+                              TRUE, pool));
+  SVN_ERR(svn_cache__get_info(ffd->dir_cache, &dir_info, TRUE, pool));
+  SVN_TEST_ASSERT(noderev_info.sets > 0);
+  SVN_TEST_ASSERT(dir_info.sets > 0);
+
+  /* ... such that walking HEAD afterwards is served from them. */
+  SVN_ERR(svn_fs_revision_root(&rev_root, fs, rev, pool));
+  SVN_ERR(svn_fs_dir_entries(&entries, rev_root, "", pool));
+  SVN_TEST_INT_ASSERT(apr_hash_count(entries), 2);
+  SVN_ERR(svn_fs_dir_entries(&entries, rev_root, "A/D/G", pool));
+  SVN_TEST_INT_ASSERT(apr_hash_count(entries), 3);
+  SVN_ERR(svn_fs_dir_entries(&entries, rev_root, "A/B/E", pool));
+  SVN_TEST_INT_ASSERT(apr_hash_count(entries), 2);
+
+  SVN_ERR(svn_cache__get_info(ffd->node_revision_cache, &noderev_info,
+                              TRUE, pool));
+  SVN_ERR(svn_cache__get_info(ffd->dir_cache, &dir_info, TRUE, pool));
+  SVN_TEST_ASSERT(noderev_info.gets > 0);
+  SVN_TEST_INT_ASSERT(noderev_info.hits, noderev_info.gets);
+  SVN_TEST_ASSERT(dir_info.gets > 0);
+  SVN_TEST_INT_ASSERT(dir_info.hits, dir_info.gets);
+
+  /* Paths only. */
+  input.start_rev = rev + 1;
+  input.end_rev = rev;
+  SVN_ERR(svn_fs_ioctl(fs, SVN_FS_FS__IOCTL_WARM_CACHES,
+                       &input, NULL, NULL, NULL, pool, pool));
+
+  /* Revisions beyond HEAD. */
+  input.start_rev = rev;
+  input.end_rev = rev + 1;
+  input.paths = NULL;
+  SVN_TEST_ASSERT_ERROR(svn_fs_ioctl(fs, SVN_FS_FS__IOCTL_WARM_CACHES,
+                                     &input, NULL, NULL, NULL, pool, pool),
+                        SVN_ERR_FS_NO_SUCH_REVISION);
+
+  return SVN_NO_ERROR;
+}
+
+/* ------------------------------------------------------------------------ */
+
+static svn_error_t *
+bump_current(const svn_test_opts_t *opts, apr_pool_t *pool)
+{
+  svn_fs_t *fs;
+  fs_fs_data_t *ffd;
+  svn_fs_txn_t *txn;
+  svn_fs_root_t *txn_root;
+  svn_revnum_t rev;
+  svn_batch_fsync__t *batch;
+  svn_stringbuf_t *contents;
+  apr_hash_t *dirents;
+  unsigned int count;
+  const char *current_path;
+  const char *db_path;
+
+  /* Bail (with success) on known-untestable scenarios */
+  if (strcmp(opts->fs_type, "fsfs") != 0)
+    return svn_error_create(SVN_ERR_TEST_SKIPPED, NULL,
+                            "this will test FSFS repositories only");
+
+  SVN_ERR(svn_test__create_fs2(&fs, "test-repo-bump-current-test", opts,
+                               NULL, pool));
+  ffd = fs->fsap_data;
+  if (ffd->format < SVN_FS_FS__MIN_NO_GLOBAL_IDS_FORMAT)
+    return svn_error_create(SVN_ERR_TEST_SKIPPED, NULL,
+                            "this needs FSFS without global IDs");
+
+  SVN_ERR(svn_fs_begin_txn(&txn, fs, 0, pool));
+  SVN_ERR(svn_fs_txn_root(&txn_root, txn, pool));
+  SVN_ERR(svn_test__create_greek_tree(txn_root, pool));
+  SVN_ERR(svn_fs_commit_txn(NULL, &rev, txn, pool));
+  SVN_TEST_ASSERT(SVN_IS_VALID_REVNUM(rev));
+
+  current_path = svn_fs_fs__path_current(fs, pool);
+  db_path = svn_dirent_dirname(current_path, pool);
+  SVN_ERR(svn_io_get_dirents3(&dirents, db_path, TRUE, pool, pool));
+  count = apr_hash_count(dirents);
+
+  /* Re-write 'current' through a batch. */
+  SVN_ERR(svn_batch_fsync__create(&batch, TRUE, pool));
+  SVN_ERR(svn_fs_fs__bump_current(fs, rev, 0, 0, batch, pool));
+
+  SVN_ERR(svn_stringbuf_from_file2(&contents, current_path, pool));
+  SVN_TEST_STRING_ASSERT(contents->data,
+                         apr_psprintf(pool, "%ld\n", rev));
+  SVN_ERR(svn_io_get_dirents3(&dirents, db_path, TRUE, pool, pool));
+  SVN_TEST_ASSERT(apr_hash_count(dirents) == count);
+
+  /* Failing to replace 'current' must not leave the temp file behind. */
+  SVN_ERR(svn_io_remove_file2(current_path, FALSE, pool));
+  SVN_ERR(svn_io_dir_make(current_path, APR_OS_DEFAULT, pool));
+
+  SVN_TEST_ASSERT_ANY_ERROR(svn_fs_fs__bump_current(fs, rev, 0, 0, batch,
+                                                    pool));
+  SVN_ERR(svn_io_get_dirents3(&dirents, db_path, TRUE, pool, pool));
+  SVN_TEST_ASSERT(apr_hash_count(dirents) == count);
+
+  SVN_ERR(svn_io_dir_remove_nonrecursive(current_path, pool));
+  SVN_ERR(svn_fs_fs__write_current(fs, rev, 0, 0, pool));
+
+  return SVN_NO_ERROR;
+}
+
 
 
 /* The test table.  */
@@ -516,6 +696,10 @@ static struct svn_test_descriptor_t test_funcs[] =
                        "load the P2L index"),
     SVN_TEST_OPTS_PASS(build_rep_cache,
                        "build the representation cache"),
+    SVN_TEST_OPTS_PASS(warm_caches,
+                       "warm up the caches"),
+    SVN_TEST_OPTS_PASS(bump_current,
+                       "bump 'current' through a batch fsync"),
     SVN_TEST_NULL
   };
 
@@ -23,9 +23,13 @@
 
 
 
+#include <stdio.h>
+
 #include <apr_general.h>
 #include <apr_pools.h>
 #include <apr_file_io.h>
+#include <apr_network_io.h>
+#include <apr_thread_proc.h>
 #include <assert.h>
 
 #include "svn_error.h"
@@ -37,6 +41,11 @@
 #include "svn_dirent_uri.h"
 #include "svn_hash.h"
 
+#include "svn_ra_svn.h"
+
+#include "private/svn_ra_private.h"
+#include "private/svn_ra_svn_private.h"
+
 #include "../svn_test.h"
 #include "../svn_test_fs.h"
 #include "../../libsvn_ra_local/ra_local.h"
@@ -1877,6 +1886,399 @@ test_get_deleted_rev_errors(const svn_test_opts_t *opts,
   return SVN_NO_ERROR;
 }
 
+/* Check svn_ra__stat_many() against individual svn_ra_stat() calls,
+   using enough paths to need several pipelines over ra_svn. */
+static svn_error_t *
+test_stat_many(const svn_test_opts_t *opts,
+               apr_pool_t *pool)
+{
+  svn_ra_session_t *ra_session;
+  static const char *const names[] = { "", "A", "B", "missing" };
+  apr_array_header_t *paths = apr_array_make(pool, 0, sizeof(const char *));
+  apr_pool_t *iterpool = svn_pool_create(pool);
+  svn_revnum_t rev;
+  svn_revnum_t youngest;
+  int i;
+
+  SVN_ERR(make_and_open_repos(&ra_session, "test-repo-stat-many", opts,
+                              pool));
+  SVN_ERR(commit_changes(ra_session, pool));
+  SVN_ERR(commit_two_changes(ra_session, pool));
+
+  for (i = 0; i < 150; i++)
+    APR_ARRAY_PUSH(paths, const char *) = names[i % 4];
+
+  for (rev = 1; rev <= 3; rev++)
+    {
+      apr_array_header_t *dirents;
+
+      svn_pool_clear(iterpool);
+      SVN_ERR(svn_ra__stat_many(ra_session, &dirents, paths, rev,
+                                iterpool, iterpool));
+      SVN_TEST_INT_ASSERT(dirents->nelts, paths->nelts);
+
+      for (i = 0; i < paths->nelts; i++)
+        {
+          svn_dirent_t *dirent = APR_ARRAY_IDX(dirents, i, svn_dirent_t *);
+          svn_dirent_t *expected;
+
+          SVN_ERR(svn_ra_stat(ra_session,
+                              APR_ARRAY_IDX(paths, i, const char *),
+                              rev, &expected, iterpool));
+          if (!expected)
+            {
+              SVN_TEST_ASSERT(dirent == NULL);
+              continue;
+            }
+
+          SVN_TEST_ASSERT(dirent != NULL);
+          SVN_TEST_ASSERT(dirent->kind == expected->kind);
+          SVN_TEST_INT_ASSERT(dirent->created_rev, expected->created_rev);
+          SVN_TEST_STRING_ASSERT(dirent->last_author, expected->last_author);
+        }
+    }
+
+  /* The session must still be usable afterwards. */
+  SVN_ERR(svn_ra_get_latest_revnum(ra_session, &youngest, pool));
+  SVN_TEST_INT_ASSERT(youngest, 3);
+
+  svn_pool_destroy(iterpool);
+
+  return SVN_NO_ERROR;
+}
+
+/* Check svn_ra__get_dir_many() against individual svn_ra_get_dir2()
+   calls, using enough paths to need several pipelines over ra_svn. */
+static svn_error_t *
+test_get_dir_many(const svn_test_opts_t *opts,
+                  apr_pool_t *pool)
+{
+  svn_ra_session_t *ra_session;
+  static const char *const names[] = { "", "A", "B" };
+  apr_array_header_t *paths = apr_array_make(pool, 0, sizeof(const char *));
+  apr_array_header_t *listings;
+  apr_pool_t *iterpool = svn_pool_create(pool);
+  svn_revnum_t youngest;
+  int i;
+
+  SVN_ERR(make_and_open_repos(&ra_session, "test-repo-get-dir-many", opts,
+                              pool));
+  SVN_ERR(commit_changes(ra_session, pool));
+  SVN_ERR(commit_two_changes(ra_session, pool));
+
+  for (i = 0; i < 150; i++)
+    APR_ARRAY_PUSH(paths, const char *) = names[i % 3];
+
+  /* All of "", "A" and "B" exist in r2. */
+  SVN_ERR(svn_ra__get_dir_many(ra_session, &listings, paths, 2,
+                               SVN_DIRENT_ALL, pool, pool));
+  SVN_TEST_INT_ASSERT(listings->nelts, paths->nelts);
+
+  for (i = 0; i < paths->nelts; i++)
+    {
+      apr_hash_t *entries = APR_ARRAY_IDX(listings, i, apr_hash_t *);
+      apr_hash_t *expected;
+      apr_hash_index_t *hi;
+
+      svn_pool_clear(iterpool);
+      SVN_ERR(svn_ra_get_dir2(ra_session, &expected, NULL, NULL,
+                              APR_ARRAY_IDX(paths, i, const char *), 2,
+                              SVN_DIRENT_ALL, iterpool));
+
+      SVN_TEST_ASSERT(entries != NULL);
+      SVN_TEST_INT_ASSERT(apr_hash_count(entries), apr_hash_count(expected));
+      for (hi = apr_hash_first(iterpool, expected); hi; hi = apr_hash_next(hi))
+        {
+          svn_dirent_t *expected_ent = apr_hash_this_val(hi);
+          svn_dirent_t *dirent = svn_hash_gets(entries, apr_hash_this_key(hi));
+
+          SVN_TEST_ASSERT(dirent != NULL);
+          SVN_TEST_ASSERT(dirent->kind == expected_ent->kind);
+          SVN_TEST_INT_ASSERT(dirent->created_rev, expected_ent->created_rev);
+          SVN_TEST_STRING_ASSERT(dirent->last_author,
+                                 expected_ent->last_author);
+        }
+    }
+
+  /* "A" is gone in r3, so the batch must fail ... */
+  SVN_TEST_ASSERT_ANY_ERROR(svn_ra__get_dir_many(ra_session, &listings,
+                                                 paths, 3, SVN_DIRENT_KIND,
+                                                 pool, pool));
+
+  /* ... but leave the session usable. */
+  SVN_ERR(svn_ra_get_latest_revnum(ra_session, &youngest, pool));
+  SVN_TEST_INT_ASSERT(youngest, 3);
+
+  svn_pool_destroy(iterpool);
+
+  return SVN_NO_ERROR;
+}
+
+/* Return a string of LEN pseudo-random bytes, allocated in POOL. */
+static svn_string_t *
+random_string(apr_size_t len, apr_uint32_t *seed, apr_pool_t *pool)
+{
+  char *data = apr_palloc(pool, len + 1);
+  apr_size_t i;
+
+  for (i = 0; i < len; i++)
+    data[i] = (char)svn_test_rand(seed);
+  data[len] = '\0';
+
+  return svn_string_ncreate(data, len, pool);
+}
+
+/* Sizes of the strings used by marshal_large_strings, chosen around the
+   ra_svn marshaller's buffering thresholds. */
+static const apr_size_t large_string_sizes[] = { 0, 1, 4095, 4096, 4097,
+                                                 8191, 8192, 16383, 16384,
+                                                 100000, 3, 65536 };
+#define LARGE_STRING_COUNT \
+  (sizeof(large_string_sizes) / sizeof(large_string_sizes[0]))
+
+/* Send all LARGE_STRING_COUNT CHUNKS as textdelta chunks for TOKEN over
+   CONN and flush it.  Use POOL for allocations. */
+static svn_error_t *
+write_large_strings(svn_ra_svn_conn_t *conn,
+                    svn_string_t **chunks,
+                    const svn_string_t *token,
+                    apr_pool_t *pool)
+{
+  apr_size_t i;
+
+  for (i = 0; i < LARGE_STRING_COUNT; i++)
+    SVN_ERR(svn_ra_svn__write_cmd_textdelta_chunk(conn, pool, token,
+                                                  chunks[i]));
+
+  return svn_error_trace(svn_ra_svn__flush(conn, pool));
+}
+
+/* Read the textdelta chunks sent by write_large_strings from CONN and
+   verify that they match TOKEN and CHUNKS.  Use POOL for allocations. */
+static svn_error_t *
+read_large_strings(svn_ra_svn_conn_t *conn,
+                   svn_string_t **chunks,
+                   const svn_string_t *token,
+                   apr_pool_t *pool)
+{
+  apr_size_t i;
+
+  for (i = 0; i < LARGE_STRING_COUNT; i++)
+    {
+      const char *cmd;
+      svn_string_t *read_token, *read_chunk;
+
+      SVN_ERR(svn_ra_svn__read_tuple(conn, pool, "w(ss)", &cmd,
+                                     &read_token, &read_chunk));
+      SVN_TEST_STRING_ASSERT(cmd, "textdelta-chunk");
+      SVN_TEST_ASSERT(svn_string_compare(read_token, token));
+      SVN_TEST_ASSERT(svn_string_compare(read_chunk, chunks[i]));
+    }
+
+  return SVN_NO_ERROR;
+}
+
+#if APR_HAS_THREADS
+
+#define APR_ERR(expr)                           \
+  do {                                          \
+    apr_status_t status = (expr);               \
+    if (status)                                 \
+      return svn_error_wrap_apr(status, NULL);  \
+  } while (0)
+
+/* Baton for write_large_strings_thread. */
+typedef struct write_strings_baton_t
+{
+  apr_socket_t *sock;
+  svn_string_t **chunks;
+  const svn_string_t *token;
+  svn_error_t *err;
+} write_strings_baton_t;
+
+/* Thread function calling write_large_strings() on a connection over the
+   socket in the write_strings_baton_t given as DATA. */
+static void *
+APR_THREAD_FUNC write_large_strings_thread(apr_thread_t *tid, void *data)
+{
+  write_strings_baton_t *baton = data;
+  apr_pool_t *pool = svn_pool_create(NULL);
+  svn_ra_svn_conn_t *conn;
+
+  conn = svn_ra_svn_create_conn5(baton->sock, NULL, NULL,
+                                 SVN_DELTA_COMPRESSION_LEVEL_NONE,
+                                 0, 0, 0, 0, pool);
+  baton->err = write_large_strings(conn, baton->chunks, baton->token, pool);
+
+  svn_pool_destroy(pool);
+  apr_thread_exit(tid, APR_SUCCESS);
+
+  return NULL;
+}
+
+/* Send CHUNKS for TOKEN over a loopback TCP connection and read them back.
+   The connection buffers are smaller than the data, so the sender runs in
+   a separate thread.  Use POOL for allocations. */
+static svn_error_t *
+socket_round_trip(svn_string_t **chunks,
+                  const svn_string_t *token,
+                  apr_pool_t *pool)
+{
+  apr_sockaddr_t *addr;
+  apr_socket_t *listener, *client, *server;
+  apr_thread_t *thread;
+  apr_status_t retval;
+  write_strings_baton_t baton;
+  svn_ra_svn_conn_t *conn;
+  svn_error_t *err;
+
+  APR_ERR(apr_sockaddr_info_get(&addr, "127.0.0.1", APR_INET, 0, 0, pool));
+  APR_ERR(apr_socket_create(&listener, APR_INET, SOCK_STREAM, APR_PROTO_TCP,
+                            pool));
+  APR_ERR(apr_socket_bind(listener, addr));
+  APR_ERR(apr_socket_listen(listener, 1));
+  APR_ERR(apr_socket_addr_get(&addr, APR_LOCAL, listener));
+
+  APR_ERR(apr_socket_create(&client, APR_INET, SOCK_STREAM, APR_PROTO_TCP,
+                            pool));
+  APR_ERR(apr_socket_connect(client, addr));
+  APR_ERR(apr_socket_accept(&server, listener, pool));
+
+  baton.sock = client;
+  baton.chunks = chunks;
+  baton.token = token;
+  baton.err = SVN_NO_ERROR;
+  APR_ERR(apr_thread_create(&thread, NULL, write_large_strings_thread,
+                            &baton, pool));
+
+  conn = svn_ra_svn_create_conn5(server, NULL, NULL,
+                                 SVN_DELTA_COMPRESSION_LEVEL_NONE,
+                                 0, 0, 0, 0, pool);
+  err = read_large_strings(conn, chunks, token, pool);
+
+  /* Unblock the writer if we stopped reading early. */
+  if (err)
+    apr_socket_close(server);
+
+  APR_ERR(apr_thread_join(&retval, thread));
+  APR_ERR(retval);
+
+  return svn_error_compose_create(err, baton.err);
+}
+
+#endif
+
+/* Check that strings around the ra_svn marshaller's buffering thresholds
+   survive a round trip, through a plain stream, a file and a socket.  The
+   latter two let the marshaller use gather writes. */
+static svn_error_t *
+marshal_large_strings(const svn_test_opts_t *opts,
+                      apr_pool_t *pool)
+{
+  svn_stringbuf_t *buffer = svn_stringbuf_create_empty(pool);
+  const svn_string_t *token = svn_string_create("c1", pool);
+  svn_string_t *chunks[LARGE_STRING_COUNT];
+  apr_uint32_t seed = 0x4d61;
+  svn_ra_svn_conn_t *conn;
+  apr_file_t *file;
+  apr_off_t offset = 0;
+  apr_size_t i;
+
+  for (i = 0; i < LARGE_STRING_COUNT; i++)
+    chunks[i] = random_string(large_string_sizes[i], &seed, pool);
+
+  /* Through a generic stream. */
+  conn = svn_ra_svn_create_conn5(NULL, svn_stream_empty(pool),
+                                 svn_stream_from_stringbuf(buffer, pool),
+                                 SVN_DELTA_COMPRESSION_LEVEL_NONE,
+                                 0, 0, 0, 0, pool);
+  SVN_ERR(write_large_strings(conn, chunks, token, pool));
+
+  conn = svn_ra_svn_create_conn5(NULL,
+                                 svn_stream_from_stringbuf(buffer, pool),
+                                 svn_stream_empty(pool),
+                                 SVN_DELTA_COMPRESSION_LEVEL_NONE,
+                                 0, 0, 0, 0, pool);
+  SVN_ERR(read_large_strings(conn, chunks, token, pool));
+
+  /* Through an APR file, as with tunnels. */
+  SVN_ERR(svn_io_open_unique_file3(&file, NULL, NULL,
+                                   svn_io_file_del_on_pool_cleanup,
+                                   pool, pool));
+  conn = svn_ra_svn_create_conn5(NULL, svn_stream_empty(pool),
+                                 svn_stream_from_aprfile2(file, TRUE, pool),
+                                 SVN_DELTA_COMPRESSION_LEVEL_NONE,
+                                 0, 0, 0, 0, pool);
+  SVN_ERR(write_large_strings(conn, chunks, token, pool));
+  SVN_ERR(svn_io_file_seek(file, APR_SET, &offset, pool));
+
+  conn = svn_ra_svn_create_conn5(NULL,
+                                 svn_stream_from_aprfile2(file, TRUE, pool),
+                                 svn_stream_empty(pool),
+                                 SVN_DELTA_COMPRESSION_LEVEL_NONE,
+                                 0, 0, 0, 0, pool);
+  SVN_ERR(read_large_strings(conn, chunks, token, pool));
+
+#if APR_HAS_THREADS
+  /* Through a socket, as with svn:// connections. */
+  SVN_ERR(socket_round_trip(chunks, token, pool));
+#endif
+
+  return SVN_NO_ERROR;
+}
+
+/* Microbenchmark for the ra_svn marshaller, writing file contents the way
+   svnserve does during a checkout.  This writes 48 MB, so it is skipped by
+   default.  Run it explicitly with --verbose to see the throughput. */
+static svn_error_t *
+marshal_throughput_bench(const svn_test_opts_t *opts,
+                         apr_pool_t *pool)
+{
+  enum { TOTAL_SIZE = 16 * 1024 * 1024 };
+  static const apr_size_t chunk_sizes[] = { 100 * 1024, 6 * 1024, 256 };
+  const svn_string_t *token = svn_string_create("c1", pool);
+  apr_uint32_t seed = 0x5eed;
+  apr_pool_t *iterpool = svn_pool_create(pool);
+  apr_size_t i;
+
+  for (i = 0; i < sizeof(chunk_sizes) / sizeof(chunk_sizes[0]); i++)
+    {
+      svn_string_t *chunk = random_string(chunk_sizes[i], &seed, pool);
+      apr_file_t *file;
+      svn_ra_svn_conn_t *conn;
+      apr_size_t written;
+      apr_time_t start, duration;
+
+      svn_pool_clear(iterpool);
+
+      SVN_ERR(svn_io_open_unique_file3(&file, NULL, NULL,
+                                       svn_io_file_del_on_pool_cleanup,
+                                       iterpool, iterpool));
+      conn = svn_ra_svn_create_conn5(NULL, svn_stream_empty(iterpool),
+                                     svn_stream_from_aprfile2(file, TRUE,
+                                                              iterpool),
+                                     SVN_DELTA_COMPRESSION_LEVEL_NONE,
+                                     0, 0, 0, 0, iterpool);
+
+      start = apr_time_now();
+      for (written = 0; written < TOTAL_SIZE; written += chunk->len)
+        SVN_ERR(svn_ra_svn__write_cmd_textdelta_chunk(conn, iterpool,
+                                                      token, chunk));
+      SVN_ERR(svn_ra_svn__flush(conn, iterpool));
+      duration = apr_time_now() - start;
+
+      if (opts->verbose)
+        printf("%6" APR_SIZE_T_FMT " byte chunks: %8" APR_TIME_T_FMT
+               " usec, %.1f MB/s\n",
+               chunk->len, duration,
+               (double)written / (duration ? duration : 1));
+    }
+
+  svn_pool_destroy(iterpool);
+
+  return SVN_NO_ERROR;
+}
+
 
 /* The test table.  */
 
@@ -1917,6 +2319,14 @@ static struct svn_test_descriptor_t test_funcs[] =
                        "test get-deleted-rev no delete"),
     SVN_TEST_OPTS_PASS(test_get_deleted_rev_errors,
                        "test get-deleted-rev errors"),
+    SVN_TEST_OPTS_PASS(test_stat_many,
+                       "stat many paths at once"),
+    SVN_TEST_OPTS_PASS(test_get_dir_many,
+                       "list many directories at once"),
+    SVN_TEST_OPTS_PASS(marshal_large_strings,
+                       "marshal strings around buffer thresholds"),
+    SVN_TEST_OPTS_SKIP(marshal_throughput_bench, TRUE,
+                       "optional ra_svn marshalling throughput benchmark"),
     SVN_TEST_NULL
   };
 
@@ -4468,6 +4468,81 @@ test_list(const svn_test_opts_t *opts,
   return SVN_NO_ERROR;
 }
 
+/* Baton for verify_notify. */
+typedef struct verify_notify_baton_t
+{
+  svn_revnum_t last_rev;
+  svn_boolean_t done;
+} verify_notify_baton_t;
+
+/* Implements svn_repos_notify_func_t.  Check that revisions get reported
+   in ascending order and that the final notification comes last. */
+static void
+verify_notify(void *baton,
+              const svn_repos_notify_t *notify,
+              apr_pool_t *scratch_pool)
+{
+  verify_notify_baton_t *b = baton;
+
+  SVN_ERR_ASSERT_NO_RETURN(!b->done);
+  if (notify->action == svn_repos_notify_verify_rev_end)
+    {
+      SVN_ERR_ASSERT_NO_RETURN(notify->revision == b->last_rev + 1);
+      b->last_rev = notify->revision;
+    }
+  else if (notify->action == svn_repos_notify_verify_end)
+    {
+      b->done = TRUE;
+    }
+}
+
+static svn_error_t *
+test_verify_concurrently(const svn_test_opts_t *opts,
+                         apr_pool_t *pool)
+{
+  svn_repos_t *repos;
+  svn_fs_t *fs;
+  svn_fs_txn_t *txn;
+  svn_fs_root_t *txn_root;
+  svn_revnum_t youngest_rev;
+  verify_notify_baton_t nb = { -1, FALSE };
+  apr_pool_t *iterpool = svn_pool_create(pool);
+  int i;
+
+  SVN_ERR(svn_test__create_repos(&repos, "test-repo-verify-concurrently",
+                                 opts, pool));
+  fs = svn_repos_fs(repos);
+
+  /* r1: the greek tree. */
+  SVN_ERR(svn_fs_begin_txn(&txn, fs, 0, pool));
+  SVN_ERR(svn_fs_txn_root(&txn_root, txn, pool));
+  SVN_ERR(svn_test__create_greek_tree(txn_root, pool));
+  SVN_ERR(svn_repos_fs_commit_txn(NULL, repos, &youngest_rev, txn, pool));
+
+  /* r2 .. r20: modify iota. */
+  for (i = 0; i < 19; ++i)
+    {
+      svn_pool_clear(iterpool);
+      SVN_ERR(svn_fs_begin_txn(&txn, fs, youngest_rev, iterpool));
+      SVN_ERR(svn_fs_txn_root(&txn_root, txn, iterpool));
+      SVN_ERR(svn_test__set_file_contents(txn_root, "iota",
+                                          apr_psprintf(iterpool,
+                                                       "revision %d\n", i),
+                                          iterpool));
+      SVN_ERR(svn_repos_fs_commit_txn(NULL, repos, &youngest_rev, txn,
+                                      iterpool));
+    }
+  svn_pool_destroy(iterpool);
+
+  SVN_ERR(svn_repos_verify_fs4(repos, 0, youngest_rev, 4, FALSE, FALSE,
+                               verify_notify, &nb, NULL, NULL,
+                               NULL, NULL, pool));
+  SVN_TEST_ASSERT(nb.last_rev == youngest_rev);
+  SVN_TEST_ASSERT(nb.done);
+
+  return SVN_NO_ERROR;
+}
+
 /* The test table.  */
 
 static int max_threads = 4;
@@ -4539,6 +4614,8 @@ static struct svn_test_descriptor_t test_funcs[] =
                    "optional authz wildcard performance test"),
     SVN_TEST_OPTS_PASS(test_list,
                        "test svn_repos_list"),
+    SVN_TEST_OPTS_PASS(test_verify_concurrently,
+                       "test svn_repos_verify_fs4 with multiple jobs"),
     SVN_TEST_NULL
   };
 
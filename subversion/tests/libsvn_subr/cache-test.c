@@ -26,8 +26,15 @@
 #include <apr_general.h>
 #include <apr_lib.h>
 #include <apr_time.h>
+#include <apr_thread_proc.h>
+
+#if APR_HAS_FORK
+#include <unistd.h>   /* For _exit() */
+#endif
 
 #include "svn_pools.h"
+#include "svn_dirent_uri.h"
+#include "svn_io.h"
 
 #include "private/svn_cache.h"
 #include "svn_private_config.h"
@@ -227,6 +234,181 @@ test_membuffer_cache_basic(apr_pool_t *pool)
   return basic_cache_test(cache, FALSE, pool);
 }
 
+static svn_error_t *
+test_disk_cache_basic(apr_pool_t *pool)
+{
+  svn_cache__t *cache;
+  svn_cache__disk_t *disk;
+  const char *path;
+  svn_revnum_t *answer;
+  svn_boolean_t found;
+
+  SVN_ERR(svn_test_make_sandbox_dir(&path, "cache-test-disk", pool));
+  SVN_ERR(svn_cache__disk_create(&disk, path, 1024 * 1024, pool));
+  SVN_ERR(svn_cache__create_disk_cache(&cache, disk,
+                                       serialize_revnum,
+                                       deserialize_revnum,
+                                       APR_HASH_KEY_STRING,
+                                       "cache:",
+                                       pool));
+
+  SVN_ERR(basic_cache_test(cache, FALSE, pool));
+
+  /* The contents must survive re-opening the store. */
+  SVN_ERR(svn_cache__disk_create(&disk, path, 1024 * 1024, pool));
+  SVN_ERR(svn_cache__create_disk_cache(&cache, disk,
+                                       serialize_revnum,
+                                       deserialize_revnum,
+                                       APR_HASH_KEY_STRING,
+                                       "cache:",
+                                       pool));
+  SVN_ERR(svn_cache__get((void **) &answer, &found, cache, "thirty", pool));
+  SVN_TEST_ASSERT(found);
+  SVN_TEST_ASSERT(*answer == 30);
+
+  /* Different prefixes must not see each other's data. */
+  SVN_ERR(svn_cache__create_disk_cache(&cache, disk,
+                                       serialize_revnum,
+                                       deserialize_revnum,
+                                       APR_HASH_KEY_STRING,
+                                       "other cache:",
+                                       pool));
+  SVN_ERR(svn_cache__get((void **) &answer, &found, cache, "thirty", pool));
+  SVN_TEST_ASSERT(!found);
+
+  return SVN_NO_ERROR;
+}
+
+static svn_error_t *
+test_disk_cache_size_limit(apr_pool_t *pool)
+{
+  enum { MAX_SIZE = 128 * 1024, ITEM_COUNT = 10000 };
+  svn_cache__t *cache;
+  svn_cache__disk_t *disk;
+  const char *path;
+  apr_hash_t *buckets;
+  apr_hash_index_t *hi;
+  apr_uint64_t total_size = 0;
+  apr_pool_t *iterpool = svn_pool_create(pool);
+  svn_revnum_t i;
+
+  SVN_ERR(svn_test_make_sandbox_dir(&path, "cache-test-disk-limit", pool));
+  SVN_ERR(svn_cache__disk_create(&disk, path, MAX_SIZE, pool));
+  SVN_ERR(svn_cache__create_disk_cache(&cache, disk,
+                                       serialize_revnum,
+                                       deserialize_revnum,
+                                       sizeof(i),
+                                       "cache:",
+                                       pool));
+
+  /* Each item file takes about 50 bytes, i.e. we write almost 4 times
+   * the limit. */
+  for (i = 0; i < ITEM_COUNT; ++i)
+    {
+      svn_pool_clear(iterpool);
+      SVN_ERR(svn_cache__set(cache, &i, &i, iterpool));
+    }
+
+  svn_pool_destroy(iterpool);
+
+  /* Sum up the sizes of all item files. */
+  SVN_ERR(svn_io_get_dirents3(&buckets, path, TRUE, pool, pool));
+  for (hi = apr_hash_first(pool, buckets); hi; hi = apr_hash_next(hi))
+    {
+      apr_hash_t *items;
+      apr_hash_index_t *item;
+      const char *bucket = svn_dirent_join(path, apr_hash_this_key(hi),
+                                           pool);
+
+      SVN_ERR(svn_io_get_dirents3(&items, bucket, FALSE, pool, pool));
+      for (item = apr_hash_first(pool, items); item;
+           item = apr_hash_next(item))
+        {
+          const svn_io_dirent2_t *dirent = apr_hash_this_val(item);
+          total_size += dirent->filesize;
+        }
+    }
+
+  SVN_TEST_ASSERT(total_size <= MAX_SIZE);
+  SVN_TEST_ASSERT(total_size >= MAX_SIZE / 2);
+
+  return SVN_NO_ERROR;
+}
+
+static svn_error_t *
+test_disk_cache_global(apr_pool_t *pool)
+{
+  svn_cache__disk_t *disk1;
+  svn_cache__disk_t *disk2;
+  svn_cache__disk_t *other;
+  const char *path;
+  const char *other_path;
+
+  SVN_ERR(svn_test_make_sandbox_dir(&path, "cache-test-disk-global", pool));
+  other_path = svn_dirent_join(path, "other", pool);
+
+  /* All users of the same directory share one store. */
+  SVN_ERR(svn_cache__get_global_disk_cache(&disk1, path, 1024 * 1024,
+                                           pool));
+  SVN_ERR(svn_cache__get_global_disk_cache(&disk2, path, 2048 * 1024,
+                                           pool));
+  SVN_TEST_ASSERT(disk1 == disk2);
+
+  SVN_ERR(svn_cache__get_global_disk_cache(&other, other_path, 1024 * 1024,
+                                           pool));
+  SVN_TEST_ASSERT(other != disk1);
+
+  return SVN_NO_ERROR;
+}
+
+static svn_error_t *
+test_tiered_cache(apr_pool_t *pool)
+{
+  svn_cache__t *first;
+  svn_cache__t *second;
+  svn_cache__t *cache;
+  svn_cache__disk_t *disk;
+  const char *path;
+  svn_revnum_t fifty = 50, *answer;
+  svn_boolean_t found;
+
+  SVN_ERR(svn_test_make_sandbox_dir(&path, "cache-test-tiered", pool));
+  SVN_ERR(svn_cache__disk_create(&disk, path, 1024 * 1024, pool));
+  SVN_ERR(svn_cache__create_disk_cache(&second, disk,
+                                       serialize_revnum,
+                                       deserialize_revnum,
+                                       APR_HASH_KEY_STRING,
+                                       "cache:",
+                                       pool));
+  SVN_ERR(svn_cache__create_inprocess(&first,
+                                      serialize_revnum,
+                                      deserialize_revnum,
+                                      APR_HASH_KEY_STRING,
+                                      1,
+                                      1,
+                                      TRUE,
+                                      "",
+                                      pool));
+  SVN_ERR(svn_cache__create_tiered(&cache, first, second, pool));
+
+  SVN_ERR(basic_cache_test(cache, FALSE, pool));
+
+  /* Items found in the second level get copied to the first level. */
+  SVN_ERR(svn_cache__set(second, "fifty", &fifty, pool));
+  SVN_ERR(svn_cache__get((void **) &answer, &found, first, "fifty", pool));
+  SVN_TEST_ASSERT(!found);
+
+  SVN_ERR(svn_cache__get((void **) &answer, &found, cache, "fifty", pool));
+  SVN_TEST_ASSERT(found);
+  SVN_TEST_ASSERT(*answer == 50);
+
+  SVN_ERR(svn_cache__get((void **) &answer, &found, first, "fifty", pool));
+  SVN_TEST_ASSERT(found);
+  SVN_TEST_ASSERT(*answer == 50);
+
+  return SVN_NO_ERROR;
+}
+
 /* Implements svn_cache__deserialize_func_t */
 static svn_error_t *
 raise_error_deserialize_func(void **out,
@@ -591,6 +773,369 @@ test_membuffer_unaligned_fixed_keys(apr_pool_t *pool)
 }
 
 
+#if APR_HAS_THREADS
+
+/* Baton for cache_access_thread(). */
+typedef struct cache_access_baton_t
+{
+  /* Shared cache to access. */
+  svn_membuffer_t *membuffer;
+
+  /* Keys to use.  The value cached for KEYS[i] is always i. */
+  const char **keys;
+  int key_count;
+
+  /* Number of cache accesses to perform. */
+  int iterations;
+
+  /* Out of 1000 accesses, this many will be writes.  All others will
+     be reads. */
+  int writes_per_thousand;
+
+  /* Seed for the pseudo-random sequence of keys to use. */
+  apr_uint32_t seed;
+
+  /* Out: Number of cache hits and the error, if any. */
+  int hits;
+  svn_error_t *err;
+} cache_access_baton_t;
+
+/* Perform the cache accesses described by BATON.
+   Use POOL for allocations. */
+static svn_error_t *
+access_cache(cache_access_baton_t *baton,
+             apr_pool_t *pool)
+{
+  svn_cache__t *cache;
+  apr_pool_t *iterpool = svn_pool_create(pool);
+  apr_uint32_t rnd = baton->seed;
+  int i;
+
+  /* Front-end instances are not thread-safe.  Use one per thread, all
+     sharing the same key space within the same membuffer. */
+  SVN_ERR(svn_cache__create_membuffer_cache(&cache,
+                                            baton->membuffer,
+                                            serialize_revnum,
+                                            deserialize_revnum,
+                                            APR_HASH_KEY_STRING,
+                                            "stress:",
+                                            SVN_CACHE__MEMBUFFER_DEFAULT_PRIORITY,
+                                            FALSE,
+                                            FALSE,
+                                            pool, pool));
+
+  for (i = 0; i < baton->iterations; ++i)
+    {
+      int k;
+
+      if ((i & 0xff) == 0)
+        svn_pool_clear(iterpool);
+
+      rnd = rnd * 1103515245 + 12345;
+      k = (int)((rnd >> 8) % baton->key_count);
+
+      if ((int)((rnd >> 4) % 1000) < baton->writes_per_thousand)
+        {
+          svn_revnum_t value = k;
+          SVN_ERR(svn_cache__set(cache, baton->keys[k], &value, iterpool));
+        }
+      else
+        {
+          svn_revnum_t *value;
+          svn_boolean_t found;
+
+          SVN_ERR(svn_cache__get((void **)&value, &found, cache,
+                                 baton->keys[k], iterpool));
+          if (found)
+            {
+              if (*value != k)
+                return svn_error_createf(SVN_ERR_TEST_FAILED, NULL,
+                                         "Got value %ld for key %d",
+                                         *value, k);
+              baton->hits++;
+            }
+        }
+    }
+
+  svn_pool_destroy(iterpool);
+
+  return SVN_NO_ERROR;
+}
+
+/* Thread function calling access_cache() for the cache_access_baton_t
+   given as DATA. */
+static void *
+APR_THREAD_FUNC cache_access_thread(apr_thread_t *tid, void *data)
+{
+  cache_access_baton_t *baton = data;
+  apr_pool_t *pool = svn_pool_create(NULL);
+
+  baton->err = access_cache(baton, pool);
+
+  svn_pool_destroy(pool);
+  apr_thread_exit(tid, APR_SUCCESS);
+
+  return NULL;
+}
+
+#define APR_ERR(expr)                           \
+  do {                                          \
+    apr_status_t status = (expr);               \
+    if (status)                                 \
+      return svn_error_wrap_apr(status, NULL);  \
+  } while (0)
+
+/* Let THREAD_COUNT threads perform ITERATIONS accesses each to MEMBUFFER,
+   using the first KEY_COUNT of KEYS with WRITES_PER_THOUSAND writes per
+   1000 accesses.  Return the wall clock time it took in *DURATION and the
+   total number of hits in *HITS.  Use POOL for allocations. */
+static svn_error_t *
+run_cache_access_threads(apr_interval_time_t *duration,
+                         int *hits,
+                         svn_membuffer_t *membuffer,
+                         const char **keys,
+                         int key_count,
+                         int thread_count,
+                         int iterations,
+                         int writes_per_thousand,
+                         apr_pool_t *pool)
+{
+  apr_thread_t **threads = apr_pcalloc(pool,
+                                       thread_count * sizeof(*threads));
+  cache_access_baton_t *batons = apr_pcalloc(pool,
+                                             thread_count * sizeof(*batons));
+  svn_error_t *err = SVN_NO_ERROR;
+  apr_time_t start = apr_time_now();
+  int i;
+
+  for (i = 0; i < thread_count; ++i)
+    {
+      batons[i].membuffer = membuffer;
+      batons[i].keys = keys;
+      batons[i].key_count = key_count;
+      batons[i].iterations = iterations;
+      batons[i].writes_per_thousand = writes_per_thousand;
+      batons[i].seed = (apr_uint32_t)i * 7919 + 1;
+
+      APR_ERR(apr_thread_create(&threads[i], NULL, cache_access_thread,
+                                &batons[i], pool));
+    }
+
+  /* wait for the threads to finish */
+  *hits = 0;
+  for (i = 0; i < thread_count; ++i)
+    {
+      apr_status_t retval;
+      APR_ERR(apr_thread_join(&retval, threads[i]));
+      APR_ERR(retval);
+
+      err = svn_error_compose_create(err, batons[i].err);
+      *hits += batons[i].hits;
+    }
+
+  *duration = apr_time_now() - start;
+
+  return svn_error_trace(err);
+}
+
+/* Return an array of COUNT distinct cache keys allocated in POOL. */
+static const char **
+make_keys(int count,
+          apr_pool_t *pool)
+{
+  const char **keys = apr_palloc(pool, count * sizeof(*keys));
+  int i;
+
+  for (i = 0; i < count; ++i)
+    keys[i] = apr_psprintf(pool, "key-%d", i);
+
+  return keys;
+}
+
+#endif
+
+static svn_error_t *
+test_membuffer_concurrent_access(apr_pool_t *pool)
+{
+#if APR_HAS_THREADS
+  enum { KEY_COUNT = 2000, THREAD_COUNT = 8 };
+  svn_membuffer_t *membuffer;
+  apr_interval_time_t duration;
+  int hits;
+
+  /* A single, small segment for maximum contention and lots of
+     evictions. */
+  SVN_ERR(svn_cache__membuffer_cache_create(&membuffer, 64 * 1024, 0, 1,
+                                            TRUE, TRUE, pool));
+
+  /* Every value read must match the key. */
+  SVN_ERR(run_cache_access_threads(&duration, &hits, membuffer,
+                                   make_keys(KEY_COUNT, pool), KEY_COUNT,
+                                   THREAD_COUNT, 20000, 100, pool));
+  SVN_TEST_ASSERT(hits > 0);
+
+  return SVN_NO_ERROR;
+#else
+  return svn_error_create(SVN_ERR_TEST_SKIPPED, NULL,
+                          "Threads are not supported");
+#endif
+}
+
+static svn_error_t *
+test_membuffer_scalability(apr_pool_t *pool)
+{
+#if APR_HAS_THREADS
+  enum { KEY_COUNT = 10000, ITERATIONS = 200000 };
+  svn_membuffer_t *membuffer;
+  const char **keys = make_keys(KEY_COUNT, pool);
+  apr_interval_time_t duration;
+  int thread_count;
+  int hits;
+
+  /* Large enough to hold all keys. */
+  SVN_ERR(svn_cache__membuffer_cache_create(&membuffer, 16 * 1024 * 1024,
+                                            0, 0, TRUE, TRUE, pool));
+
+  /* Fill the cache. */
+  SVN_ERR(run_cache_access_threads(&duration, &hits, membuffer, keys,
+                                   KEY_COUNT, 1, 10 * KEY_COUNT, 1000,
+                                   pool));
+
+  /* Mostly reads, some writes. */
+  for (thread_count = 1; thread_count <= 64; thread_count *= 2)
+    {
+      apr_uint64_t accesses = (apr_uint64_t)thread_count * ITERATIONS;
+
+      SVN_ERR(run_cache_access_threads(&duration, &hits, membuffer, keys,
+                                       KEY_COUNT, thread_count, ITERATIONS,
+                                       50, pool));
+
+      printf("%2d threads: %"APR_TIME_T_FMT" musecs, "
+             "%"APR_UINT64_T_FMT" accesses / sec\n",
+             thread_count, duration,
+             accesses * 1000000 / (duration ? duration : 1));
+    }
+
+  return SVN_NO_ERROR;
+#else
+  return svn_error_create(SVN_ERR_TEST_SKIPPED, NULL,
+                          "Threads are not supported");
+#endif
+}
+
+
+#if APR_HAS_FORK && APR_HAS_SHARED_MEMORY
+/* Implements svn_cache__partial_getter_func_t.
+ * Terminate the current process while it holds the cache lock. */
+static svn_error_t *
+die_while_reading(void **out,
+                  const void *data,
+                  apr_size_t data_len,
+                  void *baton,
+                  apr_pool_t *result_pool)
+{
+  _exit(0);
+  return SVN_NO_ERROR;
+}
+#endif
+
+static svn_error_t *
+test_membuffer_shared_memory(apr_pool_t *pool)
+{
+#if APR_HAS_FORK && APR_HAS_SHARED_MEMORY
+  svn_membuffer_t *membuffer;
+  svn_cache__t *cache;
+  svn_revnum_t *value;
+  svn_boolean_t found;
+  apr_proc_t proc;
+  apr_status_t status;
+  int exit_code;
+  apr_exit_why_e exit_why;
+  svn_error_t *err;
+
+  /* Use a single segment, so all items share the same lock. */
+  err = svn_cache__membuffer_cache_create_shared(&membuffer, 1024 * 1024,
+                                                 0, 1, TRUE, pool);
+  if (err && APR_STATUS_IS_ENOTIMPL(err->apr_err))
+    return svn_error_create(SVN_ERR_TEST_SKIPPED, err,
+                            "Shared memory caches are not supported");
+  SVN_ERR(err);
+
+  SVN_ERR(svn_cache__create_membuffer_cache(&cache,
+                                            membuffer,
+                                            serialize_revnum,
+                                            deserialize_revnum,
+                                            APR_HASH_KEY_STRING,
+                                            "shared:",
+                                            SVN_CACHE__MEMBUFFER_DEFAULT_PRIORITY,
+                                            FALSE,
+                                            FALSE,
+                                            pool, pool));
+
+  /* Let a child process add an item and check it from the parent. */
+  status = apr_proc_fork(&proc, pool);
+  if (status == APR_INCHILD)
+    {
+      svn_revnum_t answer = 42;
+      svn_error_t *err = svn_cache__set(cache, "answer", &answer, pool);
+
+      _exit(err ? 1 : 0);
+    }
+  else if (status != APR_INPARENT)
+    {
+      return svn_error_wrap_apr(status, "Can't fork");
+    }
+
+  status = apr_proc_wait(&proc, &exit_code, &exit_why, APR_WAIT);
+  if (!APR_STATUS_IS_CHILD_DONE(status))
+    return svn_error_wrap_apr(status, "Can't wait for child process");
+
+  SVN_TEST_ASSERT(APR_PROC_CHECK_EXIT(exit_why) && exit_code == 0);
+
+  SVN_ERR(svn_cache__get((void **)&value, &found, cache, "answer", pool));
+  SVN_TEST_ASSERT(found);
+  SVN_TEST_ASSERT(*value == 42);
+
+  /* Let a child process die while holding the segment lock. */
+  status = apr_proc_fork(&proc, pool);
+  if (status == APR_INCHILD)
+    {
+      svn_error_clear(svn_cache__get_partial((void **)&value, &found, cache,
+                                             "answer", die_while_reading,
+                                             NULL, pool));
+      _exit(1);
+    }
+  else if (status != APR_INPARENT)
+    {
+      return svn_error_wrap_apr(status, "Can't fork");
+    }
+
+  status = apr_proc_wait(&proc, &exit_code, &exit_why, APR_WAIT);
+  if (!APR_STATUS_IS_CHILD_DONE(status))
+    return svn_error_wrap_apr(status, "Can't wait for child process");
+
+  SVN_TEST_ASSERT(APR_PROC_CHECK_EXIT(exit_why) && exit_code == 0);
+
+  /* The next writer recovers the lock and discards the segment contents,
+     which may have been left inconsistent. */
+  {
+    svn_revnum_t question = 6 * 9;
+    SVN_ERR(svn_cache__set(cache, "question", &question, pool));
+  }
+
+  SVN_ERR(svn_cache__get((void **)&value, &found, cache, "answer", pool));
+  SVN_TEST_ASSERT(!found);
+  SVN_ERR(svn_cache__get((void **)&value, &found, cache, "question", pool));
+  SVN_TEST_ASSERT(found);
+  SVN_TEST_ASSERT(*value == 54);
+
+  return SVN_NO_ERROR;
+#else
+  return svn_error_create(SVN_ERR_TEST_SKIPPED, NULL,
+                          "Shared memory is not supported");
+#endif
+}
+
 /* The test table.  */
 
 static int max_threads = 1;
@@ -616,6 +1161,20 @@ static struct svn_test_descriptor_t test_funcs[] =
                    "test membuffer cache with unaligned string keys"),
     SVN_TEST_PASS2(test_membuffer_unaligned_fixed_keys,
                    "test membuffer cache with unaligned fixed keys"),
+    SVN_TEST_PASS2(test_membuffer_concurrent_access,
+                   "test concurrent membuffer cache access"),
+    SVN_TEST_SKIP2(test_membuffer_scalability, TRUE,
+                   "optional membuffer cache scalability benchmark"),
+    SVN_TEST_PASS2(test_membuffer_shared_memory,
+                   "test membuffer cache in shared memory"),
+    SVN_TEST_PASS2(test_disk_cache_basic,
+                   "basic disk cache test"),
+    SVN_TEST_PASS2(test_disk_cache_size_limit,
+                   "test disk cache size limit"),
+    SVN_TEST_PASS2(test_disk_cache_global,
+                   "test process-global disk caches"),
+    SVN_TEST_PASS2(test_tiered_cache,
+                   "test tiered cache"),
     SVN_TEST_NULL
   };
 
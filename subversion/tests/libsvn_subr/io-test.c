@@ -32,6 +32,7 @@
 #include "svn_string.h"
 #include "svn_io.h"
 #include "svn_time.h"
+#include "private/svn_batch_fsync.h"
 #include "private/svn_skel.h"
 #include "private/svn_dep_compat.h"
 #include "private/svn_io_private.h"
@@ -1314,6 +1315,46 @@ test_file_size_get(apr_pool_t *pool)
   return SVN_NO_ERROR;
 }
 
+static svn_error_t *
+test_copy_file(apr_pool_t *pool)
+{
+  const char *tmp_dir;
+  const char *src_path;
+  const char *dst_path;
+  apr_size_t sizes[] = { 0, 1, 16384, 300001 };
+  apr_pool_t *iterpool = svn_pool_create(pool);
+  apr_size_t i;
+
+  SVN_ERR(svn_test_make_sandbox_dir(&tmp_dir, "test_copy_file", pool));
+  src_path = svn_dirent_join(tmp_dir, "src", pool);
+  dst_path = svn_dirent_join(tmp_dir, "dst", pool);
+
+  for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+    {
+      char *data;
+      svn_boolean_t same;
+      apr_size_t k;
+
+      svn_pool_clear(iterpool);
+
+      /* Non-repetitive contents, so misplaced blocks get detected. */
+      data = apr_palloc(iterpool, sizes[i] + 1);
+      for (k = 0; k < sizes[i]; k++)
+        data[k] = (char)((k * 7 + k / 251) & 0xff);
+
+      SVN_ERR(svn_io_remove_file2(src_path, TRUE, iterpool));
+      SVN_ERR(svn_io_file_create_bytes(src_path, data, sizes[i], iterpool));
+      SVN_ERR(svn_io_copy_file(src_path, dst_path, FALSE, iterpool));
+
+      SVN_ERR(svn_io_files_contents_same_p(&same, src_path, dst_path,
+                                           iterpool));
+      SVN_TEST_ASSERT(same);
+    }
+  svn_pool_destroy(iterpool);
+
+  return SVN_NO_ERROR;
+}
+
 static svn_error_t *
 test_file_rename2(apr_pool_t *pool)
 {
@@ -1460,6 +1501,78 @@ test_rmtree_all_readonly(apr_pool_t *pool)
   return SVN_NO_ERROR;
 }
 
+static svn_error_t *
+test_batch_fsync(apr_pool_t *pool)
+{
+  const char *abspath;
+  svn_batch_fsync__t *batch;
+  int i;
+
+  /* Create an empty working directory and let it be cleaned up by the test
+   * harness. */
+  SVN_ERR(svn_test_make_sandbox_dir(&abspath, "test_batch_fsync", pool));
+  SVN_ERR(svn_dirent_get_absolute(&abspath, abspath, pool));
+
+  /* Initialize infrastructure with a pool that lives as long as this
+   * application. */
+  SVN_ERR(svn_batch_fsync__init(pool));
+
+  /* We use and re-use the same batch object throughout this test. */
+  SVN_ERR(svn_batch_fsync__create(&batch, TRUE, pool));
+
+  /* The working directory is new. */
+  SVN_ERR(svn_batch_fsync__new_path(batch, abspath, pool));
+
+  /* 1st run: Has to fire up worker threads etc. */
+  for (i = 0; i < 10; ++i)
+    {
+      apr_file_t *file;
+      const char *path = svn_dirent_join(abspath,
+                                         apr_psprintf(pool, "file%i", i),
+                                         pool);
+      apr_size_t len = strlen(path);
+
+      SVN_ERR(svn_batch_fsync__open_file(&file, batch, path, pool));
+
+      SVN_ERR(svn_io_file_write(file, path, &len, pool));
+    }
+
+  SVN_ERR(svn_batch_fsync__run(batch, pool));
+
+  /* 2nd run: Running a batch must leave the container in an empty,
+   * re-usable state. Hence, try to re-use it. */
+  for (i = 0; i < 10; ++i)
+    {
+      apr_file_t *file;
+      const char *path = svn_dirent_join(abspath,
+                                         apr_psprintf(pool, "new%i", i),
+                                         pool);
+      apr_size_t len = strlen(path);
+
+      SVN_ERR(svn_batch_fsync__open_file(&file, batch, path, pool));
+
+      SVN_ERR(svn_io_file_write(file, path, &len, pool));
+    }
+
+  SVN_ERR(svn_batch_fsync__run(batch, pool));
+
+  /* 3rd run: Schedule but don't execute. POOL cleanup shall not fail. */
+  for (i = 0; i < 10; ++i)
+    {
+      apr_file_t *file;
+      const char *path = svn_dirent_join(abspath,
+                                         apr_psprintf(pool, "another%i", i),
+                                         pool);
+      apr_size_t len = strlen(path);
+
+      SVN_ERR(svn_batch_fsync__open_file(&file, batch, path, pool));
+
+      SVN_ERR(svn_io_file_write(file, path, &len, pool));
+    }
+
+  return SVN_NO_ERROR;
+}
+
 
 /* The test table.  */
 
@@ -1500,6 +1613,8 @@ static struct svn_test_descriptor_t test_funcs[] =
                    "test svn_io_file_size_get"),
     SVN_TEST_PASS2(test_file_rename2,
                    "test svn_io_file_rename2"),
+    SVN_TEST_PASS2(test_copy_file,
+                   "test svn_io_copy_file"),
     SVN_TEST_PASS2(test_read_length_line,
                    "test svn_io_read_length_line()"),
     SVN_TEST_PASS2(test_file_readline,
@@ -1516,6 +1631,8 @@ static struct svn_test_descriptor_t test_funcs[] =
                    "test svn_io_remove_dir2() with read-only directory"),
     SVN_TEST_PASS2(test_rmtree_all_readonly,
                    "test svn_io_remove_dir2() with read-only tree"),
+    SVN_TEST_PASS2(test_batch_fsync,
+                   "test svn_batch_fsync__run()"),
     SVN_TEST_NULL
   };
 
@@ -23,6 +23,7 @@
 
 #include <apr_pools.h>
 #include <apr_general.h>
+#include <apr_strings.h>
 
 #include "svn_types.h"
 
@@ -44,6 +45,7 @@
 
 #include "../../libsvn_wc/wc.h"
 #include "../../libsvn_wc/wc_db.h"
+#include "../../libsvn_wc/wc_db_private.h"
 #include "../../libsvn_wc/wc-queries.h"
 #include "../../libsvn_wc/workqueue.h"
 
@@ -170,6 +172,90 @@ pristine_write_read(const svn_test_opts_t *opts,
   return SVN_NO_ERROR;
 }
 
+/* Exercise the pristine text API with a text that spans several blocks
+   of a compressed pristine. */
+static svn_error_t *
+pristine_write_read_compressed(const svn_test_opts_t *opts,
+                               apr_pool_t *pool)
+{
+  svn_wc__db_t *db;
+  const char *wc_abspath;
+
+  svn_wc__db_install_data_t *install_data;
+  svn_stream_t *pristine_stream;
+  svn_stringbuf_t *data = svn_stringbuf_create_empty(pool);
+  svn_checksum_t *data_sha1, *data_md5;
+  const char *plain_abspath;
+  apr_size_t sz;
+  int format;
+  int i;
+
+  SVN_ERR(create_repos_and_wc(&wc_abspath, &db,
+                              "pristine_write_read_compressed", opts, pool));
+
+  /* Only format 32 working copies may store compressed pristines. */
+  SVN_ERR(svn_wc__db_open(&db, NULL, FALSE, TRUE, pool, pool));
+  db->compress_pristines = TRUE;
+  SVN_ERR(svn_wc__db_bump_format(&format, NULL, db, wc_abspath,
+                                 svn_wc__db_get_target_format(db), pool));
+  SVN_TEST_ASSERT(format == SVN_WC__HAS_COMPRESSED_PRISTINES);
+
+  for (i = 0; i < 20000; i++)
+    svn_stringbuf_appendcstr(data, apr_psprintf(pool, "line %d\n", i % 97));
+
+  SVN_ERR(svn_wc__db_pristine_prepare_install(&pristine_stream,
+                                              &install_data,
+                                              &data_sha1, &data_md5,
+                                              db, wc_abspath,
+                                              pool, pool));
+  sz = data->len;
+  SVN_ERR(svn_stream_write(pristine_stream, data->data, &sz));
+  SVN_ERR(svn_stream_close(pristine_stream));
+
+  SVN_ERR(svn_wc__db_pristine_install(install_data,
+                                      data_sha1, data_md5, pool));
+
+  /* The store reports the size of the text, not that of the file. */
+  {
+    svn_boolean_t compressed;
+    svn_stream_t *data_read_back;
+    svn_filesize_t size;
+    svn_boolean_t same;
+
+    SVN_ERR(svn_wc__db_pristine_is_compressed(&compressed, db, wc_abspath,
+                                              data_sha1, pool));
+    SVN_TEST_ASSERT(compressed);
+
+    SVN_ERR(svn_wc__db_pristine_read(&data_read_back, &size, db, wc_abspath,
+                                     data_sha1, pool, pool));
+    SVN_TEST_ASSERT(size == data->len);
+    SVN_ERR(svn_stream_contents_same2(&same, data_read_back,
+                                      svn_stream_from_stringbuf(data, pool),
+                                      pool));
+    SVN_TEST_ASSERT(same);
+  }
+
+  /* Callers of get_path() see the text in a temporary plain file. */
+  {
+    apr_pool_t *subpool = svn_pool_create(pool);
+    svn_stringbuf_t *plain;
+    svn_node_kind_t kind;
+
+    SVN_ERR(svn_wc__db_pristine_get_path(&plain_abspath, db, wc_abspath,
+                                         data_sha1, subpool, pool));
+    SVN_TEST_ASSERT(! svn_dirent_is_ancestor(wc_abspath, plain_abspath));
+    SVN_ERR(svn_stringbuf_from_file2(&plain, plain_abspath, pool));
+    SVN_TEST_ASSERT(svn_stringbuf_compare(plain, data));
+
+    plain_abspath = apr_pstrdup(pool, plain_abspath);
+    svn_pool_destroy(subpool);
+    SVN_ERR(svn_io_check_path(plain_abspath, &kind, pool));
+    SVN_TEST_ASSERT(kind == svn_node_none);
+  }
+
+  return SVN_NO_ERROR;
+}
+
 /* Test deleting a pristine text while it is open for reading. */
 static svn_error_t *
 pristine_delete_while_open(const svn_test_opts_t *opts,
@@ -318,6 +404,8 @@ static struct svn_test_descriptor_t test_funcs[] =
                        "pristine_delete_while_open"),
     SVN_TEST_OPTS_PASS(reject_mismatching_text,
                        "reject_mismatching_text"),
+    SVN_TEST_OPTS_PASS(pristine_write_read_compressed,
+                       "pristine_write_read_compressed"),
     SVN_TEST_NULL
   };
 
@@ -24,6 +24,7 @@
 #include <apr_pools.h>
 #include <apr_general.h>
 #include <apr_md5.h>
+#include <apr_strings.h>
 
 #define SVN_DEPRECATED
 
@@ -44,6 +45,7 @@
 #include "private/svn_dep_compat.h"
 #include "../../libsvn_wc/wc.h"
 #include "../../libsvn_wc/wc_db.h"
+#include "../../libsvn_wc/workqueue.h"
 #define SVN_WC__I_AM_WC_DB
 #include "../../libsvn_wc/wc_db_private.h"
 
@@ -771,6 +773,416 @@ test_internal_file_modified_eol_style(const svn_test_opts_t *opts,
   return SVN_NO_ERROR;
 }
 
+/* Implements svn_wc_status_func4_t.
+   Append a line "<node status> <path>" to the svn_stringbuf_t BATON. */
+static svn_error_t *
+status_to_stringbuf(void *baton,
+                    const char *local_abspath,
+                    const svn_wc_status3_t *status,
+                    apr_pool_t *scratch_pool)
+{
+  svn_stringbuf_t *buf = baton;
+
+  svn_stringbuf_appendcstr(buf,
+                           apr_psprintf(scratch_pool, "%d %d %s\n",
+                                        status->node_status,
+                                        status->text_status,
+                                        local_abspath));
+
+  return SVN_NO_ERROR;
+}
+
+static svn_error_t *
+test_walk_status_concurrently(const svn_test_opts_t *opts,
+                              apr_pool_t *pool)
+{
+  svn_test__sandbox_t b;
+  svn_stringbuf_t *expected = svn_stringbuf_create_empty(pool);
+  svn_stringbuf_t *actual = svn_stringbuf_create_empty(pool);
+
+  SVN_ERR(svn_test__sandbox_create(&b, "walk_status_concurrently",
+                                   opts, pool));
+  SVN_ERR(sbox_add_and_commit_greek_tree(&b));
+
+  /* Some local changes at various depths. */
+  SVN_ERR(sbox_file_write(&b, "iota", "modified iota\n"));
+  SVN_ERR(sbox_file_write(&b, "A/B/E/alpha", "modified alpha\n"));
+  SVN_ERR(sbox_file_write(&b, "A/D/H/unversioned", "unversioned\n"));
+  SVN_ERR(sbox_disk_mkdir(&b, "A/D/G/unversioned_dir"));
+  SVN_ERR(sbox_wc_delete(&b, "A/C"));
+  SVN_ERR(sbox_wc_mkdir(&b, "A/B/F/new_dir"));
+  SVN_ERR(svn_io_remove_file2(sbox_wc_path(&b, "A/mu"), FALSE, pool));
+
+  SVN_ERR(svn_wc_walk_status(b.wc_ctx, b.wc_abspath, svn_depth_infinity,
+                             TRUE, FALSE, FALSE, NULL,
+                             status_to_stringbuf, expected,
+                             NULL, NULL, pool));
+
+  /* Same statuses in the same order. */
+  SVN_ERR(svn_wc__walk_status_concurrently(b.wc_ctx, b.wc_abspath,
+                                           svn_depth_infinity,
+                                           TRUE, FALSE, FALSE, NULL, 4,
+                                           status_to_stringbuf, actual,
+                                           NULL, NULL, pool));
+  SVN_TEST_STRING_ASSERT(actual->data, expected->data);
+
+  /* Non-recursive walks simply work sequentially. */
+  svn_stringbuf_setempty(expected);
+  svn_stringbuf_setempty(actual);
+  SVN_ERR(svn_wc_walk_status(b.wc_ctx, sbox_wc_path(&b, "A"),
+                             svn_depth_immediates,
+                             TRUE, FALSE, FALSE, NULL,
+                             status_to_stringbuf, expected,
+                             NULL, NULL, pool));
+  SVN_ERR(svn_wc__walk_status_concurrently(b.wc_ctx, sbox_wc_path(&b, "A"),
+                                           svn_depth_immediates,
+                                           TRUE, FALSE, FALSE, NULL, 4,
+                                           status_to_stringbuf, actual,
+                                           NULL, NULL, pool));
+  SVN_TEST_STRING_ASSERT(actual->data, expected->data);
+
+  return SVN_NO_ERROR;
+}
+
+static svn_error_t *
+test_monitor_dirents(const svn_test_opts_t *opts,
+                     apr_pool_t *pool)
+{
+  svn_test__sandbox_t b;
+  svn_wc__monitor_t *monitor;
+  apr_hash_t *dirents, *cached;
+  const char *dir_abspath;
+  svn_error_t *err;
+
+  err = svn_wc__monitor_create(&monitor, pool);
+  if (err && err->apr_err == SVN_ERR_UNSUPPORTED_FEATURE)
+    {
+      svn_error_clear(err);
+      return svn_error_create(SVN_ERR_TEST_SKIPPED, NULL,
+                              "change monitoring not supported");
+    }
+  SVN_ERR(err);
+
+  SVN_ERR(svn_test__sandbox_create(&b, "monitor_dirents", opts, pool));
+  SVN_ERR(sbox_add_and_commit_greek_tree(&b));
+  dir_abspath = sbox_wc_path(&b, "A/B/E");
+
+  /* Nothing is known at first. */
+  SVN_ERR(svn_wc__monitor_get_dirents(&cached, monitor, dir_abspath, FALSE,
+                                      pool, pool));
+  SVN_TEST_ASSERT(cached == NULL);
+
+  SVN_ERR(svn_io_get_dirents3(&dirents, dir_abspath, FALSE, pool, pool));
+  SVN_ERR(svn_wc__monitor_set_dirents(monitor, dir_abspath, dirents, FALSE,
+                                      pool));
+
+  /* Unchanged directories come from the monitor. */
+  SVN_ERR(svn_wc__monitor_get_dirents(&cached, monitor, dir_abspath, FALSE,
+                                      pool, pool));
+  SVN_TEST_ASSERT(cached != NULL);
+  SVN_TEST_ASSERT(apr_hash_count(cached) == apr_hash_count(dirents));
+  SVN_TEST_ASSERT(svn_hash_gets(cached, "alpha") != NULL);
+
+  /* Full listings also serve type-only requests. */
+  SVN_ERR(svn_wc__monitor_get_dirents(&cached, monitor, dir_abspath, TRUE,
+                                      pool, pool));
+  SVN_TEST_ASSERT(cached != NULL);
+
+  /* Modifying a file invalidates the listing. */
+  SVN_ERR(sbox_file_write(&b, "A/B/E/alpha", "modified alpha\n"));
+  SVN_ERR(svn_wc__monitor_get_dirents(&cached, monitor, dir_abspath, FALSE,
+                                      pool, pool));
+  SVN_TEST_ASSERT(cached == NULL);
+
+  /* Changes between reading and storing a listing are not lost. */
+  SVN_ERR(svn_io_get_dirents3(&dirents, dir_abspath, FALSE, pool, pool));
+  SVN_ERR(sbox_file_write(&b, "A/B/E/new", "new\n"));
+  SVN_ERR(svn_wc__monitor_set_dirents(monitor, dir_abspath, dirents, FALSE,
+                                      pool));
+  SVN_ERR(svn_wc__monitor_get_dirents(&cached, monitor, dir_abspath, FALSE,
+                                      pool, pool));
+  SVN_TEST_ASSERT(cached == NULL);
+
+  /* Replacing a parent directory invalidates all listings below it. */
+  SVN_ERR(svn_io_get_dirents3(&dirents, dir_abspath, FALSE, pool, pool));
+  SVN_ERR(svn_wc__monitor_set_dirents(monitor, dir_abspath, dirents, FALSE,
+                                      pool));
+  SVN_ERR(svn_wc__monitor_get_dirents(&cached, monitor,
+                                      sbox_wc_path(&b, "A"), FALSE,
+                                      pool, pool));
+  SVN_ERR(svn_io_file_rename2(sbox_wc_path(&b, "A/B"),
+                              sbox_wc_path(&b, "B_moved"), FALSE, pool));
+  SVN_ERR(svn_io_copy_dir_recursively(sbox_wc_path(&b, "B_moved"),
+                                      sbox_wc_path(&b, "A"), "B",
+                                      FALSE, NULL, NULL, pool));
+  SVN_ERR(svn_wc__monitor_get_dirents(&cached, monitor, dir_abspath, FALSE,
+                                      pool, pool));
+  SVN_TEST_ASSERT(cached == NULL);
+
+  return SVN_NO_ERROR;
+}
+
+static svn_error_t *
+test_install_files_concurrently(const svn_test_opts_t *opts,
+                                apr_pool_t *pool)
+{
+  svn_test__sandbox_t b;
+  const struct svn_test__tree_entry_t *node;
+  apr_pool_t *iterpool = svn_pool_create(pool);
+  apr_uint64_t id;
+  svn_skel_t *work_item;
+  const char *queued[] = { "iota", "A/mu", "A/B/lambda", NULL };
+  const char **path;
+  apr_uint64_t installs;
+
+  SVN_ERR(svn_test__sandbox_create(&b, "install_files_concurrently",
+                                   opts, pool));
+  SVN_ERR(sbox_add_and_commit_greek_tree(&b));
+  SVN_ERR(sbox_wc_update(&b, "", 0));
+
+  /* Let the work queue write the files with multiple threads.  The update
+     editor then leaves the installs to the queue. */
+  b.wc_ctx->db->install_jobs = 4;
+  SVN_ERR(sbox_wc_update(&b, "", 1));
+  SVN_TEST_ASSERT(b.wc_ctx->db->concurrent_installs > 0);
+
+  /* Queue a few installs directly, clobbering the working files first. */
+  installs = b.wc_ctx->db->concurrent_installs;
+  for (path = queued; *path; path++)
+    {
+      SVN_ERR(sbox_file_write(&b, *path, "clobbered\n"));
+      SVN_ERR(svn_wc__wq_build_file_install(&work_item, b.wc_ctx->db,
+                                            sbox_wc_path(&b, *path), NULL,
+                                            FALSE, TRUE, pool, pool));
+      SVN_ERR(svn_wc__db_wq_add(b.wc_ctx->db, b.wc_abspath, work_item,
+                                pool));
+    }
+  SVN_ERR(svn_wc__wq_run(b.wc_ctx->db, b.wc_abspath, NULL, NULL, pool));
+  SVN_TEST_ASSERT(b.wc_ctx->db->concurrent_installs - installs
+                  == (path - queued));
+
+  for (node = svn_test__greek_tree_nodes; node->path; node++)
+    {
+      const char *local_abspath;
+      svn_stringbuf_t *contents;
+      svn_filesize_t recorded_size;
+      apr_time_t recorded_time;
+
+      if (! node->contents)
+        continue;
+
+      svn_pool_clear(iterpool);
+      local_abspath = sbox_wc_path(&b, node->path);
+
+      SVN_ERR(svn_stringbuf_from_file2(&contents, local_abspath, iterpool));
+      SVN_TEST_STRING_ASSERT(contents->data, node->contents);
+
+      /* The file info got recorded for all of them. */
+      SVN_ERR(svn_wc__db_read_info(NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+                                   NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+                                   NULL, NULL, NULL,
+                                   &recorded_size, &recorded_time,
+                                   NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+                                   NULL,
+                                   b.wc_ctx->db, local_abspath,
+                                   iterpool, iterpool));
+      SVN_TEST_ASSERT(recorded_size == (svn_filesize_t)contents->len);
+      SVN_TEST_ASSERT(recorded_time != 0);
+    }
+
+  /* Nothing is left in the work queue. */
+  SVN_ERR(svn_wc__db_wq_fetch_next(&id, &work_item, b.wc_ctx->db,
+                                   b.wc_abspath, 0, pool, pool));
+  SVN_TEST_ASSERT(work_item == NULL);
+
+  svn_pool_destroy(iterpool);
+  return SVN_NO_ERROR;
+}
+
+static svn_error_t *
+test_batch_commits_before_work(const svn_test_opts_t *opts,
+                               apr_pool_t *pool)
+{
+  svn_test__sandbox_t b;
+  svn_wc__db_t *db;
+  svn_wc__db_t *other_db;
+  svn_skel_t *work_item;
+  svn_skel_t *fetched;
+  apr_uint64_t id;
+
+  SVN_ERR(svn_test__sandbox_create(&b, "batch_commits_before_work",
+                                   opts, pool));
+  db = b.wc_ctx->db;
+  SVN_ERR(svn_wc__db_open_similar(&other_db, db, pool, pool));
+
+  SVN_ERR(svn_wc__db_batch_begin(db, b.wc_abspath, pool));
+  SVN_ERR(svn_wc__wq_build_file_remove(&work_item, db, b.wc_abspath,
+                                       sbox_wc_path(&b, "not-there"),
+                                       pool, pool));
+  SVN_ERR(svn_wc__db_wq_add(db, b.wc_abspath, work_item, pool));
+
+  /* The batch has not been committed, yet. */
+  SVN_ERR(svn_wc__db_wq_fetch_next(&id, &fetched, other_db, b.wc_abspath,
+                                   0, pool, pool));
+  SVN_TEST_ASSERT(fetched == NULL);
+
+  /* Fetching the work item for running it commits the batch. */
+  SVN_ERR(svn_wc__db_wq_fetch_next(&id, &fetched, db, b.wc_abspath,
+                                   0, pool, pool));
+  SVN_TEST_ASSERT(fetched != NULL);
+  SVN_ERR(svn_wc__db_wq_fetch_next(&id, &fetched, other_db, b.wc_abspath,
+                                   0, pool, pool));
+  SVN_TEST_ASSERT(fetched != NULL);
+
+  SVN_ERR(svn_wc__db_batch_end(db, b.wc_abspath, pool));
+  SVN_ERR(svn_wc__wq_run(db, b.wc_abspath, NULL, NULL, pool));
+
+  SVN_ERR(svn_wc__db_wq_fetch_next(&id, &fetched, other_db, b.wc_abspath,
+                                   0, pool, pool));
+  SVN_TEST_ASSERT(fetched == NULL);
+
+  return SVN_NO_ERROR;
+}
+
+static svn_error_t *
+test_batch_defers_direct_install(const svn_test_opts_t *opts,
+                                 apr_pool_t *pool)
+{
+  svn_test__sandbox_t b;
+  svn_wc__db_t *db;
+  svn_wc__db_t *other_db;
+  const char *repos_root_url;
+  const char *repos_uuid;
+  const char *tmp_dir;
+  const char *local_abspath;
+  const char *dir_abspath;
+  svn_wc__working_file_writer_t *writer;
+  svn_stream_t *stream;
+  svn_checksum_t *checksum;
+  svn_stringbuf_t *contents;
+  svn_node_kind_t kind;
+  svn_error_t *err;
+
+  SVN_ERR(svn_test__sandbox_create(&b, "batch_defers_direct_install",
+                                   opts, pool));
+  db = b.wc_ctx->db;
+  SVN_ERR(svn_wc__db_open_similar(&other_db, db, pool, pool));
+
+  SVN_ERR(svn_wc__db_base_get_info(NULL, NULL, NULL, NULL,
+                                   &repos_root_url, &repos_uuid,
+                                   NULL, NULL, NULL, NULL, NULL, NULL,
+                                   NULL, NULL, NULL, NULL,
+                                   db, b.wc_abspath, pool, pool));
+  SVN_ERR(svn_wc__db_temp_wcroot_tempdir(&tmp_dir, db, b.wc_abspath,
+                                         pool, pool));
+  SVN_ERR(svn_checksum(&checksum, svn_checksum_sha1, "content", 7, pool));
+  dir_abspath = sbox_wc_path(&b, "dir");
+  local_abspath = sbox_wc_path(&b, "dir/file");
+
+  SVN_ERR(svn_wc__db_batch_begin(db, b.wc_abspath, pool));
+
+  SVN_ERR(svn_wc__db_base_add_incomplete_directory(db, dir_abspath, "dir",
+                                                   repos_root_url,
+                                                   repos_uuid, 0,
+                                                   svn_depth_infinity,
+                                                   FALSE, FALSE, NULL, NULL,
+                                                   TRUE, pool));
+
+  SVN_ERR(svn_wc__working_file_writer_open(&writer, tmp_dir, -1,
+                                           svn_subst_eol_style_none, NULL,
+                                           FALSE, NULL, FALSE, FALSE,
+                                           FALSE,
+                                           pool, pool));
+  stream = svn_wc__working_file_writer_get_stream(writer);
+  SVN_ERR(svn_stream_puts(stream, "content"));
+  SVN_ERR(svn_stream_close(stream));
+
+  SVN_ERR(svn_wc__db_base_add_file(db, local_abspath, b.wc_abspath,
+                                   "dir/file", repos_root_url, repos_uuid,
+                                   0, apr_hash_make(pool), 0, 0, NULL,
+                                   checksum, NULL, FALSE, FALSE, NULL,
+                                   NULL, FALSE, FALSE, NULL,
+                                   writer, TRUE, NULL, pool));
+  SVN_ERR(svn_wc__working_file_writer_close(writer));
+
+  /* Neither the nodes nor the directory and the file they describe are
+     there, yet. */
+  err = svn_wc__db_base_get_info(NULL, NULL, NULL, NULL, NULL, NULL,
+                                 NULL, NULL, NULL, NULL, NULL, NULL,
+                                 NULL, NULL, NULL, NULL,
+                                 other_db, local_abspath, pool, pool);
+  SVN_TEST_ASSERT_ERROR(err, SVN_ERR_WC_PATH_NOT_FOUND);
+  SVN_ERR(svn_io_check_path(dir_abspath, &kind, pool));
+  SVN_TEST_ASSERT(kind == svn_node_none);
+
+  /* Committing the batch puts them in place. */
+  SVN_ERR(svn_wc__db_batch_end(db, b.wc_abspath, pool));
+
+  SVN_ERR(svn_wc__db_base_get_info(NULL, &kind, NULL, NULL, NULL, NULL,
+                                   NULL, NULL, NULL, NULL, NULL, NULL,
+                                   NULL, NULL, NULL, NULL,
+                                   other_db, local_abspath, pool, pool));
+  SVN_TEST_ASSERT(kind == svn_node_file);
+  SVN_ERR(svn_io_check_path(dir_abspath, &kind, pool));
+  SVN_TEST_ASSERT(kind == svn_node_dir);
+  SVN_ERR(svn_stringbuf_from_file2(&contents, local_abspath, pool));
+  SVN_TEST_STRING_ASSERT(contents->data, "content");
+
+  return SVN_NO_ERROR;
+}
+
+/* The number of files in test_batch_update_commits(). */
+#define BATCH_UPDATE_FILES 64
+
+static svn_error_t *
+test_batch_update_commits(const svn_test_opts_t *opts,
+                          apr_pool_t *pool)
+{
+  svn_test__sandbox_t b;
+  svn_wc__db_wcroot_t *wcroot;
+  const char *local_relpath;
+  apr_uint64_t commits;
+  int i;
+
+  SVN_ERR(svn_test__sandbox_create(&b, "batch_update_commits", opts, pool));
+  SVN_ERR(sbox_wc_mkdir(&b, "A"));
+  for (i = 0; i < BATCH_UPDATE_FILES; i++)
+    {
+      const char *path = apr_psprintf(pool, "A/file%d", i);
+
+      SVN_ERR(sbox_file_write(&b, path, "content\n"));
+      SVN_ERR(sbox_wc_add(&b, path));
+    }
+  SVN_ERR(sbox_wc_commit(&b, ""));
+  SVN_ERR(sbox_wc_update(&b, "", 0));
+
+  SVN_ERR(svn_wc__db_wcroot_parse_local_abspath(&wcroot, &local_relpath,
+                                                b.wc_ctx->db, b.wc_abspath,
+                                                pool, pool));
+  commits = svn_sqlite__get_commit_count(wcroot->sdb);
+
+  /* Check out all files again.  Without batching, every one of them
+     would take at least one commit of its own. */
+  SVN_ERR(sbox_wc_update(&b, "", 1));
+  commits = svn_sqlite__get_commit_count(wcroot->sdb) - commits;
+  SVN_TEST_ASSERT(commits > 0 && commits < BATCH_UPDATE_FILES / 4);
+
+  for (i = 0; i < BATCH_UPDATE_FILES; i++)
+    {
+      svn_stringbuf_t *contents;
+
+      SVN_ERR(svn_stringbuf_from_file2(&contents,
+                                       sbox_wc_path(&b,
+                                                    apr_psprintf(pool,
+                                                                 "A/file%d",
+                                                                 i)),
+                                       pool));
+      SVN_TEST_STRING_ASSERT(contents->data, "content\n");
+    }
+
+  return SVN_NO_ERROR;
+}
+
 /* ---------------------------------------------------------------------- */
 /* The list of test functions */
 
@@ -803,6 +1215,18 @@ static struct svn_test_descriptor_t test_funcs[] =
                        "test internal_file_modified with keywords"),
     SVN_TEST_OPTS_PASS(test_internal_file_modified_eol_style,
                        "test internal_file_modified with eol-style"),
+    SVN_TEST_OPTS_PASS(test_walk_status_concurrently,
+                       "test svn_wc__walk_status_concurrently"),
+    SVN_TEST_OPTS_PASS(test_monitor_dirents,
+                       "test the working copy change monitor"),
+    SVN_TEST_OPTS_PASS(test_install_files_concurrently,
+                       "install working files concurrently"),
+    SVN_TEST_OPTS_PASS(test_batch_commits_before_work,
+                       "batched DB changes are committed before work"),
+    SVN_TEST_OPTS_PASS(test_batch_defers_direct_install,
+                       "batch defers installs until it is committed"),
+    SVN_TEST_OPTS_PASS(test_batch_update_commits,
+                       "update commits its DB changes in batches"),
     SVN_TEST_NULL
   };
 
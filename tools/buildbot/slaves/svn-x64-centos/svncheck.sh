@@ -40,6 +40,7 @@ case "$2" in
     ;;
   ra_svn)
     make svnserveautocheck FS_TYPE="$1" CLEANUP=1 || exit $?
+    make svnserveautocheck FS_TYPE="$1" CLEANUP=1 EVENT_LOOP=1 || exit $?
     ;;
   ra_local)
     make check FS_TYPE="$1" CLEANUP=1 || exit $?
@@ -0,0 +1,349 @@
+/* delta-bench.c -- measure the throughput of the text delta engine
+ *
+ * ====================================================================
+ *    Licensed to the Apache Software Foundation (ASF) under one
+ *    or more contributor license agreements.  See the NOTICE file
+ *    distributed with this work for additional information
+ *    regarding copyright ownership.  The ASF licenses this file
+ *    to you under the Apache License, Version 2.0 (the
+ *    "License"); you may not use this file except in compliance
+ *    with the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing,
+ *    software distributed under the License is distributed on an
+ *    "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *    KIND, either express or implied.  See the License for the
+ *    specific language governing permissions and limitations
+ *    under the License.
+ * ====================================================================
+ */
+
+#include <apr_getopt.h>
+#include <apr_strings.h>
+
+#include "svn_pools.h"
+#include "svn_cmdline.h"
+#include "svn_delta.h"
+#include "svn_dirent_uri.h"
+#include "svn_io.h"
+#include "svn_string.h"
+#include "svn_time.h"
+#include "private/svn_delta_private.h"
+#include "private/svn_string_private.h"
+
+#include "svn_private_config.h"
+
+/* Default number of times each delta will be calculated. */
+#define DEFAULT_ITERATIONS 3
+
+/* Default size of the synthetic corpora in MB. */
+#define DEFAULT_SIZE 16
+
+/* Simple deterministic pseudo-random number generator such that results
+ * are comparable between runs and machines. */
+static apr_uint32_t
+next_random(apr_uint32_t *seed)
+{
+  *seed = *seed * 1103515245 + 12345;
+  return *seed >> 8;
+}
+
+/* Fill *SOURCE and *TARGET with SIZE bytes (approximately) of source code
+ * like text.  TARGET is a modified copy of SOURCE with a few changed and
+ * inserted lines.  Allocate the results in RESULT_POOL.
+ */
+static void
+make_text_corpus(svn_string_t **source,
+                 svn_string_t **target,
+                 apr_size_t size,
+                 apr_pool_t *result_pool)
+{
+  svn_stringbuf_t *s = svn_stringbuf_create_ensure(size, result_pool);
+  svn_stringbuf_t *t = svn_stringbuf_create_ensure(size, result_pool);
+  apr_uint32_t seed = 1;
+  char line[80];
+
+  while (s->len < size)
+    {
+      apr_uint32_t r = next_random(&seed);
+      int len = apr_snprintf(line, sizeof(line),
+                             "%*svalue_%u = compute(value_%u, %u);\n",
+                             (int)(r % 4) * 2, "", r % 1000,
+                             (r >> 10) % 1000, r % 97);
+
+      svn_stringbuf_appendbytes(s, line, len);
+
+      /* Change every 50th line and insert one every 200 lines. */
+      r = next_random(&seed);
+      if (r % 50 == 0)
+        svn_stringbuf_appendcstr(t, "  /* changed */\n");
+      else
+        svn_stringbuf_appendbytes(t, line, len);
+
+      if (r % 200 == 1)
+        svn_stringbuf_appendcstr(t, "  log(\"inserted line\");\n");
+    }
+
+  *source = svn_stringbuf__morph_into_string(s);
+  *target = svn_stringbuf__morph_into_string(t);
+}
+
+/* Fill *SOURCE and *TARGET with SIZE bytes (approximately) of binary
+ * data.  TARGET is a modified copy of SOURCE with sparse byte changes
+ * as well as a few insertions that shift the remaining data.  Allocate
+ * the results in RESULT_POOL.
+ */
+static void
+make_binary_corpus(svn_string_t **source,
+                   svn_string_t **target,
+                   apr_size_t size,
+                   apr_pool_t *result_pool)
+{
+  svn_stringbuf_t *s = svn_stringbuf_create_ensure(size, result_pool);
+  svn_stringbuf_t *t = svn_stringbuf_create_ensure(size, result_pool);
+  apr_uint32_t seed = 2;
+  apr_size_t i;
+
+  for (i = 0; i < size; i++)
+    {
+      char c = (char)next_random(&seed);
+      apr_uint32_t r = next_random(&seed);
+
+      svn_stringbuf_appendbyte(s, c);
+      if (r % 1000 == 0)
+        svn_stringbuf_appendbyte(t, (char)(c + 1));
+      else
+        svn_stringbuf_appendbyte(t, c);
+
+      if (r % 50000 == 1)
+        svn_stringbuf_appendbytes(t, "shift", r % 5 + 1);
+    }
+
+  *source = svn_stringbuf__morph_into_string(s);
+  *target = svn_stringbuf__morph_into_string(t);
+}
+
+/* Calculate the delta from SOURCE to TARGET and return the number of
+ * new data bytes and delta ops in *NEW_DATA_LEN and *OPS, respectively.
+ * Use content-defined chunking if CDC is set.
+ * Use SCRATCH_POOL for temporary allocations.
+ */
+static svn_error_t *
+run_delta(apr_size_t *new_data_len,
+          apr_size_t *ops,
+          const svn_string_t *source,
+          const svn_string_t *target,
+          svn_boolean_t cdc,
+          apr_pool_t *scratch_pool)
+{
+  apr_pool_t *iterpool = svn_pool_create(scratch_pool);
+  svn_txdelta_stream_t *stream;
+  svn_txdelta_window_t *window;
+
+  *new_data_len = 0;
+  *ops = 0;
+
+  if (cdc)
+    svn_txdelta__cdc(&stream,
+                     svn_stream_from_string(source, scratch_pool),
+                     svn_stream_from_string(target, scratch_pool),
+                     FALSE, scratch_pool);
+  else
+    svn_txdelta2(&stream,
+                 svn_stream_from_string(source, scratch_pool),
+                 svn_stream_from_string(target, scratch_pool),
+                 FALSE, scratch_pool);
+  do
+    {
+      svn_pool_clear(iterpool);
+      SVN_ERR(svn_txdelta_next_window(&window, stream, iterpool));
+      if (window)
+        {
+          *new_data_len += window->new_data ? window->new_data->len : 0;
+          *ops += window->num_ops;
+        }
+    }
+  while (window);
+
+  svn_pool_destroy(iterpool);
+
+  return SVN_NO_ERROR;
+}
+
+/* Calculate the delta from SOURCE to TARGET ITERATIONS times and print
+ * the throughput as well as the delta size under NAME.  CDC selects the
+ * delta algorithm as in run_delta().
+ * Use SCRATCH_POOL for temporary allocations.
+ */
+static svn_error_t *
+bench_pair(const char *name,
+           const svn_string_t *source,
+           const svn_string_t *target,
+           int iterations,
+           svn_boolean_t cdc,
+           apr_pool_t *scratch_pool)
+{
+  apr_pool_t *iterpool = svn_pool_create(scratch_pool);
+  apr_size_t new_data_len = 0;
+  apr_size_t ops = 0;
+  apr_time_t start = apr_time_now();
+  apr_time_t duration;
+  double mb_per_sec;
+  int i;
+
+  for (i = 0; i < iterations; i++)
+    {
+      svn_pool_clear(iterpool);
+      SVN_ERR(run_delta(&new_data_len, &ops, source, target, cdc,
+                        iterpool));
+    }
+
+  duration = apr_time_now() - start;
+  mb_per_sec = duration
+             ? (double)target->len * iterations / duration
+               * APR_USEC_PER_SEC / 0x100000
+             : 0.0;
+
+  SVN_ERR(svn_cmdline_printf(scratch_pool,
+                             "%-24s %10" APR_SIZE_T_FMT " bytes"
+                             " %9.1f MB/s"
+                             " %10" APR_SIZE_T_FMT " new"
+                             " %8" APR_SIZE_T_FMT " ops\n",
+                             name, target->len, mb_per_sec,
+                             new_data_len, ops));
+
+  svn_pool_destroy(iterpool);
+
+  return SVN_NO_ERROR;
+}
+
+/* Read the file at PATH into *CONTENTS, allocated in RESULT_POOL. */
+static svn_error_t *
+read_file(svn_string_t **contents,
+          const char *path,
+          apr_pool_t *result_pool)
+{
+  svn_stringbuf_t *buf;
+
+  SVN_ERR(svn_stringbuf_from_file2(&buf, path, result_pool));
+  *contents = svn_stringbuf__morph_into_string(buf);
+
+  return SVN_NO_ERROR;
+}
+
+static svn_error_t *
+usage(apr_pool_t *pool)
+{
+  return svn_error_trace(svn_cmdline_fputs(
+    _("usage: delta-bench [-c] [-n ITERATIONS] [-s SIZE_MB] "
+      "[SOURCE TARGET ...]\n"
+      "\n"
+      "  Measure the throughput of the text delta engine.\n"
+      "  Without file arguments, synthetic text and binary corpora of\n"
+      "  SIZE_MB each are used.  Otherwise, the delta between each pair of\n"
+      "  SOURCE and TARGET files will be measured.\n"
+      "  With -c, use content-defined chunking to find the source data.\n"),
+    stderr, pool));
+}
+
+static svn_error_t *
+sub_main(int argc, const char *argv[], apr_pool_t *pool)
+{
+  apr_getopt_t *os;
+  int iterations = DEFAULT_ITERATIONS;
+  svn_boolean_t cdc = FALSE;
+  apr_size_t size = DEFAULT_SIZE;
+  svn_string_t *source, *target;
+
+  apr_getopt_init(&os, pool, argc, argv);
+  while (1)
+    {
+      int opt;
+      const char *arg;
+      apr_status_t status = apr_getopt(os, "cn:s:h", &opt, &arg);
+
+      if (APR_STATUS_IS_EOF(status))
+        break;
+      if (status != APR_SUCCESS)
+        return svn_error_trace(usage(pool));
+
+      switch (opt)
+        {
+          case 'c':
+            cdc = TRUE;
+            break;
+
+          case 'n':
+            SVN_ERR(svn_cstring_atoi(&iterations, arg));
+            break;
+
+          case 's':
+            {
+              int mb;
+              SVN_ERR(svn_cstring_atoi(&mb, arg));
+              size = (apr_size_t)mb * 0x100000;
+            }
+            break;
+
+          default:
+            return svn_error_trace(usage(pool));
+        }
+    }
+
+  if (os->ind == argc)
+    {
+      make_text_corpus(&source, &target, size, pool);
+      SVN_ERR(bench_pair("text", source, target, iterations, cdc, pool));
+
+      make_binary_corpus(&source, &target, size, pool);
+      SVN_ERR(bench_pair("binary", source, target, iterations, cdc,
+                         pool));
+    }
+  else if ((argc - os->ind) % 2)
+    {
+      return svn_error_trace(usage(pool));
+    }
+  else
+    {
+      apr_pool_t *iterpool = svn_pool_create(pool);
+      int i;
+
+      for (i = os->ind; i < argc; i += 2)
+        {
+          const char *source_path = svn_dirent_canonicalize(argv[i], pool);
+          const char *target_path = svn_dirent_canonicalize(argv[i + 1],
+                                                            pool);
+
+          svn_pool_clear(iterpool);
+          SVN_ERR(read_file(&source, source_path, iterpool));
+          SVN_ERR(read_file(&target, target_path, iterpool));
+          SVN_ERR(bench_pair(svn_dirent_basename(target_path, iterpool),
+                             source, target, iterations, cdc, iterpool));
+        }
+
+      svn_pool_destroy(iterpool);
+    }
+
+  return SVN_NO_ERROR;
+}
+
+int
+main(int argc, const char *argv[])
+{
+  apr_pool_t *pool;
+  svn_error_t *err;
+
+  if (svn_cmdline_init("delta-bench", stderr) != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  pool = svn_pool_create(NULL);
+
+  err = sub_main(argc, argv, pool);
+  if (err)
+    return svn_cmdline_handle_exit_error(err, pool, "delta-bench: ");
+
+  svn_pool_destroy(pool);
+  return EXIT_SUCCESS;
+}